@@ -90,9 +90,10 @@
 #define FPM_DEFAULT_PORT 2620
 
 /*
- * Largest message that can be sent to or received from the FPM.
+ * Largest message that can be sent to or received from the FPM, i.e. the
+ * largest msg_len. The routes of wide ECMP groups do not fit in 4K.
  */
-#define FPM_MAX_MSG_LEN 4096
+#define FPM_MAX_MSG_LEN 65535
 
 /*
  * Header that precedes each fpm message to/from the FPM.
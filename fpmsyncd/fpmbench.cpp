@@ -0,0 +1,468 @@
+/*
+ * Replays an FPM byte stream through the two decodings of the route messages
+ * of fpmsyncd, and reports the messages decoded per second by each:
+ * - libnl: nlmsg_convert(), a rtnl_route object, and its next hops printed
+ *   with nl_addr2str() and string concatenation;
+ * - raw: the rtattrs read in place by RawRoute.
+ * Both decodings of each message are compared.
+ *
+ * With -l, the stream is instead written to a socketpair and read back the way
+ * FpmLink receives it, and the way it used to: a single read() per wakeup into a
+ * fixed buffer whose unprocessed tail is moved back to the front.
+ *
+ * The stream is the concatenation of the FPM messages zebra writes to fpmsyncd,
+ * e.g. the TCP payload of a capture of port 2620. With -g, a stream of IPv4
+ * ECMP route additions is first written to the file.
+ *
+ * Usage: fpmsyncd-bench [-l] [-g <routes>] [-e <next hops>] [-r <rounds>] <file>
+ */
+#include <assert.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netlink/msg.h>
+#include <netlink/route/route.h>
+#include <netlink/route/nexthop.h>
+#include "fpm/fpm.h"
+#include "fpmsyncd/rawroute.h"
+#include "fpmsyncd/fpmbuffer.h"
+
+using namespace std;
+using namespace swss;
+
+#define MAX_ADDR_SIZE 64
+
+struct DecodedRoute
+{
+    string prefix;
+    string nexthops;
+    string ifnames;
+    string weights;
+};
+
+/* Interface names of the capture host are not known, ifindex N is EthernetN */
+static bool getIfName(int if_index, char *if_name, size_t name_len)
+{
+    snprintf(if_name, name_len, "Ethernet%d", if_index);
+    return true;
+}
+
+/* Same steps as RouteSync::onRouteMsg() and its next hop helpers */
+static void decodeLibnlRoute(struct nl_object *obj, void *arg)
+{
+    struct rtnl_route *route_obj = (struct rtnl_route *)obj;
+    DecodedRoute &route = *static_cast<DecodedRoute *>(arg);
+    char buf[MAX_ADDR_SIZE + 1] = {0};
+
+    route.prefix = nl_addr2str(rtnl_route_get_dst(route_obj), buf, MAX_ADDR_SIZE);
+    route.nexthops = "";
+    route.ifnames = "";
+    route.weights = "";
+
+    int count = rtnl_route_get_nnexthops(route_obj);
+    for (int i = 0; i < count; i++)
+    {
+        struct nl_addr *addr = rtnl_route_nh_get_gateway(rtnl_route_nexthop_n(route_obj, i));
+        if (addr)
+        {
+            char gw_ip[MAX_ADDR_SIZE + 1] = {0};
+            nl_addr2str(addr, gw_ip, MAX_ADDR_SIZE);
+            route.nexthops += gw_ip;
+        }
+        else
+        {
+            route.nexthops += rtnl_route_get_family(route_obj) == AF_INET ? "0.0.0.0" : "::";
+        }
+
+        if (i + 1 < count)
+        {
+            route.nexthops += string(",");
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        char if_name[IFNAMSIZ] = "0";
+        getIfName(rtnl_route_nh_get_ifindex(rtnl_route_nexthop_n(route_obj, i)), if_name, IFNAMSIZ);
+        route.ifnames += if_name;
+
+        if (i + 1 < count)
+        {
+            route.ifnames += string(",");
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t weight = rtnl_route_nh_get_weight(rtnl_route_nexthop_n(route_obj, i));
+        if (!weight)
+        {
+            route.weights = "";
+            break;
+        }
+        route.weights += to_string(weight + 1);
+
+        if (i + 1 < count)
+        {
+            route.weights += string(",");
+        }
+    }
+}
+
+static bool decodeLibnl(struct nlmsghdr *h, DecodedRoute &route)
+{
+    nl_msg *msg = nlmsg_convert(h);
+    if (msg == NULL)
+    {
+        return false;
+    }
+
+    nlmsg_set_proto(msg, NETLINK_ROUTE);
+    int err = nl_msg_parse(msg, decodeLibnlRoute, &route);
+    nlmsg_free(msg);
+    return err == 0;
+}
+
+static bool decodeRaw(struct nlmsghdr *h, RawRoute &raw, DecodedRoute &route)
+{
+    if (!raw.parse(h))
+    {
+        return false;
+    }
+
+    raw.formatNextHops(getIfName);
+    route.prefix = raw.prefix;
+    route.nexthops = raw.nexthops;
+    route.ifnames = raw.ifnames;
+    route.weights = raw.weights;
+    return true;
+}
+
+static void addAttr(vector<char> &buf, size_t msg, unsigned short type, const void *data, size_t len)
+{
+    struct rtattr rta;
+    rta.rta_type = type;
+    rta.rta_len = (unsigned short)RTA_LENGTH(len);
+
+    buf.insert(buf.end(), (char *)&rta, (char *)&rta + sizeof(rta));
+    buf.insert(buf.end(), (const char *)data, (const char *)data + len);
+    buf.resize(msg + NLMSG_ALIGN(buf.size() - msg));
+}
+
+/* Stream of IPv4 route additions over ecmp next hops, weighted every other route */
+static void generateStream(const string &file, size_t routes, size_t ecmp)
+{
+    ofstream out(file, ios::binary);
+    vector<char> buf;
+
+    for (size_t i = 0; i < routes; i++)
+    {
+        buf.assign(FPM_MSG_HDR_LEN + NLMSG_HDRLEN, 0);
+
+        struct rtmsg rtm = {};
+        rtm.rtm_family = AF_INET;
+        rtm.rtm_dst_len = 24;
+        rtm.rtm_protocol = RTPROT_BGP;
+        rtm.rtm_type = RTN_UNICAST;
+        buf.insert(buf.end(), (char *)&rtm, (char *)&rtm + NLMSG_ALIGN(sizeof(rtm)));
+
+        size_t nl = FPM_MSG_HDR_LEN;
+        uint32_t dst = htonl((uint32_t)(0x0a000000 + (i << 8)));
+        addAttr(buf, nl, RTA_DST, &dst, sizeof(dst));
+
+        /* RTA_MULTIPATH of ecmp next hops with a gateway each */
+        size_t mp = buf.size();
+        addAttr(buf, nl, RTA_MULTIPATH, NULL, 0);
+        for (size_t n = 0; n < ecmp; n++)
+        {
+            size_t nh = buf.size();
+            struct rtnexthop rtnh = {};
+            rtnh.rtnh_ifindex = (int)(n + 1);
+            rtnh.rtnh_hops = (unsigned char)(i % 2 ? n % 3 + 1 : 0);
+            buf.insert(buf.end(), (char *)&rtnh, (char *)&rtnh + sizeof(rtnh));
+
+            uint32_t gw = htonl((uint32_t)(0x0a640000 + n + 1));
+            addAttr(buf, nl, RTA_GATEWAY, &gw, sizeof(gw));
+            reinterpret_cast<struct rtnexthop *>(&buf[nh])->rtnh_len = (unsigned short)(buf.size() - nh);
+        }
+        reinterpret_cast<struct rtattr *>(&buf[mp])->rta_len = (unsigned short)(buf.size() - mp);
+
+        struct nlmsghdr *h = reinterpret_cast<struct nlmsghdr *>(&buf[nl]);
+        h->nlmsg_type = RTM_NEWROUTE;
+        h->nlmsg_flags = NLM_F_CREATE | NLM_F_REPLACE | NLM_F_REQUEST;
+        h->nlmsg_len = (uint32_t)(buf.size() - nl);
+
+        fpm_msg_hdr_t *hdr = reinterpret_cast<fpm_msg_hdr_t *>(&buf[0]);
+        hdr->version = FPM_PROTO_VERSION;
+        hdr->msg_type = FPM_MSG_TYPE_NETLINK;
+        hdr->msg_len = htons((uint16_t)fpm_data_len_to_msg_len(h->nlmsg_len));
+
+        out.write(&buf[0], (streamsize)buf.size());
+    }
+}
+
+/* Receive loop of FpmLink before FpmBuffer, returns false when the connection is closed */
+class LegacyReceiver
+{
+public:
+    uint64_t messages = 0;
+    uint64_t wakeups = 0;
+    uint64_t reads = 0;
+
+    bool read(int fd)
+    {
+        wakeups++;
+
+        ssize_t len = ::read(fd, &m_buffer[m_pos], m_buffer.size() - m_pos);
+        if (len <= 0)
+        {
+            return false;
+        }
+        reads++;
+        m_pos += (size_t)len;
+
+        size_t start = 0;
+        while (m_pos - start >= FPM_MSG_HDR_LEN)
+        {
+            fpm_msg_hdr_t *hdr = reinterpret_cast<fpm_msg_hdr_t *>(static_cast<void *>(&m_buffer[start]));
+            size_t msg_len = fpm_msg_len(hdr);
+            if (m_pos - start < msg_len)
+            {
+                break;
+            }
+            if (!fpm_msg_ok(hdr, m_pos - start))
+            {
+                return false;
+            }
+            messages++;
+            start += msg_len;
+        }
+
+        memmove(&m_buffer[0], &m_buffer[start], m_pos - start);
+        m_pos -= start;
+        return true;
+    }
+
+private:
+    /* FPM_MAX_MSG_LEN * MSG_BATCH_SIZE of FpmLink */
+    vector<char> m_buffer = vector<char>(4096 * 256);
+    size_t m_pos = 0;
+};
+
+/* Writes the stream rounds times to a socketpair, and reads it back with receive(fd) */
+template <typename Receive>
+static chrono::duration<double> replayLink(const vector<char> &stream, size_t rounds, Receive receive)
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+    {
+        throw system_error(errno, system_category());
+    }
+
+    thread writer([&]() {
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (size_t pos = 0; pos < stream.size(); )
+            {
+                ssize_t len = write(fds[1], &stream[pos], min<size_t>(64 * 1024, stream.size() - pos));
+                if (len < 0)
+                {
+                    break;
+                }
+                pos += (size_t)len;
+            }
+        }
+        close(fds[1]);
+    });
+
+    /* Non-blocking like the FPM connection, which FpmBuffer drains */
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    auto begin = chrono::steady_clock::now();
+    struct pollfd pfd = { fds[0], POLLIN, 0 };
+    while (poll(&pfd, 1, -1) > 0 && receive(fds[0]))
+    {
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+
+    writer.join();
+    close(fds[0]);
+    return elapsed;
+}
+
+static int benchLink(const vector<char> &stream, size_t rounds)
+{
+    double megabytes = static_cast<double>(stream.size() * rounds) / (1024 * 1024);
+
+    LegacyReceiver legacy;
+    auto legacyElapsed = replayLink(stream, rounds, [&](int fd) {
+        return legacy.read(fd);
+    });
+
+    FpmBuffer buffer;
+    auto bufferElapsed = replayLink(stream, rounds, [&](int fd) {
+        return buffer.read(fd, [](fpm_msg_hdr_t *) {});
+    });
+
+    cout << "read:  " << legacy.messages << " messages, " << megabytes / legacyElapsed.count() << " MB/s, "
+         << static_cast<double>(legacy.messages) / legacyElapsed.count() << " messages/s, "
+         << static_cast<double>(legacy.reads) / static_cast<double>(legacy.wakeups) << " reads/wakeup" << endl
+         << "readv: " << buffer.messages << " messages, " << megabytes / bufferElapsed.count() << " MB/s, "
+         << static_cast<double>(buffer.messages) / bufferElapsed.count() << " messages/s, "
+         << static_cast<double>(buffer.reads) / static_cast<double>(buffer.wakeups) << " reads/wakeup, "
+         << buffer.size() << " bytes buffer" << endl;
+
+    return legacy.messages == buffer.messages ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv)
+{
+    size_t routes = 0;
+    size_t ecmp = 4;
+    size_t rounds = 5;
+    bool link = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "lg:e:r:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'l':
+                link = true;
+                break;
+            case 'g':
+                routes = strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                ecmp = strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                rounds = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-l] [-g <routes>] [-e <next hops>] [-r <rounds>] <file>" << endl;
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind + 1 != argc)
+    {
+        cerr << "Usage: " << argv[0] << " [-l] [-g <routes>] [-e <next hops>] [-r <rounds>] <file>" << endl;
+        return EXIT_FAILURE;
+    }
+
+    string file = argv[optind];
+    if (routes)
+    {
+        generateStream(file, routes, ecmp);
+    }
+
+    ifstream in(file, ios::binary);
+    vector<char> stream((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    if (link)
+    {
+        return benchLink(stream, rounds);
+    }
+
+    /* Route messages of the stream, copied to aligned buffers */
+    vector<vector<uint32_t>> messages;
+    size_t start = 0;
+    while (start < stream.size())
+    {
+        fpm_msg_hdr_t *hdr = reinterpret_cast<fpm_msg_hdr_t *>(&stream[start]);
+        if (!fpm_msg_ok(hdr, stream.size() - start))
+        {
+            cerr << "Malformed FPM message at offset " << start << endl;
+            return EXIT_FAILURE;
+        }
+
+        if (hdr->msg_type == FPM_MSG_TYPE_NETLINK)
+        {
+            struct nlmsghdr *h = static_cast<struct nlmsghdr *>(fpm_msg_data(hdr));
+            if (h->nlmsg_type == RTM_NEWROUTE || h->nlmsg_type == RTM_DELROUTE)
+            {
+                messages.emplace_back((fpm_msg_data_len(hdr) + 3) / 4);
+                memcpy(&messages.back()[0], h, fpm_msg_data_len(hdr));
+            }
+        }
+        start += fpm_msg_len(hdr);
+    }
+
+    /* Both decodings agree on the messages the raw path handles */
+    RawRoute raw;
+    size_t handled = 0;
+    size_t mismatches = 0;
+    for (auto &m : messages)
+    {
+        struct nlmsghdr *h = reinterpret_cast<struct nlmsghdr *>(&m[0]);
+        DecodedRoute libnlRoute, rawRoute;
+
+        if (!decodeRaw(h, raw, rawRoute))
+        {
+            continue;
+        }
+        handled++;
+
+        if (!decodeLibnl(h, libnlRoute) || libnlRoute.prefix != rawRoute.prefix ||
+            (raw.nlmsg_type == RTM_NEWROUTE && raw.rtm_type == RTN_UNICAST &&
+             (libnlRoute.nexthops != rawRoute.nexthops || libnlRoute.ifnames != rawRoute.ifnames ||
+              libnlRoute.weights != rawRoute.weights)))
+        {
+            cerr << "Mismatch: libnl " << libnlRoute.prefix << " " << libnlRoute.nexthops << " "
+                 << libnlRoute.ifnames << " " << libnlRoute.weights << ", raw " << rawRoute.prefix << " "
+                 << rawRoute.nexthops << " " << rawRoute.ifnames << " " << rawRoute.weights << endl;
+            mismatches++;
+        }
+    }
+
+    auto rate = [&](chrono::duration<double> elapsed) {
+        return static_cast<uint64_t>(static_cast<double>(messages.size() * rounds) / elapsed.count());
+    };
+
+    DecodedRoute route;
+    auto begin = chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; r++)
+    {
+        for (auto &m : messages)
+        {
+            decodeLibnl(reinterpret_cast<struct nlmsghdr *>(&m[0]), route);
+        }
+    }
+    chrono::duration<double> libnlElapsed = chrono::steady_clock::now() - begin;
+
+    begin = chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; r++)
+    {
+        for (auto &m : messages)
+        {
+            struct nlmsghdr *h = reinterpret_cast<struct nlmsghdr *>(&m[0]);
+            if (raw.parse(h))
+            {
+                raw.formatNextHops(getIfName);
+            }
+            else
+            {
+                decodeLibnl(h, route);
+            }
+        }
+    }
+    chrono::duration<double> rawElapsed = chrono::steady_clock::now() - begin;
+
+    cout << messages.size() << " route messages, " << handled << " on the raw path, "
+         << mismatches << " mismatches" << endl
+         << "libnl: " << rate(libnlElapsed) << " messages/s" << endl
+         << "raw:   " << rate(rawElapsed) << " messages/s" << endl;
+
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,40 @@
+#include "fpmsyncd/fpmbuffer.h"
+
+using namespace std;
+using namespace swss;
+
+FpmBuffer::FpmBuffer(size_t size, size_t maxSize) :
+    bytes(0),
+    messages(0),
+    wakeups(0),
+    reads(0),
+    m_scratch(new char[MAX_MSG_LEN]),
+    m_size(2 * MAX_MSG_LEN),
+    m_head(0),
+    m_tail(0)
+{
+    /* Positions are wrapped with a mask, and the ring always has room for a message */
+    while (m_size < size)
+    {
+        m_size <<= 1;
+    }
+    m_maxSize = max(m_size, maxSize);
+    m_buffer.reset(new char[m_size]);
+}
+
+void FpmBuffer::grow()
+{
+    size_t size = m_size << 1;
+    size_t used = (size_t)(m_tail - m_head);
+    size_t head = m_head & (m_size - 1);
+    size_t first = min(used, m_size - head);
+
+    unique_ptr<char[]> buffer(new char[size]);
+    memcpy(buffer.get(), m_buffer.get() + head, first);
+    memcpy(buffer.get() + first, m_buffer.get(), used - first);
+
+    m_buffer = move(buffer);
+    m_size = size;
+    m_head = 0;
+    m_tail = used;
+}
@@ -0,0 +1,165 @@
+#ifndef __FPMBUFFER__
+#define __FPMBUFFER__
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <memory>
+#include <system_error>
+
+#include "fpm/fpm.h"
+
+namespace swss {
+
+/*
+ * Receive buffer of an FPM connection.
+ *
+ * The bytes read from the connection are kept in a ring: readv() fills both
+ * free segments at once, and the messages are processed where they were read,
+ * so nothing is moved back to the front of the buffer after a read. Only a
+ * message wrapping around the end of the ring is copied, to a scratch buffer.
+ * The ring doubles, up to its maximum size, each time a read fills it up.
+ */
+class FpmBuffer
+{
+public:
+    enum
+    {
+        INITIAL_SIZE = 256 * 1024,
+        MAX_SIZE = 16 * 1024 * 1024,
+        /* Largest message msg_len can describe, rounded up to the alignment */
+        MAX_MSG_LEN = 64 * 1024,
+    };
+
+    FpmBuffer(size_t size = INITIAL_SIZE, size_t maxSize = MAX_SIZE);
+
+    /*
+     * Reads fd until it has no more data, calling onMessage(hdr) on each
+     * complete message. Returns false when the connection is closed, and
+     * throws system_error on read errors and malformed messages.
+     */
+    template <typename OnMessage>
+    bool read(int fd, OnMessage onMessage);
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /* Drops the data read and not processed yet, on a new connection */
+    void clear()
+    {
+        m_head = m_tail = 0;
+    }
+
+    /* Counters since the buffer was created */
+    uint64_t    bytes;          /* bytes read */
+    uint64_t    messages;       /* complete messages */
+    uint64_t    wakeups;        /* calls to read() */
+    uint64_t    reads;          /* readv() calls returning data */
+
+private:
+    std::unique_ptr<char[]>     m_buffer;
+    std::unique_ptr<char[]>     m_scratch;
+    size_t                      m_size;
+    size_t                      m_maxSize;
+    /* positions of the first unprocessed byte and of the end of the data, not wrapped */
+    uint64_t                    m_head;
+    uint64_t                    m_tail;
+
+    void grow();
+
+    template <typename OnMessage>
+    void processMessages(OnMessage &onMessage);
+};
+
+template <typename OnMessage>
+bool FpmBuffer::read(int fd, OnMessage onMessage)
+{
+    wakeups++;
+
+    while (true)
+    {
+        size_t tail = m_tail & (m_size - 1);
+        size_t space = m_size - (size_t)(m_tail - m_head);
+        size_t first = std::min(space, m_size - tail);
+
+        struct iovec iov[2] = {
+            { m_buffer.get() + tail, first },
+            { m_buffer.get(), space - first },
+        };
+
+        ssize_t len = ::readv(fd, iov, space > first ? 2 : 1);
+        if (len == 0)
+        {
+            return false;
+        }
+        if (len < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return true;
+            }
+            throw std::system_error(errno, std::system_category());
+        }
+
+        reads++;
+        bytes += (uint64_t)len;
+        m_tail += (uint64_t)len;
+
+        processMessages(onMessage);
+
+        /* A short read emptied the socket, save the readv() returning EAGAIN */
+        if ((size_t)len < space)
+        {
+            return true;
+        }
+
+        if (m_size < m_maxSize)
+        {
+            grow();
+        }
+    }
+}
+
+template <typename OnMessage>
+void FpmBuffer::processMessages(OnMessage &onMessage)
+{
+    /* Messages are aligned, and so is the size of the ring: headers do not wrap */
+    while (m_tail - m_head >= FPM_MSG_HDR_LEN)
+    {
+        size_t head = m_head & (m_size - 1);
+        fpm_msg_hdr_t *hdr = reinterpret_cast<fpm_msg_hdr_t *>(static_cast<void *>(m_buffer.get() + head));
+
+        if (!fpm_msg_hdr_ok(hdr))
+            throw std::system_error(make_error_code(std::errc::bad_message), "Malformed FPM message received");
+
+        /* fpm_msg_len includes header size */
+        size_t msg_len = fpm_msg_len(hdr);
+        if (m_tail - m_head < msg_len)
+            break;
+
+        if (msg_len > m_size - head)
+        {
+            size_t first = m_size - head;
+            memcpy(m_scratch.get(), hdr, first);
+            memcpy(m_scratch.get() + first, m_buffer.get(), msg_len - first);
+            hdr = reinterpret_cast<fpm_msg_hdr_t *>(static_cast<void *>(m_scratch.get()));
+        }
+
+        messages++;
+        m_head += msg_len;
+        onMessage(hdr);
+    }
+}
+
+}
+
+#endif
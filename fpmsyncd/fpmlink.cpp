@@ -1,39 +1,16 @@
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <system_error>
 #include "logger.h"
 #include "netmsg.h"
-#include "netdispatcher.h"
+#include <netlink/msg.h>
+#include <netlink/object.h>
 #include "fpmsyncd/fpmlink.h"
 
 using namespace swss;
 using namespace std;
 
-void netlink_parse_rtattr(struct rtattr **tb, int max, struct rtattr *rta,
-        int len)
-{
-    while (RTA_OK(rta, len)) 
-    {
-        if (rta->rta_type <= max)
-        {
-            tb[rta->rta_type] = rta;
-        }
-        else
-        {
-            /* FRR 7.5 is sending RTA_ENCAP with NLA_F_NESTED bit set*/
-            if (rta->rta_type & NLA_F_NESTED)
-            {
-                int rta_type = rta->rta_type & ~NLA_F_NESTED;
-                if (rta_type <= max)
-                {
-                   tb[rta_type] = rta;
-                }
-            }
-        }
-        rta = RTA_NEXT(rta, len);
-    }
-}
-
 bool FpmLink::isRawProcessing(struct nlmsghdr *h)
 {
     int len;
@@ -111,14 +88,84 @@ bool FpmLink::isRawProcessing(struct nlmsghdr *h)
     return false;
 }
 
+static void onRouteObject(struct nl_object *obj, void *arg)
+{
+    RouteSync *rsync = static_cast<RouteSync *>(arg);
+    int nlmsg_type = nl_object_get_msgtype(obj);
+
+    if (nlmsg_type == RTM_NEWROUTE || nlmsg_type == RTM_DELROUTE)
+    {
+        rsync->onMsg(nlmsg_type, obj);
+    }
+}
+
+void FpmLink::processMsg(RouteSync *rsync, struct nlmsghdr *h)
+{
+    if (!rsync->deferMsg(h))
+    {
+        dispatchMsg(rsync, h);
+    }
+}
+
+void FpmLink::processDeferredMsgs(RouteSync *rsync)
+{
+    if (!rsync->hasDeferredMsgs())
+    {
+        return;
+    }
+
+    vector<char> msgs;
+    rsync->resolveIfNames();
+    rsync->takeDeferredMsgs(msgs);
+
+    for (size_t pos = 0; pos < msgs.size(); )
+    {
+        struct nlmsghdr *h = reinterpret_cast<struct nlmsghdr *>(&msgs[pos]);
+        dispatchMsg(rsync, h);
+        pos += NLMSG_ALIGN(h->nlmsg_len);
+    }
+}
+
+void FpmLink::dispatchMsg(RouteSync *rsync, struct nlmsghdr *h)
+{
+    /*
+     * EVPN Type5 Add Routes need to be process in Raw mode as they contain
+     * RMAC, VLAN and L3VNI information.
+     * Where as all other route will be using rtnl api to extract information
+     * from the netlink msg.
+     */
+    if (isRawProcessing(h))
+    {
+        /* EVPN Type5 Add route processing */
+        rsync->onMsgRaw(h);
+    }
+    /* Regular routes are decoded from the rtattrs, unless libnl is needed */
+    else if (!rsync->onRouteMsgRaw(h))
+    {
+        nl_msg *msg = nlmsg_convert(h);
+        if (msg == NULL)
+        {
+            throw system_error(make_error_code(errc::bad_message), "Unable to convert nlmsg");
+        }
+
+        /* Dispatched to rsync rather than NetDispatcher, as workers have their own */
+        nlmsg_set_proto(msg, NETLINK_ROUTE);
+        nl_msg_parse(msg, onRouteObject, rsync);
+        nlmsg_free(msg);
+    }
+}
+
 FpmLink::FpmLink(RouteSync *rsync, unsigned short port) :
-    MSG_BATCH_SIZE(256),
-    m_bufSize(FPM_MAX_MSG_LEN * MSG_BATCH_SIZE),
-    m_messageBuffer(NULL),
-    m_pos(0),
     m_connected(false),
+    m_closed(false),
     m_server_up(false),
-    m_routesync(rsync)
+    m_routesync(rsync),
+    m_shards(NULL),
+    m_port(port),
+    m_connection_socket(-1),
+    m_listener(this),
+    m_stateDb("STATE_DB", 0),
+    m_statsTable(&m_stateDb, STATE_FPMSYNCD_STATS_TABLE_NAME)
 {
     struct sockaddr_in addr;
     int true_val = 1;
@@ -152,6 +199,14 @@ FpmLink::FpmLink(RouteSync *rsync, unsigned short port) :
         throw system_error(errno, system_category());
     }
 
+    /* The client may be gone by the time the connection is accepted */
+    int flags = fcntl(m_server_socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(m_server_socket, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        close(m_server_socket);
+        throw system_error(errno, system_category());
+    }
+
     if (listen(m_server_socket, 2) != 0)
     {
         close(m_server_socket);
@@ -159,19 +214,17 @@ FpmLink::FpmLink(RouteSync *rsync, unsigned short port) :
     }
 
     m_server_up = true;
-    m_messageBuffer = new char[m_bufSize];
 }
 
 FpmLink::~FpmLink()
 {
-    delete[] m_messageBuffer;
     if (m_connected)
         close(m_connection_socket);
     if (m_server_up)
         close(m_server_socket);
 }
 
-void FpmLink::accept()
+bool FpmLink::accept()
 {
     struct sockaddr_in client_addr;
 
@@ -182,9 +235,34 @@ void FpmLink::accept()
     m_connection_socket = ::accept(m_server_socket, (struct sockaddr *)&client_addr,
                                    &client_len);
     if (m_connection_socket < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED || errno == EINTR)
+            return false;
+        throw system_error(errno, system_category());
+    }
+    m_connected = true;
+    m_closed = false;
+    m_buffer.clear();
+
+    /* readData() reads until the socket has no more data */
+    int flags = fcntl(m_connection_socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(m_connection_socket, F_SETFL, flags | O_NONBLOCK) < 0)
         throw system_error(errno, system_category());
 
     SWSS_LOG_INFO("New connection accepted from: %s\n", inet_ntoa(client_addr.sin_addr));
+    return true;
+}
+
+void FpmLink::disconnect()
+{
+    if (m_connected)
+    {
+        close(m_connection_socket);
+        m_connection_socket = -1;
+        m_connected = false;
+    }
+    m_closed = false;
+    m_buffer.clear();
 }
 
 int FpmLink::getFd()
@@ -192,72 +270,62 @@ int FpmLink::getFd()
     return m_connection_socket;
 }
 
-uint64_t FpmLink::readData()
+void FpmLink::processFpmMsg(fpm_msg_hdr_t *hdr)
 {
-    fpm_msg_hdr_t *hdr;
-    size_t msg_len;
-    size_t start = 0, left;
-    ssize_t read;
-
-    read = ::read(m_connection_socket, m_messageBuffer + m_pos, m_bufSize - m_pos);
-    if (read == 0)
-        throw FpmConnectionClosedException();
-    if (read < 0)
-        throw system_error(errno, system_category());
-    m_pos+= (uint32_t)read;
-
-    /* Check for complete messages */
-    while (true)
+    if (hdr->msg_type == FPM_MSG_TYPE_NETLINK)
     {
-        hdr = reinterpret_cast<fpm_msg_hdr_t *>(static_cast<void *>(m_messageBuffer + start));
-        left = m_pos - start;
-        if (left < FPM_MSG_HDR_LEN)
-            break;
-        /* fpm_msg_len includes header size */
-        msg_len = fpm_msg_len(hdr);
-        if (left < msg_len)
-            break;
-
-        if (!fpm_msg_ok(hdr, left))
-            throw system_error(make_error_code(errc::bad_message), "Malformed FPM message received");
-
-        if (hdr->msg_type == FPM_MSG_TYPE_NETLINK)
-        {
-            bool isRaw = false;
+        nlmsghdr *nl_hdr = (nlmsghdr *)fpm_msg_data(hdr);
 
-            nlmsghdr *nl_hdr = (nlmsghdr *)fpm_msg_data(hdr);
-
-            /*
-             * EVPN Type5 Add Routes need to be process in Raw mode as they contain 
-             * RMAC, VLAN and L3VNI information.
-             * Where as all other route will be using rtnl api to extract information 
-             * from the netlink msg.
-           * */
-            isRaw = isRawProcessing(nl_hdr);
+        if (m_shards)
+        {
+            m_shards->push(nl_hdr, fpm_msg_data_len(hdr));
+        }
+        else
+        {
+            processMsg(m_routesync, nl_hdr);
+        }
+    }
+}
 
-            nl_msg *msg = nlmsg_convert(nl_hdr);
-            if (msg == NULL)
-            {
-                throw system_error(make_error_code(errc::bad_message), "Unable to convert nlmsg");
-            }
+uint64_t FpmLink::readData()
+{
+    bool connected = m_buffer.read(m_connection_socket, [this](fpm_msg_hdr_t *hdr) {
+        processFpmMsg(hdr);
+    });
 
-            nlmsg_set_proto(msg, NETLINK_ROUTE);
+    if (m_shards)
+    {
+        m_shards->submit();
+    }
+    else
+    {
+        processDeferredMsgs(m_routesync);
+    }
 
-            if (isRaw)
-            {
-                /* EVPN Type5 Add route processing */
-                processRawMsg(nl_hdr);
-            }
-            else
-            {
-                NetDispatcher::getInstance().onNetlinkMessage(msg);
-            }
-            nlmsg_free(msg);
-        }
-        start += msg_len;
+    if (!connected)
+    {
+        m_closed = true;
+        return 0;
     }
 
-    memmove(m_messageBuffer, m_messageBuffer + start, m_pos - start);
-    m_pos = m_pos - (uint32_t)start;
+    publishStats();
     return 0;
 }
+
+void FpmLink::publishStats()
+{
+    auto now = chrono::steady_clock::now();
+    if (now - m_statsPublished < chrono::seconds(1))
+    {
+        return;
+    }
+    m_statsPublished = now;
+
+    vector<FieldValueTuple> fvVector;
+    fvVector.emplace_back("bytes", to_string(m_buffer.bytes));
+    fvVector.emplace_back("messages", to_string(m_buffer.messages));
+    fvVector.emplace_back("wakeups", to_string(m_buffer.wakeups));
+    fvVector.emplace_back("reads", to_string(m_buffer.reads));
+    fvVector.emplace_back("buffer_size", to_string(m_buffer.size()));
+    m_statsTable.set(string(FPMSYNCD_LINK_STATS_KEY) + "|" + to_string(m_port), fvVector);
+}
@@ -12,43 +12,122 @@
 #include <exception>
 
 #include "selectable.h"
+#include "dbconnector.h"
+#include "table.h"
 #include "fpm/fpm.h"
+#include "fpmsyncd/fpmbuffer.h"
 #include "fpmsyncd/routesync.h"
+#include "fpmsyncd/fpmshards.h"
 
 namespace swss {
 
+/*
+ * One FPM client at a time connects to the port of a link. The listening
+ * socket is a Selectable of its own, selected while the link has no client;
+ * the link is selected while its client is connected, and reports when the
+ * client closed the connection instead of throwing, so that the other links
+ * carry on.
+ */
 class FpmLink : public Selectable {
 public:
-    const int MSG_BATCH_SIZE;
     FpmLink(RouteSync *rsync, unsigned short port = FPM_DEFAULT_PORT);
     virtual ~FpmLink();
 
-    /* Wait for connection (blocking) */
-    void accept();
+    /* Readable when a client connects to the port */
+    class Listener : public Selectable {
+    public:
+        Listener(FpmLink *link) :
+            m_link(link)
+        {
+        }
+
+        int getFd() override
+        {
+            return m_link->m_server_socket;
+        }
+
+        uint64_t readData() override
+        {
+            return 0;
+        }
+
+        FpmLink *getLink()
+        {
+            return m_link;
+        }
+
+    private:
+        FpmLink *m_link;
+    };
+
+    Selectable *getListener()
+    {
+        return &m_listener;
+    }
+
+    unsigned short getPort() const
+    {
+        return m_port;
+    }
+
+    /* Accept the pending connection, false if the client went away meanwhile */
+    bool accept();
+
+    /* Close the connection, dropping the partial message read from it */
+    void disconnect();
+
+    bool isConnected() const
+    {
+        return m_connected;
+    }
+
+    /* The client closed the connection, the link is to be disconnected */
+    bool isClosed() const
+    {
+        return m_closed;
+    }
 
     int getFd() override;
     uint64_t readData() override;
-    /* readMe throws FpmConnectionClosedException when connection is lost */
-    class FpmConnectionClosedException : public std::exception
-    {
-    };
 
-    bool isRawProcessing(struct nlmsghdr *h);
-    void processRawMsg(struct nlmsghdr *h)
+    /*
+     * Hand the messages to a pool of workers instead of processing them in
+     * readData(), NULL to process them again in readData().
+     */
+    void setShards(FpmShards *shards)
     {
-        m_routesync->onMsgRaw(h);
-    };
+        m_shards = shards;
+    }
+
+    static bool isRawProcessing(struct nlmsghdr *h);
+
+    /* Decode a netlink message and hand it to rsync, unless rsync defers it */
+    static void processMsg(RouteSync *rsync, struct nlmsghdr *h);
+
+    /* Resolve the interfaces of the messages rsync deferred, and process them */
+    static void processDeferredMsgs(RouteSync *rsync);
 
 private:
     RouteSync *m_routesync;
-    unsigned int m_bufSize;
-    char *m_messageBuffer;
-    unsigned int m_pos;
+    FpmShards *m_shards;
+    FpmBuffer m_buffer;
+    unsigned short m_port;
 
     bool m_connected;
+    bool m_closed;
     bool m_server_up;
     int m_server_socket;
     int m_connection_socket;
+    Listener m_listener;
+
+    /* receive counters, published to STATE_DB at most once a second */
+    DBConnector m_stateDb;
+    Table m_statsTable;
+    std::chrono::steady_clock::time_point m_statsPublished;
+
+    void processFpmMsg(fpm_msg_hdr_t *hdr);
+    static void dispatchMsg(RouteSync *rsync, struct nlmsghdr *h);
+    void publishStats();
 };
 
 }
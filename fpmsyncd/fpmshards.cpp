@@ -0,0 +1,253 @@
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <system_error>
+#include "logger.h"
+#include "dbconnector.h"
+#include "fpmsyncd/fpmlink.h"
+#include "fpmsyncd/fpmshards.h"
+#include "fpmsyncd/routesync.h"
+
+using namespace std;
+using namespace swss;
+
+FpmShards::Shard::Shard() :
+    event_fd(-1),
+    work(BATCHES_PER_SHARD),
+    free(BATCHES_PER_SHARD),
+    current(NULL),
+    flushRequested(0),
+    flushed(0)
+{
+    event_fd = eventfd(0, 0);
+    if (event_fd < 0)
+        throw system_error(errno, system_category());
+
+    for (int i = 0; i < BATCHES_PER_SHARD; i++)
+    {
+        batches.emplace_back(new Batch{ unique_ptr<char[]>(new char[BATCH_SIZE]), 0, false });
+        free.push(batches.back().get());
+    }
+}
+
+FpmShards::Shard::~Shard()
+{
+    close(event_fd);
+}
+
+FpmShards::FpmShards(size_t workers, size_t flushKeys, uint32_t flushUsec) :
+    m_running(true),
+    m_flushKeys(flushKeys),
+    m_flushUsec(flushUsec)
+{
+    for (size_t i = 0; i < workers; i++)
+    {
+        m_shards.emplace_back(new Shard());
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        m_shards[i]->worker = thread(&FpmShards::run, this, i);
+    }
+
+    SWSS_LOG_NOTICE("Started %zu FPM route workers", workers);
+}
+
+FpmShards::~FpmShards()
+{
+    drain();
+    m_running = false;
+
+    for (auto &shard : m_shards)
+    {
+        uint64_t one = 1;
+        if (write(shard->event_fd, &one, sizeof(one)) < 0)
+        {
+            SWSS_LOG_ERROR("Failed to wake up FPM route worker: %s", strerror(errno));
+        }
+        shard->worker.join();
+    }
+}
+
+size_t FpmShards::getShard(const struct nlmsghdr *h) const
+{
+    uint32_t table = 0;
+
+    if ((h->nlmsg_type == RTM_NEWROUTE || h->nlmsg_type == RTM_DELROUTE) &&
+        h->nlmsg_len >= NLMSG_LENGTH(sizeof(struct rtmsg)))
+    {
+        struct rtmsg *rtm = (struct rtmsg *)NLMSG_DATA(h);
+        struct rtattr *tb[RTA_MAX + 1];
+
+        memset(tb, 0, sizeof(tb));
+        netlink_parse_rtattr(tb, RTA_MAX, RTM_RTA(rtm), (int)(h->nlmsg_len - NLMSG_LENGTH(sizeof(struct rtmsg))));
+
+        table = rtm->rtm_table;
+        if (tb[RTA_TABLE] && RTA_PAYLOAD(tb[RTA_TABLE]) >= sizeof(uint32_t))
+        {
+            table = *(uint32_t *)RTA_DATA(tb[RTA_TABLE]);
+        }
+    }
+
+    return table % m_shards.size();
+}
+
+FpmShards::Batch *FpmShards::getBatch(Shard &shard)
+{
+    if (!shard.current)
+    {
+        /* All the batches of the shard are queued, wait for the worker */
+        while (!shard.free.pop(shard.current))
+        {
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+
+        shard.current->len = 0;
+        shard.current->flush = false;
+    }
+
+    return shard.current;
+}
+
+void FpmShards::post(Shard &shard, Batch *batch)
+{
+    uint64_t one = 1;
+
+    /* The queue holds all the batches of the shard, it cannot be full */
+    shard.work.push(batch);
+    shard.current = NULL;
+
+    if (write(shard.event_fd, &one, sizeof(one)) < 0)
+        throw system_error(errno, system_category());
+}
+
+void FpmShards::push(const struct nlmsghdr *h, size_t data_len)
+{
+    if (h->nlmsg_len < NLMSG_HDRLEN || h->nlmsg_len > data_len)
+    {
+        SWSS_LOG_ERROR("Dropping netlink message of length %u in an FPM message of length %zu",
+                       h->nlmsg_len, data_len);
+        return;
+    }
+
+    Shard &shard = *m_shards[getShard(h)];
+    size_t len = NLMSG_ALIGN(h->nlmsg_len);
+
+    Batch *batch = getBatch(shard);
+    if (batch->len + len > BATCH_SIZE)
+    {
+        post(shard, batch);
+        batch = getBatch(shard);
+    }
+
+    memcpy(batch->data.get() + batch->len, h, h->nlmsg_len);
+    batch->len += len;
+}
+
+void FpmShards::submit()
+{
+    for (auto &shard : m_shards)
+    {
+        if (shard->current && shard->current->len)
+        {
+            post(*shard, shard->current);
+        }
+    }
+}
+
+void FpmShards::drain()
+{
+    for (auto &shard : m_shards)
+    {
+        Batch *batch = getBatch(*shard);
+        batch->flush = true;
+        shard->flushRequested++;
+        post(*shard, batch);
+    }
+
+    for (auto &shard : m_shards)
+    {
+        while (shard->flushed.load(memory_order_acquire) < shard->flushRequested)
+        {
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
+}
+
+void FpmShards::run(size_t index)
+{
+    Shard &shard = *m_shards[index];
+
+    DBConnector db("APPL_DB", 0);
+    RedisPipeline pipeline(&db);
+    RouteSync sync(&pipeline, m_flushKeys, m_flushUsec,
+                   string(FPMSYNCD_ROUTE_STATS_KEY) + "|" + to_string(index));
+
+    auto processDeferredMsgs = [&]() {
+        try
+        {
+            FpmLink::processDeferredMsgs(&sync);
+        }
+        catch (const exception &e)
+        {
+            SWSS_LOG_ERROR("FPM route worker %zu failed to process message: %s", index, e.what());
+        }
+    };
+
+    while (m_running)
+    {
+        Batch *batch;
+
+        while (shard.work.pop(batch))
+        {
+            for (size_t pos = 0; pos < batch->len; )
+            {
+                struct nlmsghdr *h = reinterpret_cast<struct nlmsghdr *>(batch->data.get() + pos);
+                try
+                {
+                    FpmLink::processMsg(&sync, h);
+                }
+                catch (const exception &e)
+                {
+                    SWSS_LOG_ERROR("FPM route worker %zu failed to process message: %s", index, e.what());
+                }
+                pos += NLMSG_ALIGN(h->nlmsg_len);
+            }
+
+            bool flush = batch->flush;
+            shard.free.push(batch);
+
+            if (flush)
+            {
+                processDeferredMsgs();
+                sync.flushRoutes();
+                pipeline.flush();
+                shard.flushed.fetch_add(1, memory_order_release);
+            }
+        }
+
+        processDeferredMsgs();
+
+        if (sync.isRouteFlushDue())
+        {
+            sync.flushRoutes();
+        }
+        pipeline.flush();
+
+        /* Sleep until more messages are queued, or the pending route updates are due */
+        struct pollfd pfd = { shard.event_fd, POLLIN, 0 };
+        struct timespec timeout = { m_flushUsec / 1000000, (long)(m_flushUsec % 1000000) * 1000 };
+        if (ppoll(&pfd, 1, sync.hasPendingRoutes() ? &timeout : NULL, NULL) > 0)
+        {
+            uint64_t events;
+            if (read(shard.event_fd, &events, sizeof(events)) < 0)
+            {
+                SWSS_LOG_ERROR("Failed to read FPM route worker event: %s", strerror(errno));
+            }
+        }
+    }
+
+    sync.flushRoutes();
+    pipeline.flush();
+}
@@ -0,0 +1,92 @@
+#ifndef __FPMSHARDS__
+#define __FPMSHARDS__
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fpmsyncd/spscqueue.h"
+
+namespace swss {
+
+/*
+ * Pool of workers decoding the FPM route messages and writing them to APPL_DB.
+ *
+ * Messages are sharded by route table, i.e. by VRF: all the messages of a
+ * prefix go to the same worker, in the order they were pushed. Each worker owns
+ * a RouteSync with its own APPL_DB connection, as RouteSync, libnl caches and
+ * pipelines are not thread-safe.
+ *
+ * The messages are copied into batches handed to the workers through SPSC
+ * queues, and the emptied batches come back through a second queue. push()
+ * waits for a worker when all the batches of its shard are in use.
+ */
+class FpmShards
+{
+public:
+    FpmShards(size_t workers, size_t flushKeys, uint32_t flushUsec);
+    ~FpmShards();
+
+    size_t size() const
+    {
+        return m_shards.size();
+    }
+
+    /* Copy a netlink message, in data_len bytes of FPM data, to the batch of its shard */
+    void push(const struct nlmsghdr *h, size_t data_len);
+
+    /* Hand the batches pushed so far to the workers */
+    void submit();
+
+    /*
+     * Wait until the workers have processed all the messages and written their
+     * route updates to APPL_DB, before the messages are processed elsewhere.
+     */
+    void drain();
+
+    /* Shard of the messages of a route table */
+    size_t getShard(const struct nlmsghdr *h) const;
+
+private:
+    enum { BATCH_SIZE = 64 * 1024, BATCHES_PER_SHARD = 16 };
+
+    struct Batch
+    {
+        std::unique_ptr<char[]> data;
+        size_t                  len;
+        bool                    flush;      /* write the route updates once processed */
+    };
+
+    struct Shard
+    {
+        Shard();
+        ~Shard();
+
+        std::thread             worker;
+        int                     event_fd;
+        SpscQueue<Batch *>      work;
+        SpscQueue<Batch *>      free;
+        std::vector<std::unique_ptr<Batch>> batches;
+        Batch                  *current;
+        uint64_t                flushRequested;
+        std::atomic<uint64_t>   flushed;
+    };
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::atomic<bool>   m_running;
+    size_t              m_flushKeys;
+    uint32_t            m_flushUsec;
+
+    Batch *getBatch(Shard &shard);
+    void post(Shard &shard, Batch *batch);
+    void run(size_t index);
+};
+
+}
+
+#endif
@@ -1,12 +1,16 @@
+#include <getopt.h>
 #include <iostream>
 #include <inttypes.h>
 #include "logger.h"
 #include "select.h"
 #include "selectabletimer.h"
 #include "netdispatcher.h"
+#include "netlink.h"
 #include "warmRestartHelper.h"
 #include "fpmsyncd/fpmlink.h"
 #include "fpmsyncd/routesync.h"
+#include "fpmsyncd/fpmshards.h"
+#include "fpmsyncd/ifnamecache.h"
 
 
 using namespace std;
@@ -44,160 +48,309 @@ static bool eoiuFlagsSet(Table &bgpStateTable)
     return true;
 }
 
+void usage()
+{
+    cout << "Usage: fpmsyncd [-p <port>[,<port>...]] [-w <workers>] [-b <routes>] [-t <usec>]" << endl;
+    cout << "       -p: FPM ports, one FPM client connecting to each (default " << FPM_DEFAULT_PORT << ")" << endl;
+    cout << "       -w: route workers, the routes of a VRF being handled by the same worker (default 0:" << endl;
+    cout << "           the routes are handled by the main thread)" << endl;
+    cout << "       -b: flush the route updates to APPL_DB past this many prefixes (default "
+         << RouteSync::DEFAULT_ROUTE_FLUSH_KEYS << ")" << endl;
+    cout << "       -t: flush the route updates to APPL_DB this many microseconds after the first one (default "
+         << RouteSync::DEFAULT_ROUTE_FLUSH_USEC << ")" << endl;
+}
+
 int main(int argc, char **argv)
 {
     swss::Logger::linkToDbNative("fpmsyncd");
+    size_t flushKeys = RouteSync::DEFAULT_ROUTE_FLUSH_KEYS;
+    uint32_t flushUsec = RouteSync::DEFAULT_ROUTE_FLUSH_USEC;
+    vector<unsigned short> ports;
+    size_t workers = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:w:b:t:h")) != -1 )
+    {
+        switch (opt)
+        {
+        case 'p':
+        {
+            stringstream ss(optarg);
+            string port;
+            while (getline(ss, port, ','))
+            {
+                ports.push_back((unsigned short)strtoul(port.c_str(), NULL, 0));
+            }
+            break;
+        }
+        case 'w':
+            workers = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            flushKeys = max<size_t>(1, strtoul(optarg, NULL, 0));
+            break;
+        case 't':
+            flushUsec = max<uint32_t>(1, (uint32_t)strtoul(optarg, NULL, 0));
+            break;
+        case 'h':
+            usage();
+            return 1;
+        default: /* '?' */
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
     DBConnector db("APPL_DB", 0);
     RedisPipeline pipeline(&db);
-    RouteSync sync(&pipeline);
+    RouteSync sync(&pipeline, flushKeys, flushUsec);
 
     DBConnector stateDb("STATE_DB", 0);
     Table bgpStateTable(&stateDb, STATE_BGP_TABLE_NAME);
 
-    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWROUTE, &sync);
-    NetDispatcher::getInstance().registerMessageHandler(RTM_DELROUTE, &sync);
+    /* Interface names of the routes, kept up to date from the link messages */
+    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &IfNameCache::getInstance());
+    NetDispatcher::getInstance().registerMessageHandler(RTM_DELLINK, &IfNameCache::getInstance());
+
+    if (ports.empty())
+    {
+        ports.push_back(FPM_DEFAULT_PORT);
+    }
+
+    /*
+     * Route workers are only used out of warm-restart, whose reconciliation
+     * needs all the routes in the RouteSync of the main thread.
+     */
+    unique_ptr<FpmShards> shards;
+    if (workers)
+    {
+        shards.reset(new FpmShards(workers, flushKeys, flushUsec));
+    }
 
-    while (true)
+    try
     {
-        try
+        vector<unique_ptr<FpmLink>> links;
+        for (auto port : ports)
         {
-            FpmLink fpm(&sync);
-            Select s;
-            SelectableTimer warmStartTimer(timespec{0, 0});
-            // Before eoiu flags detected, check them periodically. It also stop upon detection of reconciliation done.
-            SelectableTimer eoiuCheckTimer(timespec{0, 0});
-            // After eoiu flags are detected, start a hold timer before starting reconciliation.
-            SelectableTimer eoiuHoldTimer(timespec{0, 0});
-           
-            /*
-             * Pipeline should be flushed right away to deal with state pending
-             * from previous try/catch iterations.
-             */
-            pipeline.flush();
+            links.emplace_back(new FpmLink(&sync, port));
+        }
+        auto setShards = [&](FpmShards *pool) {
+            for (auto &fpm : links)
+            {
+                fpm->setShards(pool);
+            }
+        };
+        NetLink netlink;
+        Select s;
+        SelectableTimer warmStartTimer(timespec{0, 0});
+        // Before eoiu flags detected, check them periodically. It also stop upon detection of reconciliation done.
+        SelectableTimer eoiuCheckTimer(timespec{0, 0});
+        // After eoiu flags are detected, start a hold timer before starting reconciliation.
+        SelectableTimer eoiuHoldTimer(timespec{0, 0});
+        // Flushes the route updates held by RouteSync once the FPM messages slow down.
+        SelectableTimer routeFlushTimer(timespec{sync.getRouteFlushUsec() / 1000000,
+                                                 (long)(sync.getRouteFlushUsec() % 1000000) * 1000});
+        bool routeFlushTimerStarted = false;
+        bool warmStartChecked = false;
+        bool warmStartEnabled = false;
 
-            cout << "Waiting for fpm-client connection..." << endl;
-            fpm.accept();
-            cout << "Connected!" << endl;
+        netlink.registerGroup(RTNLGRP_LINK);
+        netlink.dumpRequest(RTM_GETLINK);
+        s.addSelectable(&netlink);
 
-            s.addSelectable(&fpm);
+        /* Clients are accepted as they connect, each link on its own */
+        for (auto &fpm : links)
+        {
+            cout << "Waiting for fpm-client connection on port " << fpm->getPort() << "..." << endl;
+            s.addSelectable(fpm->getListener());
+        }
+        s.addSelectable(&routeFlushTimer);
+
+        while (true)
+        {
+            Selectable *temps;
+
+            /* Reading FPM messages forever (and calling "readMe" to read them) */
+            s.select(&temps);
 
-            /* If warm-restart feature is enabled, execute 'restoration' logic */
-            bool warmStartEnabled = sync.m_warmStartHelper.checkAndStart();
-            if (warmStartEnabled)
+            FpmLink *fpm = NULL;
+            for (auto &link : links)
             {
-                /* Obtain warm-restart timer defined for routing application */
-                time_t warmRestartIval = sync.m_warmStartHelper.getRestartTimer();
-                if (!warmRestartIval)
-                {
-                    warmStartTimer.setInterval(timespec{DEFAULT_ROUTING_RESTART_INTERVAL, 0});
-                }
-                else
+                if (temps == link->getListener() || temps == link.get())
                 {
-                    warmStartTimer.setInterval(timespec{warmRestartIval, 0});
+                    fpm = link.get();
+                    break;
                 }
+            }
 
-                /* Execute restoration instruction and kick off warm-restart timer */
-                if (sync.m_warmStartHelper.runRestoration())
+            if (fpm && temps == fpm->getListener())
+            {
+                if (!fpm->accept())
                 {
-                    warmStartTimer.start();
-                    s.addSelectable(&warmStartTimer);
-                    SWSS_LOG_NOTICE("Warm-Restart timer started.");
+                    continue;
                 }
+                cout << "Connected on port " << fpm->getPort() << "!" << endl;
 
-                // Also start periodic eoiu check timer, first wait 5 seconds, then check every 1 second
-                eoiuCheckTimer.setInterval(timespec{5, 0});
-                eoiuCheckTimer.start();
-                s.addSelectable(&eoiuCheckTimer);
-                SWSS_LOG_NOTICE("Warm-Restart eoiuCheckTimer timer started.");
-            }
-            else
-            {
-                sync.m_warmStartHelper.setState(WarmStart::WSDISABLED);
-            }
-
-            while (true)
-            {
-                Selectable *temps;
+                /* One client per link, the next one waits until this one leaves */
+                s.removeSelectable(fpm->getListener());
+                s.addSelectable(fpm);
 
-                /* Reading FPM messages forever (and calling "readMe" to read them) */
-                s.select(&temps);
+                if (warmStartChecked)
+                {
+                    continue;
+                }
+                warmStartChecked = true;
 
-                /*
-                 * Upon expiration of the warm-restart timer or eoiu Hold Timer, proceed to run the
-                 * reconciliation process if not done yet and remove the timer from
-                 * select() loop.
-                 * Note:  route reconciliation always succeeds, it will not be done twice.
-                 */
-                if (temps == &warmStartTimer || temps == &eoiuHoldTimer)
+                /* If warm-restart feature is enabled, execute 'restoration' logic */
+                warmStartEnabled = sync.m_warmStartHelper.checkAndStart();
+                if (warmStartEnabled)
                 {
-                    if (temps == &warmStartTimer)
+                    /* Obtain warm-restart timer defined for routing application */
+                    time_t warmRestartIval = sync.m_warmStartHelper.getRestartTimer();
+                    if (!warmRestartIval)
                     {
-                        SWSS_LOG_NOTICE("Warm-Restart timer expired.");
+                        warmStartTimer.setInterval(timespec{DEFAULT_ROUTING_RESTART_INTERVAL, 0});
                     }
                     else
                     {
-                        SWSS_LOG_NOTICE("Warm-Restart EOIU hold timer expired.");
+                        warmStartTimer.setInterval(timespec{warmRestartIval, 0});
                     }
 
-                    if (sync.m_warmStartHelper.inProgress())
+                    /* Execute restoration instruction and kick off warm-restart timer */
+                    if (sync.m_warmStartHelper.runRestoration())
                     {
-                        sync.m_warmStartHelper.reconcile();
-                        SWSS_LOG_NOTICE("Warm-Restart reconciliation processed.");
+                        warmStartTimer.start();
+                        s.addSelectable(&warmStartTimer);
+                        SWSS_LOG_NOTICE("Warm-Restart timer started.");
                     }
-                    // remove the one-shot timer.
-                    s.removeSelectable(temps);
-                    pipeline.flush();
-                    SWSS_LOG_DEBUG("Pipeline flushed");
+
+                    // Also start periodic eoiu check timer, first wait 5 seconds, then check every 1 second
+                    eoiuCheckTimer.setInterval(timespec{5, 0});
+                    eoiuCheckTimer.start();
+                    s.addSelectable(&eoiuCheckTimer);
+                    SWSS_LOG_NOTICE("Warm-Restart eoiuCheckTimer timer started.");
+                }
+                else
+                {
+                    sync.m_warmStartHelper.setState(WarmStart::WSDISABLED);
+                    setShards(shards.get());
+                }
+                continue;
+            }
+
+            if (fpm && fpm->isClosed())
+            {
+                /*
+                 * Only this link goes back to listening: the messages it handed
+                 * over are processed, and the routes of the other links stay.
+                 */
+                cout << "Connection lost on port " << fpm->getPort() << ", waiting for reconnection..." << endl;
+                s.removeSelectable(fpm);
+                fpm->disconnect();
+                s.addSelectable(fpm->getListener());
+            }
+
+            /*
+             * Upon expiration of the warm-restart timer or eoiu Hold Timer, proceed to run the
+             * reconciliation process if not done yet and remove the timer from
+             * select() loop.
+             * Note:  route reconciliation always succeeds, it will not be done twice.
+             */
+            if (temps == &warmStartTimer || temps == &eoiuHoldTimer)
+            {
+                if (temps == &warmStartTimer)
+                {
+                    SWSS_LOG_NOTICE("Warm-Restart timer expired.");
+                }
+                else
+                {
+                    SWSS_LOG_NOTICE("Warm-Restart EOIU hold timer expired.");
+                }
+
+                if (sync.m_warmStartHelper.inProgress())
+                {
+                    sync.m_warmStartHelper.reconcile();
+                    SWSS_LOG_NOTICE("Warm-Restart reconciliation processed.");
+                }
+                // remove the one-shot timer.
+                s.removeSelectable(temps);
+                sync.flushRoutes();
+                pipeline.flush();
+                SWSS_LOG_DEBUG("Pipeline flushed");
+
+                /* The routes are reconciled, hand the next ones to the workers */
+                if (sync.m_warmStartHelper.isReconciled())
+                {
+                    setShards(shards.get());
                 }
-                else if (temps == &eoiuCheckTimer)
+            }
+            else if (temps == &eoiuCheckTimer)
+            {
+                if (sync.m_warmStartHelper.inProgress())
                 {
-                    if (sync.m_warmStartHelper.inProgress())
+                    if (eoiuFlagsSet(bgpStateTable))
                     {
-                        if (eoiuFlagsSet(bgpStateTable))
+                        /* Obtain eoiu hold timer defined for bgp docker */
+                        uintmax_t eoiuHoldIval = WarmStart::getWarmStartTimer("eoiu_hold", "bgp");
+                        if (!eoiuHoldIval)
                         {
-                            /* Obtain eoiu hold timer defined for bgp docker */
-                            uintmax_t eoiuHoldIval = WarmStart::getWarmStartTimer("eoiu_hold", "bgp");
-                            if (!eoiuHoldIval)
-                            {
-                                eoiuHoldTimer.setInterval(timespec{DEFAULT_EOIU_HOLD_INTERVAL, 0});
-                                eoiuHoldIval = DEFAULT_EOIU_HOLD_INTERVAL;
-                            }
-                            else
-                            {
-                                eoiuHoldTimer.setInterval(timespec{(time_t)eoiuHoldIval, 0});
-                            }
-                            eoiuHoldTimer.start();
-                            s.addSelectable(&eoiuHoldTimer);
-                            SWSS_LOG_NOTICE("Warm-Restart started EOIU hold timer which is to expire in %" PRIuMAX " seconds.", eoiuHoldIval);
-                            s.removeSelectable(&eoiuCheckTimer);
-                            continue;
+                            eoiuHoldTimer.setInterval(timespec{DEFAULT_EOIU_HOLD_INTERVAL, 0});
+                            eoiuHoldIval = DEFAULT_EOIU_HOLD_INTERVAL;
                         }
-                        eoiuCheckTimer.setInterval(timespec{1, 0});
-                        // re-start eoiu check timer
-                        eoiuCheckTimer.start();
-                        SWSS_LOG_DEBUG("Warm-Restart eoiuCheckTimer restarted");
-                    }
-                    else
-                    {
+                        else
+                        {
+                            eoiuHoldTimer.setInterval(timespec{(time_t)eoiuHoldIval, 0});
+                        }
+                        eoiuHoldTimer.start();
+                        s.addSelectable(&eoiuHoldTimer);
+                        SWSS_LOG_NOTICE("Warm-Restart started EOIU hold timer which is to expire in %" PRIuMAX " seconds.", eoiuHoldIval);
                         s.removeSelectable(&eoiuCheckTimer);
+                        continue;
                     }
+                    eoiuCheckTimer.setInterval(timespec{1, 0});
+                    // re-start eoiu check timer
+                    eoiuCheckTimer.start();
+                    SWSS_LOG_DEBUG("Warm-Restart eoiuCheckTimer restarted");
                 }
-                else if (!warmStartEnabled || sync.m_warmStartHelper.isReconciled())
+                else
                 {
-                    pipeline.flush();
-                    SWSS_LOG_DEBUG("Pipeline flushed");
+                    s.removeSelectable(&eoiuCheckTimer);
+                }
+            }
+            else if (!warmStartEnabled || sync.m_warmStartHelper.isReconciled())
+            {
+                /*
+                 * Route updates are coalesced until enough prefixes are
+                 * pending, or the first of them has waited long enough.
+                 * The VNET updates already in the pipeline are flushed
+                 * right away.
+                 */
+                if (temps == &routeFlushTimer || sync.isRouteFlushDue())
+                {
+                    sync.flushRoutes();
+                }
+                pipeline.flush();
+                SWSS_LOG_DEBUG("Pipeline flushed");
+
+                if (sync.hasPendingRoutes() != routeFlushTimerStarted)
+                {
+                    if (routeFlushTimerStarted)
+                    {
+                        routeFlushTimer.stop();
+                    }
+                    else
+                    {
+                        routeFlushTimer.start();
+                    }
+                    routeFlushTimerStarted = !routeFlushTimerStarted;
                 }
             }
         }
-        catch (FpmLink::FpmConnectionClosedException &e)
-        {
-            cout << "Connection lost, reconnecting..." << endl;
-        }
-        catch (const exception& e)
-        {
-            cout << "Exception \"" << e.what() << "\" had been thrown in daemon" << endl;
-            return 0;
-        }
+    }
+    catch (const exception& e)
+    {
+        cout << "Exception \"" << e.what() << "\" had been thrown in daemon" << endl;
+        return 0;
     }
 
     return 1;
@@ -0,0 +1,85 @@
+#include <string.h>
+#include <mutex>
+#include <netlink/route/link.h>
+#include "logger.h"
+#include "fpmsyncd/ifnamecache.h"
+
+using namespace std;
+using namespace swss;
+
+IfNameCache &IfNameCache::getInstance()
+{
+    static IfNameCache instance;
+    return instance;
+}
+
+IfNameCache::Lookup IfNameCache::get(int if_index, char *if_name, size_t name_len) const
+{
+    shared_lock<shared_timed_mutex> lock(m_mutex);
+
+    if (if_index <= 0 || (size_t)if_index >= m_entries.size() || m_entries[if_index].state == UNKNOWN)
+    {
+        return UNKNOWN;
+    }
+
+    const Entry &entry = m_entries[if_index];
+    if (entry.state == ABSENT)
+    {
+        return ABSENT;
+    }
+
+    snprintf(if_name, name_len, "%s", entry.name);
+    return FOUND;
+}
+
+void IfNameCache::setEntry(int if_index, const char *if_name, Lookup state)
+{
+    if (if_index <= 0 || if_index >= MAX_IF_INDEX)
+    {
+        return;
+    }
+
+    unique_lock<shared_timed_mutex> lock(m_mutex);
+
+    if ((size_t)if_index >= m_entries.size())
+    {
+        /* Grow geometrically, the new entries are UNKNOWN */
+        m_entries.resize(max((size_t)if_index + 1, m_entries.size() * 2), Entry{ "", UNKNOWN });
+    }
+
+    Entry &entry = m_entries[if_index];
+    snprintf(entry.name, sizeof(entry.name), "%s", if_name);
+    entry.state = (uint8_t)state;
+}
+
+void IfNameCache::set(int if_index, const char *if_name)
+{
+    setEntry(if_index, if_name, FOUND);
+}
+
+void IfNameCache::setAbsent(int if_index)
+{
+    setEntry(if_index, "", ABSENT);
+}
+
+void IfNameCache::onMsg(int nlmsg_type, struct nl_object *obj)
+{
+    if ((nlmsg_type != RTM_NEWLINK) && (nlmsg_type != RTM_DELLINK))
+    {
+        return;
+    }
+
+    struct rtnl_link *link = (struct rtnl_link *)obj;
+    int if_index = rtnl_link_get_ifindex(link);
+    const char *if_name = rtnl_link_get_name(link);
+
+    if (nlmsg_type == RTM_DELLINK || !if_name)
+    {
+        SWSS_LOG_DEBUG("Interface removed, ifindex %d", if_index);
+        setAbsent(if_index);
+        return;
+    }
+
+    SWSS_LOG_DEBUG("Interface %s, ifindex %d", if_name, if_index);
+    set(if_index, if_name);
+}
@@ -0,0 +1,61 @@
+#ifndef __IFNAMECACHE__
+#define __IFNAMECACHE__
+
+#include <net/if.h>
+#include <shared_mutex>
+#include <vector>
+
+#include "netmsg.h"
+
+namespace swss {
+
+/*
+ * Interface names by ifindex, for the routes of fpmsyncd.
+ *
+ * The names are kept in an array indexed by ifindex, maintained from the
+ * RTM_NEWLINK/RTM_DELLINK messages of the link netlink group: looking a name
+ * up makes no syscall. An ifindex neither learnt from a link message nor
+ * resolved yet is UNKNOWN, and is left to the caller to resolve with set() or
+ * setAbsent(). Lookups may run on the route workers while the link messages
+ * are handled by the main thread.
+ */
+class IfNameCache : public NetMsg
+{
+public:
+    enum Lookup
+    {
+        FOUND,
+        ABSENT,     /* no such interface */
+        UNKNOWN,    /* not learnt yet */
+    };
+
+    static IfNameCache &getInstance();
+
+    Lookup get(int if_index, char *if_name, size_t name_len) const;
+
+    void set(int if_index, const char *if_name);
+    void setAbsent(int if_index);
+
+    virtual void onMsg(int nlmsg_type, struct nl_object *obj);
+
+private:
+    /* ifindexes are allocated from 1 up, the larger ones are left UNKNOWN */
+    enum { MAX_IF_INDEX = 1 << 20 };
+
+    struct Entry
+    {
+        char    name[IFNAMSIZ];
+        uint8_t state;
+    };
+
+    std::vector<Entry>                  m_entries;
+    mutable std::shared_timed_mutex     m_mutex;
+
+    IfNameCache() = default;
+
+    void setEntry(int if_index, const char *if_name, Lookup state);
+};
+
+}
+
+#endif
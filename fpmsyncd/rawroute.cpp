@@ -0,0 +1,205 @@
+#include "fpmsyncd/rawroute.h"
+
+using namespace std;
+using namespace swss;
+
+#define IPV4_MAX_BYTE       4
+#define IPV6_MAX_BYTE      16
+
+void netlink_parse_rtattr(struct rtattr **tb, int max, struct rtattr *rta,
+        int len)
+{
+    while (RTA_OK(rta, len))
+    {
+        if (rta->rta_type <= max)
+        {
+            tb[rta->rta_type] = rta;
+        }
+        else
+        {
+            /* FRR 7.5 is sending RTA_ENCAP with NLA_F_NESTED bit set*/
+            if (rta->rta_type & NLA_F_NESTED)
+            {
+                int rta_type = rta->rta_type & ~NLA_F_NESTED;
+                if (rta_type <= max)
+                {
+                   tb[rta_type] = rta;
+                }
+            }
+        }
+        rta = RTA_NEXT(rta, len);
+    }
+}
+
+bool RawRoute::parse(struct nlmsghdr *h)
+{
+    struct rtattr *tb[RTA_MAX + 1];
+
+    if (h->nlmsg_type != RTM_NEWROUTE && h->nlmsg_type != RTM_DELROUTE)
+    {
+        return false;
+    }
+
+    if (h->nlmsg_len < NLMSG_LENGTH(sizeof(struct rtmsg)))
+    {
+        return false;
+    }
+
+    struct rtmsg *rtm = (struct rtmsg *)NLMSG_DATA(h);
+
+    size_t addr_len;
+    if (rtm->rtm_family == AF_INET)
+    {
+        addr_len = IPV4_MAX_BYTE;
+    }
+    else if (rtm->rtm_family == AF_INET6)
+    {
+        addr_len = IPV6_MAX_BYTE;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (rtm->rtm_dst_len > addr_len * 8)
+    {
+        return false;
+    }
+
+    memset(tb, 0, sizeof(tb));
+    netlink_parse_rtattr(tb, RTA_MAX, RTM_RTA(rtm), (int)(h->nlmsg_len - NLMSG_LENGTH(sizeof(struct rtmsg))));
+
+    /* libnl prints a route without destination as "none" */
+    if (!tb[RTA_DST] || RTA_PAYLOAD(tb[RTA_DST]) != addr_len)
+    {
+        return false;
+    }
+
+    if (tb[RTA_TABLE] && RTA_PAYLOAD(tb[RTA_TABLE]) != sizeof(uint32_t))
+    {
+        return false;
+    }
+
+    if (tb[RTA_VIA])
+    {
+        return false;
+    }
+
+    nlmsg_type = h->nlmsg_type;
+    family = rtm->rtm_family;
+    rtm_type = rtm->rtm_type;
+    table = tb[RTA_TABLE] ? *(uint32_t *)RTA_DATA(tb[RTA_TABLE]) : rtm->rtm_table;
+
+    inet_ntop(family, RTA_DATA(tb[RTA_DST]), prefix, sizeof(prefix));
+    if (rtm->rtm_dst_len != addr_len * 8)
+    {
+        size_t len = strlen(prefix);
+        snprintf(prefix + len, sizeof(prefix) - len, "/%u", rtm->rtm_dst_len);
+    }
+
+    m_nexthops.clear();
+
+    if (tb[RTA_MULTIPATH])
+    {
+        /* libnl merges these into the first next hop */
+        if (tb[RTA_GATEWAY] || tb[RTA_OIF])
+        {
+            return false;
+        }
+
+        struct rtnexthop *rtnh = (struct rtnexthop *)RTA_DATA(tb[RTA_MULTIPATH]);
+        int len = (int)RTA_PAYLOAD(tb[RTA_MULTIPATH]);
+
+        while (len > 0)
+        {
+            if (len < (int)sizeof(*rtnh) || rtnh->rtnh_len < sizeof(*rtnh) || rtnh->rtnh_len > len)
+            {
+                return false;
+            }
+
+            NextHop nh = { NULL, rtnh->rtnh_ifindex, rtnh->rtnh_hops };
+            if (rtnh->rtnh_len > sizeof(*rtnh) &&
+                !parseNextHopAttrs(RTNH_DATA(rtnh), (int)(rtnh->rtnh_len - sizeof(*rtnh)), addr_len, nh))
+            {
+                return false;
+            }
+            m_nexthops.push_back(nh);
+
+            len -= NLMSG_ALIGN(rtnh->rtnh_len);
+            rtnh = RTNH_NEXT(rtnh);
+        }
+    }
+    else if (tb[RTA_GATEWAY] || tb[RTA_OIF])
+    {
+        NextHop nh = { NULL, 0, 0 };
+
+        if (tb[RTA_OIF])
+        {
+            nh.ifindex = *(int *)RTA_DATA(tb[RTA_OIF]);
+        }
+
+        if (tb[RTA_GATEWAY])
+        {
+            if (RTA_PAYLOAD(tb[RTA_GATEWAY]) != addr_len)
+            {
+                return false;
+            }
+            nh.gateway = RTA_DATA(tb[RTA_GATEWAY]);
+        }
+        m_nexthops.push_back(nh);
+    }
+    else if (nlmsg_type == RTM_NEWROUTE && rtm_type == RTN_UNICAST)
+    {
+        /* libnl may build the next hop of other attributes */
+        return false;
+    }
+
+    return true;
+}
+
+bool RawRoute::parseNextHopAttrs(struct rtattr *rta, int len, size_t addr_len, NextHop &nh) const
+{
+    struct rtattr *tb[RTA_MAX + 1];
+
+    memset(tb, 0, sizeof(tb));
+    netlink_parse_rtattr(tb, RTA_MAX, rta, len);
+
+    if (tb[RTA_VIA])
+    {
+        return false;
+    }
+
+    if (tb[RTA_GATEWAY])
+    {
+        if (RTA_PAYLOAD(tb[RTA_GATEWAY]) != addr_len)
+        {
+            return false;
+        }
+        nh.gateway = RTA_DATA(tb[RTA_GATEWAY]);
+    }
+
+    return true;
+}
+
+bool RawRoute::hasIfName(const char *name) const
+{
+    size_t name_len = strlen(name);
+    size_t pos = 0;
+
+    while (pos <= ifnames.size())
+    {
+        size_t end = ifnames.find(',', pos);
+        if (end == string::npos)
+        {
+            end = ifnames.size();
+        }
+
+        if (end - pos == name_len && !ifnames.compare(pos, name_len, name))
+        {
+            return true;
+        }
+        pos = end + 1;
+    }
+
+    return false;
+}
@@ -0,0 +1,121 @@
+#ifndef __RAWROUTE__
+#define __RAWROUTE__
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/* Parse the Raw netlink msg */
+extern void netlink_parse_rtattr(struct rtattr **tb, int max, struct rtattr *rta,
+                                                int len);
+
+namespace swss {
+
+/*
+ * Route of an RTM_NEWROUTE/RTM_DELROUTE message, decoded straight from its
+ * rtattrs instead of through a libnl route object.
+ *
+ * The text fields are printed in place the way libnl prints them, so that a
+ * RawRoute reused across messages no longer allocates once its buffers have
+ * grown. parse() returns false on the messages libnl may read differently (no
+ * destination, RTA_VIA, unexpected address lengths, malformed next hops...),
+ * which are left to the libnl path.
+ */
+class RawRoute
+{
+public:
+    enum { PREFIX_STR_LEN = INET6_ADDRSTRLEN + 4 };
+
+    int         nlmsg_type;
+    int         family;
+    uint8_t     rtm_type;
+    uint32_t    table;                      /* master device ifindex, 0 for the default VRF */
+    char        prefix[PREFIX_STR_LEN];     /* destination, no length for host routes */
+
+    std::string nexthops;                   /* gateways: gw0,gw1,...,gwN */
+    std::string ifnames;                    /* next hop interfaces: if0,if1,...,ifN */
+    std::string weights;                    /* next hop weights, empty unless all are set */
+
+    bool parse(struct nlmsghdr *h);
+
+    /* Prints the next hops, ifName(ifindex, name, len) looking up interface names */
+    template <typename IfName>
+    void formatNextHops(IfName ifName);
+
+    /* Whether name is one of the next hop interfaces */
+    bool hasIfName(const char *name) const;
+
+private:
+    struct NextHop
+    {
+        const void *gateway;                /* address in the message, NULL if none */
+        int         ifindex;
+        uint8_t     weight;
+    };
+
+    std::vector<NextHop> m_nexthops;
+
+    bool parseNextHopAttrs(struct rtattr *rta, int len, size_t addr_len, NextHop &nh) const;
+};
+
+template <typename IfName>
+void RawRoute::formatNextHops(IfName ifName)
+{
+    char buf[INET6_ADDRSTRLEN];
+    char if_name[IFNAMSIZ];
+    bool weighted = true;
+
+    nexthops.clear();
+    ifnames.clear();
+    weights.clear();
+
+    for (size_t i = 0; i < m_nexthops.size(); i++)
+    {
+        const NextHop &nh = m_nexthops[i];
+
+        if (i)
+        {
+            nexthops += ',';
+            ifnames += ',';
+            weights += ',';
+        }
+
+        if (nh.gateway)
+        {
+            nexthops += inet_ntop(family, nh.gateway, buf, sizeof(buf));
+        }
+        else
+        {
+            nexthops += family == AF_INET ? "0.0.0.0" : "::";
+        }
+
+        /* If we cannot get the interface name */
+        if (!ifName(nh.ifindex, if_name, sizeof(if_name)))
+        {
+            strcpy(if_name, "unknown");
+        }
+        ifnames += if_name;
+
+        weighted = weighted && nh.weight;
+        if (weighted)
+        {
+            snprintf(buf, sizeof(buf), "%u", nh.weight + 1);
+            weights += buf;
+        }
+    }
+
+    if (!weighted)
+    {
+        weights.clear();
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "fpmsyncd/routecoalescer.h"
+
+using namespace std;
+using namespace swss;
+
+RouteCoalescer::RouteCoalescer(size_t flushKeys, uint32_t flushUsec) :
+    m_flushKeys(flushKeys),
+    m_flushUsec(flushUsec),
+    m_updates(0),
+    m_coalesced(0)
+{
+}
+
+void RouteCoalescer::add(const string &key, const string &op,
+                         const vector<FieldValueTuple> &fvVector, clock::time_point now)
+{
+    m_updates++;
+
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        PendingRoute &pending = m_pending[it->second];
+
+        /*
+         * A set keeps the delete it replaces, or the one the replaced set was
+         * already keeping. A delete makes the earlier updates moot.
+         */
+        if (op == SET_COMMAND)
+        {
+            pending.delFirst = pending.delFirst || kfvOp(pending.update) == DEL_COMMAND;
+        }
+        else
+        {
+            pending.delFirst = false;
+        }
+
+        kfvOp(pending.update) = op;
+        kfvFieldsValues(pending.update) = fvVector;
+        m_coalesced++;
+        return;
+    }
+
+    if (m_pending.empty())
+    {
+        m_pendingSince = now;
+    }
+
+    m_index.emplace(key, m_pending.size());
+    m_pending.emplace_back(key, op, fvVector);
+}
+
+bool RouteCoalescer::isFlushDue(clock::time_point now) const
+{
+    if (m_pending.empty())
+    {
+        return false;
+    }
+
+    return m_pending.size() >= m_flushKeys ||
+           now - m_pendingSince >= chrono::microseconds(m_flushUsec);
+}
+
+size_t RouteCoalescer::flush(const Writer &write)
+{
+    size_t written = 0;
+
+    for (const auto &route : m_pending)
+    {
+        const auto &update = route.update;
+
+        if (route.delFirst)
+        {
+            write(kfvKey(update), DEL_COMMAND, vector<FieldValueTuple>());
+            written++;
+        }
+
+        write(kfvKey(update), kfvOp(update), kfvFieldsValues(update));
+        written++;
+    }
+
+    m_pending.clear();
+    m_index.clear();
+
+    return written;
+}
@@ -0,0 +1,92 @@
+#ifndef __ROUTECOALESCER__
+#define __ROUTECOALESCER__
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "table.h"
+
+namespace swss {
+
+/*
+ * Route table updates held until they are flushed, one per prefix.
+ *
+ * A new update of a pending prefix replaces the old one, since the route
+ * table only needs the last state of the prefix. ProducerStateTable merges
+ * the fields of a set into the ones in the table, so a set replacing a
+ * pending delete is flushed as that delete followed by the set: the fields
+ * of the route before the delete, such as blackhole or weight, do not
+ * survive in the new route.
+ */
+class RouteCoalescer
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    /* Writes one update to the route table */
+    typedef std::function<void(const std::string &key, const std::string &op,
+                               const std::vector<FieldValueTuple> &fvVector)> Writer;
+
+    RouteCoalescer(size_t flushKeys, uint32_t flushUsec);
+
+    void add(const std::string &key, const std::string &op,
+             const std::vector<FieldValueTuple> &fvVector,
+             clock::time_point now = clock::now());
+
+    bool empty() const
+    {
+        return m_pending.empty();
+    }
+
+    /* Prefixes pending */
+    size_t size() const
+    {
+        return m_pending.size();
+    }
+
+    /* Whether flushKeys prefixes are pending, or the first of them waited flushUsec */
+    bool isFlushDue(clock::time_point now = clock::now()) const;
+
+    uint32_t getFlushUsec() const
+    {
+        return m_flushUsec;
+    }
+
+    /* Hand the pending updates to write in arrival order of their prefixes, returns the writes */
+    size_t flush(const Writer &write);
+
+    /* Updates added, and updates replaced by a later one of their prefix */
+    uint64_t getUpdates() const { return m_updates; }
+    uint64_t getCoalesced() const { return m_coalesced; }
+
+private:
+    struct PendingRoute
+    {
+        PendingRoute(const std::string &key, const std::string &op,
+                     const std::vector<FieldValueTuple> &fvVector) :
+            update(key, op, fvVector),
+            delFirst(false)
+        {
+        }
+
+        KeyOpFieldsValuesTuple update;
+        /* The prefix is deleted before the set is written */
+        bool delFirst;
+    };
+
+    std::vector<PendingRoute>                   m_pending;
+    std::unordered_map<std::string, size_t>     m_index;
+    clock::time_point                           m_pendingSince;
+    size_t                                      m_flushKeys;
+    uint32_t                                    m_flushUsec;
+
+    uint64_t                                    m_updates;
+    uint64_t                                    m_coalesced;
+};
+
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "producerstatetable.h"
 #include "fpmsyncd/fpmlink.h"
 #include "fpmsyncd/routesync.h"
+#include "fpmsyncd/ifnamecache.h"
 #include "macaddress.h"
 #include <string.h>
 #include <arpa/inet.h>
@@ -41,16 +42,75 @@ using namespace swss;
 
 #define ETHER_ADDR_STRLEN (3*ETH_ALEN)
 
-RouteSync::RouteSync(RedisPipeline *pipeline) :
+RouteSync::RouteSync(RedisPipeline *pipeline, size_t flushKeys, uint32_t flushUsec, const string &statsKey) :
     m_routeTable(pipeline, APP_ROUTE_TABLE_NAME, true),
     m_vnet_routeTable(pipeline, APP_VNET_RT_TABLE_NAME, true),
     m_vnet_tunnelTable(pipeline, APP_VNET_RT_TUNNEL_TABLE_NAME, true),
-    m_warmStartHelper(pipeline, &m_routeTable, APP_ROUTE_TABLE_NAME, "bgp", "bgp"),
-    m_nl_sock(NULL), m_link_cache(NULL)
+    m_warmStartHelper(pipeline, &m_routeTable, APP_ROUTE_TABLE_NAME, "bgp", "bgp",
+                      WarmStartReconciler::RECONCILE_HASH),
+    m_nl_sock(NULL),
+    m_pendingRoutes(flushKeys, flushUsec),
+    m_stateDb("STATE_DB", 0),
+    m_statsTable(&m_stateDb, STATE_FPMSYNCD_STATS_TABLE_NAME),
+    m_statsKey(statsKey),
+    m_routeWritten(0), m_routeFlushes(0)
 {
     m_nl_sock = nl_socket_alloc();
     nl_connect(m_nl_sock, NETLINK_ROUTE);
-    rtnl_link_alloc_cache(m_nl_sock, AF_UNSPEC, &m_link_cache);
+}
+
+void RouteSync::setRoute(const string &key, const vector<FieldValueTuple> &fvVector)
+{
+    m_pendingRoutes.add(key, SET_COMMAND, fvVector);
+}
+
+void RouteSync::delRoute(const string &key)
+{
+    m_pendingRoutes.add(key, DEL_COMMAND, vector<FieldValueTuple>());
+}
+
+void RouteSync::flushRoutes()
+{
+    if (m_pendingRoutes.empty())
+    {
+        return;
+    }
+
+    size_t prefixes = m_pendingRoutes.size();
+    m_routeWritten += m_pendingRoutes.flush([this](const string &key, const string &op,
+                                                   const vector<FieldValueTuple> &fvVector) {
+        if (op == SET_COMMAND)
+        {
+            m_routeTable.set(key, fvVector);
+        }
+        else
+        {
+            m_routeTable.del(key);
+        }
+    });
+
+    SWSS_LOG_DEBUG("Flushed the route updates of %zu prefixes", prefixes);
+
+    m_routeFlushes++;
+
+    publishRouteStats();
+}
+
+void RouteSync::publishRouteStats()
+{
+    auto now = chrono::steady_clock::now();
+    if (now - m_statsPublished < chrono::seconds(1))
+    {
+        return;
+    }
+    m_statsPublished = now;
+
+    vector<FieldValueTuple> fvVector;
+    fvVector.emplace_back("updates", to_string(m_pendingRoutes.getUpdates()));
+    fvVector.emplace_back("coalesced", to_string(m_pendingRoutes.getCoalesced()));
+    fvVector.emplace_back("written", to_string(m_routeWritten));
+    fvVector.emplace_back("flushes", to_string(m_routeFlushes));
+    m_statsTable.set(m_statsKey, fvVector);
 }
 
 char *RouteSync::prefixMac2Str(char *mac, char *buf, int size)
@@ -445,7 +505,7 @@ void RouteSync::onEvpnRouteMsg(struct nlmsghdr *h, int len)
     {
         if (!warmRestartInProgress)
         {
-            m_routeTable.del(destipprefix);
+            delRoute(destipprefix);
             return;
         }
         else
@@ -522,7 +582,7 @@ void RouteSync::onEvpnRouteMsg(struct nlmsghdr *h, int len)
 
     if (!warmRestartInProgress)
     {
-        m_routeTable.set(destipprefix, fvVector);
+        setRoute(destipprefix, fvVector);
         SWSS_LOG_DEBUG("RouteTable set msg: %s vtep:%s vni:%s mac:%s intf:%s",
                        destipprefix, nexthops.c_str(), vni_list.c_str(), mac_list.c_str(), intf_list.c_str());
     }
@@ -564,6 +624,144 @@ void RouteSync::onMsgRaw(struct nlmsghdr *h)
     return;
 }
 
+bool RouteSync::onRouteMsgRaw(struct nlmsghdr *h)
+{
+    RawRoute &route = m_rawRoute;
+    char destipprefix[IFNAMSIZ + MAX_ADDR_SIZE + 2] = {0};
+
+    if (!route.parse(h))
+    {
+        return false;
+    }
+
+    /* if the table_id is not set in the route then route is for default vrf. */
+    if (route.table)
+    {
+        /* Get the name of the master device */
+        char master_name[IFNAMSIZ] = {0};
+        getIfName(route.table, master_name, IFNAMSIZ);
+
+        /* VNET routes go through libnl */
+        if (!strncmp(master_name, VNET_PREFIX, strlen(VNET_PREFIX)))
+        {
+            return false;
+        }
+
+        /*
+         * Now vrf device name is required to start with VRF_PREFIX,
+         * it is difficult to split vrf_name:ipv6_addr.
+         */
+        if (memcmp(master_name, VRF_PREFIX, strlen(VRF_PREFIX)))
+        {
+            SWSS_LOG_ERROR("Invalid VRF name %s (ifindex %u)", master_name, route.table);
+            return true;
+        }
+        snprintf(destipprefix, sizeof(destipprefix), "%s:%s", master_name, route.prefix);
+    }
+    else
+    {
+        snprintf(destipprefix, sizeof(destipprefix), "%s", route.prefix);
+    }
+
+    /*
+     * Upon arrival of a delete msg we could either push the change right away,
+     * or we could opt to defer it if we are going through a warm-reboot cycle.
+     */
+    bool warmRestartInProgress = m_warmStartHelper.inProgress();
+
+    if (route.nlmsg_type == RTM_DELROUTE)
+    {
+        if (!warmRestartInProgress)
+        {
+            delRoute(destipprefix);
+            return true;
+        }
+        else
+        {
+            SWSS_LOG_INFO("Warm-Restart mode: Receiving delete msg: %s",
+                          destipprefix);
+
+            vector<FieldValueTuple> fvVector;
+            const KeyOpFieldsValuesTuple kfv = std::make_tuple(destipprefix,
+                                                               DEL_COMMAND,
+                                                               fvVector);
+            m_warmStartHelper.insertRefreshMap(kfv);
+            return true;
+        }
+    }
+
+    switch (route.rtm_type)
+    {
+        case RTN_BLACKHOLE:
+        {
+            vector<FieldValueTuple> fvVector;
+            FieldValueTuple fv("blackhole", "true");
+            fvVector.push_back(fv);
+            setRoute(destipprefix, fvVector);
+            return true;
+        }
+        case RTN_UNICAST:
+            break;
+
+        case RTN_MULTICAST:
+        case RTN_BROADCAST:
+        case RTN_LOCAL:
+            SWSS_LOG_INFO("BUM routes aren't supported yet (%s)", destipprefix);
+            return true;
+
+        default:
+            return true;
+    }
+
+    /* Get nexthop lists */
+    route.formatNextHops([this](int if_index, char *if_name, size_t name_len) {
+        return getIfName(if_index, if_name, name_len);
+    });
+
+    /*
+     * An FRR behavior change from 7.2 to 7.5 makes FRR update default route to eth0 in interface
+     * up/down events. Skipping routes to eth0 or docker0 to avoid such behavior
+     */
+    if (route.hasIfName("eth0") || route.hasIfName("docker0"))
+    {
+        SWSS_LOG_DEBUG("Skip routes to eth0 or docker0: %s %s %s",
+                destipprefix, route.nexthops.c_str(), route.ifnames.c_str());
+        return true;
+    }
+
+    vector<FieldValueTuple> fvVector;
+    fvVector.emplace_back("nexthop", route.nexthops);
+    fvVector.emplace_back("ifname", route.ifnames);
+    if (!route.weights.empty())
+    {
+        fvVector.emplace_back("weight", route.weights);
+    }
+
+    if (!warmRestartInProgress)
+    {
+        setRoute(destipprefix, fvVector);
+        SWSS_LOG_DEBUG("RouteTable set msg: %s %s %s",
+                       destipprefix, route.nexthops.c_str(), route.ifnames.c_str());
+    }
+
+    /*
+     * During routing-stack restarting scenarios route-updates will be temporarily
+     * put on hold by warm-reboot logic.
+     */
+    else
+    {
+        SWSS_LOG_INFO("Warm-Restart mode: RouteTable set msg: %s %s %s",
+                      destipprefix, route.nexthops.c_str(), route.ifnames.c_str());
+
+        const KeyOpFieldsValuesTuple kfv = std::make_tuple(destipprefix,
+                                                           SET_COMMAND,
+                                                           fvVector);
+        m_warmStartHelper.insertRefreshMap(kfv);
+    }
+
+    return true;
+}
+
 void RouteSync::onMsg(int nlmsg_type, struct nl_object *obj)
 {
     struct rtnl_route *route_obj = (struct rtnl_route *)obj;
@@ -645,7 +843,7 @@ void RouteSync::onRouteMsg(int nlmsg_type, struct nl_object *obj, char *vrf)
     {
         if (!warmRestartInProgress)
         {
-            m_routeTable.del(destipprefix);
+            delRoute(destipprefix);
             return;
         }
         else
@@ -674,7 +872,7 @@ void RouteSync::onRouteMsg(int nlmsg_type, struct nl_object *obj, char *vrf)
             vector<FieldValueTuple> fvVector;
             FieldValueTuple fv("blackhole", "true");
             fvVector.push_back(fv);
-            m_routeTable.set(destipprefix, fvVector);
+            setRoute(destipprefix, fvVector);
             return;
         }
         case RTN_UNICAST:
@@ -731,7 +929,7 @@ void RouteSync::onRouteMsg(int nlmsg_type, struct nl_object *obj, char *vrf)
 
     if (!warmRestartInProgress)
     {
-        m_routeTable.set(destipprefix, fvVector);
+        setRoute(destipprefix, fvVector);
         SWSS_LOG_DEBUG("RouteTable set msg: %s %s %s",
                        destipprefix, nexthops.c_str(), ifnames.c_str());
     }
@@ -878,20 +1076,124 @@ bool RouteSync::getIfName(int if_index, char *if_name, size_t name_len)
 
     memset(if_name, 0, name_len);
 
-    /* Cannot get interface name. Possibly the interface gets re-created. */
-    if (!rtnl_link_i2name(m_link_cache, if_index, if_name, name_len))
+    /* Resolved before the next messages, see deferMsg() */
+    if (IfNameCache::getInstance().get(if_index, if_name, name_len) == IfNameCache::UNKNOWN)
+    {
+        m_unresolvedIfIndexes.insert(if_index);
+        return false;
+    }
+
+    return if_name[0] != 0;
+}
+
+/*
+ * Collect the interfaces a route message refers to: the master device of its
+ * table, and the output interfaces of its next hops.
+ */
+static void getMsgIfIndexes(struct nlmsghdr *h, vector<int> &if_indexes)
+{
+    struct rtmsg *rtm = (struct rtmsg *)NLMSG_DATA(h);
+    struct rtattr *tb[RTA_MAX + 1];
+
+    memset(tb, 0, sizeof(tb));
+    netlink_parse_rtattr(tb, RTA_MAX, RTM_RTA(rtm), (int)(h->nlmsg_len - NLMSG_LENGTH(sizeof(struct rtmsg))));
+
+    if (tb[RTA_TABLE] && RTA_PAYLOAD(tb[RTA_TABLE]) >= sizeof(uint32_t))
     {
-        /* Trying to refill cache */
-        nl_cache_refill(m_nl_sock, m_link_cache);
-        if (!rtnl_link_i2name(m_link_cache, if_index, if_name, name_len))
+        if_indexes.push_back(*(int *)RTA_DATA(tb[RTA_TABLE]));
+    }
+    else
+    {
+        if_indexes.push_back(rtm->rtm_table);
+    }
+
+    if (tb[RTA_OIF] && RTA_PAYLOAD(tb[RTA_OIF]) >= sizeof(int))
+    {
+        if_indexes.push_back(*(int *)RTA_DATA(tb[RTA_OIF]));
+    }
+
+    if (tb[RTA_MULTIPATH])
+    {
+        struct rtnexthop *rtnh = (struct rtnexthop *)RTA_DATA(tb[RTA_MULTIPATH]);
+        int len = (int)RTA_PAYLOAD(tb[RTA_MULTIPATH]);
+
+        while (len >= (int)sizeof(*rtnh) && rtnh->rtnh_len >= sizeof(*rtnh) && rtnh->rtnh_len <= len)
+        {
+            if_indexes.push_back(rtnh->rtnh_ifindex);
+            len -= NLMSG_ALIGN(rtnh->rtnh_len);
+            rtnh = RTNH_NEXT(rtnh);
+        }
+    }
+}
+
+bool RouteSync::deferMsg(struct nlmsghdr *h)
+{
+    if (h->nlmsg_type != RTM_NEWROUTE && h->nlmsg_type != RTM_DELROUTE)
+    {
+        return false;
+    }
+
+    /* Messages are processed in order: defer the ones after a deferred message */
+    if (m_deferredMsgs.empty())
+    {
+        if (h->nlmsg_len < NLMSG_LENGTH(sizeof(struct rtmsg)))
+        {
+            return false;
+        }
+
+        m_msgIfIndexes.clear();
+        getMsgIfIndexes(h, m_msgIfIndexes);
+
+        bool unknown = false;
+        char if_name[IFNAMSIZ];
+        for (auto if_index : m_msgIfIndexes)
+        {
+            if (if_index > 0 &&
+                IfNameCache::getInstance().get(if_index, if_name, sizeof(if_name)) == IfNameCache::UNKNOWN)
+            {
+                m_unresolvedIfIndexes.insert(if_index);
+                unknown = true;
+            }
+        }
+
+        if (!unknown)
         {
             return false;
         }
     }
 
+    size_t pos = m_deferredMsgs.size();
+    m_deferredMsgs.resize(pos + NLMSG_ALIGN(h->nlmsg_len));
+    memcpy(&m_deferredMsgs[pos], h, h->nlmsg_len);
     return true;
 }
 
+void RouteSync::resolveIfNames()
+{
+    for (auto if_index : m_unresolvedIfIndexes)
+    {
+        struct rtnl_link *link = NULL;
+
+        /* A single link, instead of a dump of all the links */
+        if (rtnl_link_get_kernel(m_nl_sock, if_index, NULL, &link) < 0 || !rtnl_link_get_name(link))
+        {
+            SWSS_LOG_INFO("No interface of ifindex %d", if_index);
+            IfNameCache::getInstance().setAbsent(if_index);
+        }
+        else
+        {
+            IfNameCache::getInstance().set(if_index, rtnl_link_get_name(link));
+        }
+
+        if (link)
+        {
+            rtnl_link_put(link);
+        }
+    }
+
+    m_unresolvedIfIndexes.clear();
+}
+
 /*
  * Get next hop gateway IP addresses
  * @arg route_obj     route object
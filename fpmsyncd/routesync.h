@@ -3,9 +3,13 @@
 
 #include "dbconnector.h"
 #include "producerstatetable.h"
+#include "table.h"
 #include "netmsg.h"
 #include "warmRestartHelper.h"
+#include "fpmsyncd/rawroute.h"
+#include "fpmsyncd/routecoalescer.h"
 #include <string.h>
+#include <chrono>
 #include <bits/stdc++.h>
 
 using namespace std;
@@ -14,6 +18,25 @@ using namespace std;
 extern void netlink_parse_rtattr(struct rtattr **tb, int max, struct rtattr *rta,
                                                 int len);
 
+/*
+ * Route updates of fpmsyncd, key "ROUTE_TABLE":
+ *   updates    route sets and deletes received from zebra
+ *   coalesced  updates replaced by a later one of the same prefix before a flush
+ *   written    updates written to APPL_DB, with the deletes written ahead of the sets replacing them
+ *   flushes    flushes of the pending updates to APPL_DB
+ * With route workers, each worker reports its updates under "ROUTE_TABLE|<worker>".
+ *
+ * FPM connection of each port, key "FPM_LINK|<port>", since the connection was accepted:
+ *   bytes          bytes received
+ *   messages       FPM messages received
+ *   wakeups        reads of the connection from the select loop
+ *   reads          readv() calls returning data
+ *   buffer_size    size of the receive buffer
+ */
+#define STATE_FPMSYNCD_STATS_TABLE_NAME     "FPMSYNCD_STATS_TABLE"
+#define FPMSYNCD_ROUTE_STATS_KEY            "ROUTE_TABLE"
+#define FPMSYNCD_LINK_STATS_KEY             "FPM_LINK"
+
 namespace swss {
 
 class RouteSync : public NetMsg
@@ -21,11 +44,71 @@ class RouteSync : public NetMsg
 public:
     enum { MAX_ADDR_SIZE = 64 };
 
-    RouteSync(RedisPipeline *pipeline);
+    /* Flush the pending route updates past this many prefixes... */
+    static const size_t DEFAULT_ROUTE_FLUSH_KEYS = 1024;
+    /* ...or this many microseconds after the first of them */
+    static const uint32_t DEFAULT_ROUTE_FLUSH_USEC = 1000;
+
+    RouteSync(RedisPipeline *pipeline,
+              size_t flushKeys = DEFAULT_ROUTE_FLUSH_KEYS,
+              uint32_t flushUsec = DEFAULT_ROUTE_FLUSH_USEC,
+              const string &statsKey = FPMSYNCD_ROUTE_STATS_KEY);
 
     virtual void onMsg(int nlmsg_type, struct nl_object *obj);
 
     virtual void onMsgRaw(struct nlmsghdr *obj);
+
+    /*
+     * Handle regular route (include VRF route) from the raw netlink message.
+     * Returns false when the message has to go through the libnl conversion.
+     */
+    bool onRouteMsgRaw(struct nlmsghdr *h);
+
+    /*
+     * Route updates are held until flushRoutes(), the last one of a prefix
+     * replacing the earlier ones, see RouteCoalescer.
+     */
+    bool hasPendingRoutes() const
+    {
+        return !m_pendingRoutes.empty();
+    }
+
+    /* Whether the pending route updates reached the flush limits */
+    bool isRouteFlushDue() const
+    {
+        return m_pendingRoutes.isFlushDue();
+    }
+
+    uint32_t getRouteFlushUsec() const
+    {
+        return m_pendingRoutes.getFlushUsec();
+    }
+
+    /* Write the pending route updates to the route table pipeline */
+    void flushRoutes();
+
+    /*
+     * Keep a route message whose interfaces are not in the IfNameCache yet, or
+     * which comes after such a message. Returns true when the message is kept:
+     * it is processed once resolveIfNames() has looked its interfaces up.
+     */
+    bool deferMsg(struct nlmsghdr *h);
+
+    bool hasDeferredMsgs() const
+    {
+        return !m_deferredMsgs.empty();
+    }
+
+    /* Look up the interfaces the cache missed in the kernel, one by one */
+    void resolveIfNames();
+
+    /* Hand the deferred messages over to msgs */
+    void takeDeferredMsgs(vector<char> &msgs)
+    {
+        msgs.clear();
+        msgs.swap(m_deferredMsgs);
+    }
+
     WarmStartHelper  m_warmStartHelper;
 
 private:
@@ -35,8 +118,29 @@ private:
     ProducerStateTable  m_vnet_routeTable;
     /* vnet vxlan tunnel table */  
     ProducerStateTable  m_vnet_tunnelTable; 
-    struct nl_cache    *m_link_cache;
     struct nl_sock     *m_nl_sock;
+    /* route of the last raw route message */
+    RawRoute            m_rawRoute;
+
+    /* route messages waiting for interface names, and the interfaces to look up */
+    vector<char>        m_deferredMsgs;
+    set<int>            m_unresolvedIfIndexes;
+    vector<int>         m_msgIfIndexes;
+
+    /* route updates not written yet */
+    RouteCoalescer                      m_pendingRoutes;
+
+    /* route update counters, published to STATE_DB at most once a second */
+    DBConnector                         m_stateDb;
+    Table                               m_statsTable;
+    string                              m_statsKey;
+    chrono::steady_clock::time_point    m_statsPublished;
+    uint64_t                            m_routeWritten;
+    uint64_t                            m_routeFlushes;
+
+    void setRoute(const string &key, const vector<FieldValueTuple> &fvVector);
+    void delRoute(const string &key);
+    void publishRouteStats();
 
     /* Handle regular route (include VRF route) */
     void onRouteMsg(int nlmsg_type, struct nl_object *obj, char *vrf);
@@ -0,0 +1,82 @@
+#ifndef __SPSCQUEUE__
+#define __SPSCQUEUE__
+
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+namespace swss {
+
+/*
+ * Bounded lock-free queue between one producer thread and one consumer thread.
+ *
+ * The producer only writes the tail and the consumer only writes the head, each
+ * publishing its slot with a release store that the other side reads with an
+ * acquire load. The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    /* Producer side, returns false when the queue is full */
+    bool push(const T &item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+        {
+            return false;
+        }
+
+        m_slots[tail & m_mask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer side, returns false when the queue is empty */
+    bool pop(T &item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    enum { CACHE_LINE_SIZE = 64 };
+
+    std::vector<T>      m_slots;
+    size_t              m_mask;
+
+    /* head and tail on their own cache lines, written by different threads */
+    char                m_pad0[CACHE_LINE_SIZE];
+    std::atomic<size_t> m_head { 0 };
+    char                m_pad1[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_tail { 0 };
+    char                m_pad2[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+};
+
+}
+
+#endif
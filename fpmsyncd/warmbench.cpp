@@ -0,0 +1,238 @@
+/*
+ * Runs the warm-restart reconciliation of a synthetic fpmsyncd route table
+ * through the WarmStartReconciler of WarmStartHelper, with the restored routes
+ * held the two ways it can hold them:
+ * - full: every restored route and every refreshed route, compared on
+ *   reconciliation with compareAllFV();
+ * - hash: a WarmStartHashes entry per restored route, and the refreshed routes
+ *   differing from it.
+ * Each way runs in a child process, whose peak RSS is reported along with the
+ * time taken to restore the table, refresh it, and reconcile it. Redis is not
+ * involved: the updates reconciliation would push are only counted, and both
+ * ways must agree on them.
+ *
+ * The refreshed table has the restored next hops in another order, save for
+ * -c percent of the routes which get other next hops and -s percent which are
+ * not refreshed at all. As many brand-new routes as stale ones are refreshed.
+ *
+ * Usage: fpmsyncd-warmbench [-n <routes>] [-e <next hops>] [-c <changed %>] [-s <stale %>]
+ */
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "warmRestartHelper.h"
+
+using namespace std;
+using namespace swss;
+
+struct RouteTable
+{
+    size_t routes;
+    size_t ecmp;
+    size_t changed;
+    size_t stale;
+};
+
+struct Result
+{
+    size_t  restored;
+    size_t  deleted;
+    size_t  updated;
+    double  restoreSeconds;
+    double  refreshSeconds;
+    double  reconcileSeconds;
+};
+
+static string routeKey(size_t i)
+{
+    return "10." + to_string((i >> 16) & 0xff) + "." + to_string((i >> 8) & 0xff) + "." +
+           to_string(i & 0xff) + "/32";
+}
+
+/* The ECMP group of a route, starting at next hop 'first' */
+static vector<FieldValueTuple> routeFV(size_t ecmp, size_t group, size_t first)
+{
+    string nexthops, ifnames;
+
+    for (size_t n = 0; n < ecmp; n++)
+    {
+        size_t nh = group * ecmp + (first + n) % ecmp;
+        if (n)
+        {
+            nexthops += ",";
+            ifnames += ",";
+        }
+        nexthops += "192.168." + to_string((nh >> 8) & 0xff) + "." + to_string(nh & 0xff);
+        ifnames += "Ethernet" + to_string((nh % 64) * 4);
+    }
+
+    return { { "nexthop", nexthops }, { "ifname", ifnames } };
+}
+
+static vector<FieldValueTuple> restoredFV(const RouteTable &t, size_t i)
+{
+    return routeFV(t.ecmp, i % 256, 0);
+}
+
+/*
+ * Calls refreshed(kfv) on the routes the restarted application refreshes. The
+ * first restored routes are the stale ones, followed by the changed ones, and
+ * the brand-new routes come past the restored ones.
+ */
+template <typename Refreshed>
+static void refreshTable(const RouteTable &t, Refreshed refreshed)
+{
+    for (size_t i = t.stale; i < t.routes + t.stale; i++)
+    {
+        size_t group = (i < t.stale + t.changed) ? (i + 1) % 256 : i % 256;
+        refreshed(KeyOpFieldsValuesTuple(routeKey(i), SET_COMMAND, routeFV(t.ecmp, group, 1)));
+    }
+}
+
+static double since(chrono::steady_clock::time_point &begin)
+{
+    auto now = chrono::steady_clock::now();
+    chrono::duration<double> elapsed = now - begin;
+    begin = now;
+    return elapsed.count();
+}
+
+static Result reconcile(WarmStartReconciler::ReconcileMode mode, const RouteTable &t)
+{
+    Result r = {};
+    auto begin = chrono::steady_clock::now();
+
+    WarmStartReconciler reconciler(mode);
+    for (size_t i = 0; i < t.routes; i++)
+    {
+        reconciler.restore(routeKey(i), restoredFV(t, i));
+    }
+    r.restored = reconciler.restoredSize();
+    r.restoreSeconds = since(begin);
+
+    refreshTable(t, [&](const KeyOpFieldsValuesTuple &kfv) {
+        reconciler.insertRefreshMap(kfv);
+    });
+    r.refreshSeconds = since(begin);
+
+    reconciler.reconcile(
+        [&](const string &) {
+            r.deleted++;
+        },
+        [&](const string &, const vector<FieldValueTuple> &) {
+            r.updated++;
+        });
+    r.reconcileSeconds = since(begin);
+
+    return r;
+}
+
+static Result reconcileFull(const RouteTable &t)
+{
+    return reconcile(WarmStartReconciler::RECONCILE_FULL, t);
+}
+
+static Result reconcileHash(const RouteTable &t)
+{
+    return reconcile(WarmStartReconciler::RECONCILE_HASH, t);
+}
+
+/* Runs reconcile() in a child process, returns its peak RSS in KB */
+static long runChild(Result (*reconcile)(const RouteTable &), const RouteTable &t, Result &result)
+{
+    int fds[2];
+    if (pipe(fds) < 0)
+    {
+        perror("pipe");
+        exit(EXIT_FAILURE);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(EXIT_FAILURE);
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        Result r = reconcile(t);
+        _exit(write(fds[1], &r, sizeof(r)) == sizeof(r) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    ssize_t len = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0 || len != sizeof(result) ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+        cerr << "Reconciliation failed" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return usage.ru_maxrss;
+}
+
+static void report(const char *name, const Result &r, long maxRss)
+{
+    cout << name << r.restored << " restored, " << r.deleted << " deleted, " << r.updated << " updated, "
+         << "restore " << r.restoreSeconds << " s, refresh " << r.refreshSeconds << " s, reconcile "
+         << r.reconcileSeconds << " s, peak RSS " << maxRss / 1024 << " MB" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    RouteTable t = { 1000000, 4, 0, 0 };
+    size_t changed = 1;
+    size_t stale = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:e:c:s:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                t.routes = strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                t.ecmp = strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                changed = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                stale = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n <routes>] [-e <next hops>] [-c <changed %>] [-s <stale %>]" << endl;
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (!t.ecmp || changed + stale > 100)
+    {
+        cerr << "Usage: " << argv[0] << " [-n <routes>] [-e <next hops>] [-c <changed %>] [-s <stale %>]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    t.changed = t.routes * changed / 100;
+    t.stale = t.routes * stale / 100;
+
+    Result full, hash;
+    long fullRss = runChild(reconcileFull, t, full);
+    long hashRss = runChild(reconcileHash, t, hash);
+
+    report("full: ", full, fullRss);
+    report("hash: ", hash, hashRss);
+
+    return (full.deleted == hash.deleted && full.updated == hash.updated) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,6 +1,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include "aclorch.h"
 #include "logger.h"
@@ -24,6 +25,7 @@ sai_uint32_t AclRule::m_maxPriority = 0;
 
 swss::DBConnector AclOrch::m_db("COUNTERS_DB", 0);
 swss::Table AclOrch::m_countersTable(&m_db, "COUNTERS");
+swss::Table AclOrch::m_counterRuleMapTable(&m_db, ACL_COUNTER_RULE_MAP);
 
 extern sai_acl_api_t*    sai_acl_api;
 extern sai_port_api_t*   sai_port_api;
@@ -31,6 +33,8 @@ extern sai_switch_api_t* sai_switch_api;
 extern sai_object_id_t   gSwitchId;
 extern PortsOrch*        gPortsOrch;
 extern CrmOrch *gCrmOrch;
+extern size_t gMaxBulkSize;
+extern bool gAclFlexCounters;
 
 #define MIN_VLAN_ID 1    // 0 is a reserved VLAN ID
 #define MAX_VLAN_ID 4095 // 4096 is a reserved VLAN ID
@@ -164,6 +168,7 @@ AclRule::AclRule(AclOrch *aclOrch, string rule, string table, acl_table_type_t t
         m_ruleOid(SAI_NULL_OBJECT_ID),
         m_counterOid(SAI_NULL_OBJECT_ID),
         m_priority(0),
+        m_rangeCount(0),
         m_createCounter(createCounter)
 {
     m_tableOid = aclOrch->getTableById(m_tableId);
@@ -471,12 +476,7 @@ bool AclRule::create()
 {
     SWSS_LOG_ENTER();
 
-    sai_object_id_t table_oid = m_pAclOrch->getTableById(m_tableId);
     vector<sai_attribute_t> rule_attrs;
-    sai_object_id_t range_objects[2];
-    sai_object_list_t range_object_list = {0, range_objects};
-
-    sai_attribute_t attr;
     sai_status_t status;
 
     if (m_createCounter && !createCounter())
@@ -486,6 +486,35 @@ bool AclRule::create()
 
     SWSS_LOG_INFO("Created counter for the rule %s in table %s", m_id.c_str(), m_tableId.c_str());
 
+    if (!getEntryAttributes(rule_attrs))
+    {
+        return false;
+    }
+
+    status = sai_acl_api->create_acl_entry(&m_ruleOid, gSwitchId, (uint32_t)rule_attrs.size(), rule_attrs.data());
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        SWSS_LOG_ERROR("Failed to create ACL rule %s, rv:%d",
+                m_id.c_str(), status);
+        AclRange::remove(m_rangeOids, m_rangeCount);
+        m_rangeCount = 0;
+        decreaseNextHopRefCount();
+    }
+
+    gCrmOrch->incCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_ENTRY, m_tableOid);
+
+    return (status == SAI_STATUS_SUCCESS);
+}
+
+bool AclRule::getEntryAttributes(vector<sai_attribute_t> &rule_attrs)
+{
+    SWSS_LOG_ENTER();
+
+    sai_object_id_t table_oid = m_pAclOrch->getTableById(m_tableId);
+    sai_attribute_t attr;
+
+    m_rangeCount = 0;
+
     // store table oid this rule belongs to
     attr.id = SAI_ACL_ENTRY_ATTR_TABLE_ID;
     attr.value.oid = table_oid;
@@ -521,12 +550,13 @@ bool AclRule::create()
             if (!range)
             {
                 // release already created range if any
-                AclRange::remove(range_objects, range_object_list.count);
+                AclRange::remove(m_rangeOids, m_rangeCount);
+                m_rangeCount = 0;
                 return false;
             }
             else
             {
-                range_objects[range_object_list.count++] = range->getOid();
+                m_rangeOids[m_rangeCount++] = range->getOid();
             }
         }
         else
@@ -538,12 +568,12 @@ bool AclRule::create()
         }
     }
 
-    // store ranges if any
-    if (range_object_list.count > 0)
+    // store ranges if any, the list points to m_rangeOids until the entry is created
+    if (m_rangeCount > 0)
     {
         attr.id = SAI_ACL_ENTRY_ATTR_FIELD_ACL_RANGE_TYPE;
         attr.value.aclfield.enable = true;
-        attr.value.aclfield.data.objlist = range_object_list;
+        attr.value.aclfield.data.objlist = {m_rangeCount, m_rangeOids};
         rule_attrs.push_back(attr);
     }
 
@@ -555,18 +585,128 @@ bool AclRule::create()
         rule_attrs.push_back(attr);
     }
 
-    status = sai_acl_api->create_acl_entry(&m_ruleOid, gSwitchId, (uint32_t)rule_attrs.size(), rule_attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
+    return true;
+}
+
+void AclRule::createCounterPre(ObjectBulker<sai_acl_api_t> &counterBulker)
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_createCounter)
     {
-        SWSS_LOG_ERROR("Failed to create ACL rule %s, rv:%d",
-                m_id.c_str(), status);
-        AclRange::remove(range_objects, range_object_list.count);
+        return;
+    }
+
+    vector<sai_attribute_t> counter_attrs = getCounterAttributes();
+    counterBulker.create_entry(&m_counterOid, (uint32_t)counter_attrs.size(), counter_attrs.data());
+}
+
+bool AclRule::createPre(ObjectBulker<sai_acl_api_t> &entryBulker)
+{
+    SWSS_LOG_ENTER();
+
+    if (m_createCounter)
+    {
+        if (m_counterOid == SAI_NULL_OBJECT_ID)
+        {
+            SWSS_LOG_ERROR("Failed to create counter for the rule %s in table %s", m_id.c_str(), m_tableId.c_str());
+            return false;
+        }
+
+        gCrmOrch->incCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_COUNTER, m_tableOid);
+        m_pAclOrch->registerRuleCounter(*this);
+    }
+
+    vector<sai_attribute_t> rule_attrs;
+    if (!getEntryAttributes(rule_attrs))
+    {
+        removeCounter();
+        return false;
+    }
+
+    entryBulker.create_entry(&m_ruleOid, (uint32_t)rule_attrs.size(), rule_attrs.data());
+    return true;
+}
+
+bool AclRule::createPost()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_ruleOid == SAI_NULL_OBJECT_ID)
+    {
+        SWSS_LOG_ERROR("Failed to create ACL rule %s", m_id.c_str());
+        AclRange::remove(m_rangeOids, m_rangeCount);
+        m_rangeCount = 0;
         decreaseNextHopRefCount();
+        removeCounter();
+        return false;
     }
 
     gCrmOrch->incCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_ENTRY, m_tableOid);
+    return true;
+}
 
-    return (status == SAI_STATUS_SUCCESS);
+void AclRule::removePre(ObjectBulker<sai_acl_api_t> &entryBulker)
+{
+    SWSS_LOG_ENTER();
+
+    m_bulkStatus = SAI_STATUS_SUCCESS;
+    if (m_ruleOid != SAI_NULL_OBJECT_ID)
+    {
+        entryBulker.remove_entry(&m_bulkStatus, m_ruleOid);
+    }
+}
+
+bool AclRule::removeCounterPre(ObjectBulker<sai_acl_api_t> &counterBulker)
+{
+    SWSS_LOG_ENTER();
+
+    if (m_bulkStatus != SAI_STATUS_SUCCESS)
+    {
+        SWSS_LOG_ERROR("Failed to delete ACL rule %s, rv:%d", m_id.c_str(), m_bulkStatus);
+        return false;
+    }
+
+    // Released once with the entry, a retry only removes the counter left behind
+    if (m_ruleOid != SAI_NULL_OBJECT_ID)
+    {
+        gCrmOrch->decCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_ENTRY, m_tableOid);
+        m_ruleOid = SAI_NULL_OBJECT_ID;
+
+        decreaseNextHopRefCount();
+
+        if (!removeRanges())
+        {
+            SWSS_LOG_ERROR("Failed to remove ACL ranges of rule %s in table %s", m_id.c_str(), m_tableId.c_str());
+        }
+    }
+
+    if (m_createCounter && m_counterOid != SAI_NULL_OBJECT_ID)
+    {
+        m_pAclOrch->deregisterRuleCounter(*this);
+        counterBulker.remove_entry(&m_bulkStatus, m_counterOid);
+    }
+
+    return true;
+}
+
+bool AclRule::removePost()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_createCounter && m_counterOid != SAI_NULL_OBJECT_ID)
+    {
+        if (m_bulkStatus != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to remove ACL counter for rule %s in table %s", m_id.c_str(), m_tableId.c_str());
+            return false;
+        }
+
+        gCrmOrch->decCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_COUNTER, m_tableOid);
+        m_counterOid = SAI_NULL_OBJECT_ID;
+    }
+
+    return true;
 }
 
 void AclRule::decreaseNextHopRefCount()
@@ -765,10 +905,8 @@ shared_ptr<AclRule> AclRule::makeShared(acl_table_type_t type, AclOrch *acl, Mir
     throw runtime_error("Wrong combination of table type and action in rule " + rule);
 }
 
-bool AclRule::createCounter()
+vector<sai_attribute_t> AclRule::getCounterAttributes() const
 {
-    SWSS_LOG_ENTER();
-
     sai_attribute_t attr;
     vector<sai_attribute_t> counter_attrs;
 
@@ -784,6 +922,15 @@ bool AclRule::createCounter()
     attr.value.booldata = true;
     counter_attrs.push_back(attr);
 
+    return counter_attrs;
+}
+
+bool AclRule::createCounter()
+{
+    SWSS_LOG_ENTER();
+
+    vector<sai_attribute_t> counter_attrs = getCounterAttributes();
+
     if (sai_acl_api->create_acl_counter(&m_counterOid, gSwitchId, (uint32_t)counter_attrs.size(), counter_attrs.data()) != SAI_STATUS_SUCCESS)
     {
         SWSS_LOG_ERROR("Failed to create counter for the rule %s in table %s", m_id.c_str(), m_tableId.c_str());
@@ -791,6 +938,7 @@ bool AclRule::createCounter()
     }
 
     gCrmOrch->incCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_COUNTER, m_tableOid);
+    m_pAclOrch->registerRuleCounter(*this);
 
     return true;
 }
@@ -818,6 +966,8 @@ bool AclRule::removeCounter()
         return true;
     }
 
+    m_pAclOrch->deregisterRuleCounter(*this);
+
     if (sai_acl_api->remove_acl_counter(m_counterOid) != SAI_STATUS_SUCCESS)
     {
         SWSS_LOG_ERROR("Failed to remove ACL counter for rule %s in table %s", m_id.c_str(), m_tableId.c_str());
@@ -826,9 +976,6 @@ bool AclRule::removeCounter()
 
     gCrmOrch->decCrmAclTableUsedCounter(CrmResourceType::CRM_ACL_COUNTER, m_tableOid);
 
-    SWSS_LOG_INFO("Removing record about the counter %" PRIx64 " from the DB", m_counterOid);
-    AclOrch::getCountersTable().del(getTableId() + ":" + getId());
-
     m_counterOid = SAI_NULL_OBJECT_ID;
 
     return true;
@@ -1804,19 +1951,52 @@ bool AclTable::clear()
 {
     SWSS_LOG_ENTER();
 
-    for (auto& rulepair: rules)
+    vector<AclRule *> bulkRules;
+    bool suc = true;
+
+    for (auto it = rules.begin(); it != rules.end();)
     {
-        auto& rule = *rulepair.second;
-        bool suc = rule.remove();
-        if (!suc)
+        auto& rule = *it->second;
+        if (m_pAclOrch && rule.isBulkSupported())
+        {
+            bulkRules.push_back(&rule);
+            it++;
+        }
+        else if (rule.remove())
+        {
+            it = rules.erase(it);
+        }
+        else
         {
             SWSS_LOG_ERROR("Failed to delete ACL rule %s when removing the ACL table %s",
                     rule.getId().c_str(), id.c_str());
-            return false;
+            suc = false;
+            it++;
         }
     }
-    rules.clear();
-    return true;
+
+    if (bulkRules.empty())
+    {
+        return suc;
+    }
+
+    auto removed = m_pAclOrch->bulkRemoveAclRules(bulkRules);
+    for (size_t i = 0; i < bulkRules.size(); i++)
+    {
+        string rule_id = bulkRules[i]->getId();
+        if (removed[i])
+        {
+            rules.erase(rule_id);
+        }
+        else
+        {
+            SWSS_LOG_ERROR("Failed to delete ACL rule %s when removing the ACL table %s",
+                    rule_id.c_str(), id.c_str());
+            suc = false;
+        }
+    }
+
+    return suc;
 }
 
 AclRuleCounters AclRuleMirror::getCounters()
@@ -2560,10 +2740,26 @@ AclOrch::AclOrch(vector<TableConnector>& connectors, SwitchOrch *switchOrch,
         m_mirrorOrch(mirrorOrch),
         m_neighOrch(neighOrch),
         m_routeOrch(routeOrch),
-        m_dTelOrch(dtelOrch)
+        m_dTelOrch(dtelOrch),
+        m_aclCounterBulker(sai_acl_api, gSwitchId, gMaxBulkSize, SAI_OBJECT_TYPE_ACL_COUNTER),
+        m_aclEntryBulker(sai_acl_api, gSwitchId, gMaxBulkSize, SAI_OBJECT_TYPE_ACL_ENTRY),
+        m_countersPipeline(&m_db),
+        m_countersBatchTable(&m_countersPipeline, "COUNTERS", true)
 {
     SWSS_LOG_ENTER();
 
+    if (gAclFlexCounters)
+    {
+        /* Syncd only polls the ACL counters when swss-common defines their counter id list */
+#ifdef ACL_COUNTER_ATTR_ID_LIST
+        m_flexCounterManager.reset(new FlexCounterManager(ACL_COUNTER_FLEX_COUNTER_GROUP, StatsMode::READ,
+                                                          COUNTERS_READ_INTERVAL * 1000, true));
+        SWSS_LOG_NOTICE("Polling the ACL rule counters with flex counters");
+#else
+        SWSS_LOG_WARN("ACL flex counters are not supported, polling the ACL rule counters in orchagent");
+#endif
+    }
+
     init(connectors, portOrch, mirrorOrch, neighOrch, routeOrch);
 
     if (m_dTelOrch)
@@ -2854,7 +3050,7 @@ bool AclOrch::addAclTable(AclTable &newTable)
 
     if (createBindAclTable(newTable, table_oid))
     {
-        m_AclTables[table_oid] = newTable;
+        insertAclTable(table_oid, newTable);
         SWSS_LOG_NOTICE("Created ACL table %s oid:%" PRIx64,
                 newTable.id.c_str(), table_oid);
 
@@ -2906,7 +3102,7 @@ bool AclOrch::removeAclTable(string table_id)
         }
 
         SWSS_LOG_NOTICE("Successfully deleted ACL table %s", table_id.c_str());
-        m_AclTables.erase(table_oid);
+        eraseAclTable(table_oid);
 
         // Clear mirror table information
         // If the v4 and v6 ACL mirror tables are combined together,
@@ -2949,6 +3145,64 @@ bool AclOrch::addAclRule(shared_ptr<AclRule> newRule, string table_id)
     return m_AclTables[table_oid].add(newRule);
 }
 
+vector<bool> AclOrch::bulkCreateAclRules(const vector<AclRule *> &rules)
+{
+    SWSS_LOG_ENTER();
+
+    vector<bool> created(rules.size(), false);
+
+    for (auto rule : rules)
+    {
+        rule->createCounterPre(m_aclCounterBulker);
+    }
+    m_aclCounterBulker.flush();
+
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        created[i] = rules[i]->createPre(m_aclEntryBulker);
+    }
+    m_aclEntryBulker.flush();
+
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        if (created[i])
+        {
+            created[i] = rules[i]->createPost();
+        }
+    }
+
+    return created;
+}
+
+vector<bool> AclOrch::bulkRemoveAclRules(const vector<AclRule *> &rules)
+{
+    SWSS_LOG_ENTER();
+
+    vector<bool> removed(rules.size(), false);
+
+    for (auto rule : rules)
+    {
+        rule->removePre(m_aclEntryBulker);
+    }
+    m_aclEntryBulker.flush();
+
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        removed[i] = rules[i]->removeCounterPre(m_aclCounterBulker);
+    }
+    m_aclCounterBulker.flush();
+
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        if (removed[i])
+        {
+            removed[i] = rules[i]->removePost();
+        }
+    }
+
+    return removed;
+}
+
 bool AclOrch::removeAclRule(string table_id, string rule_id)
 {
     sai_object_id_t table_oid = getTableById(table_id);
@@ -3212,6 +3466,10 @@ void AclOrch::doAclRuleTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
 
+    // Rules supporting bulk are created and removed together once the tasks are walked
+    vector<AclRuleBulkContext> bulkContexts;
+    unordered_set<string> bulkKeys;
+
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
@@ -3222,6 +3480,24 @@ void AclOrch::doAclRuleTask(Consumer &consumer)
         string rule_id = key.substr(found + 1);
         string op = kfvOp(t);
 
+        // A DEL followed by a SET of the rule: the DEL is applied first
+        if (bulkKeys.find(key) != bulkKeys.end())
+        {
+            postAclRuleBulk(consumer, bulkContexts);
+            bulkKeys.clear();
+        }
+
+        auto stale = m_staleAclRules.find(key);
+        if (stale != m_staleAclRules.end())
+        {
+            if (!removeStaleAclRules(stale->second))
+            {
+                it++;
+                continue;
+            }
+            m_staleAclRules.erase(stale);
+        }
+
         SWSS_LOG_INFO("OP: %s, TABLE_ID: %s, RULE_ID: %s", op.c_str(), table_id.c_str(), rule_id.c_str());
 
         if (table_id.empty())
@@ -3273,6 +3549,7 @@ void AclOrch::doAclRuleTask(Consumer &consumer)
             {
                 SWSS_LOG_ERROR("Error while creating ACL rule %s: %s", rule_id.c_str(), e.what());
                 it = consumer.m_toSync.erase(it);
+                postAclRuleBulk(consumer, bulkContexts);
                 return;
             }
 
@@ -3306,7 +3583,17 @@ void AclOrch::doAclRuleTask(Consumer &consumer)
             // validate and create ACL rule
             if (bAllAttributesOk && newRule->validate())
             {
-                if (addAclRule(newRule, table_id))
+                auto &table = m_AclTables[table_oid];
+                auto rule_it = table.rules.find(rule_id);
+                shared_ptr<AclRule> replaced = rule_it != table.rules.end() ? rule_it->second : nullptr;
+
+                if (newRule->isBulkSupported() && (!replaced || replaced->isBulkSupported()))
+                {
+                    bulkContexts.push_back({ it, &table, newRule, replaced, false });
+                    bulkKeys.insert(key);
+                    it++;
+                }
+                else if (addAclRule(newRule, table_id))
                     it = consumer.m_toSync.erase(it);
                 else
                     it++;
@@ -3319,7 +3606,15 @@ void AclOrch::doAclRuleTask(Consumer &consumer)
         }
         else if (op == DEL_COMMAND)
         {
-            if (removeAclRule(table_id, rule_id))
+            AclRule *rule = getAclRule(table_id, rule_id);
+            if (rule && rule->isBulkSupported())
+            {
+                auto &table = m_AclTables[getTableById(table_id)];
+                bulkContexts.push_back({ it, &table, nullptr, table.rules[rule_id], false });
+                bulkKeys.insert(key);
+                it++;
+            }
+            else if (removeAclRule(table_id, rule_id))
                 it = consumer.m_toSync.erase(it);
             else
                 it++;
@@ -3330,6 +3625,147 @@ void AclOrch::doAclRuleTask(Consumer &consumer)
             SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
         }
     }
+
+    postAclRuleBulk(consumer, bulkContexts);
+}
+
+/*
+ * Programs the rule tasks collected by doAclRuleTask(), make before break: the
+ * new rules are created first, then the rules they replace and the deleted
+ * rules are removed, so that an updated rule is never missing from hardware.
+ * When a new rule can not be created next to the one it replaces, it replaces
+ * it in place as AclTable::add() does. Tasks which failed are left to retry,
+ * along with the replaced rules which could not be removed.
+ */
+void AclOrch::postAclRuleBulk(Consumer &consumer, vector<AclRuleBulkContext> &contexts)
+{
+    SWSS_LOG_ENTER();
+
+    if (contexts.empty())
+    {
+        return;
+    }
+
+    vector<AclRule *> creating;
+    vector<AclRuleBulkContext *> creatingContexts;
+    for (auto &ctx : contexts)
+    {
+        if (ctx.rule)
+        {
+            creating.push_back(ctx.rule.get());
+            creatingContexts.push_back(&ctx);
+        }
+    }
+
+    auto created = bulkCreateAclRules(creating);
+    for (size_t i = 0; i < creating.size(); i++)
+    {
+        auto &ctx = *creatingContexts[i];
+        string rule_id = ctx.rule->getId();
+
+        if (created[i])
+        {
+            ctx.table->rules[rule_id] = ctx.rule;
+            ctx.done = true;
+            SWSS_LOG_NOTICE("Successfully created ACL rule %s in table %s",
+                    rule_id.c_str(), ctx.table->id.c_str());
+        }
+        else if (ctx.replaced)
+        {
+            SWSS_LOG_NOTICE("Replacing ACL rule %s in table %s in place",
+                    rule_id.c_str(), ctx.table->id.c_str());
+            ctx.done = ctx.table->add(ctx.rule);
+            ctx.replaced = nullptr;
+        }
+        else
+        {
+            SWSS_LOG_ERROR("Failed to create ACL rule %s in table %s",
+                    rule_id.c_str(), ctx.table->id.c_str());
+        }
+    }
+
+    vector<AclRule *> removing;
+    vector<AclRuleBulkContext *> removingContexts;
+    for (auto &ctx : contexts)
+    {
+        if (ctx.replaced && (!ctx.rule || ctx.done))
+        {
+            removing.push_back(ctx.replaced.get());
+            removingContexts.push_back(&ctx);
+        }
+    }
+
+    auto removed = bulkRemoveAclRules(removing);
+    for (size_t i = 0; i < removing.size(); i++)
+    {
+        auto &ctx = *removingContexts[i];
+        string rule_id = ctx.replaced->getId();
+
+        if (!removed[i])
+        {
+            SWSS_LOG_ERROR("Failed to delete ACL rule %s in table %s",
+                    rule_id.c_str(), ctx.table->id.c_str());
+            if (ctx.rule)
+            {
+                // The new rule is in place, the task is kept to retry removing the replaced one
+                m_staleAclRules[kfvKey(ctx.task->second)].push_back(ctx.replaced);
+                ctx.done = false;
+            }
+            continue;
+        }
+
+        if (!ctx.rule)
+        {
+            ctx.table->rules.erase(rule_id);
+            ctx.done = true;
+        }
+        SWSS_LOG_NOTICE("Successfully deleted ACL rule %s in table %s",
+                rule_id.c_str(), ctx.table->id.c_str());
+    }
+
+    for (auto &ctx : contexts)
+    {
+        if (ctx.done)
+        {
+            consumer.m_toSync.erase(ctx.task);
+        }
+    }
+
+    contexts.clear();
+}
+
+/*
+ * Removes the replaced rules left behind by postAclRuleBulk(), returns true once
+ * none is left. The task of the rule is then handled again from scratch.
+ */
+bool AclOrch::removeStaleAclRules(vector<shared_ptr<AclRule>> &rules)
+{
+    SWSS_LOG_ENTER();
+
+    vector<AclRule *> removing;
+    for (auto &rule : rules)
+    {
+        removing.push_back(rule.get());
+    }
+
+    auto removed = bulkRemoveAclRules(removing);
+
+    vector<shared_ptr<AclRule>> left;
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        if (removed[i])
+        {
+            SWSS_LOG_NOTICE("Successfully deleted replaced ACL rule %s in table %s",
+                    rules[i]->getId().c_str(), rules[i]->getTableId().c_str());
+        }
+        else
+        {
+            left.push_back(rules[i]);
+        }
+    }
+
+    rules.swap(left);
+    return rules.empty();
 }
 
 bool AclOrch::processAclTablePorts(string portList, AclTable &aclTable)
@@ -3419,7 +3855,7 @@ bool AclOrch::processAclTableStage(string stage, acl_stage_type_t &acl_stage)
     return true;
 }
 
-sai_object_id_t AclOrch::getTableById(string table_id)
+sai_object_id_t AclOrch::getTableById(const string &table_id)
 {
     SWSS_LOG_ENTER();
 
@@ -3429,12 +3865,10 @@ sai_object_id_t AclOrch::getTableById(string table_id)
         return SAI_NULL_OBJECT_ID;
     }
 
-    for (auto it : m_AclTables)
+    auto it = m_AclTableIds.find(table_id);
+    if (it != m_AclTableIds.end())
     {
-        if (it.second.id == table_id)
-        {
-            return it.first;
-        }
+        return it->second;
     }
 
     // Check if the table is a mirror table and a sibling mirror table is created
@@ -3468,6 +3902,24 @@ const AclTable *AclOrch::getTableByOid(sai_object_id_t oid) const
    return &it->second;
 }
 
+void AclOrch::insertAclTable(sai_object_id_t table_oid, const AclTable &aclTable)
+{
+    m_AclTables[table_oid] = aclTable;
+    m_AclTableIds[aclTable.id] = table_oid;
+}
+
+void AclOrch::eraseAclTable(sai_object_id_t table_oid)
+{
+    auto it = m_AclTables.find(table_oid);
+    if (it == m_AclTables.end())
+    {
+        return;
+    }
+
+    m_AclTableIds.erase(it->second.id);
+    m_AclTables.erase(it);
+}
+
 bool AclOrch::createBindAclTable(AclTable &aclTable, sai_object_id_t &table_oid)
 {
     SWSS_LOG_ENTER();
@@ -3501,28 +3953,139 @@ sai_status_t AclOrch::deleteUnbindAclTable(sai_object_id_t table_oid)
     return sai_acl_api->remove_acl_table(table_oid);
 }
 
-void AclOrch::doTask(SelectableTimer &timer)
+bool AclOrch::isFlexCounterRule(AclRule &rule) const
+{
+    return m_flexCounterManager && rule.isFlexCounterSupported() && rule.getCounterOid() != SAI_NULL_OBJECT_ID;
+}
+
+void AclOrch::registerRuleCounter(AclRule &rule)
 {
     SWSS_LOG_ENTER();
 
-    for (auto& table_it : m_AclTables)
+    if (!isFlexCounterRule(rule))
+    {
+        return;
+    }
+
+    static const unordered_set<string> counterStats = {
+        "SAI_ACL_COUNTER_ATTR_PACKETS",
+        "SAI_ACL_COUNTER_ATTR_BYTES"
+    };
+
+    m_flexCounterManager->setCounterIdList(rule.getCounterOid(), CounterType::ACL_COUNTER, counterStats);
+
+    vector<FieldValueTuple> fvs = {
+        { rule.getTableId() + ":" + rule.getId(), sai_serialize_object_id(rule.getCounterOid()) }
+    };
+    m_counterRuleMapTable.set("", fvs);
+}
+
+void AclOrch::deregisterRuleCounter(AclRule &rule)
+{
+    SWSS_LOG_ENTER();
+
+    string key = rule.getTableId() + ":" + rule.getId();
+    bool flexCounter = isFlexCounterRule(rule);
+
+    if (flexCounter)
     {
-        vector<swss::FieldValueTuple> values;
+        m_flexCounterManager->clearCounterIdList(rule.getCounterOid());
+    }
+
+    // A rule replaced make before break shares its records with the rule replacing it
+    AclRule *current = getAclRule(rule.getTableId(), rule.getId());
+    if (current && current != &rule)
+    {
+        return;
+    }
 
-        for (auto rule_it : table_it.second.rules)
+    if (flexCounter)
+    {
+        m_counterRuleMapTable.hdel("", key);
+    }
+
+    SWSS_LOG_INFO("Removing record about the counter %" PRIx64 " from the DB", rule.getCounterOid());
+    m_countersTable.del(key);
+    m_lastCounters.erase(key);
+}
+
+/*
+ * Publish the counters of the rules under COUNTERS:<table>:<rule>. They are
+ * read from SAI, or from the stats syncd polled under COUNTERS:<counter oid>
+ * for the rules on flex counters. Only the counters which changed since the
+ * last poll are written, in one pipeline.
+ */
+void AclOrch::doTask(SelectableTimer &timer)
+{
+    SWSS_LOG_ENTER();
+
+    size_t written = 0;
+
+    for (const auto& table_it : m_AclTables)
+    {
+        for (const auto& rule_it : table_it.second.rules)
         {
-            AclRuleCounters cnt = rule_it.second->getCounters();
+            const auto& rule = rule_it.second;
+
+            AclRuleCounters cnt;
+            if (!isFlexCounterRule(*rule))
+            {
+                cnt = rule->getCounters();
+            }
+            else if (!getFlexCounters(*rule, cnt))
+            {
+                continue;
+            }
+
+            string key = rule->getTableId() + ":" + rule->getId();
 
-            swss::FieldValueTuple fvtp("Packets", to_string(cnt.packets));
-            values.push_back(fvtp);
-            swss::FieldValueTuple fvtb("Bytes", to_string(cnt.bytes));
-            values.push_back(fvtb);
+            auto last_it = m_lastCounters.find(key);
+            if (last_it != m_lastCounters.end() && last_it->second == cnt)
+            {
+                continue;
+            }
 
-            AclOrch::getCountersTable().set(rule_it.second->getTableId() + ":"
-                    + rule_it.second->getId(), values, "");
+            vector<swss::FieldValueTuple> values = {
+                { "Packets", to_string(cnt.packets) },
+                { "Bytes", to_string(cnt.bytes) }
+            };
+            m_countersBatchTable.set(key, values, "");
+            m_lastCounters[key] = cnt;
+            written++;
         }
-        values.clear();
     }
+
+    m_countersBatchTable.flush();
+
+    SWSS_LOG_DEBUG("Wrote %zu changed ACL rule counters", written);
+}
+
+/* Counters of a rule as last polled by syncd, false until they are */
+bool AclOrch::getFlexCounters(AclRule &rule, AclRuleCounters &counters)
+{
+    vector<FieldValueTuple> values;
+    if (!m_countersTable.get(sai_serialize_object_id(rule.getCounterOid()), values))
+    {
+        return false;
+    }
+
+    bool packets = false;
+    bool bytes = false;
+    for (const auto &fv : values)
+    {
+        if (fvField(fv) == "SAI_ACL_COUNTER_ATTR_PACKETS")
+        {
+            counters.packets = stoull(fvValue(fv));
+            packets = true;
+        }
+        else if (fvField(fv) == "SAI_ACL_COUNTER_ATTR_BYTES")
+        {
+            counters.bytes = stoull(fvValue(fv));
+            bytes = true;
+        }
+    }
+
+    return packets && bytes;
 }
 
 sai_status_t AclOrch::bindAclTable(AclTable &aclTable, bool bind)
@@ -3633,7 +4196,7 @@ sai_status_t AclOrch::createDTelWatchListTables()
     }
 
     gCrmOrch->incCrmAclUsedCounter(CrmResourceType::CRM_ACL_TABLE, SAI_ACL_STAGE_INGRESS, SAI_ACL_BIND_POINT_TYPE_SWITCH);
-    m_AclTables[table_oid] = flowWLTable;
+    insertAclTable(table_oid, flowWLTable);
     SWSS_LOG_INFO("Successfully created ACL table %s, oid: %" PRIx64, flowWLTable.description.c_str(), table_oid);
 
     /* Create Drop watchlist ACL table */
@@ -3697,7 +4260,7 @@ sai_status_t AclOrch::createDTelWatchListTables()
     }
 
     gCrmOrch->incCrmAclUsedCounter(CrmResourceType::CRM_ACL_TABLE, SAI_ACL_STAGE_INGRESS, SAI_ACL_BIND_POINT_TYPE_SWITCH);
-    m_AclTables[table_oid] = dropWLTable;
+    insertAclTable(table_oid, dropWLTable);
     SWSS_LOG_INFO("Successfully created ACL table %s, oid: %" PRIx64, dropWLTable.description.c_str(), table_oid);
 
     return SAI_STATUS_SUCCESS;
@@ -3732,7 +4295,7 @@ sai_status_t AclOrch::deleteDTelWatchListTables()
     }
 
     gCrmOrch->decCrmAclUsedCounter(CrmResourceType::CRM_ACL_TABLE, SAI_ACL_STAGE_INGRESS, SAI_ACL_BIND_POINT_TYPE_SWITCH, table_oid);
-    m_AclTables.erase(table_oid);
+    eraseAclTable(table_oid);
 
     table_id = TABLE_TYPE_DTEL_DROP_WATCHLIST;
 
@@ -3755,7 +4318,7 @@ sai_status_t AclOrch::deleteDTelWatchListTables()
     }
 
     gCrmOrch->decCrmAclUsedCounter(CrmResourceType::CRM_ACL_TABLE, SAI_ACL_STAGE_INGRESS, SAI_ACL_BIND_POINT_TYPE_SWITCH, table_oid);
-    m_AclTables.erase(table_oid);
+    eraseAclTable(table_oid);
 
     return SAI_STATUS_SUCCESS;
 }
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <tuple>
 #include <map>
+#include <unordered_map>
 #include <condition_variable>
 
 #include "orch.h"
@@ -17,12 +18,19 @@
 #include "observer.h"
 
 #include "acltable.h"
+#include "bulker.h"
+#include "flex_counter_manager.h"
+#include "redispipeline.h"
 
 // ACL counters update interval in the DB
 // Value is in seconds. Should not be less than 5 seconds
 // (in worst case update of 1265 counters takes almost 5 sec)
 #define COUNTERS_READ_INTERVAL 10
 
+// ACL counters polled by syncd, and the map of the rules to their counter
+#define ACL_COUNTER_FLEX_COUNTER_GROUP "ACL_STAT_COUNTER"
+#define ACL_COUNTER_RULE_MAP "ACL_COUNTER_RULE_MAP"
+
 #define RULE_PRIORITY           "PRIORITY"
 #define MATCH_IN_PORTS          "IN_PORTS"
 #define MATCH_OUT_PORTS         "OUT_PORTS"
@@ -143,12 +151,24 @@ struct AclRuleCounters
     {
     }
 
+    AclRuleCounters& operator =(const AclRuleCounters& rhs)
+    {
+        packets = rhs.packets;
+        bytes = rhs.bytes;
+        return *this;
+    }
+
     AclRuleCounters& operator +=(const AclRuleCounters& rhs)
     {
         packets += rhs.packets;
         bytes += rhs.bytes;
         return *this;
     }
+
+    bool operator ==(const AclRuleCounters& rhs) const
+    {
+        return packets == rhs.packets && bytes == rhs.bytes;
+    }
 };
 
 class AclRule
@@ -169,9 +189,32 @@ public:
     virtual bool create();
     virtual bool remove();
     virtual void update(SubjectType, void *) = 0;
+
+    /*
+     * Creation and removal through the ACL bulkers, for the rules which do not
+     * override create() and remove(). AclOrch flushes the bulkers between the
+     * phases: counters are created before the entries which reference them,
+     * and removed after them.
+     */
+    virtual bool isBulkSupported() const
+    {
+        return true;
+    }
+    void createCounterPre(ObjectBulker<sai_acl_api_t> &counterBulker);
+    bool createPre(ObjectBulker<sai_acl_api_t> &entryBulker);
+    bool createPost();
+    void removePre(ObjectBulker<sai_acl_api_t> &entryBulker);
+    bool removeCounterPre(ObjectBulker<sai_acl_api_t> &counterBulker);
+    bool removePost();
     virtual void updateInPorts();
     virtual AclRuleCounters getCounters();
 
+    // Whether the counter of the rule is polled by syncd, else AclOrch polls it
+    virtual bool isFlexCounterSupported() const
+    {
+        return true;
+    }
+
     string getId()
     {
         return m_id;
@@ -200,6 +243,9 @@ protected:
     virtual bool removeCounter();
     virtual bool removeRanges();
 
+    vector<sai_attribute_t> getCounterAttributes() const;
+    bool getEntryAttributes(vector<sai_attribute_t> &rule_attrs);
+
     void decreaseNextHopRefCount();
 
     bool isActionSupported(sai_acl_entry_attr_t) const;
@@ -222,6 +268,12 @@ protected:
     vector<sai_object_id_t> m_inPorts;
     vector<sai_object_id_t> m_outPorts;
 
+    // Ranges of the entry, referenced by its attributes until it is created
+    sai_object_id_t m_rangeOids[2];
+    uint32_t m_rangeCount;
+
+    sai_status_t m_bulkStatus = SAI_STATUS_SUCCESS;
+
 private:
     bool m_createCounter;
 };
@@ -269,8 +321,17 @@ public:
     bool validate();
     bool create();
     bool remove();
+    bool isBulkSupported() const
+    {
+        return false;
+    }
     void update(SubjectType, void *);
     AclRuleCounters getCounters();
+    // Counters are kept across the mirror session changes
+    bool isFlexCounterSupported() const
+    {
+        return false;
+    }
 
 protected:
     bool m_state {false};
@@ -287,6 +348,10 @@ public:
     bool validate();
     bool create();
     bool remove();
+    bool isBulkSupported() const
+    {
+        return false;
+    }
     void update(SubjectType, void *);
 
 protected:
@@ -388,7 +453,7 @@ public:
     ~AclOrch();
     void update(SubjectType, void *);
 
-    sai_object_id_t getTableById(string table_id);
+    sai_object_id_t getTableById(const string &table_id);
     const AclTable* getTableByOid(sai_object_id_t oid) const;
 
     static swss::Table& getCountersTable()
@@ -410,6 +475,16 @@ public:
     bool updateAclRule(string table_id, string rule_id, string attr_name, void *data, bool oper);
     AclRule* getAclRule(string table_id, string rule_id);
 
+    // Register the counter of a rule to be polled, remove its counters from the DB
+    void registerRuleCounter(AclRule &rule);
+    void deregisterRuleCounter(AclRule &rule);
+    // Whether the counter of the rule is polled by syncd, only with flex counters enabled
+    bool isFlexCounterRule(AclRule &rule) const;
+
+    // Create or remove rules supporting bulk, returns which of them succeeded
+    vector<bool> bulkCreateAclRules(const vector<AclRule *> &rules);
+    vector<bool> bulkRemoveAclRules(const vector<AclRule *> &rules);
+
     bool isCombinedMirrorV6Table();
     bool isAclActionSupported(acl_stage_type_t stage, sai_acl_action_type_t action) const;
     bool isAclActionEnumValueSupported(sai_acl_action_type_t action, sai_acl_action_parameter_t param) const;
@@ -423,17 +498,30 @@ public:
     static bool getAclBindPortId(Port& port, sai_object_id_t& port_id);
 
     using Orch::doTask;  // Allow access to the basic doTask
-    map<sai_object_id_t, AclTable>  getAclTables()
+    const map<sai_object_id_t, AclTable> &getAclTables() const
     {
         return m_AclTables;
     }
 
 private:
+    // A rule task handled in bulk: rule is created, then replaced is removed
+    struct AclRuleBulkContext
+    {
+        SyncMap::iterator task;
+        AclTable *table;
+        shared_ptr<AclRule> rule;
+        shared_ptr<AclRule> replaced;
+        bool done;
+    };
+
     SwitchOrch *m_switchOrch;
     void doTask(Consumer &consumer);
     void doAclTableTask(Consumer &consumer);
     void doAclRuleTask(Consumer &consumer);
+    void postAclRuleBulk(Consumer &consumer, vector<AclRuleBulkContext> &contexts);
+    bool removeStaleAclRules(vector<shared_ptr<AclRule>> &rules);
     void doTask(SelectableTimer &timer);
+    bool getFlexCounters(AclRule &rule, AclRuleCounters &counters);
     void init(vector<TableConnector>& connectors, PortsOrch *portOrch, MirrorOrch *mirrorOrch, NeighOrch *neighOrch, RouteOrch *routeOrch);
 
     void queryMirrorTableCapability();
@@ -466,7 +554,19 @@ private:
     sai_status_t createDTelWatchListTables();
     sai_status_t deleteDTelWatchListTables();
 
+    void insertAclTable(sai_object_id_t table_oid, const AclTable &aclTable);
+    void eraseAclTable(sai_object_id_t table_oid);
+
+    ObjectBulker<sai_acl_api_t> m_aclCounterBulker;
+    ObjectBulker<sai_acl_api_t> m_aclEntryBulker;
+
+    // Replaced rules which failed to be removed, by rule task key. The task is
+    // kept and they are removed again before it is handled again.
+    map<string, vector<shared_ptr<AclRule>>> m_staleAclRules;
+
     map<sai_object_id_t, AclTable> m_AclTables;
+    // Table oid by table id, kept along with m_AclTables
+    unordered_map<string, sai_object_id_t> m_AclTableIds;
     // TODO: Move all ACL tables into one map: name -> instance
     map<string, AclTable> m_ctrlAclTables;
 
@@ -475,6 +575,15 @@ private:
     static bool m_bCollectCounters;
     static DBConnector m_db;
     static Table m_countersTable;
+    static Table m_counterRuleMapTable;
+
+    // ACL_STAT_COUNTER group, only when orchagent is started with the ACL flex counters
+    unique_ptr<FlexCounterManager> m_flexCounterManager;
+
+    // Counters of the rules written by the timer, written again only when changed
+    RedisPipeline m_countersPipeline;
+    Table m_countersBatchTable;
+    unordered_map<string, AclRuleCounters> m_lastCounters;
 
     map<acl_stage_type_t, string> m_mirrorTableId;
     map<acl_stage_type_t, string> m_mirrorV6TableId;
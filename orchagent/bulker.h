@@ -1,10 +1,13 @@
 #pragma once
 
 #include <assert.h>
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <stdexcept>
+#include <future>
+#include <utility>
 #include <boost/functional/hash.hpp>
 #include <sairedis.h>
 #include "sai.h"
@@ -41,6 +44,55 @@ static inline bool operator==(const sai_route_entry_t& a, const sai_route_entry_
         ;
 }
 
+static inline bool operator==(const sai_ip_address_t& a, const sai_ip_address_t& b)
+{
+    if (a.addr_family != b.addr_family) return false;
+
+    if (a.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        return a.addr.ip4 == b.addr.ip4;
+    }
+    else if (a.addr_family == SAI_IP_ADDR_FAMILY_IPV6)
+    {
+        return memcmp(a.addr.ip6, b.addr.ip6, sizeof(a.addr.ip6)) == 0;
+    }
+    else
+    {
+        throw std::invalid_argument("a has invalid addr_family");
+    }
+}
+
+static inline bool operator==(const sai_neighbor_entry_t& a, const sai_neighbor_entry_t& b)
+{
+    return a.switch_id == b.switch_id
+        && a.rif_id == b.rif_id
+        && a.ip_address == b.ip_address
+        ;
+}
+
+static inline bool operator==(const sai_fdb_entry_t& a, const sai_fdb_entry_t& b)
+{
+    return a.switch_id == b.switch_id
+        && a.bv_id == b.bv_id
+        && memcmp(a.mac_address, b.mac_address, sizeof(a.mac_address)) == 0
+        ;
+}
+
+static inline std::size_t hash_value(const sai_ip_address_t& a)
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, a.addr_family);
+    if (a.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        boost::hash_combine(seed, a.addr.ip4);
+    }
+    else if (a.addr_family == SAI_IP_ADDR_FAMILY_IPV6)
+    {
+        boost::hash_combine(seed, a.addr.ip6);
+    }
+    return seed;
+}
+
 static inline std::size_t hash_value(const sai_ip_prefix_t& a)
 {
     size_t seed = 0;
@@ -73,6 +125,19 @@ namespace std
         }
     };
 
+    template <>
+    struct hash<sai_neighbor_entry_t>
+    {
+        size_t operator()(const sai_neighbor_entry_t& a) const noexcept
+        {
+            size_t seed = 0;
+            boost::hash_combine(seed, a.switch_id);
+            boost::hash_combine(seed, a.rif_id);
+            boost::hash_combine(seed, a.ip_address);
+            return seed;
+        }
+    };
+
     template <>
     struct hash<sai_fdb_entry_t>
     {
@@ -137,6 +202,19 @@ struct SaiBulkerTraits<sai_fdb_api_t>
     using bulk_set_entry_attribute_fn = sai_bulk_set_fdb_entry_attribute_fn;
 };
 
+template<>
+struct SaiBulkerTraits<sai_neighbor_api_t>
+{
+    using entry_t = sai_neighbor_entry_t;
+    using api_t = sai_neighbor_api_t;
+    using create_entry_fn = sai_create_neighbor_entry_fn;
+    using remove_entry_fn = sai_remove_neighbor_entry_fn;
+    using set_entry_attribute_fn = sai_set_neighbor_entry_attribute_fn;
+    using bulk_create_entry_fn = sai_bulk_create_neighbor_entry_fn;
+    using bulk_remove_entry_fn = sai_bulk_remove_neighbor_entry_fn;
+    using bulk_set_entry_attribute_fn = sai_bulk_set_neighbor_entry_attribute_fn;
+};
+
 template<>
 struct SaiBulkerTraits<sai_next_hop_group_api_t>
 {
@@ -151,6 +229,39 @@ struct SaiBulkerTraits<sai_next_hop_group_api_t>
     //using bulk_set_entry_attribute_fn = sai_bulk_object_set_attribute_fn;
 };
 
+template<>
+struct SaiBulkerTraits<sai_next_hop_api_t>
+{
+    using entry_t = sai_object_id_t;
+    using api_t = sai_next_hop_api_t;
+    using create_entry_fn = sai_create_next_hop_fn;
+    using remove_entry_fn = sai_remove_next_hop_fn;
+    using set_entry_attribute_fn = sai_set_next_hop_attribute_fn;
+    using bulk_create_entry_fn = sai_bulk_object_create_fn;
+    using bulk_remove_entry_fn = sai_bulk_object_remove_fn;
+    // TODO: wait until available in SAI
+    //using bulk_set_entry_attribute_fn = sai_bulk_object_set_attribute_fn;
+};
+
+/*
+ * The ACL API has no bulk functions of its own: ObjectBulker<sai_acl_api_t>
+ * handles one object type, ACL counters or ACL entries, and flushes it with the
+ * generic sai_bulk_object_create() and sai_bulk_object_remove(). When the SAI
+ * does not implement them for the type, its objects are created and removed one
+ * at a time.
+ */
+template<>
+struct SaiBulkerTraits<sai_acl_api_t>
+{
+    using entry_t = sai_object_id_t;
+    using api_t = sai_acl_api_t;
+    using create_entry_fn = sai_create_acl_entry_fn;
+    using remove_entry_fn = sai_remove_acl_entry_fn;
+    using set_entry_attribute_fn = sai_set_acl_entry_attribute_fn;
+    using bulk_create_entry_fn = sai_bulk_object_create_fn;
+    using bulk_remove_entry_fn = sai_bulk_object_remove_fn;
+};
+
 template <typename T>
 class EntityBulker
 {
@@ -408,9 +519,14 @@ private:
 
     size_t max_bulk_size;
 
-    typename Ts::bulk_create_entry_fn                       create_entries;
-    typename Ts::bulk_remove_entry_fn                       remove_entries;
-    typename Ts::bulk_set_entry_attribute_fn                set_entries_attribute;
+    typename Ts::bulk_create_entry_fn                       create_entries = nullptr;
+    typename Ts::bulk_remove_entry_fn                       remove_entries = nullptr;
+    typename Ts::bulk_set_entry_attribute_fn                set_entries_attribute = nullptr;
+
+    // Used one entry at a time when the bulk API is not available
+    typename Ts::create_entry_fn                            create_single_entry = nullptr;
+    typename Ts::remove_entry_fn                            remove_single_entry = nullptr;
+    typename Ts::set_entry_attribute_fn                     set_single_entry_attribute = nullptr;
 
     sai_status_t flush_removing_entries(
         _Inout_ std::vector<Te> &rs)
@@ -421,7 +537,19 @@ private:
         }
         size_t count = rs.size();
         std::vector<sai_status_t> statuses(count);
-        sai_status_t status = (*remove_entries)((uint32_t)count, rs.data(), SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses.data());
+        sai_status_t status = SAI_STATUS_SUCCESS;
+        if (remove_entries)
+        {
+            status = (*remove_entries)((uint32_t)count, rs.data(), SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses.data());
+        }
+        else
+        {
+            for (size_t ir = 0; ir < count; ir++)
+            {
+                statuses[ir] = (*remove_single_entry)(&rs[ir]);
+                if (statuses[ir] != SAI_STATUS_SUCCESS) status = SAI_STATUS_FAILURE;
+            }
+        }
         if (status == SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_INFO("EntityBulker.flush removing_entries %zu\n", count);
@@ -458,8 +586,20 @@ private:
         }
         size_t count = rs.size();
         std::vector<sai_status_t> statuses(count);
-        sai_status_t status = (*create_entries)((uint32_t)count, rs.data(), cs.data(), tss.data()
-            , SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses.data());
+        sai_status_t status = SAI_STATUS_SUCCESS;
+        if (create_entries)
+        {
+            status = (*create_entries)((uint32_t)count, rs.data(), cs.data(), tss.data()
+                , SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses.data());
+        }
+        else
+        {
+            for (size_t ir = 0; ir < count; ir++)
+            {
+                statuses[ir] = (*create_single_entry)(&rs[ir], cs[ir], tss[ir]);
+                if (statuses[ir] != SAI_STATUS_SUCCESS) status = SAI_STATUS_FAILURE;
+            }
+        }
         if (status == SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_INFO("EntityBulker.flush creating_entries %zu\n", count);
@@ -498,8 +638,20 @@ private:
         }
         size_t count = rs.size();
         std::vector<sai_status_t> statuses(count);
-        sai_status_t status = (*set_entries_attribute)((uint32_t)count, rs.data(), ts.data()
-            , SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses.data());
+        sai_status_t status = SAI_STATUS_SUCCESS;
+        if (set_entries_attribute)
+        {
+            status = (*set_entries_attribute)((uint32_t)count, rs.data(), ts.data()
+                , SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses.data());
+        }
+        else
+        {
+            for (size_t ir = 0; ir < count; ir++)
+            {
+                statuses[ir] = (*set_single_entry_attribute)(&rs[ir], &ts[ir]);
+                if (statuses[ir] != SAI_STATUS_SUCCESS) status = SAI_STATUS_FAILURE;
+            }
+        }
         if (status == SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_INFO("EntityBulker.flush setting_entries, count %zu\n", count);
@@ -537,17 +689,28 @@ inline EntityBulker<sai_route_api_t>::EntityBulker(sai_route_api_t *api, size_t
     set_entries_attribute = api->set_route_entries_attribute;
 }
 
+template <>
+inline EntityBulker<sai_neighbor_api_t>::EntityBulker(sai_neighbor_api_t *api, size_t max_bulk_size) :
+    max_bulk_size(max_bulk_size)
+{
+    create_entries = api->create_neighbor_entries;
+    remove_entries = api->remove_neighbor_entries;
+    set_entries_attribute = api->set_neighbor_entries_attribute;
+}
+
 template <>
 inline EntityBulker<sai_fdb_api_t>::EntityBulker(sai_fdb_api_t *api, size_t max_bulk_size) :
     max_bulk_size(max_bulk_size)
 {
-    // TODO: implement after create_fdb_entries() is available in SAI
-    throw std::logic_error("Not implemented");
+    // TODO: use create_fdb_entries() after it is available in SAI
     /*
     create_entries = api->create_fdb_entries;
     remove_entries = api->remove_fdb_entries;
     set_entries_attribute = api->set_fdb_entries_attribute;
     */
+    create_single_entry = api->create_fdb_entry;
+    remove_single_entry = api->remove_fdb_entry;
+    set_single_entry_attribute = api->set_fdb_entry_attribute;
 }
 
 template <typename T>
@@ -562,6 +725,13 @@ public:
         throw std::logic_error("Not implemented");
     }
 
+    // For the APIs handling several object types
+    ObjectBulker(typename Ts::api_t* api, sai_object_id_t switch_id, size_t max_bulk_size, sai_object_type_t object_type) :
+        max_bulk_size(max_bulk_size)
+    {
+        throw std::logic_error("Not implemented");
+    }
+
     sai_status_t create_entry(
         _Out_ sai_object_id_t *object_id,
         _In_ uint32_t attr_count,
@@ -764,11 +934,32 @@ private:
                                                             // object_id -> object_status
     std::unordered_map<sai_object_id_t, sai_status_t *>     removing_entries;
 
-    typename Ts::bulk_create_entry_fn                       create_entries;
-    typename Ts::bulk_remove_entry_fn                       remove_entries;
+    typename Ts::bulk_create_entry_fn                       create_entries = nullptr;
+    typename Ts::bulk_remove_entry_fn                       remove_entries = nullptr;
     // TODO: wait until available in SAI
     //typename Ts::bulk_set_entry_attribute_fn                set_entries_attribute;
 
+    // Object type flushed with the generic bulk object API, if any
+    sai_object_type_t                                       bulk_object_type = SAI_OBJECT_TYPE_NULL;
+
+    // Used one object at a time when the bulk API is not available
+    typename Ts::create_entry_fn                            create_single_entry = nullptr;
+    typename Ts::remove_entry_fn                            remove_single_entry = nullptr;
+
+    // Falls back to one object at a time if the generic bulk object API is not implemented
+    bool bulk_object_supported(sai_status_t status)
+    {
+        if (status != SAI_STATUS_NOT_IMPLEMENTED && status != SAI_STATUS_NOT_SUPPORTED)
+        {
+            return true;
+        }
+
+        SWSS_LOG_NOTICE("ObjectBulker: bulk API not supported for %s, using one call per object",
+                        sai_serialize_object_type(bulk_object_type).c_str());
+        bulk_object_type = SAI_OBJECT_TYPE_NULL;
+        return false;
+    }
+
     sai_status_t flush_removing_entries(
         _Inout_ std::vector<sai_object_id_t> &rs)
     {
@@ -778,7 +969,29 @@ private:
         }
         size_t count = rs.size();
         std::vector<sai_status_t> statuses(count);
-        sai_status_t status = (*remove_entries)((uint32_t)count, rs.data(), SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, statuses.data());
+        sai_status_t status = SAI_STATUS_SUCCESS;
+        bool bulked = false;
+        if (remove_entries)
+        {
+            status = (*remove_entries)((uint32_t)count, rs.data(), SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, statuses.data());
+            bulked = true;
+        }
+        else if (bulk_object_type != SAI_OBJECT_TYPE_NULL)
+        {
+            // The statuses are left as is when the call fails before any object is handled
+            std::fill(statuses.begin(), statuses.end(), SAI_STATUS_NOT_EXECUTED);
+            status = sai_bulk_object_remove(bulk_object_type, (uint32_t)count, rs.data(), SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, statuses.data());
+            bulked = bulk_object_supported(status);
+        }
+        if (!bulked)
+        {
+            status = SAI_STATUS_SUCCESS;
+            for (size_t ir = 0; ir < count; ir++)
+            {
+                statuses[ir] = (*remove_single_entry)(rs[ir]);
+                if (statuses[ir] != SAI_STATUS_SUCCESS) status = SAI_STATUS_FAILURE;
+            }
+        }
         if (status == SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_INFO("ObjectBulker.flush removing_entries %zu rc=%d statuses[0]=%d\n", removing_entries.size(), status, statuses[0]);
@@ -813,8 +1026,30 @@ private:
         size_t count = rs.size();
         std::vector<sai_object_id_t> object_ids(count);
         std::vector<sai_status_t> statuses(count);
-        sai_status_t status = (*create_entries)(switch_id, (uint32_t)count, cs.data(), tss.data()
-            , SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, object_ids.data(), statuses.data());
+        sai_status_t status = SAI_STATUS_SUCCESS;
+        bool bulked = false;
+        if (create_entries)
+        {
+            status = (*create_entries)(switch_id, (uint32_t)count, cs.data(), tss.data()
+                , SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, object_ids.data(), statuses.data());
+            bulked = true;
+        }
+        else if (bulk_object_type != SAI_OBJECT_TYPE_NULL)
+        {
+            std::fill(statuses.begin(), statuses.end(), SAI_STATUS_NOT_EXECUTED);
+            status = sai_bulk_object_create(switch_id, bulk_object_type, (uint32_t)count, cs.data(), tss.data()
+                , SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, object_ids.data(), statuses.data());
+            bulked = bulk_object_supported(status);
+        }
+        if (!bulked)
+        {
+            status = SAI_STATUS_SUCCESS;
+            for (size_t ir = 0; ir < count; ir++)
+            {
+                statuses[ir] = (*create_single_entry)(&object_ids[ir], switch_id, cs[ir], tss[ir]);
+                if (statuses[ir] != SAI_STATUS_SUCCESS) status = SAI_STATUS_FAILURE;
+            }
+        }
         if (status == SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_INFO("ObjectBulker.flush creating_entries %zu\n", count);
@@ -880,3 +1115,89 @@ inline ObjectBulker<sai_next_hop_group_api_t>::ObjectBulker(SaiBulkerTraits<sai_
     // TODO: wait until available in SAI
     //set_entries_attribute = ;
 }
+
+template <>
+inline ObjectBulker<sai_next_hop_api_t>::ObjectBulker(SaiBulkerTraits<sai_next_hop_api_t>::api_t *api, sai_object_id_t switch_id, size_t max_bulk_size) :
+    switch_id(switch_id),
+    max_bulk_size(max_bulk_size)
+{
+    create_entries = api->create_next_hops;
+    remove_entries = api->remove_next_hops;
+    // TODO: wait until available in SAI
+    //set_entries_attribute = ;
+}
+
+template <>
+inline ObjectBulker<sai_acl_api_t>::ObjectBulker(SaiBulkerTraits<sai_acl_api_t>::api_t *api, sai_object_id_t switch_id, size_t max_bulk_size, sai_object_type_t object_type) :
+    switch_id(switch_id),
+    max_bulk_size(max_bulk_size),
+    bulk_object_type(object_type)
+{
+    switch (object_type)
+    {
+    case SAI_OBJECT_TYPE_ACL_COUNTER:
+        create_single_entry = api->create_acl_counter;
+        remove_single_entry = api->remove_acl_counter;
+        break;
+    case SAI_OBJECT_TYPE_ACL_ENTRY:
+        create_single_entry = api->create_acl_entry;
+        remove_single_entry = api->remove_acl_entry;
+        break;
+    default:
+        throw std::invalid_argument("Unsupported ACL object type");
+    }
+}
+
+/*
+ * Flushes a bulker in a worker thread, so that the next batch can be collected
+ * while the bulk calls of the previous one are in flight.
+ *
+ * dispatch() takes over the entries pending in the caller's bulker and leaves
+ * it empty for the next batch. The object statuses of the dispatched entries
+ * are written by the worker thread, they must stay valid and must not be read
+ * until wait() returns.
+ *
+ * The worker thread owns the SAI between dispatch() and wait(): the caller
+ * must not make any SAI call, nor flush another bulker, in the meantime.
+ * in_flight() tells whether a SAI call has to wait().
+ */
+template <typename B>
+class BulkPipeline
+{
+public:
+    template <typename... Args>
+    BulkPipeline(Args&&... args) :
+        bulker(std::forward<Args>(args)...)
+    {
+    }
+
+    ~BulkPipeline()
+    {
+        wait();
+    }
+
+    bool in_flight() const
+    {
+        return flushing.valid();
+    }
+
+    void dispatch(B& pending)
+    {
+        wait();
+
+        std::swap(bulker, pending);
+        flushing = std::async(std::launch::async, [this]() { bulker.flush(); });
+    }
+
+    void wait()
+    {
+        if (flushing.valid())
+        {
+            flushing.get();
+        }
+    }
+
+private:
+    B                                                       bulker;
+    std::future<void>                                       flushing;
+};
@@ -0,0 +1,192 @@
+#include <inttypes.h>
+#include "consumerbatchorch.h"
+#include "converter.h"
+#include "timer.h"
+#include "logger.h"
+
+using namespace std;
+using namespace swss;
+
+#define CONSUMER_BATCH_PUBLISH_INTERVAL_SEC 1
+
+#define MIN_BATCH_SIZE_FIELD        "min_batch_size"
+#define MAX_BATCH_SIZE_FIELD        "max_batch_size"
+#define LATENCY_BUDGET_FIELD        "latency_budget_us"
+
+ConsumerBatchOrch::ConsumerBatchOrch(DBConnector *cfgDb, DBConnector *stateDb, const vector<Orch *> &orchs) :
+    Orch(cfgDb, CFG_CONSUMER_BATCH_TABLE_NAME),
+    m_orchs(orchs),
+    m_stateTable(stateDb, STATE_CONSUMER_BATCH_TABLE_NAME)
+{
+    SWSS_LOG_ENTER();
+
+    auto interv = timespec { .tv_sec = CONSUMER_BATCH_PUBLISH_INTERVAL_SEC, .tv_nsec = 0 };
+    auto timer = new SelectableTimer(interv);
+    auto executor = new ExecutableTimer(timer, this, "CONSUMER_BATCH_PUBLISH");
+    Orch::addExecutor(executor);
+    timer->start();
+}
+
+vector<Consumer *> ConsumerBatchOrch::getConsumers(const string &tableName)
+{
+    vector<Consumer *> consumers;
+
+    for (auto *orch : m_orchs)
+    {
+        for (auto *selectable : orch->getSelectables())
+        {
+            auto *consumer = dynamic_cast<Consumer *>(selectable);
+            if (consumer && consumer->getTableName() == tableName)
+            {
+                consumers.push_back(consumer);
+            }
+        }
+    }
+
+    return consumers;
+}
+
+bool ConsumerBatchOrch::applyLimits(const string &tableName, const vector<FieldValueTuple> &data)
+{
+    SWSS_LOG_ENTER();
+
+    auto consumers = getConsumers(tableName);
+    if (consumers.empty())
+    {
+        SWSS_LOG_WARN("No consumer of table %s", tableName.c_str());
+        return true;
+    }
+
+    /* Unset limits take the defaults */
+    ConsumerBatchSizer defaults(consumers.front()->m_batchSizer.getPopSize());
+    BatchLimits limits = { defaults.getMinSize(), defaults.getMaxSize(), defaults.getLatencyBudget() };
+
+    for (const auto &fv : data)
+    {
+        const auto &field = fvField(fv);
+        const auto &value = fvValue(fv);
+
+        try
+        {
+            if (field == MIN_BATCH_SIZE_FIELD)
+            {
+                limits.minSize = to_uint<uint32_t>(value);
+            }
+            else if (field == MAX_BATCH_SIZE_FIELD)
+            {
+                limits.maxSize = to_uint<uint32_t>(value);
+            }
+            else if (field == LATENCY_BUDGET_FIELD)
+            {
+                limits.latencyBudgetUsec = to_uint<uint32_t>(value);
+            }
+            else
+            {
+                SWSS_LOG_ERROR("Unknown consumer batch attribute %s for table %s", field.c_str(), tableName.c_str());
+                return true;
+            }
+        }
+        catch (const exception& e)
+        {
+            SWSS_LOG_ERROR("Failed to parse consumer batch attribute %s for table %s: %s",
+                           field.c_str(), tableName.c_str(), e.what());
+            return true;
+        }
+    }
+
+    if (limits.minSize == 0 || limits.maxSize < limits.minSize)
+    {
+        SWSS_LOG_ERROR("Invalid batch size range [%zu, %zu] for table %s",
+                       limits.minSize, limits.maxSize, tableName.c_str());
+        return true;
+    }
+
+    for (auto *consumer : consumers)
+    {
+        consumer->m_batchSizer.setLimits(limits.minSize, limits.maxSize, limits.latencyBudgetUsec);
+    }
+    m_limits[tableName] = limits;
+
+    SWSS_LOG_NOTICE("Set batch size range [%zu, %zu], latency budget %" PRIu64 "us for table %s",
+                    limits.minSize, limits.maxSize, limits.latencyBudgetUsec, tableName.c_str());
+    return true;
+}
+
+void ConsumerBatchOrch::resetLimits(const string &tableName)
+{
+    SWSS_LOG_ENTER();
+
+    for (auto *consumer : getConsumers(tableName))
+    {
+        consumer->m_batchSizer.resetLimits();
+    }
+    m_limits.erase(tableName);
+
+    SWSS_LOG_NOTICE("Reset batch size range for table %s", tableName.c_str());
+}
+
+void ConsumerBatchOrch::doTask(Consumer &consumer)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = consumer.m_toSync.begin();
+    while (it != consumer.m_toSync.end())
+    {
+        auto &t = it->second;
+
+        const string &key = kfvKey(t);
+        const string &op = kfvOp(t);
+
+        if (op == SET_COMMAND)
+        {
+            applyLimits(key, kfvFieldsValues(t));
+        }
+        else if (op == DEL_COMMAND)
+        {
+            resetLimits(key);
+        }
+        else
+        {
+            SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
+        }
+
+        it = consumer.m_toSync.erase(it);
+    }
+}
+
+void ConsumerBatchOrch::publish(Consumer &consumer)
+{
+    const auto &sizer = consumer.m_batchSizer;
+
+    vector<FieldValueTuple> fvs = {
+        { "batch_size", to_string(sizer.getBatchSize()) },
+        { MIN_BATCH_SIZE_FIELD, to_string(sizer.getMinSize()) },
+        { MAX_BATCH_SIZE_FIELD, to_string(sizer.getMaxSize()) },
+        { LATENCY_BUDGET_FIELD, to_string(sizer.getLatencyBudget()) },
+        { "last_popped", to_string(sizer.getLastPopped()) },
+        { "last_latency_us", to_string(sizer.getLastLatency()) },
+        { "backlog", sizer.hasBacklog() ? "true" : "false" },
+        { "grow_count", to_string(sizer.getGrowCount()) },
+        { "shrink_count", to_string(sizer.getShrinkCount()) },
+    };
+
+    m_stateTable.set(consumer.getDbName() + state_db_key_delimiter + consumer.getTableName(), fvs);
+}
+
+/* Publish the consumers whose batch size or limits changed since the last run */
+void ConsumerBatchOrch::doTask(SelectableTimer &timer)
+{
+    SWSS_LOG_ENTER();
+
+    for (auto *orch : m_orchs)
+    {
+        for (auto *selectable : orch->getSelectables())
+        {
+            auto *consumer = dynamic_cast<Consumer *>(selectable);
+            if (consumer && consumer->m_batchSizer.fetchChanged())
+            {
+                publish(*consumer);
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SWSS_CONSUMERBATCHORCH_H
+#define SWSS_CONSUMERBATCHORCH_H
+
+#include <map>
+#include <memory>
+#include "orch.h"
+#include "table.h"
+
+#define CFG_CONSUMER_BATCH_TABLE_NAME       "CONSUMER_BATCH"
+#define STATE_CONSUMER_BATCH_TABLE_NAME     "CONSUMER_BATCH_TABLE"
+
+/*
+ * Applies the per table limits of the adaptive pop batch (ConsumerBatchSizer)
+ * from CONFIG_DB, and publishes the batch sizing decisions to STATE_DB.
+ *
+ * CONFIG_DB CONSUMER_BATCH|<table name>
+ *     min_batch_size, max_batch_size, latency_budget_us
+ * The limits apply to all the consumers of that table name.
+ *
+ * STATE_DB CONSUMER_BATCH_TABLE|<db name>|<table name>
+ *     batch_size, the limits and the last iteration statistics
+ */
+class ConsumerBatchOrch : public Orch
+{
+public:
+    ConsumerBatchOrch(swss::DBConnector *cfgDb, swss::DBConnector *stateDb,
+                      const std::vector<Orch *> &orchs);
+
+    void doTask(Consumer &consumer) override;
+    void doTask(swss::SelectableTimer &timer) override;
+
+private:
+    struct BatchLimits
+    {
+        size_t minSize;
+        size_t maxSize;
+        uint64_t latencyBudgetUsec;
+    };
+
+    const std::vector<Orch *> &m_orchs;
+    std::map<std::string, BatchLimits> m_limits;
+    swss::Table m_stateTable;
+
+    std::vector<Consumer *> getConsumers(const std::string &tableName);
+    bool applyLimits(const std::string &tableName, const std::vector<swss::FieldValueTuple> &data);
+    void resetLimits(const std::string &tableName);
+    void publish(Consumer &consumer);
+};
+
+#endif /* SWSS_CONSUMERBATCHORCH_H */
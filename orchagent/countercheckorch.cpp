@@ -58,12 +58,13 @@ void CounterCheckOrch::mcCounterCheck()
         auto mcCounters = i.second;
         uint8_t pfcMask = 0;
 
-        Port port;
-        if (!gPortsOrch->getPort(oid, port))
+        const Port *p = gPortsOrch->findPort(oid);
+        if (!p)
         {
             SWSS_LOG_ERROR("Invalid port oid 0x%" PRIx64, oid);
             continue;
         }
+        const Port &port = *p;
 
         auto newMcCounters = getQueueMcCounters(port);
 
@@ -106,12 +107,13 @@ void CounterCheckOrch::pfcFrameCounterCheck()
         auto newCounters = getPfcFrameCounters(oid);
         uint8_t pfcMask = 0;
 
-        Port port;
-        if (!gPortsOrch->getPort(oid, port))
+        const Port *p = gPortsOrch->findPort(oid);
+        if (!p)
         {
             SWSS_LOG_ERROR("Invalid port oid 0x%" PRIx64, oid);
             continue;
         }
+        const Port &port = *p;
 
         if (!gPortsOrch->getPortPfc(port.m_port_id, &pfcMask))
         {
@@ -18,6 +18,7 @@ extern sai_fdb_api_t    *sai_fdb_api;
 
 extern sai_object_id_t  gSwitchId;
 extern PortsOrch*       gPortsOrch;
+extern size_t           gMaxBulkSize;
 extern CrmOrch *        gCrmOrch;
 extern Directory<Orch*> gDirectory;
 
@@ -26,7 +27,8 @@ const int FdbOrch::fdborch_pri = 20;
 FdbOrch::FdbOrch(DBConnector* applDbConnector, vector<table_name_with_pri_t> appFdbTables, TableConnector stateDbFdbConnector, PortsOrch *port) :
     Orch(applDbConnector, appFdbTables),
     m_portsOrch(port),
-    m_fdbStateTable(stateDbFdbConnector.first, stateDbFdbConnector.second)
+    m_fdbStateTable(stateDbFdbConnector.first, stateDbFdbConnector.second),
+    gFdbBulker(sai_fdb_api, gMaxBulkSize)
 {
     for(auto it: appFdbTables)
     {
@@ -69,9 +71,9 @@ bool FdbOrch::storeFdbEntryState(const FdbUpdate& update)
     const Port& port = update.port;
     const MacAddress& mac = entry.mac;
     string portName = port.m_alias;
-    Port vlan;
 
-    if (!m_portsOrch->getPort(entry.bv_id, vlan))
+    const Port *vlan = m_portsOrch->findPort(entry.bv_id);
+    if (!vlan)
     {
         SWSS_LOG_NOTICE("FdbOrch notification: Failed to locate \
                          vlan port from bv_id 0x%" PRIx64, entry.bv_id);
@@ -79,7 +81,7 @@ bool FdbOrch::storeFdbEntryState(const FdbUpdate& update)
     }
 
     // ref: https://github.com/Azure/sonic-swss/blob/master/doc/swss-schema.md#fdb_table
-    string key = "Vlan" + to_string(vlan.m_vlan_info.vlan_id) + ":" + mac.to_string();
+    string key = "Vlan" + to_string(vlan->m_vlan_info.vlan_id) + ":" + mac.to_string();
 
     if (update.add)
     {
@@ -116,7 +118,7 @@ bool FdbOrch::storeFdbEntryState(const FdbUpdate& update)
         std::vector<FieldValueTuple> fvs;
         fvs.push_back(FieldValueTuple("port", portName));
         fvs.push_back(FieldValueTuple("type", update.type));
-        m_fdbStateTable.set(key, fvs);
+        setFdbEntryState(key, fvs);
 
         if (!mac_move)
         {
@@ -143,7 +145,7 @@ bool FdbOrch::storeFdbEntryState(const FdbUpdate& update)
         if (oldFdbData.origin != FDB_ORIGIN_VXLAN_ADVERTIZED)
         {
             // Remove in StateDb for non advertised mac addresses
-            m_fdbStateTable.del(key);
+            delFdbEntryState(key);
         }
 
         gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_FDB_ENTRY);
@@ -220,7 +222,7 @@ void FdbOrch::update(sai_fdb_event_t        type,
         m_portsOrch->setPort(vlan.m_alias, vlan);
 
         storeFdbEntryState(update);
-        notify(SUBJECT_TYPE_FDB_CHANGE, &update);
+        notifyFdbChange(update);
 
         break;
     }
@@ -313,7 +315,7 @@ void FdbOrch::update(sai_fdb_event_t        type,
         }
         storeFdbEntryState(update);
 
-        notify(SUBJECT_TYPE_FDB_CHANGE, &update);
+        notifyFdbChange(update);
 
         notifyTunnelOrch(update.port);
         break;
@@ -354,7 +356,7 @@ void FdbOrch::update(sai_fdb_event_t        type,
         m_portsOrch->setPort(update.port.m_alias, update.port);
         storeFdbEntryState(update);
 
-        notify(SUBJECT_TYPE_FDB_CHANGE, &update);
+        notifyFdbChange(update);
 
         notifyTunnelOrch(port_old);
 
@@ -369,15 +371,15 @@ void FdbOrch::update(sai_fdb_event_t        type,
 
         string vlanName = "-";
         if (entry->bv_id) {
-            Port vlan;
+            const Port *vlan = m_portsOrch->findPort(entry->bv_id);
 
-            if (!m_portsOrch->getPort(entry->bv_id, vlan))
+            if (!vlan)
             {
                 SWSS_LOG_NOTICE("FdbOrch notification: Failed to locate vlan\
                                 port from bv_id 0x%" PRIx64, entry->bv_id);
                 return;
             }
-            vlanName = "Vlan" + to_string(vlan.m_vlan_info.vlan_id);
+            vlanName = "Vlan" + to_string(vlan->m_vlan_info.vlan_id);
         }
 
 
@@ -401,10 +403,7 @@ void FdbOrch::update(sai_fdb_event_t        type,
 
                 storeFdbEntryState(update);
 
-                for (auto observer: m_observers)
-                {
-                    observer->update(SUBJECT_TYPE_FDB_CHANGE, &update);
-                }
+                notifyFdbChange(update);
             }
         }
         else if (entry->bv_id == SAI_NULL_OBJECT_ID)
@@ -425,10 +424,7 @@ void FdbOrch::update(sai_fdb_event_t        type,
 
                     storeFdbEntryState(update);
 
-                    for (auto observer: m_observers)
-                    {
-                        observer->update(SUBJECT_TYPE_FDB_CHANGE, &update);
-                    }
+                    notifyFdbChange(update);
                 }
                 itr = next_item;
             }
@@ -536,138 +532,198 @@ void FdbOrch::doTask(Consumer& consumer)
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
-        KeyOpFieldsValuesTuple t = it->second;
-
-        /* format: <VLAN_name>:<MAC_address> */
-        vector<string> keys = tokenize(kfvKey(t), ':', 1);
-        string op = kfvOp(t);
-
-        Port vlan;
-        if (!m_portsOrch->getPort(keys[0], vlan))
+        // FDB bulk results will be stored in a map
+        std::map<
+                std::pair<
+                        std::string,            // Key
+                        std::string             // Op
+                >,
+                FdbBulkContext
+        >                                       toBulk;
+
+        // Add or remove FDB entries with the FDB bulker
+        while (it != consumer.m_toSync.end())
         {
-            SWSS_LOG_INFO("Failed to locate %s", keys[0].c_str());
-            if(op == DEL_COMMAND)
-            {
-                /* Delete if it is in saved_fdb_entry */
-                unsigned short vlan_id;
-                try {
-                    vlan_id = (unsigned short) stoi(keys[0].substr(4));
-                } catch(exception &e) {
-                    it = consumer.m_toSync.erase(it);
-                    continue;
-                }
-                deleteFdbEntryFromSavedFDB(MacAddress(keys[1]), vlan_id, origin);
+            KeyOpFieldsValuesTuple t = it->second;
 
-                it = consumer.m_toSync.erase(it);
-            }
-            else
-            {
-                it++;
-            }
-            continue;
-        }
+            /* format: <VLAN_name>:<MAC_address> */
+            vector<string> keys = tokenize(kfvKey(t), ':', 1);
+            string op = kfvOp(t);
 
-        FdbEntry entry;
-        entry.mac = MacAddress(keys[1]);
-        entry.bv_id = vlan.m_vlan_info.vlan_oid;
-
-        if (op == SET_COMMAND)
-        {
-            string port = "";
-            string type = "dynamic";
-            string remote_ip = "";
-            string esi = "";
-            unsigned int vni = 0;
-            string sticky = "";
-
-            for (auto i : kfvFieldsValues(t))
+            Port vlan;
+            if (!m_portsOrch->getPort(keys[0], vlan))
             {
-                if (fvField(i) == "port")
+                SWSS_LOG_INFO("Failed to locate %s", keys[0].c_str());
+                if(op == DEL_COMMAND)
                 {
-                    port = fvValue(i);
-                }
+                    /* Delete if it is in saved_fdb_entry */
+                    unsigned short vlan_id;
+                    try {
+                        vlan_id = (unsigned short) stoi(keys[0].substr(4));
+                    } catch(exception &e) {
+                        it = consumer.m_toSync.erase(it);
+                        continue;
+                    }
+                    deleteFdbEntryFromSavedFDB(MacAddress(keys[1]), vlan_id, origin);
 
-                if (fvField(i) == "type")
+                    it = consumer.m_toSync.erase(it);
+                }
+                else
                 {
-                    type = fvValue(i);
+                    it++;
                 }
+                continue;
+            }
 
-                if(origin == FDB_ORIGIN_VXLAN_ADVERTIZED)
+            FdbEntry entry;
+            entry.mac = MacAddress(keys[1]);
+            entry.bv_id = vlan.m_vlan_info.vlan_oid;
+
+            if (op == SET_COMMAND)
+            {
+                string port = "";
+                string type = "dynamic";
+                string remote_ip = "";
+                string esi = "";
+                unsigned int vni = 0;
+                string sticky = "";
+
+                for (auto i : kfvFieldsValues(t))
                 {
-                    if (fvField(i) == "remote_vtep")
+                    if (fvField(i) == "port")
                     {
-                        remote_ip = fvValue(i);
-                        // Creating an IpAddress object to validate if remote_ip is valid
-                        // if invalid it will throw the exception and we will ignore the
-                        // event
-                        try {
-                            IpAddress valid_ip = IpAddress(remote_ip);
-                            (void)valid_ip; // To avoid g++ warning
-                        } catch(exception &e) {
-                            SWSS_LOG_NOTICE("Invalid IP address in remote MAC %s", remote_ip.c_str());
-                            remote_ip = "";
-                            break;
-                        }
+                        port = fvValue(i);
                     }
 
-                    if (fvField(i) == "esi")
+                    if (fvField(i) == "type")
                     {
-                        esi = fvValue(i);
+                        type = fvValue(i);
                     }
 
-                    if (fvField(i) == "vni")
+                    if(origin == FDB_ORIGIN_VXLAN_ADVERTIZED)
                     {
-                        try {
-                            vni = (unsigned int) stoi(fvValue(i));
-                        } catch(exception &e) {
-                            SWSS_LOG_INFO("Invalid VNI in remote MAC %s", fvValue(i).c_str());
-                            vni = 0;
-                            break;
+                        if (fvField(i) == "remote_vtep")
+                        {
+                            remote_ip = fvValue(i);
+                            // Creating an IpAddress object to validate if remote_ip is valid
+                            // if invalid it will throw the exception and we will ignore the
+                            // event
+                            try {
+                                IpAddress valid_ip = IpAddress(remote_ip);
+                                (void)valid_ip; // To avoid g++ warning
+                            } catch(exception &e) {
+                                SWSS_LOG_NOTICE("Invalid IP address in remote MAC %s", remote_ip.c_str());
+                                remote_ip = "";
+                                break;
+                            }
+                        }
+
+                        if (fvField(i) == "esi")
+                        {
+                            esi = fvValue(i);
+                        }
+
+                        if (fvField(i) == "vni")
+                        {
+                            try {
+                                vni = (unsigned int) stoi(fvValue(i));
+                            } catch(exception &e) {
+                                SWSS_LOG_INFO("Invalid VNI in remote MAC %s", fvValue(i).c_str());
+                                vni = 0;
+                                break;
+                            }
                         }
                     }
                 }
-            }
 
-            /* FDB type is either dynamic or static */
-            assert(type == "dynamic" || type == "static");
+                /* FDB type is either dynamic or static */
+                assert(type == "dynamic" || type == "static");
 
-            if(origin == FDB_ORIGIN_VXLAN_ADVERTIZED)
-            {
-                VxlanTunnelOrch* tunnel_orch = gDirectory.get<VxlanTunnelOrch*>();
+                if(origin == FDB_ORIGIN_VXLAN_ADVERTIZED)
+                {
+                    VxlanTunnelOrch* tunnel_orch = gDirectory.get<VxlanTunnelOrch*>();
+
+                    if(!remote_ip.length())
+                    {
+                        it = consumer.m_toSync.erase(it);
+                        continue;
+                    }
+                    port = tunnel_orch->getTunnelPortName(remote_ip);
+                }
 
-                if(!remote_ip.length())
+                // The entry is removed in this bulk, flush the bulker before adding it again
+                if (toBulk.find(make_pair(kfvKey(t), DEL_COMMAND)) != toBulk.end())
                 {
-                    it = consumer.m_toSync.erase(it);
-                    continue;
+                    break;
                 }
-                port = tunnel_orch->getTunnelPortName(remote_ip);
-            }
 
+                auto rc = toBulk.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(kfvKey(t), op),
+                        std::forward_as_tuple(entry, origin));
+                auto& ctx = rc.first->second;
+
+                ctx.port_name = port;
+                ctx.fdbData.bridge_port_id = SAI_NULL_OBJECT_ID;
+                ctx.fdbData.type = type;
+                ctx.fdbData.origin = origin;
+                ctx.fdbData.remote_ip = remote_ip;
+                ctx.fdbData.esi = esi;
+                ctx.fdbData.vni = vni;
+                if (addFdbEntry(ctx))
+                    it = consumer.m_toSync.erase(it);
+                else
+                    it++;
+            }
+            else if (op == DEL_COMMAND)
+            {
+                auto rc = toBulk.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(kfvKey(t), op),
+                        std::forward_as_tuple(entry, origin));
+                if (removeFdbEntry(rc.first->second))
+                    it = consumer.m_toSync.erase(it);
+                else
+                    it++;
 
-            FdbData fdbData;
-            fdbData.bridge_port_id = SAI_NULL_OBJECT_ID;
-            fdbData.type = type;
-            fdbData.origin = origin;
-            fdbData.remote_ip = remote_ip;
-            fdbData.esi = esi;
-            fdbData.vni = vni;
-            if (addFdbEntry(entry, port, fdbData))
-                it = consumer.m_toSync.erase(it);
+            }
             else
-                it++;
-        }
-        else if (op == DEL_COMMAND)
-        {
-            if (removeFdbEntry(entry, origin))
+            {
+                SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
                 it = consumer.m_toSync.erase(it);
-            else
-                it++;
-
+            }
         }
-        else
+
+        // Flush the FDB bulker, so FDB entries will be written to syncd and ASIC
+        gFdbBulker.flush();
+
+        // Go through the bulker results
+        auto it_prev = consumer.m_toSync.begin();
+        while (it_prev != it)
         {
-            SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
-            it = consumer.m_toSync.erase(it);
+            KeyOpFieldsValuesTuple t = it_prev->second;
+
+            string op = kfvOp(t);
+            auto found = toBulk.find(make_pair(kfvKey(t), op));
+            if (found == toBulk.end())
+            {
+                it_prev++;
+                continue;
+            }
+
+            auto& ctx = found->second;
+            if (op == SET_COMMAND)
+            {
+                if (addFdbEntryPost(ctx))
+                    it_prev = consumer.m_toSync.erase(it_prev);
+                else
+                    it_prev++;
+            }
+            else if (op == DEL_COMMAND)
+            {
+                if (removeFdbEntryPost(ctx))
+                    it_prev = consumer.m_toSync.erase(it_prev);
+                else
+                    it_prev++;
+            }
         }
     }
 }
@@ -681,121 +737,162 @@ void FdbOrch::doTask(NotificationConsumer& consumer)
         return;
     }
 
+    /* Drain a batch of notifications at once, instead of one per select */
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    consumer.pops(entries);
+
+    if (&consumer == m_flushNotificationsConsumer)
+    {
+        for (const auto &entry : entries)
+        {
+            doFlushRequest(kfvOp(entry), kfvKey(entry));
+        }
+    }
+    else if (&consumer == m_fdbNotificationConsumer)
+    {
+        doFdbEvents(entries);
+    }
+}
+
+void FdbOrch::doFlushRequest(const string &op, const string &data)
+{
+    SWSS_LOG_ENTER();
+
     sai_status_t status;
-    std::string op;
-    std::string data;
-    std::vector<swss::FieldValueTuple> values;
     string alias;
     string vlan;
     Port port;
     Port vlanPort;
 
-    consumer.pop(op, data, values);
-
-    if (&consumer == m_flushNotificationsConsumer)
+    if (op == "ALL")
     {
-        if (op == "ALL")
+        /*
+         * so far only support flush all the FDB entries
+         * flush per port and flush per vlan will be added later.
+         */
+        status = sai_fdb_api->flush_fdb_entries(gSwitchId, 0, NULL);
+        if (status != SAI_STATUS_SUCCESS)
         {
-            /*
-             * so far only support flush all the FDB entries
-             * flush per port and flush per vlan will be added later.
-             */
-            status = sai_fdb_api->flush_fdb_entries(gSwitchId, 0, NULL);
-            if (status != SAI_STATUS_SUCCESS)
-            {
-                SWSS_LOG_ERROR("Flush fdb failed, return code %x", status);
-            }
+            SWSS_LOG_ERROR("Flush fdb failed, return code %x", status);
+        }
 
+        return;
+    }
+    else if (op == "PORT")
+    {
+        alias = data;
+        if (alias.empty())
+        {
+            SWSS_LOG_ERROR("Receive wrong port to flush fdb!");
             return;
         }
-        else if (op == "PORT")
+        if (!gPortsOrch->getPort(alias, port))
         {
-            alias = data;
-            if (alias.empty())
-            {
-                SWSS_LOG_ERROR("Receive wrong port to flush fdb!");
-                return;
-            }
-            if (!gPortsOrch->getPort(alias, port))
-            {
-                SWSS_LOG_ERROR("Get Port from port(%s) failed!", alias.c_str());
-                return;
-            }
-            if (port.m_bridge_port_id == SAI_NULL_OBJECT_ID)
-            {
-                return;
-            }
-            flushFDBEntries(port.m_bridge_port_id, SAI_NULL_OBJECT_ID);
-            SWSS_LOG_NOTICE("Clear fdb by port(%s)", alias.c_str());
+            SWSS_LOG_ERROR("Get Port from port(%s) failed!", alias.c_str());
             return;
         }
-        else if (op == "VLAN")
+        if (port.m_bridge_port_id == SAI_NULL_OBJECT_ID)
         {
-            vlan = data;
-            if (vlan.empty())
-            {
-                SWSS_LOG_ERROR("Receive wrong vlan to flush fdb!");
-                return;
-            }
-            if (!gPortsOrch->getPort(vlan, vlanPort))
-            {
-                SWSS_LOG_ERROR("Get Port from vlan(%s) failed!", vlan.c_str());
-                return;
-            }
-            if (vlanPort.m_vlan_info.vlan_oid == SAI_NULL_OBJECT_ID)
-            {
-                return;
-            }
-            flushFDBEntries(SAI_NULL_OBJECT_ID, vlanPort.m_vlan_info.vlan_oid);
-            SWSS_LOG_NOTICE("Clear fdb by vlan(%s)", vlan.c_str());
             return;
         }
-        else if (op == "PORTVLAN")
+        flushFDBEntries(port.m_bridge_port_id, SAI_NULL_OBJECT_ID);
+        SWSS_LOG_NOTICE("Clear fdb by port(%s)", alias.c_str());
+        return;
+    }
+    else if (op == "VLAN")
+    {
+        vlan = data;
+        if (vlan.empty())
         {
-            size_t found = data.find('|');
-            if (found != string::npos)
-            {
-                alias = data.substr(0, found);
-                vlan = data.substr(found+1);
-            }
-            if (alias.empty() || vlan.empty())
-            {
-                SWSS_LOG_ERROR("Receive wrong port or vlan to flush fdb!");
-                return;
-            }
-            if (!gPortsOrch->getPort(alias, port))
-            {
-                SWSS_LOG_ERROR("Get Port from port(%s) failed!", alias.c_str());
-                return;
-            }
-            if (!gPortsOrch->getPort(vlan, vlanPort))
-            {
-                SWSS_LOG_ERROR("Get Port from vlan(%s) failed!", vlan.c_str());
-                return;
-            }
-            if (port.m_bridge_port_id == SAI_NULL_OBJECT_ID ||
-                vlanPort.m_vlan_info.vlan_oid == SAI_NULL_OBJECT_ID)
-            {
-                return;
-            }
-            flushFDBEntries(port.m_bridge_port_id, vlanPort.m_vlan_info.vlan_oid); 
-            SWSS_LOG_NOTICE("Clear fdb by port(%s)+vlan(%s)", alias.c_str(), vlan.c_str());
+            SWSS_LOG_ERROR("Receive wrong vlan to flush fdb!");
             return;
         }
-        else
+        if (!gPortsOrch->getPort(vlan, vlanPort))
         {
-            SWSS_LOG_ERROR("Received unknown flush fdb request");
+            SWSS_LOG_ERROR("Get Port from vlan(%s) failed!", vlan.c_str());
             return;
         }
+        if (vlanPort.m_vlan_info.vlan_oid == SAI_NULL_OBJECT_ID)
+        {
+            return;
+        }
+        flushFDBEntries(SAI_NULL_OBJECT_ID, vlanPort.m_vlan_info.vlan_oid);
+        SWSS_LOG_NOTICE("Clear fdb by vlan(%s)", vlan.c_str());
+        return;
     }
-    else if (&consumer == m_fdbNotificationConsumer && op == "fdb_event")
+    else if (op == "PORTVLAN")
     {
+        size_t found = data.find('|');
+        if (found != string::npos)
+        {
+            alias = data.substr(0, found);
+            vlan = data.substr(found+1);
+        }
+        if (alias.empty() || vlan.empty())
+        {
+            SWSS_LOG_ERROR("Receive wrong port or vlan to flush fdb!");
+            return;
+        }
+        if (!gPortsOrch->getPort(alias, port))
+        {
+            SWSS_LOG_ERROR("Get Port from port(%s) failed!", alias.c_str());
+            return;
+        }
+        if (!gPortsOrch->getPort(vlan, vlanPort))
+        {
+            SWSS_LOG_ERROR("Get Port from vlan(%s) failed!", vlan.c_str());
+            return;
+        }
+        if (port.m_bridge_port_id == SAI_NULL_OBJECT_ID ||
+            vlanPort.m_vlan_info.vlan_oid == SAI_NULL_OBJECT_ID)
+        {
+            return;
+        }
+        flushFDBEntries(port.m_bridge_port_id, vlanPort.m_vlan_info.vlan_oid); 
+        SWSS_LOG_NOTICE("Clear fdb by port(%s)+vlan(%s)", alias.c_str(), vlan.c_str());
+        return;
+    }
+    else
+    {
+        SWSS_LOG_ERROR("Received unknown flush fdb request");
+        return;
+    }
+}
+
+/*
+ * Handles the FDB events of a batch of notifications. They are all deserialized
+ * first, and while they are handled the state DB writes and the FDB change
+ * notifications are held, so that an entry learnt, moved or aged several times
+ * in the batch is written and notified once, with its last state.
+ */
+void FdbOrch::doFdbEvents(const std::deque<KeyOpFieldsValuesTuple> &entries)
+{
+    SWSS_LOG_ENTER();
+
+    vector<pair<uint32_t, sai_fdb_event_notification_data_t *>> events;
+    events.reserve(entries.size());
+
+    for (const auto &entry : entries)
+    {
+        if (kfvOp(entry) != "fdb_event")
+        {
+            continue;
+        }
+
         uint32_t count;
         sai_fdb_event_notification_data_t *fdbevent = nullptr;
 
-        sai_deserialize_fdb_event_ntf(data, count, &fdbevent);
+        sai_deserialize_fdb_event_ntf(kfvKey(entry), count, &fdbevent);
+        events.emplace_back(count, fdbevent);
+    }
 
-        for (uint32_t i = 0; i < count; ++i)
+    m_fdbEventBatch = true;
+
+    for (const auto &event : events)
+    {
+        sai_fdb_event_notification_data_t *fdbevent = event.second;
+
+        for (uint32_t i = 0; i < event.first; ++i)
         {
             sai_object_id_t oid = SAI_NULL_OBJECT_ID;
 
@@ -810,9 +907,87 @@ void FdbOrch::doTask(NotificationConsumer& consumer)
 
             this->update(fdbevent[i].event_type, &fdbevent[i].fdb_entry, oid);
         }
+    }
+
+    flushFdbEventBatch();
+
+    for (const auto &event : events)
+    {
+        sai_deserialize_free_fdb_event_ntf(event.first, event.second);
+    }
+}
+
+void FdbOrch::setFdbEntryState(const string &key, const vector<FieldValueTuple> &fvs)
+{
+    if (m_fdbEventBatch)
+    {
+        m_fdbStateUpdates[key] = KeyOpFieldsValuesTuple(key, SET_COMMAND, fvs);
+        return;
+    }
+
+    m_fdbStateTable.set(key, fvs);
+}
+
+void FdbOrch::delFdbEntryState(const string &key)
+{
+    if (m_fdbEventBatch)
+    {
+        m_fdbStateUpdates[key] = KeyOpFieldsValuesTuple(key, DEL_COMMAND, vector<FieldValueTuple>());
+        return;
+    }
+
+    m_fdbStateTable.del(key);
+}
+
+void FdbOrch::notifyFdbChange(FdbUpdate &update)
+{
+    if (!m_fdbEventBatch)
+    {
+        notify(SUBJECT_TYPE_FDB_CHANGE, &update);
+        return;
+    }
+
+    /* Only the last update of an entry is notified */
+    auto it = m_fdbChangeIndex.find(update.entry);
+    if (it != m_fdbChangeIndex.end())
+    {
+        m_fdbChanges[it->second] = update;
+        return;
+    }
+
+    m_fdbChangeIndex[update.entry] = m_fdbChanges.size();
+    m_fdbChanges.push_back(update);
+}
+
+void FdbOrch::flushFdbEventBatch()
+{
+    SWSS_LOG_ENTER();
+
+    m_fdbEventBatch = false;
+
+    for (const auto &it : m_fdbStateUpdates)
+    {
+        if (kfvOp(it.second) == SET_COMMAND)
+        {
+            m_fdbStateTable.set(it.first, kfvFieldsValues(it.second));
+        }
+        else
+        {
+            m_fdbStateTable.del(it.first);
+        }
+    }
 
-        sai_deserialize_free_fdb_event_ntf(count, fdbevent);
+    for (auto &update : m_fdbChanges)
+    {
+        notify(SUBJECT_TYPE_FDB_CHANGE, &update);
     }
+
+    SWSS_LOG_INFO("FDB event batch: %zu state updates, %zu changes notified",
+                  m_fdbStateUpdates.size(), m_fdbChanges.size());
+
+    m_fdbStateUpdates.clear();
+    m_fdbChanges.clear();
+    m_fdbChangeIndex.clear();
 }
 
 /*
@@ -960,10 +1135,30 @@ void FdbOrch::updateVlanMember(const VlanMemberUpdate& update)
 
 bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
         FdbData fdbData)
+{
+    SWSS_LOG_ENTER();
+
+    FdbBulkContext ctx(entry);
+    ctx.port_name = port_name;
+    ctx.fdbData = fdbData;
+    if (addFdbEntry(ctx))
+    {
+        return true;
+    }
+
+    gFdbBulker.flush();
+    return addFdbEntryPost(ctx);
+}
+
+bool FdbOrch::addFdbEntry(FdbBulkContext& ctx)
 {
     Port vlan;
     Port port;
 
+    const FdbEntry& entry = ctx.entry;
+    const string& port_name = ctx.port_name;
+    const FdbData& fdbData = ctx.fdbData;
+
     SWSS_LOG_ENTER();
     SWSS_LOG_INFO("mac=%s bv_id=0x%" PRIx64 " port_name=%s type=%s origin=%d",
             entry.mac.to_string().c_str(), entry.bv_id, port_name.c_str(),
@@ -1000,9 +1195,9 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
     fdb_entry.bv_id = entry.bv_id;
 
     Port oldPort;
-    string oldType;
-    FdbOrigin oldOrigin = FDB_ORIGIN_INVALID ;
-    bool macUpdate = false;
+    string& oldType = ctx.oldType;
+    FdbOrigin& oldOrigin = ctx.oldOrigin;
+    bool& macUpdate = ctx.macUpdate;
     auto it = m_entries.find(entry);
     if (it != m_entries.end())
     {
@@ -1072,6 +1267,7 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
              */
         }
 
+        ctx.oldBridgePortId = it->second.bridge_port_id;
         macUpdate = true;
     }
 
@@ -1145,6 +1341,9 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
     }
 
 
+
+    auto& object_statuses = ctx.object_statuses;
+
     if (macUpdate)
     {
         SWSS_LOG_INFO("MAC-Update FDB %s in %s on from-%s:to-%s from-%s:to-%s origin-%d-to-%d",
@@ -1153,11 +1352,66 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
                 oldOrigin, fdbData.origin);
         for (auto itr : attrs)
         {
-            status = sai_fdb_api->set_fdb_entry_attribute(&fdb_entry, &itr);
+            object_statuses.emplace_back();
+            gFdbBulker.set_entry_attribute(&object_statuses.back(), &fdb_entry, &itr);
+        }
+    }
+    else
+    {
+        SWSS_LOG_INFO("MAC-Create %s FDB %s in %s on %s", fdbData.type.c_str(), entry.mac.to_string().c_str(), vlan.m_alias.c_str(), port_name.c_str());
+
+        object_statuses.emplace_back();
+        status = gFdbBulker.create_entry(&object_statuses.back(), &fdb_entry, (uint32_t)attrs.size(), attrs.data());
+        if (status == SAI_STATUS_ITEM_ALREADY_EXISTS)
+        {
+            SWSS_LOG_ERROR("Failed to create %s FDB %s in %s on %s: already exists in bulker",
+                    fdbData.type.c_str(), entry.mac.to_string().c_str(),
+                    vlan.m_alias.c_str(), port_name.c_str());
+            object_statuses.clear();
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool FdbOrch::addFdbEntryPost(FdbBulkContext& ctx)
+{
+    Port vlan;
+    Port port;
+
+    const FdbEntry& entry = ctx.entry;
+    const string& port_name = ctx.port_name;
+    const FdbData& fdbData = ctx.fdbData;
+    bool macUpdate = ctx.macUpdate;
+    FdbOrigin oldOrigin = ctx.oldOrigin;
+
+    SWSS_LOG_ENTER();
+
+    const auto& object_statuses = ctx.object_statuses;
+
+    if (object_statuses.empty())
+    {
+        // Something went wrong before FDB bulker, will retry
+        return false;
+    }
+
+    /* Ports are fetched again as the FDB counts may be updated by the other entries of the bulk */
+    if (!m_portsOrch->getPort(entry.bv_id, vlan) || !m_portsOrch->getPort(port_name, port))
+    {
+        SWSS_LOG_ERROR("Failed to locate vlan 0x%" PRIx64 " or port %s of FDB %s",
+                entry.bv_id, port_name.c_str(), entry.mac.to_string().c_str());
+        return false;
+    }
+
+    if (macUpdate)
+    {
+        for (auto status : object_statuses)
+        {
             if (status != SAI_STATUS_SUCCESS)
             {
-                SWSS_LOG_ERROR("macUpdate-Failed for attr.id=0x%x for FDB %s in %s on %s, rv:%d",
-                            itr.id, entry.mac.to_string().c_str(), vlan.m_alias.c_str(), port_name.c_str(), status);
+                SWSS_LOG_ERROR("macUpdate-Failed for FDB %s in %s on %s, rv:%d",
+                            entry.mac.to_string().c_str(), vlan.m_alias.c_str(), port_name.c_str(), status);
                 task_process_status handle_status = handleSaiSetStatus(SAI_API_FDB, status);
                 if (handle_status != task_success)
                 {
@@ -1165,19 +1419,21 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
                 }
             }
         }
-        if (oldPort.m_bridge_port_id != port.m_bridge_port_id)
+        if (ctx.oldBridgePortId != port.m_bridge_port_id)
         {
-            oldPort.m_fdb_count--;
-            m_portsOrch->setPort(oldPort.m_alias, oldPort);
+            Port oldPort;
+            if (m_portsOrch->getPortByBridgePortId(ctx.oldBridgePortId, oldPort))
+            {
+                oldPort.m_fdb_count--;
+                m_portsOrch->setPort(oldPort.m_alias, oldPort);
+            }
             port.m_fdb_count++;
             m_portsOrch->setPort(port.m_alias, port);
         }
     }
     else
     {
-        SWSS_LOG_INFO("MAC-Create %s FDB %s in %s on %s", fdbData.type.c_str(), entry.mac.to_string().c_str(), vlan.m_alias.c_str(), port_name.c_str());
-
-        status = sai_fdb_api->create_fdb_entry(&fdb_entry, (uint32_t)attrs.size(), attrs.data());
+        sai_status_t status = object_statuses.front();
         if (status != SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_ERROR("Failed to create %s FDB %s in %s on %s, rv:%d",
@@ -1239,11 +1495,29 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name,
     return true;
 }
 
+
 bool FdbOrch::removeFdbEntry(const FdbEntry& entry, FdbOrigin origin)
+{
+    SWSS_LOG_ENTER();
+
+    FdbBulkContext ctx(entry, origin);
+    if (removeFdbEntry(ctx))
+    {
+        return true;
+    }
+
+    gFdbBulker.flush();
+    return removeFdbEntryPost(ctx);
+}
+
+bool FdbOrch::removeFdbEntry(FdbBulkContext& ctx)
 {
     Port vlan;
     Port port;
 
+    const FdbEntry& entry = ctx.entry;
+    FdbOrigin origin = ctx.origin;
+
     SWSS_LOG_ENTER();
 
     SWSS_LOG_INFO("FdbOrch RemoveFDBEntry: mac=%s bv_id=0x%" PRIx64 "origin %d", entry.mac.to_string().c_str(), entry.bv_id, origin);
@@ -1264,7 +1538,8 @@ bool FdbOrch::removeFdbEntry(const FdbEntry& entry, FdbOrigin origin)
         return true;
     }
 
-    FdbData fdbData = it->second;
+    FdbData& fdbData = ctx.fdbData;
+    fdbData = it->second;
     if (!m_portsOrch->getPortByBridgePortId(fdbData.bridge_port_id, port))
     {
         SWSS_LOG_NOTICE("FdbOrch RemoveFDBEntry: Failed to locate port from bridge_port_id 0x%" PRIx64, fdbData.bridge_port_id);
@@ -1289,15 +1564,47 @@ bool FdbOrch::removeFdbEntry(const FdbEntry& entry, FdbOrigin origin)
         return true;
     }
 
-    string key = "Vlan" + to_string(vlan.m_vlan_info.vlan_id) + ":" + entry.mac.to_string();
-
-    sai_status_t status;
     sai_fdb_entry_t fdb_entry;
     fdb_entry.switch_id = gSwitchId;
     memcpy(fdb_entry.mac_address, entry.mac.getMac(), sizeof(sai_mac_t));
     fdb_entry.bv_id = entry.bv_id;
 
-    status = sai_fdb_api->remove_fdb_entry(&fdb_entry);
+    ctx.object_statuses.emplace_back();
+    gFdbBulker.remove_entry(&ctx.object_statuses.back(), &fdb_entry);
+
+    return false;
+}
+
+bool FdbOrch::removeFdbEntryPost(FdbBulkContext& ctx)
+{
+    Port vlan;
+    Port port;
+
+    const FdbEntry& entry = ctx.entry;
+    const FdbData& fdbData = ctx.fdbData;
+
+    SWSS_LOG_ENTER();
+
+    const auto& object_statuses = ctx.object_statuses;
+
+    if (object_statuses.empty())
+    {
+        // Something went wrong before FDB bulker, will retry
+        return false;
+    }
+
+    /* Ports are fetched again as the FDB counts may be updated by the other entries of the bulk */
+    if (!m_portsOrch->getPort(entry.bv_id, vlan) ||
+        !m_portsOrch->getPortByBridgePortId(fdbData.bridge_port_id, port))
+    {
+        SWSS_LOG_NOTICE("FdbOrch RemoveFDBEntry: Failed to locate vlan 0x%" PRIx64 " or port 0x%" PRIx64,
+                entry.bv_id, fdbData.bridge_port_id);
+        return false;
+    }
+
+    string key = "Vlan" + to_string(vlan.m_vlan_info.vlan_id) + ":" + entry.mac.to_string();
+
+    sai_status_t status = object_statuses.front();
     if (status != SAI_STATUS_SUCCESS)
     {
         SWSS_LOG_ERROR("FdbOrch RemoveFDBEntry: Failed to remove FDB entry. mac=%s, bv_id=0x%" PRIx64,
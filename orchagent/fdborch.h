@@ -4,6 +4,7 @@
 #include "orch.h"
 #include "observer.h"
 #include "portsorch.h"
+#include "bulker.h"
 
 enum FdbOrigin
 {
@@ -76,6 +77,29 @@ struct SavedFdbEntry
 
 typedef unordered_map<string, vector<SavedFdbEntry>> fdb_entries_by_port_t;
 
+struct FdbBulkContext
+{
+    std::deque<sai_status_t>    object_statuses;    // Bulk statuses
+    FdbEntry                    entry;
+    string                      port_name;
+    FdbData                     fdbData;            // Data of the added or removed entry
+    FdbOrigin                   origin;             // Origin of the removal
+    bool                        macUpdate;          // Existing entry is updated
+    sai_object_id_t             oldBridgePortId;    // Bridge port of the updated entry
+    string                      oldType;
+    FdbOrigin                   oldOrigin;
+
+    FdbBulkContext(const FdbEntry& entry, FdbOrigin origin = FDB_ORIGIN_PROVISIONED)
+        : entry(entry), origin(origin), macUpdate(false),
+          oldBridgePortId(SAI_NULL_OBJECT_ID), oldOrigin(FDB_ORIGIN_INVALID)
+    {
+    }
+
+    // Disable any copy constructors
+    FdbBulkContext(const FdbBulkContext&) = delete;
+    FdbBulkContext(FdbBulkContext&&) = delete;
+};
+
 class FdbOrch: public Orch, public Subject, public Observer
 {
 public:
@@ -107,17 +131,37 @@ private:
     Table m_fdbStateTable;
     NotificationConsumer* m_flushNotificationsConsumer;
     NotificationConsumer* m_fdbNotificationConsumer;
+    EntityBulker<sai_fdb_api_t> gFdbBulker;
+
+    /*
+     * Set while a batch of FDB event notifications is handled: the state DB
+     * writes and the FDB change notifications are held until the batch is done
+     */
+    bool m_fdbEventBatch = false;
+    unordered_map<string, KeyOpFieldsValuesTuple> m_fdbStateUpdates;
+    vector<FdbUpdate> m_fdbChanges;
+    map<FdbEntry, size_t> m_fdbChangeIndex;
 
     void doTask(Consumer& consumer);
     void doTask(NotificationConsumer& consumer);
+    void doFlushRequest(const string &op, const string &data);
+    void doFdbEvents(const std::deque<KeyOpFieldsValuesTuple> &entries);
 
     void updateVlanMember(const VlanMemberUpdate&);
     void updatePortOperState(const PortOperStateUpdate&);
 
     bool addFdbEntry(const FdbEntry&, const string&, FdbData fdbData);
+    bool addFdbEntry(FdbBulkContext& ctx);
+    bool addFdbEntryPost(FdbBulkContext& ctx);
+    bool removeFdbEntry(FdbBulkContext& ctx);
+    bool removeFdbEntryPost(FdbBulkContext& ctx);
     void deleteFdbEntryFromSavedFDB(const MacAddress &mac, const unsigned short &vlanId, FdbOrigin origin, const string portName="");
 
     bool storeFdbEntryState(const FdbUpdate& update);
+    void setFdbEntryState(const string &key, const vector<FieldValueTuple> &fvs);
+    void delFdbEntryState(const string &key);
+    void notifyFdbChange(FdbUpdate &update);
+    void flushFdbEventBatch();
     void notifyTunnelOrch(Port& port);
 };
 
@@ -39,6 +39,9 @@ const unordered_map<CounterType, string> FlexCounterManager::counter_id_field_lo
     { CounterType::PORT,            PORT_COUNTER_ID_LIST },
     { CounterType::QUEUE,           QUEUE_COUNTER_ID_LIST },
     { CounterType::MACSEC_SA_ATTR,  MACSEC_SA_ATTR_ID_LIST },
+#ifdef ACL_COUNTER_ATTR_ID_LIST
+    { CounterType::ACL_COUNTER,     ACL_COUNTER_ATTR_ID_LIST },
+#endif
 };
 
 FlexCounterManager::FlexCounterManager(
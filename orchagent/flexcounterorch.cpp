@@ -1,6 +1,7 @@
 #include <unordered_map>
 #include "flexcounterorch.h"
 #include "portsorch.h"
+#include "intfsorch.h"
 #include "fabricportsorch.h"
 #include "select.h"
 #include "notifier.h"
@@ -9,6 +10,8 @@
 #include "bufferorch.h"
 #include "flexcounterorch.h"
 #include "debugcounterorch.h"
+#include "aclorch.h"
+#include "converter.h"
 
 extern sai_port_api_t *sai_port_api;
 
@@ -33,6 +36,7 @@ unordered_map<string, string> flexCounterGroupMap =
     {"RIF", RIF_STAT_COUNTER_FLEX_COUNTER_GROUP},
     {"RIF_RATES", RIF_RATE_COUNTER_FLEX_COUNTER_GROUP},
     {"DEBUG_COUNTER", DEBUG_COUNTER_FLEX_COUNTER_GROUP},
+    {"ACL", ACL_COUNTER_FLEX_COUNTER_GROUP},
 };
 
 
@@ -91,6 +95,16 @@ void FlexCounterOrch::doTask(Consumer &consumer)
                     vector<FieldValueTuple> fieldValues;
                     fieldValues.emplace_back(POLL_INTERVAL_FIELD, value);
                     m_flexCounterGroupTable->set(flexCounterGroupMap[key], fieldValues);
+
+                    // The rates computed in orchagent follow the polls of the counters they are computed from
+                    try
+                    {
+                        setRatesInterval(flexCounterGroupMap[key], to_uint<uint32_t>(value));
+                    }
+                    catch (const exception &e)
+                    {
+                        SWSS_LOG_ERROR("Invalid poll interval %s of flex counter group %s: %s", value.c_str(), key.c_str(), e.what());
+                    }
                 }
                 else if(field == FLEX_COUNTER_STATUS_FIELD)
                 {
@@ -133,6 +147,8 @@ void FlexCounterOrch::doTask(Consumer &consumer)
                     vector<FieldValueTuple> fieldValues;
                     fieldValues.emplace_back(FLEX_COUNTER_STATUS_FIELD, value);
                     m_flexCounterGroupTable->set(flexCounterGroupMap[key], fieldValues);
+
+                    setRatesStatus(flexCounterGroupMap[key], value == "enable");
                 }
                 else
                 {
@@ -144,3 +160,27 @@ void FlexCounterOrch::doTask(Consumer &consumer)
         consumer.m_toSync.erase(it++);
     }
 }
+
+void FlexCounterOrch::setRatesInterval(const string &group, uint32_t intervalMs)
+{
+    if (gPortsOrch && group == PORT_STAT_COUNTER_FLEX_COUNTER_GROUP)
+    {
+        gPortsOrch->setPortRatesInterval(intervalMs);
+    }
+    else if (gIntfsOrch && group == RIF_STAT_COUNTER_FLEX_COUNTER_GROUP)
+    {
+        gIntfsOrch->setRifRatesInterval(intervalMs);
+    }
+}
+
+void FlexCounterOrch::setRatesStatus(const string &group, bool enabled)
+{
+    if (gPortsOrch && group == PORT_STAT_COUNTER_FLEX_COUNTER_GROUP)
+    {
+        gPortsOrch->setPortRatesStatus(enabled);
+    }
+    else if (gIntfsOrch && group == RIF_STAT_COUNTER_FLEX_COUNTER_GROUP)
+    {
+        gIntfsOrch->setRifRatesStatus(enabled);
+    }
+}
@@ -19,6 +19,9 @@ public:
 private:
     std::shared_ptr<swss::DBConnector> m_flexCounterDb = nullptr;
     std::shared_ptr<swss::ProducerTable> m_flexCounterGroupTable = nullptr;
+
+    void setRatesInterval(const std::string &group, uint32_t intervalMs);
+    void setRatesStatus(const std::string &group, bool enabled);
 };
 
 #endif
@@ -36,6 +36,7 @@ extern bool gIsNatSupported;
 extern NeighOrch *gNeighOrch;
 extern string gMySwitchType;
 extern int32_t gVoqMySwitchId;
+extern bool gLuaRates;
 
 const int intfsorch_pri = 35;
 
@@ -84,20 +85,32 @@ IntfsOrch::IntfsOrch(DBConnector *db, string tableName, VRFOrch *vrf_orch, DBCon
 
     string rifRatePluginName = "rif_rates.lua";
 
-    try
+    if (!gLuaRates)
     {
-        string rifRateLuaScript = swss::loadLuaScript(rifRatePluginName);
-        string rifRateSha = swss::loadRedisScript(m_counter_db.get(), rifRateLuaScript);
+        uint32_t ratesInterval = static_cast<uint32_t>(stoul(RIF_FLEX_STAT_COUNTER_POLL_MSECS));
+        m_rifRates = unique_ptr<RateCounters>(new RateCounters(m_counter_db.get(), RateCounters::Type::RIF, ratesInterval));
 
-        vector<FieldValueTuple> fieldValues;
-        fieldValues.emplace_back(RIF_PLUGIN_FIELD, rifRateSha);
-        fieldValues.emplace_back(POLL_INTERVAL_FIELD, RIF_FLEX_STAT_COUNTER_POLL_MSECS);
-        fieldValues.emplace_back(STATS_MODE_FIELD, STATS_MODE_READ);
-        m_flexCounterGroupTable->set(RIF_STAT_COUNTER_FLEX_COUNTER_GROUP, fieldValues);
+        auto interval = timespec { .tv_sec = ratesInterval / 1000, .tv_nsec = (ratesInterval % 1000) * 1000000 };
+        m_rifRatesTimer = new SelectableTimer(interval);
+        Orch::addExecutor(new ExecutableTimer(m_rifRatesTimer, this, "RIF_RATES_TIMER"));
     }
-    catch (const runtime_error &e)
+    else
     {
-        SWSS_LOG_WARN("RIF flex counter group plugins was not set successfully: %s", e.what());
+        try
+        {
+            string rifRateLuaScript = swss::loadLuaScript(rifRatePluginName);
+            string rifRateSha = swss::loadRedisScript(m_counter_db.get(), rifRateLuaScript);
+
+            vector<FieldValueTuple> fieldValues;
+            fieldValues.emplace_back(RIF_PLUGIN_FIELD, rifRateSha);
+            fieldValues.emplace_back(POLL_INTERVAL_FIELD, RIF_FLEX_STAT_COUNTER_POLL_MSECS);
+            fieldValues.emplace_back(STATS_MODE_FIELD, STATS_MODE_READ);
+            m_flexCounterGroupTable->set(RIF_STAT_COUNTER_FLEX_COUNTER_GROUP, fieldValues);
+        }
+        catch (const runtime_error &e)
+        {
+            SWSS_LOG_WARN("RIF flex counter group plugins was not set successfully: %s", e.what());
+        }
     }
 
     if(gMySwitchType == "voq")
@@ -1321,6 +1334,11 @@ void IntfsOrch::addRifToFlexCounter(const string &id, const string &name, const
     vector<FieldValueTuple> fieldValues;
     fieldValues.emplace_back(RIF_COUNTER_ID_LIST, counters_stream.str());
     m_flexCounterTable->set(key, fieldValues);
+
+    if (m_rifRates)
+    {
+        m_rifRates->add(id);
+    }
     SWSS_LOG_DEBUG("Registered interface %s to Flex counter", name.c_str());
 }
 
@@ -1335,6 +1353,11 @@ void IntfsOrch::removeRifFromFlexCounter(const string &id, const string &name)
     string key = getRifFlexCounterTableKey(id);
 
     m_flexCounterTable->del(key);
+
+    if (m_rifRates)
+    {
+        m_rifRates->remove(id);
+    }
     SWSS_LOG_DEBUG("Unregistered interface %s from Flex counter", name.c_str());
 }
 
@@ -1365,10 +1388,64 @@ bool IntfsOrch::updateSyncdIntfPfx(const string &alias, const IpPrefix &ip_prefi
     return false;
 }
 
+void IntfsOrch::setRifRatesInterval(uint32_t intervalMs)
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_rifRates || intervalMs == 0)
+    {
+        return;
+    }
+
+    m_rifRates->setInterval(intervalMs);
+    m_rifRatesTimer->setInterval(timespec { .tv_sec = intervalMs / 1000, .tv_nsec = (intervalMs % 1000) * 1000000 });
+    if (m_rifRatesEnabled)
+    {
+        m_rifRatesTimer->reset();
+    }
+
+    SWSS_LOG_NOTICE("RIF rates are computed every %u ms", intervalMs);
+}
+
+void IntfsOrch::setRifRatesStatus(bool enabled)
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_rifRates || enabled == m_rifRatesEnabled)
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        m_rifRatesTimer->start();
+    }
+    else
+    {
+        m_rifRatesTimer->stop();
+    }
+    m_rifRatesEnabled = enabled;
+
+    SWSS_LOG_NOTICE("RIF rates are %s", enabled ? "enabled" : "disabled");
+}
+
 void IntfsOrch::doTask(SelectableTimer &timer)
 {
     SWSS_LOG_ENTER();
 
+    if (&timer == m_rifRatesTimer)
+    {
+        try
+        {
+            m_rifRates->poll();
+        }
+        catch (const runtime_error &e)
+        {
+            SWSS_LOG_ERROR("Failed to update RIF rates: %s", e.what());
+        }
+        return;
+    }
+
     SWSS_LOG_DEBUG("Registering %" PRId64 " new intfs", m_rifsToAdd.size());
     string value;
     for (auto it = m_rifsToAdd.begin(); it != m_rifsToAdd.end(); )
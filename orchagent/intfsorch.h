@@ -49,6 +49,10 @@ public:
     std::set<IpPrefix> getSubnetRoutes();
 
     void generateInterfaceMap();
+
+    /* RIF rates follow the poll interval and the status of the RIF counters group */
+    void setRifRatesInterval(uint32_t intervalMs);
+    void setRifRatesStatus(bool enabled);
     void addRifToFlexCounter(const string&, const string&, const string&);
     void removeRifFromFlexCounter(const string&, const string&);
 
@@ -72,6 +76,11 @@ private:
     SelectableTimer* m_updateMapsTimer = nullptr;
     std::vector<Port> m_rifsToAdd;
 
+    /* RIF rates computed in orchagent, unless they are left to rif_rates.lua */
+    unique_ptr<RateCounters> m_rifRates;
+    SelectableTimer *m_rifRatesTimer = nullptr;
+    bool m_rifRatesEnabled = false;
+
     VRFOrch *m_vrfOrch;
     IntfsTable m_syncdIntfses;
     map<string, string> m_vnetInfses;
@@ -48,6 +48,10 @@ MacAddress gMacAddress;
 MacAddress gVxlanMacAddress;
 
 extern size_t gMaxBulkSize;
+extern bool gRoutePipeline;
+extern bool gLuaRates;
+extern bool gLuaPfcWd;
+extern bool gAclFlexCounters;
 
 #define DEFAULT_BATCH_SIZE  128
 int gBatchSize = DEFAULT_BATCH_SIZE;
@@ -74,7 +78,7 @@ string gMyAsicName = "";
 
 void usage()
 {
-    cout << "usage: orchagent [-h] [-r record_type] [-d record_location] [-f swss_rec_filename] [-j sairedis_rec_filename] [-b batch_size] [-m MAC] [-i INST_ID] [-s] [-z mode] [-k bulk_size]" << endl;
+    cout << "usage: orchagent [-h] [-r record_type] [-d record_location] [-f swss_rec_filename] [-j sairedis_rec_filename] [-b batch_size] [-m MAC] [-i INST_ID] [-s] [-z mode] [-k bulk_size] [-p] [-c chunk_size] [-l] [-w] [-a]" << endl;
     cout << "    -h: display this message" << endl;
     cout << "    -r record_type: record orchagent logs with type (default 3)" << endl;
     cout << "                    0: do not record logs" << endl;
@@ -89,7 +93,12 @@ void usage()
     cout << "    -z: redis communication mode (redis_async|redis_sync|zmq_sync), default: redis_async" << endl;
     cout << "    -f swss_rec_filename: swss record log filename(default 'swss.rec')" << endl;
     cout << "    -j sairedis_rec_filename: sairedis record log filename(default sairedis.rec)" << endl;
-    cout << "    -k max bulk size in bulk mode (default 1000)";
+    cout << "    -k max bulk size in bulk mode (default 1000)" << endl;
+    cout << "    -p: pipeline the route bulk calls with the processing of the next routes" << endl;
+    cout << "    -c chunk_size: keys per chunk when reading back tables on warm start (default 1024), 0 to read them one key at a time" << endl;
+    cout << "    -l: compute port and RIF rates with the port_rates.lua and rif_rates.lua plugins of syncd, rather than in orchagent" << endl;
+    cout << "    -w: detect PFC storms with the pfc_detect_<platform>.lua and pfc_restore.lua plugins of syncd, rather than in orchagent" << endl;
+    cout << "    -a: poll the ACL rule counters with the flex counters of syncd, when supported, rather than in orchagent" << endl;
 }
 
 void sighup_handler(int signo)
@@ -322,7 +331,7 @@ int main(int argc, char **argv)
     string swss_rec_filename = "swss.rec";
     string sairedis_rec_filename = "sairedis.rec";
 
-    while ((opt = getopt(argc, argv, "b:m:r:f:j:d:i:hsz:k:")) != -1)
+    while ((opt = getopt(argc, argv, "b:m:r:f:j:d:i:hsz:k:pc:lwa")) != -1)
     {
         switch (opt)
         {
@@ -414,6 +423,36 @@ int main(int argc, char **argv)
                 }
             }
             break;
+        case 'p':
+            gRoutePipeline = true;
+            SWSS_LOG_NOTICE("Enabling pipelined route programming");
+            break;
+        case 'c':
+            {
+                auto chunkSize = atoi(optarg);
+                if (chunkSize >= 0)
+                {
+                    Consumer::setRefillChunkSize(chunkSize);
+                    SWSS_LOG_NOTICE("Setting table refill chunk size as %d", chunkSize);
+                }
+                else
+                {
+                    SWSS_LOG_ERROR("Invalid input for table refill chunk size: %d. Ignoring.", chunkSize);
+                }
+            }
+            break;
+        case 'l':
+            gLuaRates = true;
+            SWSS_LOG_NOTICE("Leaving port and RIF rates to the Lua plugins");
+            break;
+        case 'w':
+            gLuaPfcWd = true;
+            SWSS_LOG_NOTICE("Leaving PFC storm detection to the Lua plugins");
+            break;
+        case 'a':
+            gAclFlexCounters = true;
+            SWSS_LOG_NOTICE("Leaving ACL rule counters to the flex counters");
+            break;
         default: /* '?' */
             exit(EXIT_FAILURE);
         }
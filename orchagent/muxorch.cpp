@@ -41,6 +41,9 @@ extern sai_tunnel_api_t* sai_tunnel_api;
 extern sai_next_hop_api_t* sai_next_hop_api;
 extern sai_router_interface_api_t* sai_router_intfs_api;
 
+/* Mux state changes are served ahead of route and neighbor updates */
+const int muxorch_pri = 40;
+
 /* Constants */
 #define MUX_TUNNEL "MuxTunnel0"
 #define MUX_ACL_TABLE_NAME INGRESS_TABLE_DROP
@@ -1269,7 +1272,7 @@ bool MuxOrch::delOperation(const Request& request)
 }
 
 MuxCableOrch::MuxCableOrch(DBConnector *db, DBConnector *sdb, const std::string& tableName):
-              Orch2(db, tableName, request_),
+              Orch2(db, tableName, request_, muxorch_pri),
               app_tunnel_route_table_(db, APP_TUNNEL_ROUTE_TABLE_NAME),
               mux_metric_table_(sdb, STATE_MUX_METRICS_TABLE_NAME)
 {
@@ -1375,7 +1378,7 @@ bool MuxCableOrch::delOperation(const Request& request)
 }
 
 MuxStateOrch::MuxStateOrch(DBConnector *db, const std::string& tableName) :
-              Orch2(db, tableName, request_),
+              Orch2(db, tableName, request_, muxorch_pri),
               mux_state_table_(db, STATE_MUX_CABLE_TABLE_NAME)
 {
     SWSS_LOG_ENTER();
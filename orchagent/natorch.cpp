@@ -39,7 +39,6 @@ extern bool               gIsNatSupported;
 #ifdef DEBUG_FRAMEWORK
 extern DebugDumpOrch      *gDebugDumpOrch;
 #endif
-uint32_t  natTimerTickCntr  = 0;
 bool      gNhTrackingSupported = false;
 
 NatOrch::NatOrch(DBConnector *appDb, DBConnector *stateDb, vector<table_name_with_pri_t> &tableNames,
@@ -57,6 +56,7 @@ NatOrch::NatOrch(DBConnector *appDb, DBConnector *stateDb, vector<table_name_wit
          m_naptQueryTable(appDb, APP_NAPT_TABLE_NAME),
          m_twiceNatQueryTable(appDb, APP_NAT_TWICE_TABLE_NAME),
          m_twiceNaptQueryTable(appDb, APP_NAPT_TWICE_TABLE_NAME),
+         m_stateNatAgingTable(stateDb, STATE_NAT_AGING_TABLE_NAME),
          nullIpv4Addr(0)
 {
     /* Set NAT admin mode to disabled */
@@ -71,6 +71,20 @@ NatOrch::NatOrch(DBConnector *appDb, DBConnector *stateDb, vector<table_name_wit
     /* Set NAT default udp timeout as 300 seconds */
     udp_timeout = 300;
 
+    /* Start the aging wheels on the current tick */
+    struct timespec time_now;
+    if (clock_gettime (CLOCK_MONOTONIC, &time_now) == 0)
+    {
+        uint64_t tick = static_cast<uint64_t>(time_now.tv_sec) / NAT_HITBIT_N_CNTRS_QUERY_PERIOD;
+        m_natAgingWheel.advance(tick);
+        m_naptAgingWheel.advance(tick);
+        m_twiceNatAgingWheel.advance(tick);
+        m_twiceNaptAgingWheel.advance(tick);
+    }
+    m_hitBitQuerySpread = 0;
+    m_maxAgingLag = 0;
+    m_agingIdle = false;
+
     /* Set entries count to 0 */
     totalEntries = totalSnatEntries = totalDnatEntries = 0;
     totalStaticNatEntries = totalDynamicNatEntries = 0;
@@ -89,7 +103,7 @@ NatOrch::NatOrch(DBConnector *appDb, DBConnector *stateDb, vector<table_name_wit
     auto cleanupNotifier = new Notifier(m_cleanupNotificationConsumer, this, "NAT_DB_CLEANUP_NOTIFICATION");
     Orch::addExecutor(cleanupNotifier);
 
-    /* Start the timer to query NAT entry statistics every 5 secs and hitbits every 30 secs */
+    /* Start the timer to query NAT entry statistics and the hitbits due every 5 secs */
     SWSS_LOG_INFO("Start the HITBIT Timer ");
     auto interval      = timespec { .tv_sec = NAT_HITBIT_N_CNTRS_QUERY_PERIOD, .tv_nsec = 0 };
     m_natQueryTimer = new SelectableTimer(interval);
@@ -1342,6 +1356,7 @@ bool NatOrch::addHwSnatEntry(const IpAddress &ip_address)
     updateNatCounters(ip_address, 0, 0);
     m_natEntries[ip_address].addedToHw = true;
     m_natEntries[ip_address].activeTime = time_now.tv_sec;
+    scheduleHitBitQuery(ip_address, time_now.tv_sec);
     gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_SNAT_ENTRY);
 
     if (entry.entry_type == "static")
@@ -1428,6 +1443,7 @@ bool NatOrch::addHwTwiceNatEntry(const TwiceNatEntryKey &key)
     updateTwiceNatCounters(key, 0, 0);
     m_twiceNatEntries[key].addedToHw = true; 
     m_twiceNatEntries[key].activeTime = time_now.tv_sec;
+    scheduleHitBitQuery(key, time_now.tv_sec);
 
     totalDnatEntries++;
     updateDnatCounters(totalDnatEntries);
@@ -1519,6 +1535,7 @@ bool NatOrch::addHwSnaptEntry(const NaptEntryKey &keyEntry)
 
      m_naptEntries[keyEntry].addedToHw = true;
      m_naptEntries[keyEntry].activeTime = time_now.tv_sec;
+     scheduleHitBitQuery(keyEntry, time_now.tv_sec);
 
      updateNaptCounters(keyEntry.prototype.c_str(), keyEntry.ip_address, keyEntry.l4_port, 0, 0);
      gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_SNAT_ENTRY);
@@ -1623,6 +1640,7 @@ bool NatOrch::addHwTwiceNaptEntry(const TwiceNaptEntryKey &key)
      updateTwiceNaptCounters(key, 0, 0);
      m_twiceNaptEntries[key].addedToHw = true;
      m_twiceNaptEntries[key].activeTime = time_now.tv_sec;
+     scheduleHitBitQuery(key, time_now.tv_sec);
 
      totalDnatEntries++;
      updateDnatCounters(totalDnatEntries);
@@ -2704,6 +2722,7 @@ void NatOrch::doNatTableTask(Consumer& consumer)
             assert(type == "dynamic" || type == "static");
             entry.entry_type = type;
             entry.addedToHw = false;
+            entry.hitBitQueryTick = 0;
 
             if (addNatEntry(ip_address, entry))
                 it = consumer.m_toSync.erase(it);
@@ -2778,6 +2797,7 @@ void NatOrch::doNaptTableTask(Consumer& consumer)
             assert(type == "dynamic" || type == "static");
             entry.entry_type = type;
             entry.addedToHw = false;
+            entry.hitBitQueryTick = 0;
 
             if (addNaptEntry(keyEntry, entry))
                 it = consumer.m_toSync.erase(it);
@@ -2847,6 +2867,7 @@ void NatOrch::doTwiceNatTableTask(Consumer& consumer)
             assert(type == "dynamic" || type == "static");
             entry.entry_type = type;
             entry.addedToHw = false;
+            entry.hitBitQueryTick = 0;
 
             if (addTwiceNatEntry(keyEntry, entry))
                 it = consumer.m_toSync.erase(it);
@@ -2926,6 +2947,7 @@ void NatOrch::doTwiceNaptTableTask(Consumer& consumer)
             assert(type == "dynamic" || type == "static");
             entry.entry_type = type;
             entry.addedToHw = false;
+            entry.hitBitQueryTick = 0;
 
             if (addTwiceNaptEntry(keyEntry, entry))
                 it = consumer.m_toSync.erase(it);
@@ -2957,6 +2979,7 @@ void NatOrch::doNatGlobalTableTask(Consumer& consumer)
         string op = kfvOp(t);
         string mode;
         vector<string> keys = tokenize(key, ':');
+        bool timeoutChanged = false;
          
         /* Example : APPL_DB
          * NAT_GLOBAL_TABLE:Values
@@ -2993,18 +3016,27 @@ void NatOrch::doNatGlobalTableTask(Consumer& consumer)
             }
             else if (fvField(i) == "nat_tcp_timeout")
             {
+                timeoutChanged |= (tcp_timeout != stoi(fvValue(i)));
                 tcp_timeout = stoi(fvValue(i));
             }
             else if (fvField(i) == "nat_udp_timeout")
             {
+                timeoutChanged |= (udp_timeout != stoi(fvValue(i)));
                 udp_timeout = stoi(fvValue(i));
             }
             else if (fvField(i) == "nat_timeout")
             {
+                timeoutChanged |= (timeout != stoi(fvValue(i)));
                 timeout = stoi(fvValue(i));
             }
         }
 
+        if (timeoutChanged)
+        {
+            /* Entries are due on the wheels according to the previous timeouts */
+            scheduleAllHitBitQueries();
+        }
+
         SWSS_LOG_INFO("Global Values - Admin mode - %s, TCP - %d, UDP - %d and Both - %d", admin_mode.c_str(), tcp_timeout, udp_timeout, timeout);
 
         it = consumer.m_toSync.erase(it);
@@ -3145,10 +3177,7 @@ void NatOrch::doTask(SelectableTimer &timer)
 
     if (timer.getFd() == m_natQueryTimer->getFd())
     {
-        if (((natTimerTickCntr++) % NAT_HITBIT_QUERY_MULTIPLE) == 0)
-        {
-            queryHitBits();
-        }
+        queryHitBits();
         queryCounters();
     }
     else if (timer.getFd() == m_natTimeoutTimer->getFd())
@@ -3352,7 +3381,7 @@ void NatOrch::queryHitBits(void)
 {
     SWSS_LOG_ENTER();
 
-    uint32_t         queried_entries = 0;
+    NatAgingStats    stats = {};
     struct timespec  time_now, time_end, time_spent;
 
     if (clock_gettime (CLOCK_MONOTONIC, &time_now) < 0)
@@ -3360,133 +3389,418 @@ void NatOrch::queryHitBits(void)
         return;
     }
 
-    /* Remove the NAT entries that are aged out.
-     * Query the NAT entries for their activity in the hardware
-     * and update the active timeout. */
-    NatEntry::iterator natIter = m_natEntries.begin();
-    while (natIter != m_natEntries.end())
+    /* Removed entries are left on the wheels until due, start over once they are the most */
+    size_t scheduled = m_natAgingWheel.size() + m_naptAgingWheel.size() +
+                       m_twiceNatAgingWheel.size() + m_twiceNaptAgingWheel.size();
+    size_t entries   = m_natEntries.size() + m_naptEntries.size() +
+                       m_twiceNatEntries.size() + m_twiceNaptEntries.size();
+    if (scheduled > 2 * entries + NAT_HITBIT_QUERIES_PER_TICK)
+    {
+        scheduleAllHitBitQueries();
+    }
+
+    uint64_t tick = static_cast<uint64_t>(time_now.tv_sec) / NAT_HITBIT_N_CNTRS_QUERY_PERIOD;
+    m_natAgingWheel.advance(tick);
+    m_naptAgingWheel.advance(tick);
+    m_twiceNatAgingWheel.advance(tick);
+    m_twiceNaptAgingWheel.advance(tick);
+
+    /* Query the hit bits of the entries due, each table gets its share of the
+     * budget of the tick first, and then what is left of it in turn. Entries
+     * not queried stay due for the next tick. */
+    uint32_t budget = getHitBitQueryBudget(entries);
+    uint32_t share = budget / 4;
+    queryNatHitBits(share, time_now.tv_sec, stats);
+    queryNaptHitBits(stats.queried + share, time_now.tv_sec, stats);
+    queryTwiceNatHitBits(stats.queried + share, time_now.tv_sec, stats);
+    queryTwiceNaptHitBits(stats.queried + share, time_now.tv_sec, stats);
+
+    queryNatHitBits(budget, time_now.tv_sec, stats);
+    queryNaptHitBits(budget, time_now.tv_sec, stats);
+    queryTwiceNatHitBits(budget, time_now.tv_sec, stats);
+    queryTwiceNaptHitBits(budget, time_now.tv_sec, stats);
+
+    if (clock_gettime (CLOCK_MONOTONIC, &time_end) < 0)
+    {
+        return;
+    }
+    time_spent = getTimeDiff(time_now, time_end);
+
+    if (stats.queried)
+    {
+        SWSS_LOG_DEBUG("Time spent in querying hardware hit-bits for %u NAT/NAPT entries = %lu secs, %lu msecs",
+                       stats.queried, time_spent.tv_sec, (time_spent.tv_nsec / 1000000UL));
+    }
+
+    publishAgingStats(stats, time_spent);
+}
+
+/* Remove the NAT entries that are aged out.
+ * Query the NAT entries due for their activity in the hardware
+ * and update the active timeout. */
+void NatOrch::queryNatHitBits(uint32_t budget, time_t now, NatAgingStats &stats)
+{
+    uint64_t              tick = m_natAgingWheel.getTick();
+    NatAgingWheel::Timer  timer;
+
+    while ((stats.queried < budget) and m_natAgingWheel.pop(timer))
     {
-        if (checkIfNatEntryIsActive(natIter, time_now.tv_sec))
+        NatEntry::iterator natIter = m_natEntries.find(timer.second);
+        if ((natIter == m_natEntries.end()) or (natIter->second.hitBitQueryTick != timer.first))
+        {
+            /* Removed or rescheduled since */
+            continue;
+        }
+
+        NatEntryValue &entry = natIter->second;
+        if ((entry.nat_type != "snat") or (entry.addedToHw == false) or (entry.entry_type == "static"))
+        {
+            /* Scheduled again when added back to the hardware */
+            entry.hitBitQueryTick = 0;
+            continue;
+        }
+
+        stats.lag = max(stats.lag, tick - timer.first);
+        stats.queried++;
+
+        if (checkIfNatEntryIsActive(natIter, now))
         {
             /* Since the entry is active in the hardware, reset the active time */
-            natIter->second.activeTime = time_now.tv_sec;
+            entry.activeTime = now;
         }
-        else
+        else if (now - entry.activeTime >= timeout)
         {
-            if ((natIter->second.nat_type == "snat") and (natIter->second.addedToHw == true) and
-                (natIter->second.entry_type != "static"))
-            {
-                if (time_now.tv_sec - natIter->second.activeTime >= timeout)
-                {
-                    std::vector<FieldValueTuple> fvVector;
-                    std::string key = natIter->first.to_string();
-                    setTimeoutNotifier->send("AGEOUT-SINGLE-NAT", key, fvVector);
-                }
-            } 
+            std::vector<FieldValueTuple> fvVector;
+            std::string key = natIter->first.to_string();
+            setTimeoutNotifier->send("AGEOUT-SINGLE-NAT", key, fvVector);
+            stats.agedOut++;
         }
-        queried_entries++;
-        natIter++;
+
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, nullptr);
+        m_natAgingWheel.schedule(natIter->first, entry.hitBitQueryTick);
     }
+}
 
-    /* Remove the NAPT entries that are aged out.
-     * Query the NAPT entries for their activity in the hardware
-     * and update the active timeout. */
-    NaptEntry::iterator naptIter = m_naptEntries.begin();
-    while (naptIter != m_naptEntries.end())
+/* Remove the NAPT entries that are aged out.
+ * Query the NAPT entries due for their activity in the hardware
+ * and update the active timeout. */
+void NatOrch::queryNaptHitBits(uint32_t budget, time_t now, NatAgingStats &stats)
+{
+    uint64_t               tick = m_naptAgingWheel.getTick();
+    NaptAgingWheel::Timer  timer;
+
+    while ((stats.queried < budget) and m_naptAgingWheel.pop(timer))
     {
-        if (checkIfNaptEntryIsActive(naptIter, time_now.tv_sec))
+        NaptEntry::iterator naptIter = m_naptEntries.find(timer.second);
+        if ((naptIter == m_naptEntries.end()) or (naptIter->second.hitBitQueryTick != timer.first))
+        {
+            /* Removed or rescheduled since */
+            continue;
+        }
+
+        NaptEntryValue &entry = naptIter->second;
+        if ((entry.nat_type != "snat") or (entry.addedToHw == false) or (entry.entry_type == "static"))
+        {
+            /* Scheduled again when added back to the hardware */
+            entry.hitBitQueryTick = 0;
+            continue;
+        }
+
+        stats.lag = max(stats.lag, tick - timer.first);
+        stats.queried++;
+
+        int timeout = naptIter->first.prototype == string("TCP") ? tcp_timeout : udp_timeout;
+        if (checkIfNaptEntryIsActive(naptIter, now))
         {
             /* Since the entry is active in the hardware, reset the active time */
-            naptIter->second.activeTime = time_now.tv_sec;
+            entry.activeTime = now;
         }
-        else
+        else if (now - entry.activeTime >= timeout)
         {
-            if ((naptIter->second.nat_type == "snat") and (naptIter->second.addedToHw == true) and
-                (naptIter->second.entry_type != "static"))
-            {
-                int timeout = naptIter->first.prototype == string("TCP") ? tcp_timeout : udp_timeout;
-                if (time_now.tv_sec - naptIter->second.activeTime >= timeout)
-                {
-                    std::vector<FieldValueTuple> fvVector;
-                    std::string key = (naptIter->first.prototype + ":" + naptIter->first.ip_address.to_string() + ":" + to_string(naptIter->first.l4_port));
-                    setTimeoutNotifier->send("AGEOUT-SINGLE-NAPT", key, fvVector);
-                }
-            }
+            std::vector<FieldValueTuple> fvVector;
+            std::string key = (naptIter->first.prototype + ":" + naptIter->first.ip_address.to_string() + ":" + to_string(naptIter->first.l4_port));
+            setTimeoutNotifier->send("AGEOUT-SINGLE-NAPT", key, fvVector);
+            stats.agedOut++;
         }
-        queried_entries++;
-        naptIter++;
+
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, nullptr);
+        m_naptAgingWheel.schedule(naptIter->first, entry.hitBitQueryTick);
     }
+}
 
-    /* Remove the Twice NAT entries that are aged out.
-     * Query the Twice NAT entries for their activity in the hardware
-     * and update the active timeout. */
-    TwiceNatEntry::iterator twiceNatIter = m_twiceNatEntries.begin();
-    while (twiceNatIter != m_twiceNatEntries.end())
+/* Remove the Twice NAT entries that are aged out.
+ * Query the Twice NAT entries due for their activity in the hardware
+ * and update the active timeout. */
+void NatOrch::queryTwiceNatHitBits(uint32_t budget, time_t now, NatAgingStats &stats)
+{
+    uint64_t                   tick = m_twiceNatAgingWheel.getTick();
+    TwiceNatAgingWheel::Timer  timer;
+
+    while ((stats.queried < budget) and m_twiceNatAgingWheel.pop(timer))
     {
-        if (checkIfTwiceNatEntryIsActive(twiceNatIter, time_now.tv_sec))
+        TwiceNatEntry::iterator twiceNatIter = m_twiceNatEntries.find(timer.second);
+        if ((twiceNatIter == m_twiceNatEntries.end()) or (twiceNatIter->second.hitBitQueryTick != timer.first))
+        {
+            /* Removed or rescheduled since */
+            continue;
+        }
+
+        TwiceNatEntryValue &entry = twiceNatIter->second;
+        if ((entry.addedToHw == false) or (entry.entry_type == "static"))
+        {
+            /* Scheduled again when added back to the hardware */
+            entry.hitBitQueryTick = 0;
+            continue;
+        }
+
+        stats.lag = max(stats.lag, tick - timer.first);
+        stats.queried++;
+
+        if (checkIfTwiceNatEntryIsActive(twiceNatIter, now))
         {
             /* Since the entry is active in the hardware, reset the active time */
-            twiceNatIter->second.activeTime = time_now.tv_sec;
+            entry.activeTime = now;
         }
-        else
+        else if (now - entry.activeTime >= timeout)
         {
-            if ((twiceNatIter->second.addedToHw == true) and
-                (twiceNatIter->second.entry_type != "static"))
-            {
-                if (time_now.tv_sec - twiceNatIter->second.activeTime >= timeout)
-                {
-                    std::vector<FieldValueTuple> fvVector;
-                    std::string key = (twiceNatIter->first.src_ip.to_string() + ":" + twiceNatIter->first.dst_ip.to_string());
-                    setTimeoutNotifier->send("AGEOUT-TWICE-NAT", key, fvVector);
-                }
-            }
+            std::vector<FieldValueTuple> fvVector;
+            std::string key = (twiceNatIter->first.src_ip.to_string() + ":" + twiceNatIter->first.dst_ip.to_string());
+            setTimeoutNotifier->send("AGEOUT-TWICE-NAT", key, fvVector);
+            stats.agedOut++;
         }
-        queried_entries++;
-        twiceNatIter++;
+
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, nullptr);
+        m_twiceNatAgingWheel.schedule(twiceNatIter->first, entry.hitBitQueryTick);
     }
+}
 
-    /* Remove the Twice NAPT entries that are aged out.
-     * Query the Twice NAPT entries for their activity in the hardware
-     * and update the active timeout. */
-    TwiceNaptEntry::iterator twiceNaptIter = m_twiceNaptEntries.begin();
-    while (twiceNaptIter != m_twiceNaptEntries.end())
+/* Remove the Twice NAPT entries that are aged out.
+ * Query the Twice NAPT entries due for their activity in the hardware
+ * and update the active timeout. */
+void NatOrch::queryTwiceNaptHitBits(uint32_t budget, time_t now, NatAgingStats &stats)
+{
+    uint64_t                    tick = m_twiceNaptAgingWheel.getTick();
+    TwiceNaptAgingWheel::Timer  timer;
+
+    while ((stats.queried < budget) and m_twiceNaptAgingWheel.pop(timer))
     {
-        if (checkIfTwiceNaptEntryIsActive(twiceNaptIter, time_now.tv_sec))
+        TwiceNaptEntry::iterator twiceNaptIter = m_twiceNaptEntries.find(timer.second);
+        if ((twiceNaptIter == m_twiceNaptEntries.end()) or (twiceNaptIter->second.hitBitQueryTick != timer.first))
+        {
+            /* Removed or rescheduled since */
+            continue;
+        }
+
+        TwiceNaptEntryValue &entry = twiceNaptIter->second;
+        if ((entry.addedToHw == false) or (entry.entry_type == "static"))
+        {
+            /* Scheduled again when added back to the hardware */
+            entry.hitBitQueryTick = 0;
+            continue;
+        }
+
+        stats.lag = max(stats.lag, tick - timer.first);
+        stats.queried++;
+
+        int timeout = twiceNaptIter->first.prototype == string("TCP") ? tcp_timeout : udp_timeout;
+        if (checkIfTwiceNaptEntryIsActive(twiceNaptIter, now))
         {
             /* Since the entry is active in the hardware, reset the active time */
-            twiceNaptIter->second.activeTime = time_now.tv_sec;
+            entry.activeTime = now;
         }
-        else
+        else if (now - entry.activeTime >= timeout)
         {
-            if ((twiceNaptIter->second.addedToHw == true) and
-                (twiceNaptIter->second.entry_type != "static"))
-            {
-                int timeout = twiceNaptIter->first.prototype == string("TCP") ? tcp_timeout : udp_timeout;
-                if (time_now.tv_sec - twiceNaptIter->second.activeTime >= timeout)
-                {
-                    std::vector<FieldValueTuple> fvVector;
-                    std::string key = (twiceNaptIter->first.prototype + ":" + twiceNaptIter->first.src_ip.to_string() + ":" + to_string(twiceNaptIter->first.src_l4_port) + 
-                                       ":" + twiceNaptIter->first.dst_ip.to_string() + ":" + to_string(twiceNaptIter->first.dst_l4_port));
-                    setTimeoutNotifier->send("AGEOUT-TWICE-NAPT", key, fvVector);
-                }
-            }
+            std::vector<FieldValueTuple> fvVector;
+            std::string key = (twiceNaptIter->first.prototype + ":" + twiceNaptIter->first.src_ip.to_string() + ":" + to_string(twiceNaptIter->first.src_l4_port) +
+                               ":" + twiceNaptIter->first.dst_ip.to_string() + ":" + to_string(twiceNaptIter->first.dst_l4_port));
+            setTimeoutNotifier->send("AGEOUT-TWICE-NAPT", key, fvVector);
+            stats.agedOut++;
         }
-        queried_entries++;
-        twiceNaptIter++;
+
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, nullptr);
+        m_twiceNaptAgingWheel.schedule(twiceNaptIter->first, entry.hitBitQueryTick);
     }
-    if (clock_gettime (CLOCK_MONOTONIC, &time_end) < 0)
+}
+
+/* Queries of a tick, enough for the entries to be queried on the tick they are due.
+ * An entry is queried at most every NAT_HITBIT_QUERY_MULTIPLE ticks, and once more
+ * on the tick it expires, so at most twice every NAT_HITBIT_QUERY_MULTIPLE ticks. */
+uint32_t NatOrch::getHitBitQueryBudget(size_t entries)
+{
+    size_t queries = (2 * entries + NAT_HITBIT_QUERY_MULTIPLE - 1) / NAT_HITBIT_QUERY_MULTIPLE;
+
+    return static_cast<uint32_t>(min<size_t>(max<size_t>(NAT_HITBIT_QUERIES_PER_TICK, queries), UINT32_MAX));
+}
+
+/* Tick the hit bits of an entry are queried on next. They are queried every
+ * 1/NAT_HITBIT_QUERIES_PER_TIMEOUT of the timeout, but not more often than every
+ * NAT_HITBIT_QUERY_MULTIPLE ticks, and last on the tick the entry expires.
+ * Entries scheduled along a 'spread' count are spread over the period. */
+uint64_t NatOrch::getHitBitQueryTick(time_t activeTime, int timeout, time_t now, uint64_t *spread)
+{
+    uint64_t nowTick    = static_cast<uint64_t>(now) / NAT_HITBIT_N_CNTRS_QUERY_PERIOD;
+    uint64_t timeoutSec = timeout > 0 ? static_cast<uint64_t>(timeout) : 0;
+    uint64_t expiryTick = (static_cast<uint64_t>(activeTime) + timeoutSec + NAT_HITBIT_N_CNTRS_QUERY_PERIOD - 1) /
+                          NAT_HITBIT_N_CNTRS_QUERY_PERIOD;
+    uint64_t period     = max<uint64_t>(NAT_HITBIT_QUERY_MULTIPLE,
+                                        timeoutSec / (NAT_HITBIT_QUERIES_PER_TIMEOUT * NAT_HITBIT_N_CNTRS_QUERY_PERIOD));
+
+    /* Entries scheduled together, as when added in bulk, are spread over the period */
+    uint64_t ticks = spread ? 1 + ((*spread)++ % period) : period;
+
+    if (expiryTick > nowTick)
+    {
+        ticks = min(ticks, expiryTick - nowTick);
+    }
+    else if (!spread)
+    {
+        /* Aged out already, query it again until it is removed */
+        ticks = NAT_HITBIT_QUERY_MULTIPLE;
+    }
+
+    return nowTick + ticks;
+}
+
+void NatOrch::scheduleHitBitQuery(const IpAddress &ip_address, time_t now)
+{
+    NatEntry::iterator natIter = m_natEntries.find(ip_address);
+    if (natIter == m_natEntries.end())
     {
         return;
     }
-    time_spent = getTimeDiff(time_now, time_end);
 
-    if (queried_entries)
+    NatEntryValue &entry = natIter->second;
+    entry.hitBitQueryTick = 0;
+
+    /* Hitbits of DNAT entries are queried along the SNAT entries, static entries are never aged */
+    if ((entry.nat_type == "snat") and (entry.addedToHw == true) and (entry.entry_type != "static"))
     {
-        SWSS_LOG_DEBUG("Time spent in querying hardware hit-bits for %u NAT/NAPT entries = %lu secs, %lu msecs",
-                       queried_entries, time_spent.tv_sec, (time_spent.tv_nsec / 1000000UL));
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, &m_hitBitQuerySpread);
+        m_natAgingWheel.schedule(ip_address, entry.hitBitQueryTick);
     }
 }
 
+void NatOrch::scheduleHitBitQuery(const NaptEntryKey &key, time_t now)
+{
+    NaptEntry::iterator naptIter = m_naptEntries.find(key);
+    if (naptIter == m_naptEntries.end())
+    {
+        return;
+    }
+
+    NaptEntryValue &entry = naptIter->second;
+    entry.hitBitQueryTick = 0;
+
+    /* Hitbits of DNAPT entries are queried along the SNAPT entries, static entries are never aged */
+    if ((entry.nat_type == "snat") and (entry.addedToHw == true) and (entry.entry_type != "static"))
+    {
+        int timeout = key.prototype == string("TCP") ? tcp_timeout : udp_timeout;
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, &m_hitBitQuerySpread);
+        m_naptAgingWheel.schedule(key, entry.hitBitQueryTick);
+    }
+}
+
+void NatOrch::scheduleHitBitQuery(const TwiceNatEntryKey &key, time_t now)
+{
+    TwiceNatEntry::iterator twiceNatIter = m_twiceNatEntries.find(key);
+    if (twiceNatIter == m_twiceNatEntries.end())
+    {
+        return;
+    }
+
+    TwiceNatEntryValue &entry = twiceNatIter->second;
+    entry.hitBitQueryTick = 0;
+
+    if ((entry.addedToHw == true) and (entry.entry_type != "static"))
+    {
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, &m_hitBitQuerySpread);
+        m_twiceNatAgingWheel.schedule(key, entry.hitBitQueryTick);
+    }
+}
+
+void NatOrch::scheduleHitBitQuery(const TwiceNaptEntryKey &key, time_t now)
+{
+    TwiceNaptEntry::iterator twiceNaptIter = m_twiceNaptEntries.find(key);
+    if (twiceNaptIter == m_twiceNaptEntries.end())
+    {
+        return;
+    }
+
+    TwiceNaptEntryValue &entry = twiceNaptIter->second;
+    entry.hitBitQueryTick = 0;
+
+    if ((entry.addedToHw == true) and (entry.entry_type != "static"))
+    {
+        int timeout = key.prototype == string("TCP") ? tcp_timeout : udp_timeout;
+        entry.hitBitQueryTick = getHitBitQueryTick(entry.activeTime, timeout, now, &m_hitBitQuerySpread);
+        m_twiceNaptAgingWheel.schedule(key, entry.hitBitQueryTick);
+    }
+}
+
+/* Schedule the hit bit queries of all the entries over again, as on a change of the timeouts */
+void NatOrch::scheduleAllHitBitQueries(void)
+{
+    SWSS_LOG_ENTER();
+
+    struct timespec  time_now;
+
+    if (clock_gettime (CLOCK_MONOTONIC, &time_now) < 0)
+    {
+        return;
+    }
+
+    m_natAgingWheel.clear();
+    m_naptAgingWheel.clear();
+    m_twiceNatAgingWheel.clear();
+    m_twiceNaptAgingWheel.clear();
+
+    for (auto &natEntry : m_natEntries)
+    {
+        scheduleHitBitQuery(natEntry.first, time_now.tv_sec);
+    }
+    for (auto &naptEntry : m_naptEntries)
+    {
+        scheduleHitBitQuery(naptEntry.first, time_now.tv_sec);
+    }
+    for (auto &twiceNatEntry : m_twiceNatEntries)
+    {
+        scheduleHitBitQuery(twiceNatEntry.first, time_now.tv_sec);
+    }
+    for (auto &twiceNaptEntry : m_twiceNaptEntries)
+    {
+        scheduleHitBitQuery(twiceNaptEntry.first, time_now.tv_sec);
+    }
+}
+
+/* Publish how far behind the aging is to STATE_DB, lags are in secs */
+void NatOrch::publishAgingStats(const NatAgingStats &stats, const timespec &time_spent)
+{
+    size_t scheduled = m_natAgingWheel.size() + m_naptAgingWheel.size() +
+                       m_twiceNatAgingWheel.size() + m_twiceNaptAgingWheel.size();
+    size_t due       = m_natAgingWheel.backlog() + m_naptAgingWheel.backlog() +
+                       m_twiceNatAgingWheel.backlog() + m_twiceNaptAgingWheel.backlog();
+
+    /* Nothing aged, the table is only updated once */
+    bool idle = (scheduled == 0) and (stats.queried == 0);
+    if (idle and m_agingIdle)
+    {
+        return;
+    }
+    m_agingIdle = idle;
+
+    m_maxAgingLag = max(m_maxAgingLag, stats.lag);
+
+    std::vector<FieldValueTuple> values;
+    values.emplace_back("SCHEDULED_ENTRIES", to_string(scheduled));
+    values.emplace_back("DUE_ENTRIES", to_string(due));
+    values.emplace_back("QUERIED_ENTRIES", to_string(stats.queried));
+    values.emplace_back("AGED_OUT_ENTRIES", to_string(stats.agedOut));
+    values.emplace_back("AGING_LAG", to_string(stats.lag * NAT_HITBIT_N_CNTRS_QUERY_PERIOD));
+    values.emplace_back("MAX_AGING_LAG", to_string(m_maxAgingLag * NAT_HITBIT_N_CNTRS_QUERY_PERIOD));
+    values.emplace_back("QUERY_TIME_MSECS", to_string(time_spent.tv_sec * 1000 + time_spent.tv_nsec / 1000000));
+    m_stateNatAgingTable.set(VALUES, values);
+}
+
 void NatOrch::updateAllConntrackEntries(void)
 {
     SWSS_LOG_ENTER();
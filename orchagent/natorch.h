@@ -29,14 +29,18 @@
 #include "routeorch.h"
 #include "nexthopgroupkey.h"
 #include "notificationproducer.h"
+#include "timingwheel.h"
 #ifdef DEBUG_FRAMEWORK
 #include "debugdumporch.h"
 #endif
 
 #define VALUES                            "Values" // Global Values Key
-#define NAT_HITBIT_N_CNTRS_QUERY_PERIOD   5        // 5 secs
+#define NAT_HITBIT_N_CNTRS_QUERY_PERIOD   5        // 5 secs, also the tick of the aging wheels
 #define NAT_CONNTRACK_TIMEOUT_PERIOD      86400    // 1 day
-#define NAT_HITBIT_QUERY_MULTIPLE         6        // Hit bits are queried every 30 secs
+#define NAT_HITBIT_QUERY_MULTIPLE         6        // Hit bits of an entry are queried at most every 30 secs
+#define NAT_HITBIT_QUERIES_PER_TIMEOUT    8        // Hit bits of an entry are queried at least 8 times per timeout
+#define NAT_HITBIT_QUERIES_PER_TICK       2048     // Hit bits of at least 2048 entries due are queried every tick
+#define STATE_NAT_AGING_TABLE_NAME        "NAT_AGING_TABLE"
 
 struct NatEntryValue
 {
@@ -46,6 +50,7 @@ struct NatEntryValue
     time_t         activeTime;         // Timestamp in secs when the entry was last seen as active
     time_t         ageOutTime;         // Timestamp in secs when the entry expires
     bool           addedToHw;          // Boolean to represent added to hardware
+    uint64_t       hitBitQueryTick;    // Aging wheel tick the hit bits are queried on next, 0 if not aged
 
     bool operator<(const NatEntryValue& other) const
     {
@@ -74,6 +79,7 @@ struct NaptEntryValue
     time_t         activeTime;         // Timestamp in secs when the entry was last seen as active
     time_t         ageOutTime;         // Timestamp in secs when the entry expires
     bool           addedToHw;          // Boolean to represent added to hardware
+    uint64_t       hitBitQueryTick;    // Aging wheel tick the hit bits are queried on next, 0 if not aged
 
     bool operator<(const NaptEntryValue& other) const
     {
@@ -100,6 +106,7 @@ struct TwiceNatEntryValue
     time_t         activeTime;         // Timestamp in secs when the entry was last seen as active
     time_t         ageOutTime;         // Timestamp in secs when the entry expires
     bool           addedToHw;          // Boolean to represent added to hardware
+    uint64_t       hitBitQueryTick;    // Aging wheel tick the hit bits are queried on next, 0 if not aged
 
     bool operator<(const TwiceNatEntryValue& other) const
     {
@@ -131,6 +138,7 @@ struct TwiceNaptEntryValue
     time_t         activeTime;         // Timestamp in secs when the entry was last seen as active
     time_t         ageOutTime;         // Timestamp in secs when the entry expires
     bool           addedToHw;          // Boolean to represent added to hardware
+    uint64_t       hitBitQueryTick;    // Aging wheel tick the hit bits are queried on next, 0 if not aged
 
     bool operator<(const TwiceNaptEntryValue& other) const
     {
@@ -176,6 +184,20 @@ struct DnatEntries
 
 typedef std::map<IpAddress, DnatEntries> DnatNhResolvCache;
 
+/* Wheels of the entries aged, on which their hit bits are queried next */
+typedef TimingWheel<IpAddress> NatAgingWheel;
+typedef TimingWheel<NaptEntryKey> NaptAgingWheel;
+typedef TimingWheel<TwiceNatEntryKey> TwiceNatAgingWheel;
+typedef TimingWheel<TwiceNaptEntryKey> TwiceNaptAgingWheel;
+
+/* Hit bit queries of a tick */
+struct NatAgingStats
+{
+    uint32_t       queried;            // Entries queried
+    uint32_t       agedOut;            // Entries notified as aged out
+    uint64_t       lag;                // Ticks the entry queried the most late was due before
+};
+
 class NatOrch: public Orch, public Subject, public Observer
 {
 public:
@@ -212,6 +234,7 @@ private:
     Table                   m_naptQueryTable;
     Table                   m_twiceNatQueryTable;
     Table                   m_twiceNaptQueryTable;
+    Table                   m_stateNatAgingTable;
     NotificationConsumer   *m_flushNotificationsConsumer;
     NotificationConsumer   *m_cleanupNotificationConsumer;
     mutex                   m_natMutex;
@@ -225,6 +248,17 @@ private:
      * or indirect NextHop (via route) to reach the DNAT IP is changed. */
     DnatNhResolvCache       m_nhResolvCache;
 
+    /* Only the dynamic SNAT entries in hardware are aged. Rather than querying all the
+     * entries every 30 secs, the hit bits of each entry are queried when due on the wheel
+     * of its table, within a budget of queries per tick. */
+    NatAgingWheel           m_natAgingWheel;
+    NaptAgingWheel          m_naptAgingWheel;
+    TwiceNatAgingWheel      m_twiceNatAgingWheel;
+    TwiceNaptAgingWheel     m_twiceNaptAgingWheel;
+    uint64_t                m_hitBitQuerySpread;
+    uint64_t                m_maxAgingLag;
+    bool                    m_agingIdle;
+
     int              timeout;
     int              tcp_timeout;
     int              udp_timeout;
@@ -303,6 +337,18 @@ private:
     void clearCounters(void);
     void queryCounters(void);
     void queryHitBits(void);
+    void queryNatHitBits(uint32_t budget, time_t now, NatAgingStats &stats);
+    void queryNaptHitBits(uint32_t budget, time_t now, NatAgingStats &stats);
+    void queryTwiceNatHitBits(uint32_t budget, time_t now, NatAgingStats &stats);
+    void queryTwiceNaptHitBits(uint32_t budget, time_t now, NatAgingStats &stats);
+    static uint32_t getHitBitQueryBudget(size_t entries);
+    static uint64_t getHitBitQueryTick(time_t activeTime, int timeout, time_t now, uint64_t *spread);
+    void scheduleHitBitQuery(const IpAddress &ip_address, time_t now);
+    void scheduleHitBitQuery(const NaptEntryKey &key, time_t now);
+    void scheduleHitBitQuery(const TwiceNatEntryKey &key, time_t now);
+    void scheduleHitBitQuery(const TwiceNaptEntryKey &key, time_t now);
+    void scheduleAllHitBitQueries(void);
+    void publishAgingStats(const NatAgingStats &stats, const timespec &time_spent);
     bool isNatEnabled(void);
     bool getNatCounters(const NatEntry::iterator &iter);
     bool getTwiceNatCounters(const TwiceNatEntry::iterator &iter);
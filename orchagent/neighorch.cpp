@@ -19,6 +19,7 @@ extern FgNhgOrch *gFgNhgOrch;
 extern Directory<Orch*> gDirectory;
 extern string gMySwitchType;
 extern int32_t gVoqMySwitchId;
+extern size_t gMaxBulkSize;
 
 const int neighorch_pri = 30;
 
@@ -27,7 +28,9 @@ NeighOrch::NeighOrch(DBConnector *appDb, string tableName, IntfsOrch *intfsOrch,
         m_intfsOrch(intfsOrch),
         m_fdbOrch(fdbOrch),
         m_portsOrch(portsOrch),
-        m_appNeighResolveProducer(appDb, APP_NEIGH_RESOLVE_TABLE_NAME)
+        m_appNeighResolveProducer(appDb, APP_NEIGH_RESOLVE_TABLE_NAME),
+        gNeighBulker(sai_neighbor_api, gMaxBulkSize),
+        gNextHopBulker(sai_next_hop_api, gSwitchId, gMaxBulkSize)
 {
     SWSS_LOG_ENTER();
 
@@ -169,29 +172,10 @@ bool NeighOrch::hasNextHop(const NextHopKey &nexthop)
     return m_syncdNextHops.find(nexthop) != m_syncdNextHops.end();
 }
 
-bool NeighOrch::addNextHop(const IpAddress &ipAddress, const string &alias)
+NextHopKey NeighOrch::getNextHopKey(const NeighborEntry &neighborEntry)
 {
-    SWSS_LOG_ENTER();
-
-    Port p;
-    if (!gPortsOrch->getPort(alias, p))
-    {
-        SWSS_LOG_ERROR("Neighbor %s seen on port %s which doesn't exist",
-                        ipAddress.to_string().c_str(), alias.c_str());
-        return false;
-    }
-    if (p.m_type == Port::SUBPORT)
-    {
-        if (!gPortsOrch->getPort(p.m_parent_port_id, p))
-        {
-            SWSS_LOG_ERROR("Neighbor %s seen on sub interface %s whose parent port doesn't exist",
-                            ipAddress.to_string().c_str(), alias.c_str());
-            return false;
-        }
-    }
-
-    NextHopKey nexthop = { ipAddress, alias };
-    if(m_intfsOrch->isRemoteSystemPortIntf(alias))
+    NextHopKey nexthop = { neighborEntry.ip_address, neighborEntry.alias };
+    if(m_intfsOrch->isRemoteSystemPortIntf(neighborEntry.alias))
     {
         //For remote system ports kernel nexthops are always on inband. Change the key
         Port inbp;
@@ -200,8 +184,14 @@ bool NeighOrch::addNextHop(const IpAddress &ipAddress, const string &alias)
 
         nexthop.alias = inbp.m_alias;
     }
-    assert(!hasNextHop(nexthop));
-    sai_object_id_t rif_id = m_intfsOrch->getRouterIntfsId(alias);
+    return nexthop;
+}
+
+bool NeighOrch::addNextHop(NeighborBulkContext& ctx)
+{
+    SWSS_LOG_ENTER();
+
+    assert(!hasNextHop(getNextHopKey(ctx.neighborEntry)));
 
     vector<sai_attribute_t> next_hop_attrs;
 
@@ -211,26 +201,37 @@ bool NeighOrch::addNextHop(const IpAddress &ipAddress, const string &alias)
     next_hop_attrs.push_back(next_hop_attr);
 
     next_hop_attr.id = SAI_NEXT_HOP_ATTR_IP;
-    copy(next_hop_attr.value.ipaddr, ipAddress);
+    copy(next_hop_attr.value.ipaddr, ctx.neighborEntry.ip_address);
     next_hop_attrs.push_back(next_hop_attr);
 
     next_hop_attr.id = SAI_NEXT_HOP_ATTR_ROUTER_INTERFACE_ID;
-    next_hop_attr.value.oid = rif_id;
+    next_hop_attr.value.oid = ctx.neighbor_entry.rif_id;
     next_hop_attrs.push_back(next_hop_attr);
 
-    sai_object_id_t next_hop_id;
-    sai_status_t status = sai_next_hop_api->create_next_hop(&next_hop_id, gSwitchId, (uint32_t)next_hop_attrs.size(), next_hop_attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
+    gNextHopBulker.create_entry(&ctx.next_hop_id, (uint32_t)next_hop_attrs.size(), next_hop_attrs.data());
+    return true;
+}
+
+bool NeighOrch::addNextHopPost(const NeighborBulkContext& ctx)
+{
+    SWSS_LOG_ENTER();
+
+    const IpAddress &ipAddress = ctx.neighborEntry.ip_address;
+    const string &alias = ctx.neighborEntry.alias;
+
+    if (ctx.next_hop_id == SAI_NULL_OBJECT_ID)
     {
-        SWSS_LOG_ERROR("Failed to create next hop %s on %s, rv:%d",
-                       ipAddress.to_string().c_str(), alias.c_str(), status);
-        task_process_status handle_status = handleSaiCreateStatus(SAI_API_NEXT_HOP, status);
+        SWSS_LOG_ERROR("Failed to create next hop %s on %s",
+                       ipAddress.to_string().c_str(), alias.c_str());
+        task_process_status handle_status = handleSaiCreateStatus(SAI_API_NEXT_HOP, SAI_STATUS_FAILURE);
         if (handle_status != task_success)
         {
             return parseHandleSaiStatusFailure(handle_status);
         }
     }
 
+    NextHopKey nexthop = getNextHopKey(ctx.neighborEntry);
+
     SWSS_LOG_NOTICE("Created next hop %s on %s",
                     ipAddress.to_string().c_str(), alias.c_str());
     if (m_neighborToResolve.find(nexthop) != m_neighborToResolve.end())
@@ -241,7 +242,7 @@ bool NeighOrch::addNextHop(const IpAddress &ipAddress, const string &alias)
     }
 
     NextHopEntry next_hop_entry;
-    next_hop_entry.next_hop_id = next_hop_id;
+    next_hop_entry.next_hop_id = ctx.next_hop_id;
     next_hop_entry.ref_count = 0;
     next_hop_entry.nh_flags = 0;
     m_syncdNextHops[nexthop] = next_hop_entry;
@@ -259,6 +260,14 @@ bool NeighOrch::addNextHop(const IpAddress &ipAddress, const string &alias)
 
     gFgNhgOrch->validNextHopInNextHopGroup(nexthop);
 
+    /* The port was checked by addNeighbor() */
+    Port p;
+    gPortsOrch->getPort(alias, p);
+    if (p.m_type == Port::SUBPORT)
+    {
+        gPortsOrch->getPort(p.m_parent_port_id, p);
+    }
+
     // For nexthop with incoming port which has down oper status, NHFLAGS_IFDOWN
     // flag should be set on it.
     // This scenario may happen under race condition where buffered neighbor event
@@ -533,125 +542,198 @@ void NeighOrch::doTask(Consumer &consumer)
         return;
     }
 
-    auto it = consumer.m_toSync.begin();
-    while (it != consumer.m_toSync.end())
+    /* Remove remaining DEL operation in m_toSync for the same neighbor.
+     * Since DEL operation is supposed to be executed before SET for the same neighbor
+     * A remaining DEL after the SET operation means the DEL operation failed previously and should not be executed anymore
+     */
+    auto removePendingDel = [&consumer](SyncMap::iterator it, const string &key)
     {
-        KeyOpFieldsValuesTuple t = it->second;
-
-        string key = kfvKey(t);
-        string op = kfvOp(t);
-
-        size_t found = key.find(':');
-        if (found == string::npos)
+        auto rit = make_reverse_iterator(it);
+        while (rit != consumer.m_toSync.rend() && rit->first == key && kfvOp(rit->second) == DEL_COMMAND)
         {
-            SWSS_LOG_ERROR("Failed to parse key %s", key.c_str());
-            it = consumer.m_toSync.erase(it);
-            continue;
+            consumer.m_toSync.erase(next(rit).base());
+            SWSS_LOG_NOTICE("Removed pending neighbor DEL operation for %s after SET operation", key.c_str());
         }
+    };
 
-        string alias = key.substr(0, found);
-
-        if (alias == "eth0" || alias == "lo" || alias == "docker0")
+    auto it = consumer.m_toSync.begin();
+    while (it != consumer.m_toSync.end())
+    {
+        // Neighbor bulk results will be stored in a map
+        std::map<
+                std::pair<
+                        std::string,            // Key
+                        std::string             // Op
+                >,
+                NeighborBulkContext
+        >                                       toBulk;
+
+        // Add or remove neighbors with the neighbor and next hop bulkers
+        while (it != consumer.m_toSync.end())
         {
-            it = consumer.m_toSync.erase(it);
-            continue;
-        }
+            KeyOpFieldsValuesTuple t = it->second;
 
-        if(gPortsOrch->isInbandPort(alias))
-        {
-            Port ibport;
-            gPortsOrch->getInbandPort(ibport);
-            if(ibport.m_type != Port::VLAN)
+            string key = kfvKey(t);
+            string op = kfvOp(t);
+
+            size_t found = key.find(':');
+            if (found == string::npos)
             {
-                //For "port" type Inband, the neighbors are only remote neighbors.
-                //Hence, this is the neigh learned due to the kernel entry added on
-                //Inband interface for the remote system port neighbors. Skip
+                SWSS_LOG_ERROR("Failed to parse key %s", key.c_str());
                 it = consumer.m_toSync.erase(it);
                 continue;
             }
-            //For "vlan" type inband, may identify the remote neighbors and skip
-        }
-
-        IpAddress ip_address(key.substr(found+1));
 
-        NeighborEntry neighbor_entry = { ip_address, alias };
+            string alias = key.substr(0, found);
 
-        if (op == SET_COMMAND)
-        {
-            Port p;
-            if (!gPortsOrch->getPort(alias, p))
+            if (alias == "eth0" || alias == "lo" || alias == "docker0")
             {
-                SWSS_LOG_INFO("Port %s doesn't exist", alias.c_str());
-                it++;
+                it = consumer.m_toSync.erase(it);
                 continue;
             }
 
-            if (!p.m_rif_id)
+            if(gPortsOrch->isInbandPort(alias))
             {
-                SWSS_LOG_INFO("Router interface doesn't exist on %s", alias.c_str());
-                it++;
-                continue;
+                Port ibport;
+                gPortsOrch->getInbandPort(ibport);
+                if(ibport.m_type != Port::VLAN)
+                {
+                    //For "port" type Inband, the neighbors are only remote neighbors.
+                    //Hence, this is the neigh learned due to the kernel entry added on
+                    //Inband interface for the remote system port neighbors. Skip
+                    it = consumer.m_toSync.erase(it);
+                    continue;
+                }
+                //For "vlan" type inband, may identify the remote neighbors and skip
             }
 
-            MacAddress mac_address;
-            for (auto i = kfvFieldsValues(t).begin();
-                 i  != kfvFieldsValues(t).end(); i++)
-            {
-                if (fvField(*i) == "neigh")
-                    mac_address = MacAddress(fvValue(*i));
-            }
+            IpAddress ip_address(key.substr(found+1));
+
+            NeighborEntry neighbor_entry = { ip_address, alias };
 
-            if (m_syncdNeighbors.find(neighbor_entry) == m_syncdNeighbors.end()
-                    || m_syncdNeighbors[neighbor_entry].mac != mac_address)
+            if (op == SET_COMMAND)
             {
-                if (addNeighbor(neighbor_entry, mac_address))
+                Port p;
+                if (!gPortsOrch->getPort(alias, p))
                 {
-                    it = consumer.m_toSync.erase(it);
+                    SWSS_LOG_INFO("Port %s doesn't exist", alias.c_str());
+                    it++;
+                    continue;
                 }
-                else
+
+                if (!p.m_rif_id)
                 {
+                    SWSS_LOG_INFO("Router interface doesn't exist on %s", alias.c_str());
                     it++;
                     continue;
                 }
+
+                MacAddress mac_address;
+                for (auto i = kfvFieldsValues(t).begin();
+                     i  != kfvFieldsValues(t).end(); i++)
+                {
+                    if (fvField(*i) == "neigh")
+                        mac_address = MacAddress(fvValue(*i));
+                }
+
+                /*
+                 * The neighbor is removed in this bulk, flush the bulkers before
+                 * adding it again, even with the same MAC: it is not synced anymore
+                 */
+                if (toBulk.find(make_pair(key, DEL_COMMAND)) != toBulk.end())
+                {
+                    break;
+                }
+
+                if (m_syncdNeighbors.find(neighbor_entry) == m_syncdNeighbors.end()
+                        || m_syncdNeighbors[neighbor_entry].mac != mac_address)
+                {
+                    auto rc = toBulk.emplace(std::piecewise_construct,
+                            std::forward_as_tuple(key, op),
+                            std::forward_as_tuple(neighbor_entry, mac_address));
+                    if (addNeighbor(rc.first->second))
+                    {
+                        it = consumer.m_toSync.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                        continue;
+                    }
+                }
+                else
+                {
+                    /* Duplicate entry */
+                    it = consumer.m_toSync.erase(it);
+                }
+
+                removePendingDel(it, key);
+            }
+            else if (op == DEL_COMMAND)
+            {
+                if (m_syncdNeighbors.find(neighbor_entry) != m_syncdNeighbors.end())
+                {
+                    auto rc = toBulk.emplace(std::piecewise_construct,
+                            std::forward_as_tuple(key, op),
+                            std::forward_as_tuple(neighbor_entry));
+                    if (removeNeighbor(rc.first->second))
+                    {
+                        it = consumer.m_toSync.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+                else
+                    /* Cannot locate the neighbor */
+                    it = consumer.m_toSync.erase(it);
             }
             else
             {
-                /* Duplicate entry */
+                SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
                 it = consumer.m_toSync.erase(it);
             }
+        }
+
+        // Flush the bulkers, so neighbors and next hops will be written to syncd and ASIC
+        flushBulk();
+
+        // Go through the bulker results
+        auto it_prev = consumer.m_toSync.begin();
+        while (it_prev != it)
+        {
+            KeyOpFieldsValuesTuple t = it_prev->second;
 
-            /* Remove remaining DEL operation in m_toSync for the same neighbor.
-             * Since DEL operation is supposed to be executed before SET for the same neighbor
-             * A remaining DEL after the SET operation means the DEL operation failed previously and should not be executed anymore
-             */
-            auto rit = make_reverse_iterator(it);
-            while (rit != consumer.m_toSync.rend() && rit->first == key && kfvOp(rit->second) == DEL_COMMAND)
+            string key = kfvKey(t);
+            string op = kfvOp(t);
+            auto found = toBulk.find(make_pair(key, op));
+            if (found == toBulk.end())
             {
-                consumer.m_toSync.erase(next(rit).base());
-                SWSS_LOG_NOTICE("Removed pending neighbor DEL operation for %s after SET operation", key.c_str());
+                it_prev++;
+                continue;
             }
-        }
-        else if (op == DEL_COMMAND)
-        {
-            if (m_syncdNeighbors.find(neighbor_entry) != m_syncdNeighbors.end())
+
+            auto& ctx = found->second;
+            if (op == SET_COMMAND)
             {
-                if (removeNeighbor(neighbor_entry))
+                if (addNeighborPost(ctx))
                 {
-                    it = consumer.m_toSync.erase(it);
+                    it_prev = consumer.m_toSync.erase(it_prev);
+                    removePendingDel(it_prev, key);
                 }
                 else
                 {
-                    it++;
+                    it_prev++;
                 }
             }
-            else
-                /* Cannot locate the neighbor */
-                it = consumer.m_toSync.erase(it);
-        }
-        else
-        {
-            SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
-            it = consumer.m_toSync.erase(it);
+            else if (op == DEL_COMMAND)
+            {
+                if (removeNeighborPost(ctx))
+                    it_prev = consumer.m_toSync.erase(it_prev);
+                else
+                    it_prev++;
+            }
         }
     }
 }
@@ -660,7 +742,22 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
 {
     SWSS_LOG_ENTER();
 
-    sai_status_t status;
+    NeighborBulkContext ctx(neighborEntry, macAddress);
+    if (addNeighbor(ctx))
+    {
+        return true;
+    }
+
+    flushBulk();
+    return addNeighborPost(ctx);
+}
+
+bool NeighOrch::addNeighbor(NeighborBulkContext& ctx)
+{
+    SWSS_LOG_ENTER();
+
+    const NeighborEntry &neighborEntry = ctx.neighborEntry;
+    const MacAddress &macAddress = ctx.mac;
     IpAddress ip_address = neighborEntry.ip_address;
     string alias = neighborEntry.alias;
 
@@ -671,7 +768,7 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
         return false;
     }
 
-    sai_neighbor_entry_t neighbor_entry;
+    sai_neighbor_entry_t &neighbor_entry = ctx.neighbor_entry;
     neighbor_entry.rif_id = rif_id;
     neighbor_entry.switch_id = gSwitchId;
     copy(neighbor_entry.ip_address, ip_address);
@@ -686,8 +783,25 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
     MuxOrch* mux_orch = gDirectory.get<MuxOrch*>();
     bool hw_config = isHwConfigured(neighborEntry);
 
+    auto& object_statuses = ctx.object_statuses;
+
     if (!hw_config && mux_orch->isNeighborActive(ip_address, macAddress, alias))
     {
+        /* The next hop is created along with the neighbor, check its port first */
+        Port p;
+        if (!gPortsOrch->getPort(alias, p))
+        {
+            SWSS_LOG_ERROR("Neighbor %s seen on port %s which doesn't exist",
+                            ip_address.to_string().c_str(), alias.c_str());
+            return false;
+        }
+        if (p.m_type == Port::SUBPORT && !gPortsOrch->getPort(p.m_parent_port_id, p))
+        {
+            SWSS_LOG_ERROR("Neighbor %s seen on sub interface %s whose parent port doesn't exist",
+                            ip_address.to_string().c_str(), alias.c_str());
+            return false;
+        }
+
         if (gMySwitchType == "voq")
         {
             if (!addVoqEncapIndex(alias, ip_address, neighbor_attrs))
@@ -696,8 +810,60 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
             }
         }
 
-        status = sai_neighbor_api->create_neighbor_entry(&neighbor_entry,
+        object_statuses.emplace_back();
+        sai_status_t status = gNeighBulker.create_entry(&object_statuses.back(), &neighbor_entry,
                                    (uint32_t)neighbor_attrs.size(), neighbor_attrs.data());
+        if (status == SAI_STATUS_ITEM_ALREADY_EXISTS)
+        {
+            SWSS_LOG_ERROR("Failed to create neighbor %s on %s: already exists in bulker",
+                           macAddress.to_string().c_str(), alias.c_str());
+            object_statuses.clear();
+            return false;
+        }
+
+        ctx.create = true;
+        ctx.hw_config = true;
+    }
+    else if (hw_config)
+    {
+        object_statuses.emplace_back();
+        gNeighBulker.set_entry_attribute(&object_statuses.back(), &neighbor_entry, &neighbor_attr);
+
+        ctx.hw_config = true;
+    }
+    else
+    {
+        /* Nothing to write to HW, the neighbor is only kept in cache */
+        object_statuses.emplace_back(SAI_STATUS_SUCCESS);
+        return addNeighborPost(ctx);
+    }
+
+    m_bulkContexts.push_back(&ctx);
+    return false;
+}
+
+bool NeighOrch::addNeighborPost(NeighborBulkContext& ctx)
+{
+    SWSS_LOG_ENTER();
+
+    const NeighborEntry &neighborEntry = ctx.neighborEntry;
+    const MacAddress &macAddress = ctx.mac;
+    IpAddress ip_address = neighborEntry.ip_address;
+    string alias = neighborEntry.alias;
+    sai_neighbor_entry_t &neighbor_entry = ctx.neighbor_entry;
+
+    const auto& object_statuses = ctx.object_statuses;
+
+    if (object_statuses.empty())
+    {
+        // Something went wrong before neighbor bulker, will retry
+        return false;
+    }
+
+    sai_status_t status = object_statuses.front();
+
+    if (ctx.create)
+    {
         if (status != SAI_STATUS_SUCCESS)
         {
             if (status == SAI_STATUS_ITEM_ALREADY_EXISTS)
@@ -731,7 +897,7 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
             gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_NEIGHBOR);
         }
 
-        if (!addNextHop(ip_address, alias))
+        if (!addNextHopPost(ctx))
         {
             status = sai_neighbor_api->remove_neighbor_entry(&neighbor_entry);
             if (status != SAI_STATUS_SUCCESS)
@@ -757,11 +923,9 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
 
             return false;
         }
-        hw_config = true;
     }
-    else if (isHwConfigured(neighborEntry))
+    else if (ctx.hw_config)
     {
-        status = sai_neighbor_api->set_neighbor_entry_attribute(&neighbor_entry, &neighbor_attr);
         if (status != SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_ERROR("Failed to update neighbor %s on %s, rv:%d",
@@ -775,7 +939,7 @@ bool NeighOrch::addNeighbor(const NeighborEntry &neighborEntry, const MacAddress
         SWSS_LOG_NOTICE("Updated neighbor %s on %s", macAddress.to_string().c_str(), alias.c_str());
     }
 
-    m_syncdNeighbors[neighborEntry] = { macAddress, hw_config };
+    m_syncdNeighbors[neighborEntry] = { macAddress, ctx.hw_config };
 
     NeighborUpdate update = { neighborEntry, macAddress, true };
     notify(SUBJECT_TYPE_NEIGH_CHANGE, static_cast<void *>(&update));
@@ -793,20 +957,26 @@ bool NeighOrch::removeNeighbor(const NeighborEntry &neighborEntry, bool disable)
 {
     SWSS_LOG_ENTER();
 
-    sai_status_t status;
+    NeighborBulkContext ctx(neighborEntry);
+    ctx.disable = disable;
+    if (removeNeighbor(ctx))
+    {
+        return true;
+    }
+
+    flushBulk();
+    return removeNeighborPost(ctx);
+}
+
+bool NeighOrch::removeNeighbor(NeighborBulkContext& ctx)
+{
+    SWSS_LOG_ENTER();
+
+    const NeighborEntry &neighborEntry = ctx.neighborEntry;
     IpAddress ip_address = neighborEntry.ip_address;
     string alias = neighborEntry.alias;
 
-    NextHopKey nexthop = { ip_address, alias };
-    if(m_intfsOrch->isRemoteSystemPortIntf(alias))
-    {
-        //For remote system ports kernel nexthops are always on inband. Change the key
-        Port inbp;
-        gPortsOrch->getInbandPort(inbp);
-        assert(inbp.m_alias.length());
-
-        nexthop.alias = inbp.m_alias;
-    }
+    NextHopKey nexthop = getNextHopKey(neighborEntry);
 
     if (m_syncdNeighbors.find(neighborEntry) == m_syncdNeighbors.end())
     {
@@ -820,17 +990,58 @@ bool NeighOrch::removeNeighbor(const NeighborEntry &neighborEntry, bool disable)
         return false;
     }
 
-    if (isHwConfigured(neighborEntry))
+    auto& object_statuses = ctx.object_statuses;
+
+    if (!isHwConfigured(neighborEntry))
     {
-        sai_object_id_t rif_id = m_intfsOrch->getRouterIntfsId(alias);
+        /* Nothing to remove from HW, the neighbor is only removed from cache */
+        object_statuses.emplace_back(SAI_STATUS_SUCCESS);
+        return removeNeighborPost(ctx);
+    }
+
+    sai_neighbor_entry_t &neighbor_entry = ctx.neighbor_entry;
+    neighbor_entry.rif_id = m_intfsOrch->getRouterIntfsId(alias);
+    neighbor_entry.switch_id = gSwitchId;
+    copy(neighbor_entry.ip_address, ip_address);
+
+    /* The next hop is removed first, the neighbor is removed by flushBulk() once it is gone */
+    sai_object_id_t next_hop_id = m_syncdNextHops[nexthop].next_hop_id;
+    if (next_hop_id == SAI_NULL_OBJECT_ID)
+    {
+        object_statuses.emplace_back(SAI_STATUS_ITEM_NOT_FOUND);
+    }
+    else
+    {
+        object_statuses.emplace_back();
+        gNextHopBulker.remove_entry(&object_statuses.back(), next_hop_id);
+    }
+
+    ctx.remove = true;
+    ctx.hw_config = true;
+    m_bulkContexts.push_back(&ctx);
+    return false;
+}
+
+bool NeighOrch::removeNeighborPost(NeighborBulkContext& ctx)
+{
+    SWSS_LOG_ENTER();
+
+    const NeighborEntry &neighborEntry = ctx.neighborEntry;
+    IpAddress ip_address = neighborEntry.ip_address;
+    string alias = neighborEntry.alias;
+    const sai_neighbor_entry_t &neighbor_entry = ctx.neighbor_entry;
 
-        sai_neighbor_entry_t neighbor_entry;
-        neighbor_entry.rif_id = rif_id;
-        neighbor_entry.switch_id = gSwitchId;
-        copy(neighbor_entry.ip_address, ip_address);
+    const auto& object_statuses = ctx.object_statuses;
 
-        sai_object_id_t next_hop_id = m_syncdNextHops[nexthop].next_hop_id;
-        status = sai_next_hop_api->remove_next_hop(next_hop_id);
+    if (object_statuses.empty())
+    {
+        // Something went wrong before neighbor bulker, will retry
+        return false;
+    }
+
+    if (ctx.hw_config)
+    {
+        sai_status_t status = object_statuses[0];
         if (status != SAI_STATUS_SUCCESS)
         {
             /* When next hop is not found, we continue to remove neighbor entry. */
@@ -866,7 +1077,13 @@ bool NeighOrch::removeNeighbor(const NeighborEntry &neighborEntry, bool disable)
         SWSS_LOG_NOTICE("Removed next hop %s on %s",
                         ip_address.to_string().c_str(), alias.c_str());
 
-        status = sai_neighbor_api->remove_neighbor_entry(&neighbor_entry);
+        if (object_statuses.size() < 2)
+        {
+            // Neighbor was not removed with its next hop, will retry
+            return false;
+        }
+
+        status = object_statuses[1];
         if (status != SAI_STATUS_SUCCESS)
         {
             if (status == SAI_STATUS_ITEM_NOT_FOUND)
@@ -904,7 +1121,7 @@ bool NeighOrch::removeNeighbor(const NeighborEntry &neighborEntry, bool disable)
             m_syncdNeighbors[neighborEntry].mac.to_string().c_str(), alias.c_str());
 
     /* Do not delete entry from cache if its disable request */
-    if (disable)
+    if (ctx.disable)
     {
         m_syncdNeighbors[neighborEntry].hw_configured = false;
         return true;
@@ -924,6 +1141,44 @@ bool NeighOrch::removeNeighbor(const NeighborEntry &neighborEntry, bool disable)
     return true;
 }
 
+void NeighOrch::flushBulk()
+{
+    SWSS_LOG_ENTER();
+
+    /* Remove the next hops, then the neighbors whose next hop is gone */
+    gNextHopBulker.flush();
+
+    for (auto ctx : m_bulkContexts)
+    {
+        if (!ctx->remove)
+        {
+            continue;
+        }
+
+        sai_status_t status = ctx->object_statuses.front();
+        if (status == SAI_STATUS_SUCCESS || status == SAI_STATUS_ITEM_NOT_FOUND)
+        {
+            ctx->object_statuses.emplace_back();
+            gNeighBulker.remove_entry(&ctx->object_statuses.back(), &ctx->neighbor_entry);
+        }
+    }
+
+    gNeighBulker.flush();
+
+    /* Create the next hops of the neighbors just created */
+    for (auto ctx : m_bulkContexts)
+    {
+        if (ctx->create && ctx->object_statuses.front() == SAI_STATUS_SUCCESS)
+        {
+            addNextHop(*ctx);
+        }
+    }
+
+    gNextHopBulker.flush();
+
+    m_bulkContexts.clear();
+}
+
 bool NeighOrch::isHwConfigured(const NeighborEntry& neighborEntry)
 {
     if (m_syncdNeighbors.find(neighborEntry) == m_syncdNeighbors.end())
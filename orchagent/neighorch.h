@@ -3,6 +3,7 @@
 
 #include "orch.h"
 #include "observer.h"
+#include "bulker.h"
 #include "portsorch.h"
 #include "intfsorch.h"
 #include "fdborch.h"
@@ -41,6 +42,30 @@ struct NeighborUpdate
     bool add;
 };
 
+struct NeighborBulkContext
+{
+    std::deque<sai_status_t>            object_statuses;    // Bulk statuses
+    NeighborEntry                       neighborEntry;
+    MacAddress                          mac;
+    sai_neighbor_entry_t                neighbor_entry;
+    bool                                create;             // Neighbor is created in HW
+    bool                                remove;             // Neighbor is removed from HW
+    bool                                hw_config;          // Neighbor is (to be) written to HW
+    bool                                disable;            // Removed from HW only, kept in cache
+    sai_object_id_t                     next_hop_id;        // Next hop created with the neighbor
+
+    NeighborBulkContext(const NeighborEntry &neighborEntry, const MacAddress &mac = MacAddress())
+        : neighborEntry(neighborEntry), mac(mac), create(false), remove(false), hw_config(false), disable(false),
+          next_hop_id(SAI_NULL_OBJECT_ID)
+    {
+        memset(&neighbor_entry, 0, sizeof(neighbor_entry));
+    }
+
+    // Disable any copy constructors
+    NeighborBulkContext(const NeighborBulkContext&) = delete;
+    NeighborBulkContext(NeighborBulkContext&&) = delete;
+};
+
 class NeighOrch : public Orch, public Subject, public Observer
 {
 public:
@@ -87,12 +112,26 @@ private:
 
     std::set<NextHopKey> m_neighborToResolve;
 
-    bool addNextHop(const IpAddress&, const string&);
+    EntityBulker<sai_neighbor_api_t>    gNeighBulker;
+    ObjectBulker<sai_next_hop_api_t>    gNextHopBulker;
+    /* Contexts having SAI operations in the bulkers */
+    std::vector<NeighborBulkContext *>  m_bulkContexts;
+
+    NextHopKey getNextHopKey(const NeighborEntry&);
+
+    bool addNextHop(NeighborBulkContext& ctx);
+    bool addNextHopPost(const NeighborBulkContext& ctx);
     bool removeNextHop(const IpAddress&, const string&);
 
     bool addNeighbor(const NeighborEntry&, const MacAddress&);
     bool removeNeighbor(const NeighborEntry&, bool disable = false);
 
+    bool addNeighbor(NeighborBulkContext& ctx);
+    bool addNeighborPost(NeighborBulkContext& ctx);
+    bool removeNeighbor(NeighborBulkContext& ctx);
+    bool removeNeighborPost(NeighborBulkContext& ctx);
+    void flushBulk();
+
     bool setNextHopFlag(const NextHopKey &, const uint32_t);
     bool clearNextHopFlag(const NextHopKey &, const uint32_t);
 
@@ -1,8 +1,114 @@
 #ifndef SWSS_NEXTHOPGROUPKEY_H
 #define SWSS_NEXTHOPGROUPKEY_H
 
+#include <set>
+#include <map>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
 #include "nexthopkey.h"
 
+/*
+ * Interning table of the next hop sets.
+ *
+ * Each distinct next hop set, weights included, is stored once and given a compact
+ * integer ID. The entry is shared by all the next hop group keys of the set, and is
+ * released with the last of them, its ID being then reused.
+ */
+class NextHopGroupPool
+{
+public:
+    typedef std::set<NextHopKey> NextHopSet;
+
+    struct Entry;
+
+    struct NextHopSetLess
+    {
+        static bool nextHopLess(const NextHopKey &a, const NextHopKey &b)
+        {
+            if (a < b)
+            {
+                return true;
+            }
+            return !(b < a) && a.weight < b.weight;
+        }
+
+        bool operator()(const NextHopSet &a, const NextHopSet &b) const
+        {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), nextHopLess);
+        }
+    };
+
+    typedef std::map<NextHopSet, std::weak_ptr<const Entry>, NextHopSetLess> EntryMap;
+
+    struct Entry
+    {
+        EntryMap::iterator  node;
+        uint32_t            id;
+    };
+
+    /* Never destroyed, as keys may be held by other static objects */
+    static NextHopGroupPool &instance()
+    {
+        static NextHopGroupPool *pool = new NextHopGroupPool();
+        return *pool;
+    }
+
+    /* Returns the entry of the next hop set, nullptr for the empty set */
+    std::shared_ptr<const Entry> intern(NextHopSet &&nexthops)
+    {
+        if (nexthops.empty())
+        {
+            return nullptr;
+        }
+
+        auto rc = m_entries.emplace(std::move(nexthops), std::weak_ptr<const Entry>());
+        if (!rc.second)
+        {
+            return rc.first->second.lock();
+        }
+
+        uint32_t id;
+        if (m_freeIds.empty())
+        {
+            id = ++m_lastId;
+        }
+        else
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+
+        std::shared_ptr<const Entry> entry(new Entry{ rc.first, id }, [this](const Entry *e) { release(e); });
+        rc.first->second = entry;
+        return entry;
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+private:
+    EntryMap                m_entries;
+    std::vector<uint32_t>   m_freeIds;
+    uint32_t                m_lastId = 0;
+
+    void release(const Entry *entry)
+    {
+        m_entries.erase(entry->node);
+        m_freeIds.push_back(entry->id);
+        delete entry;
+    }
+};
+
+/*
+ * Set of next hops, interned in the NextHopGroupPool: keys of the same set share
+ * one entry, and are compared and hashed by its ID in constant time. The ID of
+ * the empty set is 0.
+ */
 class NextHopGroupKey
 {
 public:
@@ -11,29 +117,32 @@ public:
     /* ip_string@if_alias separated by ',' */
     NextHopGroupKey(const std::string &nexthops)
     {
-        m_overlay_nexthops = false;
+        NextHopGroupPool::NextHopSet nhs;
         auto nhv = tokenize(nexthops, NHG_DELIMITER);
         for (const auto &nh : nhv)
         {
-            m_nexthops.insert(nh);
+            nhs.insert(nh);
         }
+        intern(std::move(nhs));
     }
 
     /* ip_string|if_alias|vni|router_mac separated by ',' */
     NextHopGroupKey(const std::string &nexthops, bool overlay_nh)
     {
         m_overlay_nexthops = true;
+        NextHopGroupPool::NextHopSet nhs;
         auto nhv = tokenize(nexthops, NHG_DELIMITER);
         for (const auto &nh_str : nhv)
         {
             auto nh = NextHopKey(nh_str, overlay_nh);
-            m_nexthops.insert(nh);
+            nhs.insert(nh);
         }
+        intern(std::move(nhs));
     }
 
     NextHopGroupKey(const std::string &nexthops, const std::string &weights)
     {
-        m_overlay_nexthops = false;
+        NextHopGroupPool::NextHopSet nhs;
         std::vector<std::string> nhv = tokenize(nexthops, NHG_DELIMITER);
         std::vector<std::string> wtv = tokenize(weights, NHG_DELIMITER);
         for (uint32_t i = 0; i < nhv.size(); i++)
@@ -43,28 +152,35 @@ public:
             {
                 nh.weight = (uint32_t)std::stoi(wtv[i]);
             }
-            m_nexthops.insert(nh);
+            nhs.insert(nh);
         }
+        intern(std::move(nhs));
     }
 
     inline const std::set<NextHopKey> &getNextHops() const
     {
-        return m_nexthops;
+        static const NextHopGroupPool::NextHopSet empty;
+        return m_entry ? m_entry->node->first : empty;
     }
 
     inline size_t getSize() const
     {
-        return m_nexthops.size();
+        return getNextHops().size();
+    }
+
+    inline uint32_t getId() const
+    {
+        return m_entry ? m_entry->id : 0;
     }
 
     inline bool operator<(const NextHopGroupKey &o) const
     {
-        return m_nexthops < o.m_nexthops;
+        return getId() < o.getId();
     }
 
     inline bool operator==(const NextHopGroupKey &o) const
     {
-        return m_nexthops == o.m_nexthops;
+        return m_entry == o.m_entry;
     }
 
     inline bool operator!=(const NextHopGroupKey &o) const
@@ -74,33 +190,35 @@ public:
 
     void add(const std::string &ip, const std::string &alias)
     {
-        m_nexthops.emplace(ip, alias);
+        add(NextHopKey(ip, alias));
     }
 
     void add(const std::string &nh)
     {
-        m_nexthops.insert(nh);
+        add(NextHopKey(nh));
     }
 
     void add(const NextHopKey &nh)
     {
-        m_nexthops.insert(nh);
+        auto nhs = getNextHops();
+        nhs.insert(nh);
+        intern(std::move(nhs));
     }
 
     bool contains(const std::string &ip, const std::string &alias) const
     {
         NextHopKey nh(ip, alias);
-        return m_nexthops.find(nh) != m_nexthops.end();
+        return contains(nh);
     }
 
     bool contains(const std::string &nh) const
     {
-        return m_nexthops.find(nh) != m_nexthops.end();
+        return contains(NextHopKey(nh));
     }
 
     bool contains(const NextHopKey &nh) const
     {
-        return m_nexthops.find(nh) != m_nexthops.end();
+        return getNextHops().find(nh) != getNextHops().end();
     }
 
     bool contains(const NextHopGroupKey &nhs) const
@@ -117,7 +235,7 @@ public:
 
     bool hasIntfNextHop() const
     {
-        for (const auto &nh : m_nexthops)
+        for (const auto &nh : getNextHops())
         {
             if (nh.isIntfNextHop())
             {
@@ -129,27 +247,34 @@ public:
 
     void remove(const std::string &ip, const std::string &alias)
     {
-        NextHopKey nh(ip, alias);
-        m_nexthops.erase(nh);
+        remove(NextHopKey(ip, alias));
     }
 
     void remove(const std::string &nh)
     {
-        m_nexthops.erase(nh);
+        remove(NextHopKey(nh));
     }
 
     void remove(const NextHopKey &nh)
     {
-        m_nexthops.erase(nh);
+        if (!contains(nh))
+        {
+            return;
+        }
+
+        auto nhs = getNextHops();
+        nhs.erase(nh);
+        intern(std::move(nhs));
     }
 
     const std::string to_string() const
     {
         string nhs_str;
+        const auto &nexthops = getNextHops();
 
-        for (auto it = m_nexthops.begin(); it != m_nexthops.end(); ++it)
+        for (auto it = nexthops.begin(); it != nexthops.end(); ++it)
         {
-            if (it != m_nexthops.begin())
+            if (it != nexthops.begin())
             {
                 nhs_str += NHG_DELIMITER;
             }
@@ -170,12 +295,29 @@ public:
 
     void clear()
     {
-        m_nexthops.clear();
+        m_entry.reset();
     }
 
 private:
-    std::set<NextHopKey> m_nexthops;
-    bool m_overlay_nexthops;
+    std::shared_ptr<const NextHopGroupPool::Entry> m_entry;
+    bool m_overlay_nexthops = false;
+
+    void intern(NextHopGroupPool::NextHopSet &&nexthops)
+    {
+        m_entry = NextHopGroupPool::instance().intern(std::move(nexthops));
+    }
 };
 
+namespace std
+{
+    template <>
+    struct hash<NextHopGroupKey>
+    {
+        size_t operator()(const NextHopGroupKey &key) const
+        {
+            return key.getId();
+        }
+    };
+}
+
 #endif /* SWSS_NEXTHOPGROUPKEY_H */
@@ -18,10 +18,10 @@ struct NextHopKey
     uint32_t            weight;         // NH weight for NHGs
 
 
-    NextHopKey() : weight(0) {}
+    NextHopKey() : vni(0), weight(0) {}
     NextHopKey(const std::string &ipstr, const std::string &alias) : ip_address(ipstr), alias(alias), vni(0), mac_address(), weight(0) {}
     NextHopKey(const IpAddress &ip, const std::string &alias) : ip_address(ip), alias(alias), vni(0), mac_address(), weight(0) {}
-    NextHopKey(const std::string &str)
+    NextHopKey(const std::string &str) : weight(0)
     {
         if (str.find(NHG_DELIMITER) != string::npos)
         {
@@ -51,7 +51,7 @@ struct NextHopKey
             throw std::invalid_argument(err);
         }
     }
-    NextHopKey(const std::string &str, bool overlay_nh)
+    NextHopKey(const std::string &str, bool overlay_nh) : weight(0)
     {
         if (str.find(NHG_DELIMITER) != string::npos)
         {
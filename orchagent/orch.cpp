@@ -11,6 +11,7 @@
 #include "logger.h"
 #include "consumerstatetable.h"
 #include "sai_serialize.h"
+#include "redisreply.h"
 
 using namespace swss;
 
@@ -21,6 +22,179 @@ extern ofstream gRecordOfs;
 extern bool gLogRotate;
 extern string gRecordFile;
 
+/* Retry backoff of a stalled consumer, see ConsumerSchedState */
+#define CONSUMER_RETRY_BACKOFF_MIN_MSECS 1
+#define CONSUMER_RETRY_BACKOFF_MAX_MSECS 1000
+
+/*
+ * Default limits of the adaptive pop batch, see ConsumerBatchSizer.
+ * They are overridden per table from CONFIG_DB by ConsumerBatchOrch.
+ */
+#define CONSUMER_BATCH_MAX_POPS 32
+#define CONSUMER_BATCH_LATENCY_BUDGET_USECS 50000
+
+/* Default keys per chunk of the tables refilled on warm start, see TableBulkReader */
+#define CONSUMER_REFILL_CHUNK_SIZE 1024
+
+uint64_t Orch::m_taskEpoch = 0;
+Orch::RefillSource Orch::m_refillSource;
+size_t Consumer::m_refillChunkSize = CONSUMER_REFILL_CHUNK_SIZE;
+
+TableBulkReader::TableBulkReader(DBConnector *db, Table *table, size_t chunkSize) :
+    m_db(db),
+    m_table(table),
+    m_prefix(table->getTableName() + table->getTableNameSeparator()),
+    m_chunkSize(std::max(chunkSize, (size_t)1))
+{
+}
+
+bool TableBulkReader::next(std::deque<KeyOpFieldsValuesTuple> &entries)
+{
+    if (!m_started)
+    {
+        auto start = sched_clock_t::now();
+        m_table->getKeys(m_keys);
+        m_keysTime += sched_clock_t::now() - start;
+        m_started = true;
+    }
+
+    if (m_next >= m_keys.size())
+    {
+        return false;
+    }
+
+    auto start = sched_clock_t::now();
+    size_t first = m_next;
+    size_t count = std::min(m_chunkSize, m_keys.size() - first);
+    m_next += count;
+
+    /* Every reply is read before any is parsed, so that none is left on the connection */
+    redisContext *ctx = m_db->getContext();
+    for (size_t i = first; i < first + count; i++)
+    {
+        string key = m_prefix + m_keys[i];
+        if (redisAppendCommand(ctx, "HGETALL %b", key.data(), key.size()) != REDIS_OK)
+        {
+            throw runtime_error("Failed to pipeline HGETALL " + key);
+        }
+    }
+
+    vector<unique_ptr<redisReply, void (*)(void *)>> replies;
+    replies.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        void *reply = nullptr;
+        if (redisGetReply(ctx, &reply) != REDIS_OK)
+        {
+            throw runtime_error("Failed to read HGETALL replies");
+        }
+        replies.emplace_back(static_cast<redisReply *>(reply), freeReplyObject);
+    }
+
+    m_fetchTime += sched_clock_t::now() - start;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        KeyOpFieldsValuesTuple kco;
+
+        parseHashReply(replies[i].get(), kfvFieldsValues(kco));
+
+        /* Deleted since the keys were read */
+        if (kfvFieldsValues(kco).empty())
+        {
+            continue;
+        }
+
+        kfvKey(kco) = std::move(m_keys[first + i]);
+        kfvOp(kco) = SET_COMMAND;
+        entries.push_back(std::move(kco));
+    }
+
+    return true;
+}
+
+void TableBulkReader::parseHashReply(const redisReply *reply, vector<FieldValueTuple> &values)
+{
+    if (reply->type != REDIS_REPLY_ARRAY || reply->elements % 2)
+    {
+        throw runtime_error("Unexpected HGETALL reply");
+    }
+
+    values.reserve(reply->elements / 2);
+    for (size_t i = 0; i < reply->elements; i += 2)
+    {
+        const redisReply *field = reply->element[i];
+        const redisReply *value = reply->element[i + 1];
+        if (field->type != REDIS_REPLY_STRING || value->type != REDIS_REPLY_STRING)
+        {
+            throw runtime_error("Unexpected HGETALL reply field");
+        }
+        values.emplace_back(string(field->str, field->len), string(value->str, value->len));
+    }
+}
+
+ConsumerBatchSizer::ConsumerBatchSizer(size_t popSize) :
+    m_popSize(popSize),
+    m_minSize(popSize),
+    m_maxSize(popSize * CONSUMER_BATCH_MAX_POPS),
+    m_batchSize(popSize),
+    m_latencyBudgetUsec(CONSUMER_BATCH_LATENCY_BUDGET_USECS)
+{
+}
+
+void ConsumerBatchSizer::setLimits(size_t minSize, size_t maxSize, uint64_t latencyBudgetUsec)
+{
+    m_minSize = std::max(minSize, (size_t)1);
+    m_maxSize = std::max(maxSize, m_minSize);
+    m_latencyBudgetUsec = latencyBudgetUsec;
+    m_batchSize = std::min(std::max(m_batchSize, m_minSize), m_maxSize);
+    m_changed = true;
+}
+
+void ConsumerBatchSizer::resetLimits()
+{
+    setLimits(m_popSize, m_popSize * CONSUMER_BATCH_MAX_POPS, CONSUMER_BATCH_LATENCY_BUDGET_USECS);
+}
+
+/*
+ * Halve the batch size when the iteration took longer than the latency budget,
+ * double it when the whole batch was popped and the table still has a backlog.
+ */
+void ConsumerBatchSizer::update(size_t popped, bool backlog, uint64_t latencyUsec)
+{
+    m_lastPopped = popped;
+    m_lastLatencyUsec = latencyUsec;
+    m_backlog = backlog;
+
+    size_t batchSize = m_batchSize;
+    if (latencyUsec > m_latencyBudgetUsec)
+    {
+        batchSize = std::max(m_minSize, m_batchSize / 2);
+    }
+    else if (backlog && popped >= m_batchSize)
+    {
+        batchSize = std::min(m_maxSize, m_batchSize * 2);
+    }
+
+    if (batchSize > m_batchSize)
+    {
+        m_growCount++;
+    }
+    else if (batchSize < m_batchSize)
+    {
+        m_shrinkCount++;
+    }
+    else
+    {
+        return;
+    }
+
+    SWSS_LOG_DEBUG("Pop batch size %zu -> %zu, popped %zu, latency %" PRIu64 "us",
+                   m_batchSize, batchSize, popped, latencyUsec);
+    m_batchSize = batchSize;
+    m_changed = true;
+}
+
 Orch::Orch(DBConnector *db, const string tableName, int pri)
 {
     addConsumer(db, tableName, pri);
@@ -52,6 +226,12 @@ Orch::Orch(const vector<TableConnector>& tables)
 
 Orch::~Orch()
 {
+    for (auto *consumer : m_readyConsumers)
+    {
+        consumer->m_sched.ready = false;
+    }
+    m_readyConsumers.clear();
+
     if (gRecordOfs.is_open())
     {
         gRecordOfs.close();
@@ -68,13 +248,22 @@ vector<Selectable *> Orch::getSelectables()
     return selectables;
 }
 
-void Consumer::addToSync(const KeyOpFieldsValuesTuple &entry)
+Consumer::~Consumer()
 {
-    SWSS_LOG_ENTER();
+    if (m_sched.ready && m_orch)
+    {
+        m_orch->clearReady(this);
+    }
+}
 
+void Consumer::addToSync(const KeyOpFieldsValuesTuple &entry)
+{
+    addToSync(KeyOpFieldsValuesTuple(entry));
+}
 
-    string key = kfvKey(entry);
-    string op  = kfvOp(entry);
+void Consumer::addToSync(KeyOpFieldsValuesTuple &&entry)
+{
+    SWSS_LOG_ENTER();
 
     /* Record incoming tasks */
     if (gSwssRecord)
@@ -83,94 +272,46 @@ void Consumer::addToSync(const KeyOpFieldsValuesTuple &entry)
     }
 
     /*
-    * m_toSync is a multimap which will allow one key with multiple values,
-    * Also, the order of the key-value pairs whose keys compare equivalent
-    * is the order of insertion and does not change. (since C++11)
+    * m_toSync keeps at most two tasks per key: DEL, SET or DEL then SET.
+    * A DEL overrides the pending tasks of the key, a SET is merged into the
+    * pending SET if any. See SyncMap::add().
     */
+    m_toSync.add(std::move(entry));
 
-    /* If a new task comes we directly put it into getConsumerTable().m_toSync map */
-    if (m_toSync.find(key) == m_toSync.end())
-    {
-        m_toSync.emplace(key, entry);
-    }
-
-    /* if a DEL task comes, we overwrite the old key */
-    else if (op == DEL_COMMAND)
+    /* New data may unblock the pending tasks, so do not wait for the retry backoff */
+    m_sched.stalled = false;
+    if (m_orch)
     {
-        m_toSync.erase(key);
-        m_toSync.emplace(key, entry);
+        m_orch->setReady(this);
     }
-    else
-    {
-        /*
-        * Now we are trying to add the key-value with SET.
-        * We maintain maximum two values per key.
-        * In case there is one key-value, it should be DEL or SET
-        * In case there are two key-value pairs, it should be DEL then SET
-        * The code logic is following:
-        * We iterate the values with the key, we skip the value with DEL and then
-        * check if that was the only one (I,E, the iter pointer now points to end or next key),
-        * in such case, we insert the key-value with SET.
-        * If there was a SET already (I,E, the pointer still points to the same key), we combine the kfv.
-        */
-        auto ret = m_toSync.equal_range(key);
-        auto iter = ret.first;
-        for (; iter != ret.second; ++iter)
-        {
-            auto old_op = kfvOp(iter->second);
-            if (old_op == SET_COMMAND)
-                break;
-        }
-        if (iter == ret.second)
-        {
-            m_toSync.emplace(key, entry);
-        }
-        else
-        {
-            KeyOpFieldsValuesTuple existing_data = iter->second;
-
-            auto new_values = kfvFieldsValues(entry);
-            auto existing_values = kfvFieldsValues(existing_data);
-
+}
 
-            for (auto it : new_values)
-            {
-                string field = fvField(it);
-                string value = fvValue(it);
+size_t Consumer::addToSync(const std::deque<KeyOpFieldsValuesTuple> &entries)
+{
+    SWSS_LOG_ENTER();
 
-                auto iu = existing_values.begin();
-                while (iu != existing_values.end())
-                {
-                    string ofield = fvField(*iu);
-                    if (field == ofield)
-                        iu = existing_values.erase(iu);
-                    else
-                        iu++;
-                }
-                existing_values.push_back(FieldValueTuple(field, value));
-            }
-            iter->second = KeyOpFieldsValuesTuple(key, op, existing_values);
-        }
+    for (auto& entry: entries)
+    {
+        addToSync(entry);
     }
 
+    return entries.size();
 }
 
-size_t Consumer::addToSync(const std::deque<KeyOpFieldsValuesTuple> &entries)
+size_t Consumer::addToSync(std::deque<KeyOpFieldsValuesTuple> &&entries)
 {
     SWSS_LOG_ENTER();
 
     for (auto& entry: entries)
     {
-        addToSync(entry);
+        addToSync(std::move(entry));
     }
 
     return entries.size();
 }
 
-// TODO: Table should be const
-size_t Consumer::refillToSync(Table* table)
+static void readTable(Table* table, std::deque<KeyOpFieldsValuesTuple> &entries)
 {
-    std::deque<KeyOpFieldsValuesTuple> entries;
     vector<string> keys;
     table->getKeys(keys);
     for (const auto &key: keys)
@@ -184,10 +325,95 @@ size_t Consumer::refillToSync(Table* table)
         {
             continue;
         }
-        entries.push_back(kco);
+        entries.push_back(std::move(kco));
+    }
+}
+
+// TODO: Table should be const
+size_t Consumer::refillToSync(Table* table)
+{
+    std::deque<KeyOpFieldsValuesTuple> entries;
+
+    const auto &source = Orch::getRefillSource();
+    if (source && source(getWarmSnapshotName(), entries))
+    {
+        SWSS_LOG_INFO("Refill %s from warm snapshot, %zu entries", getTableName().c_str(), entries.size());
+        return addToSync(std::move(entries));
+    }
+
+    if (m_refillChunkSize)
+    {
+        try
+        {
+            return bulkRefillToSync(table);
+        }
+        catch (const std::exception &e)
+        {
+            /* Entries refilled so far are refilled again, with the same content */
+            SWSS_LOG_WARN("Failed to bulk read %s, reading it one key at a time: %s",
+                          getTableName().c_str(), e.what());
+        }
+    }
+
+    readTable(table, entries);
+    return addToSync(std::move(entries));
+}
+
+/* Each chunk read is added to m_toSync right away, the whole table is never held twice */
+size_t Consumer::bulkRefillToSync(Table* table)
+{
+    TableBulkReader reader(getConsumerTable()->getDbConnector(), table, m_refillChunkSize);
+
+    auto start = sched_clock_t::now();
+    auto syncTime = sched_clock_t::duration::zero();
+    size_t refilled = 0;
+    size_t chunks = 0;
+
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    while (reader.next(entries))
+    {
+        auto read = sched_clock_t::now();
+        refilled += addToSync(std::move(entries));
+        entries.clear();
+        syncTime += sched_clock_t::now() - read;
+        chunks++;
+    }
+
+    auto ms = [](sched_clock_t::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    SWSS_LOG_NOTICE("Refilled %zu entries of %s in %zu chunks, %.1f ms: keys %.1f ms, fetch %.1f ms, sync %.1f ms",
+                    refilled, table->getTableName().c_str(), chunks, ms(sched_clock_t::now() - start),
+                    ms(reader.getKeysTime()), ms(reader.getFetchTime()), ms(syncTime));
+
+    return refilled;
+}
+
+void Consumer::readConsumedTable(std::deque<KeyOpFieldsValuesTuple> &entries) const
+{
+    auto db = getConsumerTable()->getDbConnector();
+    Table table(db, getTableName());
+
+    if (m_refillChunkSize)
+    {
+        try
+        {
+            TableBulkReader reader(db, &table, m_refillChunkSize);
+            while (reader.next(entries))
+            {
+            }
+            return;
+        }
+        catch (const std::exception &e)
+        {
+            SWSS_LOG_WARN("Failed to bulk read %s, reading it one key at a time: %s",
+                          getTableName().c_str(), e.what());
+            entries.clear();
+        }
     }
 
-    return addToSync(entries);
+    readTable(&table, entries);
 }
 
 size_t Consumer::refillToSync()
@@ -199,7 +425,7 @@ size_t Consumer::refillToSync()
     {
         std::deque<KeyOpFieldsValuesTuple> entries;
         subTable->pops(entries);
-        return addToSync(entries);
+        return addToSync(std::move(entries));
     }
     else
     {
@@ -211,22 +437,85 @@ size_t Consumer::refillToSync()
     }
 }
 
+/*
+ * Only the tables popped through a ConsumerStateTable are kept: the producers
+ * write to the temporary keys and the table only changes when orchagent pops
+ * it, so once frozen the table holds what orchagent consumed.
+ */
+string Consumer::getWarmSnapshotName() const
+{
+    if (dynamic_cast<ConsumerStateTable *>(getConsumerTable()) == nullptr)
+    {
+        return "";
+    }
+
+    return getDbName() + state_db_key_delimiter + getTableName();
+}
+
 void Consumer::execute()
 {
     SWSS_LOG_ENTER();
 
-    std::deque<KeyOpFieldsValuesTuple> entries;
-    getConsumerTable()->pops(entries);
+    popTasks();
+    drain();
+    updateBatchSize(sched_clock_t::now());
+}
 
-    addToSync(entries);
+void Consumer::popTasks()
+{
+    SWSS_LOG_ENTER();
 
-    drain();
+    auto *table = getConsumerTable();
+    size_t popped = 0;
+    bool backlog;
+
+    if (!m_batchPending)
+    {
+        m_batchStart = sched_clock_t::now();
+    }
+
+    /* Keep popping full batches up to the adaptive batch size */
+    do
+    {
+        std::deque<KeyOpFieldsValuesTuple> entries;
+        table->pops(entries);
+
+        backlog = entries.size() >= m_batchSizer.getPopSize();
+        popped += addToSync(std::move(entries));
+    }
+    while (backlog && popped < m_batchSizer.getBatchSize());
+
+    /* Pops made before the previous batch was drained count in the same batch */
+    m_batchPopped = m_batchPending ? m_batchPopped + popped : popped;
+    m_batchBacklog = backlog;
+    m_batchPending = true;
+
+    /* Nothing to drain */
+    if (!m_sched.ready)
+    {
+        updateBatchSize(sched_clock_t::now());
+    }
+}
+
+void Consumer::updateBatchSize(const sched_clock_t::time_point &now)
+{
+    if (!m_batchPending)
+    {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_batchStart);
+    m_batchSizer.update(m_batchPopped, m_batchBacklog, static_cast<uint64_t>(elapsed.count()));
+    m_batchPending = false;
 }
 
 void Consumer::drain()
 {
     if (!m_toSync.empty())
         m_orch->doTask(*this);
+
+    if (m_toSync.empty() && m_sched.ready)
+        m_orch->clearReady(this);
 }
 
 string Consumer::dumpTuple(const KeyOpFieldsValuesTuple &tuple)
@@ -511,6 +800,133 @@ void Orch::doTask()
     }
 }
 
+void Orch::setReady(Consumer *consumer)
+{
+    if (!consumer->m_sched.ready)
+    {
+        consumer->m_sched.ready = true;
+        m_readyConsumers.insert(consumer);
+    }
+}
+
+void Orch::clearReady(Consumer *consumer)
+{
+    consumer->m_sched = ConsumerSchedState();
+    m_readyConsumers.erase(consumer);
+}
+
+/*
+ * Whether some ready consumer is due: not stalled, or stalled but some task made
+ * progress since then, or its retry backoff expired. When none is due, the
+ * earliest retry time is folded into nextRetry.
+ */
+bool Orch::hasDueTasks(const sched_clock_t::time_point &now, sched_clock_t::time_point &nextRetry) const
+{
+    for (auto *consumer : m_readyConsumers)
+    {
+        const auto &sched = consumer->m_sched;
+        if (!sched.stalled || sched.stallEpoch != m_taskEpoch || now >= sched.retryTime)
+        {
+            return true;
+        }
+    }
+
+    for (auto *consumer : m_readyConsumers)
+    {
+        nextRetry = std::min(nextRetry, consumer->m_sched.retryTime);
+    }
+    return false;
+}
+
+/* Highest table priority among the ready consumers */
+int Orch::getReadyPriority() const
+{
+    int pri = default_orch_pri;
+    for (auto *consumer : m_readyConsumers)
+    {
+        pri = std::max(pri, consumer->getPri());
+    }
+    return pri;
+}
+
+/*
+ * Run doTask() and then classify each ready consumer: drained consumers leave
+ * the ready set, consumers without progress are stalled with an exponential
+ * retry backoff. Any progress bumps the task epoch, which makes all stalled
+ * consumers due again on the next pass.
+ */
+void Orch::doReadyTasks(const sched_clock_t::time_point &now,
+                        sched_clock_t::time_point &nextRetry,
+                        OrchSchedulerStats &stats)
+{
+    m_readySnapshot.clear();
+    for (auto *consumer : m_readyConsumers)
+    {
+        m_readySnapshot.emplace_back(consumer, consumer->m_toSync.epoch());
+    }
+
+    stats.orchsRun++;
+    doTask();
+
+    auto end = sched_clock_t::now();
+    for (const auto &it : m_readySnapshot)
+    {
+        it.first->updateBatchSize(end);
+    }
+
+    /* A consumer progressed if doTask() added or erased any of its tasks */
+    bool progress = false;
+    for (const auto &it : m_readySnapshot)
+    {
+        if (it.first->m_toSync.epoch() != it.second)
+        {
+            progress = true;
+            break;
+        }
+    }
+    if (progress)
+    {
+        m_taskEpoch++;
+    }
+
+    for (const auto &it : m_readySnapshot)
+    {
+        auto *consumer = it.first;
+        if (consumer->m_toSync.empty())
+        {
+            if (consumer->m_sched.ready)
+            {
+                clearReady(consumer);
+            }
+            stats.consumersDrained++;
+            continue;
+        }
+
+        auto &sched = consumer->m_sched;
+        if (consumer->m_toSync.epoch() != it.second)
+        {
+            sched.stalled = false;
+            sched.backoff = sched_clock_t::duration::zero();
+            continue;
+        }
+
+        if (!sched.stalled)
+        {
+            sched.backoff = std::chrono::milliseconds(CONSUMER_RETRY_BACKOFF_MIN_MSECS);
+        }
+        else
+        {
+            sched.backoff = std::min<sched_clock_t::duration>(sched.backoff * 2,
+                    std::chrono::milliseconds(CONSUMER_RETRY_BACKOFF_MAX_MSECS));
+        }
+        sched.stalled = true;
+        sched.stallEpoch = m_taskEpoch;
+        sched.retryTime = now + sched.backoff;
+        nextRetry = std::min(nextRetry, sched.retryTime);
+        stats.consumersStalled++;
+    }
+}
+
 void Orch::dumpPendingTasks(vector<string> &ts)
 {
     for (auto &it : m_consumerMap)
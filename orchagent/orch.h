@@ -5,8 +5,12 @@
 #include <unordered_set>
 #include <map>
 #include <set>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <utility>
+#include <chrono>
+#include <algorithm>
 
 extern "C" {
 #include "sai.h"
@@ -20,6 +24,7 @@ extern "C" {
 #include "notificationconsumer.h"
 #include "selectabletimer.h"
 #include "macaddress.h"
+#include "syncmap.h"
 
 const char delimiter           = ':';
 const char list_item_delimiter = ',';
@@ -71,15 +76,52 @@ typedef std::map<std::string, object_reference_map*> type_map;
 typedef std::map<std::string, sai_object_id_t> object_map;
 typedef std::pair<std::string, sai_object_id_t> object_map_pair;
 
-// Use multimap to support multiple OpFieldsValues for the same key (e,g, DEL and SET)
-// The order of the key-value pairs whose keys compare equivalent is the order of
-// insertion and does not change. (since C++11)
-typedef std::multimap<std::string, swss::KeyOpFieldsValuesTuple> SyncMap;
 
 typedef std::pair<std::string, int> table_name_with_pri_t;
 
+typedef std::chrono::steady_clock sched_clock_t;
+
 class Orch;
 
+/*
+ * Per-consumer bookkeeping of the ready-list scheduler run by OrchDaemon.
+ * A consumer is ready while its m_toSync holds tasks. A ready consumer whose
+ * last drain made no progress is stalled: it is retried once some other task
+ * made progress, or once its retry backoff has expired.
+ */
+struct ConsumerSchedState
+{
+    bool ready = false;
+    bool stalled = false;
+    uint64_t stallEpoch = 0;
+    sched_clock_t::duration backoff = sched_clock_t::duration::zero();
+    sched_clock_t::time_point retryTime;
+};
+
+/* Counters of the ready-list scheduler, per loop or accumulated */
+struct OrchSchedulerStats
+{
+    uint64_t loops = 0;             // scheduler passes
+    uint64_t orchsRun = 0;          // orchs with ready consumers whose doTask() was run
+    uint64_t orchsIdle = 0;         // orchs skipped since none of their consumers had tasks
+    uint64_t consumersDrained = 0;  // ready consumers left with empty m_toSync
+    uint64_t consumersStalled = 0;  // ready consumers which made no progress
+    uint64_t consumersDeferred = 0; // stalled consumers skipped while backing off
+    uint64_t orchsPreempted = 0;    // due orchs postponed to the next pass once the time slice was used
+
+    OrchSchedulerStats& operator+=(const OrchSchedulerStats &o)
+    {
+        loops += o.loops;
+        orchsRun += o.orchsRun;
+        orchsIdle += o.orchsIdle;
+        consumersDrained += o.consumersDrained;
+        consumersStalled += o.consumersStalled;
+        consumersDeferred += o.consumersDeferred;
+        orchsPreempted += o.orchsPreempted;
+        return *this;
+    }
+};
+
 // Design assumption
 // 1. one Orch can have one or more Executor
 // 2. one Executor must belong to one and only one Orch
@@ -88,7 +130,8 @@ class Executor : public swss::Selectable
 {
 public:
     Executor(swss::Selectable *selectable, Orch *orch, const std::string &name)
-        : m_selectable(selectable)
+        : swss::Selectable(selectable->getPri())
+        , m_selectable(selectable)
         , m_orch(orch)
         , m_name(name)
     {
@@ -127,13 +170,100 @@ protected:
     swss::Selectable *getSelectable() const { return m_selectable; }
 };
 
+/*
+ * Adaptive number of entries Consumer::execute() pops before draining them.
+ * The batch size grows while the backlog persists, i.e. pops keep returning
+ * full batches, and shrinks when an iteration exceeds the latency budget.
+ * Pops are done in units of the table pop size, within [minSize, maxSize].
+ */
+class ConsumerBatchSizer
+{
+public:
+    ConsumerBatchSizer(size_t popSize);
+
+    void setLimits(size_t minSize, size_t maxSize, uint64_t latencyBudgetUsec);
+    void resetLimits();
+    void update(size_t popped, bool backlog, uint64_t latencyUsec);
+
+    size_t getBatchSize() const { return m_batchSize; }
+    size_t getPopSize() const { return m_popSize; }
+    size_t getMinSize() const { return m_minSize; }
+    size_t getMaxSize() const { return m_maxSize; }
+    uint64_t getLatencyBudget() const { return m_latencyBudgetUsec; }
+    size_t getLastPopped() const { return m_lastPopped; }
+    uint64_t getLastLatency() const { return m_lastLatencyUsec; }
+    bool hasBacklog() const { return m_backlog; }
+    uint64_t getGrowCount() const { return m_growCount; }
+    uint64_t getShrinkCount() const { return m_shrinkCount; }
+
+    /* Set when the batch size or the limits changed since the last call */
+    bool fetchChanged()
+    {
+        bool changed = m_changed;
+        m_changed = false;
+        return changed;
+    }
+
+private:
+    size_t m_popSize;
+    size_t m_minSize;
+    size_t m_maxSize;
+    size_t m_batchSize;
+    uint64_t m_latencyBudgetUsec;
+
+    size_t m_lastPopped = 0;
+    uint64_t m_lastLatencyUsec = 0;
+    bool m_backlog = false;
+    uint64_t m_growCount = 0;
+    uint64_t m_shrinkCount = 0;
+    bool m_changed = true;
+};
+
+/*
+ * Reads a whole table in chunks. The keys of the table are read once with KEYS,
+ * which only returns the keys of this table. The HGETALL of each chunk of
+ * chunkSize keys is then pipelined on the connection. Reading the table costs
+ * one round trip to redis plus one per chunk, where reading the keys one at a
+ * time costs one per key. Only the keys are held for the whole read.
+ */
+class TableBulkReader
+{
+public:
+    TableBulkReader(swss::DBConnector *db, swss::Table *table, size_t chunkSize);
+
+    /* Append the next chunk to entries, returns false once the table was read. Throws on redis errors */
+    bool next(std::deque<swss::KeyOpFieldsValuesTuple> &entries);
+
+    /* Time spent waiting for the KEYS and HGETALL replies */
+    sched_clock_t::duration getKeysTime() const { return m_keysTime; }
+    sched_clock_t::duration getFetchTime() const { return m_fetchTime; }
+
+    /* Parse an HGETALL reply */
+    static void parseHashReply(const redisReply *reply, std::vector<swss::FieldValueTuple> &values);
+
+private:
+    swss::DBConnector *m_db;
+    swss::Table *m_table;
+    std::string m_prefix;
+    size_t m_chunkSize;
+    std::vector<std::string> m_keys;
+    size_t m_next = 0;
+    bool m_started = false;
+
+    sched_clock_t::duration m_keysTime = sched_clock_t::duration::zero();
+    sched_clock_t::duration m_fetchTime = sched_clock_t::duration::zero();
+};
+
 class Consumer : public Executor {
 public:
     Consumer(swss::ConsumerTableBase *select, Orch *orch, const std::string &name)
         : Executor(select, orch, name)
+        , m_batchSizer(static_cast<size_t>(std::max(select->POP_BATCH_SIZE, 1)))
     {
     }
 
+    ~Consumer() override;
+
     swss::ConsumerTableBase *getConsumerTable() const
     {
         return static_cast<swss::ConsumerTableBase *>(getSelectable());
@@ -159,17 +289,52 @@ public:
 
     size_t refillToSync();
     size_t refillToSync(swss::Table* table);
+
+    /* Keys per chunk of the tables refilled by TableBulkReader, 0 to read them one key at a time */
+    static void setRefillChunkSize(size_t chunkSize) { m_refillChunkSize = chunkSize; }
+
+    /* Read the consumed table from redis, in chunks of the refill chunk size if set */
+    void readConsumedTable(std::deque<swss::KeyOpFieldsValuesTuple> &entries) const;
+
+    /* Name of the consumed table in a WarmSnapshot, empty when it is not kept in snapshots */
+    std::string getWarmSnapshotName() const;
     void execute();
     void drain();
 
+    /*
+     * Pop up to the adaptive batch size into m_toSync without draining it, the
+     * ready consumer is then drained by OrchScheduler. The batch size is updated
+     * once its orch ran, with the latency from the pop to the end of doTask().
+     */
+    void popTasks();
+    void updateBatchSize(const sched_clock_t::time_point &now);
+
     /* Store the latest 'golden' status */
     // TODO: hide?
     SyncMap m_toSync;
 
     void addToSync(const swss::KeyOpFieldsValuesTuple &entry);
+    void addToSync(swss::KeyOpFieldsValuesTuple &&entry);
 
     // Returns: the number of entries added to m_toSync
     size_t addToSync(const std::deque<swss::KeyOpFieldsValuesTuple> &entries);
+    size_t addToSync(std::deque<swss::KeyOpFieldsValuesTuple> &&entries);
+
+    /* Scheduling state, owned by m_orch */
+    ConsumerSchedState m_sched;
+
+    ConsumerBatchSizer m_batchSizer;
+
+private:
+    static size_t m_refillChunkSize;
+
+    /* Last popped batch, until updateBatchSize() */
+    sched_clock_t::time_point m_batchStart;
+    size_t m_batchPopped = 0;
+    bool m_batchBacklog = false;
+    bool m_batchPending = false;
+
+    size_t bulkRefillToSync(swss::Table* table);
 };
 
 typedef std::map<std::string, std::shared_ptr<Executor>> ConsumerMap;
@@ -218,7 +383,43 @@ public:
     static void recordTuple(Consumer &consumer, const swss::KeyOpFieldsValuesTuple &tuple);
 
     void dumpPendingTasks(std::vector<std::string> &ts);
+
+    const ConsumerMap &getConsumerMap() const { return m_consumerMap; }
+
+    /*
+     * Where refillToSync() takes the consumer tables from, before reading them
+     * from redis, while set: source(table, entries) returns false when it does
+     * not have the table named by Consumer::getWarmSnapshotName().
+     */
+    typedef std::function<bool(const std::string &, std::deque<swss::KeyOpFieldsValuesTuple> &)> RefillSource;
+    static void setRefillSource(RefillSource source) { m_refillSource = source; }
+    static const RefillSource &getRefillSource() { return m_refillSource; }
+
+    /*
+     * Ready-list scheduling, see ConsumerSchedState and OrchScheduler.
+     * Only doTask() of an Orch having due ready consumers is run, stalled
+     * consumers are skipped until their retry time.
+     */
+    void setReady(Consumer *consumer);
+    void clearReady(Consumer *consumer);
+    bool hasReadyConsumers() const { return !m_readyConsumers.empty(); }
+    size_t getReadyConsumerCount() const { return m_readyConsumers.size(); }
+    bool hasDueTasks(const sched_clock_t::time_point &now, sched_clock_t::time_point &nextRetry) const;
+    int getReadyPriority() const;
+    void doReadyTasks(const sched_clock_t::time_point &now,
+                      sched_clock_t::time_point &nextRetry,
+                      OrchSchedulerStats &stats);
+
+    /* Weighted run time accounted by OrchScheduler */
+    uint64_t getVirtualRuntime() const { return m_vruntime; }
+    void setVirtualRuntime(uint64_t vruntime) { m_vruntime = vruntime; }
+
+    /* Signal that some state changed, so that stalled consumers are worth retrying */
+    static void bumpTaskEpoch() { m_taskEpoch++; }
 protected:
+    /* Declared ahead of m_consumerMap so that it outlives the consumers */
+    std::unordered_set<Consumer *> m_readyConsumers;
+
     ConsumerMap m_consumerMap;
 
     static void logfileReopen();
@@ -242,6 +443,14 @@ protected:
     virtual task_process_status handleSaiRemoveStatus(sai_api_t api, sai_status_t status, void *context = nullptr);
     bool parseHandleSaiStatusFailure(task_process_status status);
 private:
+    static uint64_t m_taskEpoch;
+    static RefillSource m_refillSource;
+
+    uint64_t m_vruntime = 0;
+
+    /* Epoch of the ready consumers before doTask(), reused to avoid allocating on every scheduler pass */
+    std::vector<std::pair<Consumer *, uint64_t>> m_readySnapshot;
+
     void removeMeFromObjsReferencedByMe(type_map &type_maps, const std::string &table, const std::string &obj_name, const std::string &field, const std::string &old_referenced_obj_name);
     void addConsumer(swss::DBConnector *db, std::string tableName, int pri = default_orch_pri);
 };
@@ -1,6 +1,7 @@
 #include <unistd.h>
 #include <unordered_map>
 #include <limits.h>
+#include <inttypes.h>
 #include "orchdaemon.h"
 #include "logger.h"
 #include <sairedis.h>
@@ -17,6 +18,10 @@ using namespace swss;
 #define SELECT_TIMEOUT 1000
 #define PFC_WD_POLL_MSECS 100
 
+/* Snapshot of the consumer tables written on freeze, and its id in STATE_DB WARM_RESTART_TABLE */
+#define WARM_SNAPSHOT_PATH "/var/warmboot/orchagent_snapshot.bin"
+#define WARM_SNAPSHOT_ID_FIELD "snapshot_id"
+
 extern sai_switch_api_t*           sai_switch_api;
 extern sai_object_id_t             gSwitchId;
 extern bool                        gSaiRedisLogRotate;
@@ -45,12 +50,17 @@ bool gIsNatSupported = false;
 
 #define DEFAULT_MAX_BULK_SIZE 1000
 size_t gMaxBulkSize = DEFAULT_MAX_BULK_SIZE;
+bool gRoutePipeline = false;
+bool gLuaRates = false;
+bool gLuaPfcWd = false;
+bool gAclFlexCounters = false;
 
 OrchDaemon::OrchDaemon(DBConnector *applDb, DBConnector *configDb, DBConnector *stateDb, DBConnector *chassisAppDb) :
         m_applDb(applDb),
         m_configDb(configDb),
         m_stateDb(stateDb),
-        m_chassisAppDb(chassisAppDb)
+        m_chassisAppDb(chassisAppDb),
+        m_scheduler(m_orchList)
 {
     SWSS_LOG_ENTER();
     m_select = new Select();
@@ -152,7 +162,8 @@ bool OrchDaemon::init()
 
     gFgNhgOrch = new FgNhgOrch(m_configDb, m_applDb, m_stateDb, fgnhg_tables, gNeighOrch, gIntfsOrch, vrf_orch);
     gDirectory.set(gFgNhgOrch);
-    gRouteOrch = new RouteOrch(m_applDb, APP_ROUTE_TABLE_NAME, gSwitchOrch, gNeighOrch, gIntfsOrch, vrf_orch, gFgNhgOrch);
+    TableConnector stateDbRouteStats(m_stateDb, STATE_VRF_ROUTE_STATS_TABLE_NAME);
+    gRouteOrch = new RouteOrch(m_applDb, APP_ROUTE_TABLE_NAME, stateDbRouteStats, gSwitchOrch, gNeighOrch, gIntfsOrch, vrf_orch, gFgNhgOrch);
 
     CoppOrch  *copp_orch  = new CoppOrch(m_applDb, APP_COPP_TABLE_NAME);
     TunnelDecapOrch *tunnel_decap_orch = new TunnelDecapOrch(m_applDb, APP_TUNNEL_DECAP_TABLE_NAME);
@@ -495,6 +506,9 @@ bool OrchDaemon::init()
 
     m_orchList.push_back(&CounterCheckOrch::getInstance(m_configDb));
 
+    /* Tunes the pop batch of the consumers of all the orchs above */
+    m_orchList.push_back(new ConsumerBatchOrch(m_configDb, m_stateDb, m_orchList));
+
     if (WarmStart::isWarmStart())
     {
         bool suc = warmRestoreAndSyncUp();
@@ -503,6 +517,11 @@ bool OrchDaemon::init()
             return false;
         }
     }
+    else
+    {
+        /* A snapshot left over by a warm restart which did not happen */
+        WarmSnapshot(WARM_SNAPSHOT_PATH).remove();
+    }
 
     return true;
 }
@@ -544,12 +563,14 @@ void OrchDaemon::start()
         m_select->addSelectables(o->getSelectables());
     }
 
+    int timeout = SELECT_TIMEOUT;
+
     while (true)
     {
         Selectable *s;
         int ret;
 
-        ret = m_select->select(&s, SELECT_TIMEOUT);
+        ret = m_select->select(&s, timeout);
 
         if (ret == Select::ERROR)
         {
@@ -559,6 +580,15 @@ void OrchDaemon::start()
 
         if (ret == Select::TIMEOUT)
         {
+            /* Run the tasks postponed by the previous pass and retry the
+             * stalled tasks whose backoff has expired */
+            timeout = m_scheduler.doReadyTasks(SELECT_TIMEOUT);
+            if (m_scheduler.getLastStats().orchsPreempted)
+            {
+                continue;
+            }
+            reportSchedulerStats();
+
             /* Let sairedis to flush all SAI function call to ASIC DB.
              * Normally the redis pipeline will flush when enough request
              * accumulated. Still it is possible that small amount of
@@ -569,14 +599,24 @@ void OrchDaemon::start()
         }
 
         auto *c = (Executor *)s;
-        c->execute();
+        auto *consumer = dynamic_cast<Consumer *>(c);
+        if (consumer)
+        {
+            /* The popped tasks are drained by the scheduler below, in weighted-fair
+             * order with the tasks of the other ready consumers */
+            consumer->popTasks();
+        }
+        else
+        {
+            c->execute();
 
-        /* After each iteration, periodically check all m_toSync map to
-         * execute all the remaining tasks that need to be retried. */
+            /* Notifications and timers may change state that pending tasks wait for */
+            Orch::bumpTaskEpoch();
+        }
 
-        /* TODO: Abstract Orch class to have a specific todo list */
-        for (Orch *o : m_orchList)
-            o->doTask();
+        /* After each iteration, run the consumers having tasks in their m_toSync
+         * map, newly popped or to be retried, within the scheduler time slice. */
+        timeout = m_scheduler.doReadyTasks(SELECT_TIMEOUT);
 
         /*
          * Asked to check warm restart readiness.
@@ -616,6 +656,28 @@ void OrchDaemon::start()
     }
 }
 
+/* Log the scheduler counters accumulated since the previous report */
+void OrchDaemon::reportSchedulerStats()
+{
+    const auto &stats = m_scheduler.getStats();
+    if (stats.orchsRun == m_reportedSchedStats.orchsRun)
+    {
+        return;
+    }
+
+    SWSS_LOG_INFO("Scheduler: %" PRIu64 " passes, orchs run %" PRIu64 " idle %" PRIu64 " preempted %" PRIu64
+                  ", consumers drained %" PRIu64 " stalled %" PRIu64 " deferred %" PRIu64,
+                  stats.loops - m_reportedSchedStats.loops,
+                  stats.orchsRun - m_reportedSchedStats.orchsRun,
+                  stats.orchsIdle - m_reportedSchedStats.orchsIdle,
+                  stats.orchsPreempted - m_reportedSchedStats.orchsPreempted,
+                  stats.consumersDrained - m_reportedSchedStats.consumersDrained,
+                  stats.consumersStalled - m_reportedSchedStats.consumersStalled,
+                  stats.consumersDeferred - m_reportedSchedStats.consumersDeferred);
+
+    m_reportedSchedStats = stats;
+}
+
 /*
  * Try to perform orchagent state restore and dynamic states sync up if
  * warm start request is detected.
@@ -624,11 +686,23 @@ bool OrchDaemon::warmRestoreAndSyncUp()
 {
     WarmStart::setWarmStartState("orchagent", WarmStart::INITIALIZED);
 
+    /* Consumer tables kept in the snapshot are not read back from redis */
+    WarmSnapshot snapshot(WARM_SNAPSHOT_PATH);
+    if (loadWarmSnapshot(snapshot))
+    {
+        Orch::setRefillSource([&snapshot](const string &table, deque<KeyOpFieldsValuesTuple> &entries) {
+            return snapshot.take(table, entries);
+        });
+    }
+
     for (Orch *o : m_orchList)
     {
         o->bake();
     }
 
+    Orch::setRefillSource(nullptr);
+    snapshot.remove();
+
     /*
      * Three iterations are needed.
      *
@@ -688,6 +762,53 @@ bool OrchDaemon::warmRestoreAndSyncUp()
     return true;
 }
 
+/*
+ * Write the frozen consumer tables to a snapshot for the next warm start,
+ * and record its id in STATE_DB. On failure, warm start reads the tables from redis.
+ */
+bool OrchDaemon::saveWarmSnapshot()
+{
+    SWSS_LOG_ENTER();
+
+    WarmSnapshot snapshot(WARM_SNAPSHOT_PATH);
+    uint64_t id = WarmSnapshot::newId();
+
+    /* Never leave an earlier snapshot behind, its id may still be in STATE_DB */
+    snapshot.remove();
+
+    bool suc = snapshot.begin(id);
+    for (Orch *o : m_orchList)
+    {
+        suc = suc && snapshot.add(*o);
+    }
+
+    if (!suc || !snapshot.commit())
+    {
+        SWSS_LOG_WARN("Failed to save warm snapshot, warm start will read the tables from redis");
+        return false;
+    }
+
+    Table warmRestartTable(m_stateDb, STATE_WARM_RESTART_TABLE_NAME);
+    warmRestartTable.hset("orchagent", WARM_SNAPSHOT_ID_FIELD, to_string(id));
+    return true;
+}
+
+/* Load the snapshot saved on freeze, if it is the one whose id is recorded in STATE_DB */
+bool OrchDaemon::loadWarmSnapshot(WarmSnapshot &snapshot)
+{
+    SWSS_LOG_ENTER();
+
+    Table warmRestartTable(m_stateDb, STATE_WARM_RESTART_TABLE_NAME);
+    string id;
+    if (!warmRestartTable.hget("orchagent", WARM_SNAPSHOT_ID_FIELD, id))
+    {
+        SWSS_LOG_NOTICE("No warm snapshot saved, reading the tables from redis");
+        return false;
+    }
+
+    return snapshot.load(strtoull(id.c_str(), NULL, 10));
+}
+
 /*
  * Get tasks to sync for consumers of each orch being managed by this orch daemon
  */
@@ -756,6 +877,16 @@ bool OrchDaemon::warmRestartCheck()
         }
     }
 
+    /*
+     * Orchagent stops processing once READY is replied, and may be stopped
+     * right after: the snapshot is committed, or has failed and warm start
+     * reads redis, by then.
+     */
+    if (ret && !gSwitchOrch->checkRestartNoFreeze())
+    {
+        saveWarmSnapshot();
+    }
+
     SWSS_LOG_NOTICE("Restart check result: %s", data.c_str());
     gSwitchOrch->restartCheckReply(op,  data, values);
     return ret;
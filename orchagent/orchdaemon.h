@@ -34,6 +34,9 @@
 #include "natorch.h"
 #include "muxorch.h"
 #include "macsecorch.h"
+#include "consumerbatchorch.h"
+#include "orchscheduler.h"
+#include "warmsnapshot.h"
 
 using namespace swss;
 
@@ -50,12 +53,23 @@ public:
     bool warmRestoreValidation();
 
     bool warmRestartCheck();
+    bool saveWarmSnapshot();
 
     void addOrchList(Orch* o);
     void setFabricEnabled(bool enabled)
     {
         m_fabricEnabled = enabled;
     }
+
+    /* Counters of the ready-list scheduler: last pass and accumulated */
+    const OrchSchedulerStats& getLastSchedulerStats() const
+    {
+        return m_scheduler.getLastStats();
+    }
+    const OrchSchedulerStats& getSchedulerStats() const
+    {
+        return m_scheduler.getStats();
+    }
 private:
     DBConnector *m_applDb;
     DBConnector *m_configDb;
@@ -67,7 +81,12 @@ private:
     std::vector<Orch *> m_orchList;
     Select *m_select;
 
+    OrchScheduler m_scheduler;
+    OrchSchedulerStats m_reportedSchedStats;
+
     void flush();
+    void reportSchedulerStats();
+    bool loadWarmSnapshot(WarmSnapshot &snapshot);
 };
 
 class FabricOrchDaemon : public OrchDaemon
@@ -0,0 +1,108 @@
+#include <inttypes.h>
+#include <algorithm>
+#include "orchscheduler.h"
+#include "logger.h"
+
+using namespace std;
+
+/* Default run time of a scheduler pass */
+#define SCHED_TIME_SLICE_USECS 10000
+
+OrchScheduler::OrchScheduler(const vector<Orch *> &orchs) :
+    m_orchs(orchs),
+    m_timeSlice(chrono::microseconds(SCHED_TIME_SLICE_USECS))
+{
+}
+
+/* Weight of an orch given the priority of its ready tables, at least 1 */
+uint64_t OrchScheduler::getWeight(int pri)
+{
+    return static_cast<uint64_t>(max(pri, 0)) + 1;
+}
+
+int OrchScheduler::doReadyTasks(int maxTimeout)
+{
+    auto start = sched_clock_t::now();
+    auto nextRetry = sched_clock_t::time_point::max();
+
+    m_lastStats = OrchSchedulerStats();
+    m_lastStats.loops = 1;
+
+    m_runQueue.clear();
+    for (Orch *o : m_orchs)
+    {
+        if (!o->hasReadyConsumers())
+        {
+            m_lastStats.orchsIdle++;
+            continue;
+        }
+
+        if (!o->hasDueTasks(start, nextRetry))
+        {
+            m_lastStats.consumersDeferred += o->getReadyConsumerCount();
+            continue;
+        }
+
+        /* An orch becoming ready does not get credit for the time it was idle */
+        o->setVirtualRuntime(max(o->getVirtualRuntime(), m_minVruntime));
+        m_runQueue.push_back(o);
+    }
+
+    /*
+     * Ties go to the highest priority, and stable so that orchs of equal run time
+     * and priority keep the order of the orch list
+     */
+    stable_sort(m_runQueue.begin(), m_runQueue.end(), [](const Orch *a, const Orch *b) {
+        if (a->getVirtualRuntime() != b->getVirtualRuntime())
+        {
+            return a->getVirtualRuntime() < b->getVirtualRuntime();
+        }
+        return a->getReadyPriority() > b->getReadyPriority();
+    });
+
+    if (!m_runQueue.empty())
+    {
+        m_minVruntime = m_runQueue.front()->getVirtualRuntime();
+    }
+
+    bool preempted = false;
+    for (size_t i = 0; i < m_runQueue.size(); i++)
+    {
+        auto now = sched_clock_t::now();
+        if (i > 0 && now - start >= m_timeSlice)
+        {
+            m_lastStats.orchsPreempted += m_runQueue.size() - i;
+            preempted = true;
+            break;
+        }
+
+        Orch *o = m_runQueue[i];
+        uint64_t weight = getWeight(o->getReadyPriority());
+
+        o->doReadyTasks(now, nextRetry, m_lastStats);
+
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(sched_clock_t::now() - now);
+        o->setVirtualRuntime(o->getVirtualRuntime() + static_cast<uint64_t>(elapsed.count()) / weight);
+    }
+
+    m_stats += m_lastStats;
+
+    SWSS_LOG_DEBUG("Scheduler pass: run %" PRIu64 " idle %" PRIu64 " preempted %" PRIu64 " orchs, drained %" PRIu64
+                   " stalled %" PRIu64 " deferred %" PRIu64 " consumers",
+                   m_lastStats.orchsRun, m_lastStats.orchsIdle, m_lastStats.orchsPreempted,
+                   m_lastStats.consumersDrained, m_lastStats.consumersStalled,
+                   m_lastStats.consumersDeferred);
+
+    if (preempted)
+    {
+        return 0;
+    }
+
+    if (nextRetry == sched_clock_t::time_point::max())
+    {
+        return maxTimeout;
+    }
+
+    auto wait = chrono::duration_cast<chrono::milliseconds>(nextRetry - sched_clock_t::now()).count();
+    return static_cast<int>(max<int64_t>(min<int64_t>(wait, maxTimeout), 0));
+}
@@ -0,0 +1,50 @@
+#ifndef SWSS_ORCHSCHEDULER_H
+#define SWSS_ORCHSCHEDULER_H
+
+#include <vector>
+#include "orch.h"
+
+/*
+ * Weighted-fair scheduler of the pending tasks of the orchs.
+ *
+ * Only orchs having due ready consumers are run. Each run is charged to the orch
+ * as run time divided by its weight, which is derived from the highest table
+ * priority among its ready consumers, and orchs with the least weighted run time
+ * are run first. A pass stops once its time slice is used and the remaining orchs
+ * run first on the next pass, so that a high priority table (port, neighbor, mux
+ * state) waits at most one slice plus one doTask() while routes are drained.
+ */
+class OrchScheduler
+{
+public:
+    OrchScheduler(const std::vector<Orch *> &orchs);
+
+    /*
+     * Run one pass, returns the select timeout in milliseconds until the next due
+     * task, 0 when the pass was preempted, maxTimeout when no task is pending
+     */
+    int doReadyTasks(int maxTimeout);
+
+    void setTimeSlice(sched_clock_t::duration slice) { m_timeSlice = slice; }
+
+    /* Counters of the last pass and accumulated */
+    const OrchSchedulerStats& getLastStats() const { return m_lastStats; }
+    const OrchSchedulerStats& getStats() const { return m_stats; }
+
+    static uint64_t getWeight(int pri);
+
+private:
+    const std::vector<Orch *> &m_orchs;
+    sched_clock_t::duration m_timeSlice;
+
+    /* Reused on every pass to avoid allocating */
+    std::vector<Orch *> m_runQueue;
+
+    /* Floor of the weighted run time given to orchs becoming ready */
+    uint64_t m_minVruntime = 0;
+
+    OrchSchedulerStats m_lastStats;
+    OrchSchedulerStats m_stats;
+};
+
+#endif /* SWSS_ORCHSCHEDULER_H */
@@ -0,0 +1,585 @@
+#include <stdlib.h>
+#include <stdexcept>
+
+#include "pfcwddetector.h"
+#include "orch.h"
+#include "logger.h"
+#include "rediscommand.h"
+#include "schema.h"
+
+using namespace std;
+using namespace swss;
+
+#define PFC_WD_EVENT_STORM      "storm"
+#define PFC_WD_EVENT_RESTORE    "restore"
+#define PFC_WD_DEBUG_STORM      "DEBUG_STORM"
+
+/* The plugins take a storm for a port paused for more than 80% of the poll time */
+static const double pauseDurationRatio = 0.8;
+
+static inline int64_t delta(uint64_t current, uint64_t last)
+{
+    /* As the plugins compute it, a cleared counter gives a negative delta */
+    return static_cast<int64_t>(current - last);
+}
+
+unique_ptr<PfcWdStormPolicy> PfcWdStormPolicy::create(const string &platform)
+{
+    if (platform == MLNX_PLATFORM_SUBSTRING)
+    {
+        return unique_ptr<PfcWdStormPolicy>(new PfcWdPauseDurationPolicy("RX_PAUSE_DURATION_US", PortLast::FORGET_ON_STORM));
+    }
+    else if (platform == BFN_PLATFORM_SUBSTRING)
+    {
+        return unique_ptr<PfcWdStormPolicy>(new PfcWdPauseDurationPolicy("RX_PAUSE_DURATION", PortLast::FORGET_ON_STORM));
+    }
+    else if (platform == NPS_PLATFORM_SUBSTRING)
+    {
+        return unique_ptr<PfcWdStormPolicy>(new PfcWdPauseDurationPolicy("RX_PAUSE_DURATION", PortLast::UPDATE));
+    }
+    else if (platform == INVM_PLATFORM_SUBSTRING)
+    {
+        return unique_ptr<PfcWdStormPolicy>(new PfcWdInnoviumPolicy());
+    }
+    else if (platform == BRCM_PLATFORM_SUBSTRING)
+    {
+        return unique_ptr<PfcWdStormPolicy>(new PfcWdOn2OffPolicy());
+    }
+
+    return nullptr;
+}
+
+string PfcWdOn2OffPolicy::getAuxCounter(uint8_t tc) const
+{
+    return "SAI_PORT_STAT_PFC_" + to_string(tc) + "_ON2OFF_RX_PKTS";
+}
+
+void PfcWdOn2OffPolicy::detect(const PfcWdCounterArrays &c, uint8_t *storm) const
+{
+    for (size_t i = 0; i < c.count; i++)
+    {
+        storm[i] = delta(c.pfcRx[i], c.pfcRxLast[i]) > 0 &&
+                c.pfcAux[i] == c.pfcAuxLast[i] &&
+                c.pausedLast[i] && c.paused[i];
+    }
+}
+
+PfcWdPauseDurationPolicy::PfcWdPauseDurationPolicy(const string &durationSuffix, PortLast portLast) :
+    m_durationSuffix(durationSuffix),
+    m_portLast(portLast)
+{
+}
+
+string PfcWdPauseDurationPolicy::getAuxCounter(uint8_t tc) const
+{
+    return "SAI_PORT_STAT_PFC_" + to_string(tc) + "_" + m_durationSuffix;
+}
+
+void PfcWdPauseDurationPolicy::detect(const PfcWdCounterArrays &c, uint8_t *storm) const
+{
+    for (size_t i = 0; i < c.count; i++)
+    {
+        const bool idle = c.packets[i] == c.packetsLast[i];
+        const bool pfcRx = delta(c.pfcRx[i], c.pfcRxLast[i]) > 0;
+        const bool paused = static_cast<double>(delta(c.pfcAux[i], c.pfcAuxLast[i])) >
+                static_cast<double>(c.elapsedUs[i]) * pauseDurationRatio;
+
+        storm[i] = (c.occupancy[i] > 0 && idle && pfcRx) ||
+                (c.occupancy[i] == 0 && idle && paused);
+    }
+}
+
+PfcWdInnoviumPolicy::PfcWdInnoviumPolicy() :
+    PfcWdPauseDurationPolicy("RX_PAUSE_DURATION", PortLast::KEEP_ON_STORM)
+{
+}
+
+void PfcWdInnoviumPolicy::detect(const PfcWdCounterArrays &c, uint8_t *storm) const
+{
+    for (size_t i = 0; i < c.count; i++)
+    {
+        const bool idle = c.packets[i] == c.packetsLast[i];
+        const bool pfcRx = delta(c.pfcRx[i], c.pfcRxLast[i]) > 0;
+        const bool paused = static_cast<double>(delta(c.pfcAux[i], c.pfcAuxLast[i])) >
+                static_cast<double>(c.elapsedUs[i]) * pauseDurationRatio;
+
+        storm[i] = (c.occupancy[i] > 0 && idle && pfcRx) ||
+                (c.occupancy[i] == 0 && pfcRx && paused);
+    }
+}
+
+PfcWdDetector::PfcWdDetector(DBConnector *countersDb, unique_ptr<PfcWdStormPolicy> policy, uint32_t intervalMs) :
+    m_db(countersDb),
+    m_policy(move(policy)),
+    m_intervalMs(intervalMs),
+    m_countersTable(countersDb, COUNTERS_TABLE)
+{
+}
+
+void PfcWdDetector::add(const string &queueOid, const string &portOid, uint8_t tc,
+        uint32_t detectionMs, uint32_t restorationMs, bool alert)
+{
+    auto it = m_index.find(queueOid);
+    if (it != m_index.end())
+    {
+        size_t i = it->second;
+        m_detectionUs[i] = detectionMs * 1000ULL;
+        m_restorationUs[i] = restorationMs * 1000ULL;
+        m_alert[i] = alert;
+        return;
+    }
+
+    m_index[queueOid] = m_queueOids.size();
+    m_queueOids.push_back(queueOid);
+    m_portOids.push_back(portOid);
+    m_tc.push_back(tc);
+
+    m_detectionUs.push_back(detectionMs * 1000ULL);
+    m_restorationUs.push_back(restorationMs * 1000ULL);
+    m_alert.push_back(alert);
+    m_stormed.push_back(0);
+    m_detectionLeft.push_back(static_cast<int64_t>(m_detectionUs.back()));
+    m_restorationLeft.push_back(static_cast<int64_t>(m_restorationUs.back()));
+    m_sampled.push_back(0);
+    m_lastTime.emplace_back();
+
+    m_present.push_back(0);
+    m_debugStorm.push_back(0);
+    m_occupancy.push_back(0);
+    m_packets.push_back(0);
+    m_pfcRx.push_back(0);
+    m_pfcAux.push_back(0);
+    m_paused.push_back(0);
+
+    m_last.push_back(0);
+    m_packetsLast.push_back(0);
+    m_pfcRxLast.push_back(0);
+    m_pfcAuxLast.push_back(0);
+    m_pausedLast.push_back(0);
+
+    m_elapsedUs.push_back(0);
+    m_storm.push_back(0);
+
+    m_requestValid = false;
+}
+
+/* The last element takes the place of the removed one, so that the arrays stay contiguous */
+template <typename T>
+static void removeAt(vector<T> &v, size_t i)
+{
+    if (i != v.size() - 1)
+    {
+        v[i] = move(v.back());
+    }
+    v.pop_back();
+}
+
+void PfcWdDetector::remove(const string &queueOid)
+{
+    auto it = m_index.find(queueOid);
+    if (it == m_index.end())
+    {
+        return;
+    }
+
+    size_t i = it->second;
+    m_index.erase(it);
+    if (i != m_queueOids.size() - 1)
+    {
+        m_index[m_queueOids.back()] = i;
+    }
+
+    removeAt(m_queueOids, i);
+    removeAt(m_portOids, i);
+    removeAt(m_tc, i);
+
+    removeAt(m_detectionUs, i);
+    removeAt(m_restorationUs, i);
+    removeAt(m_alert, i);
+    removeAt(m_stormed, i);
+    removeAt(m_detectionLeft, i);
+    removeAt(m_restorationLeft, i);
+    removeAt(m_sampled, i);
+    removeAt(m_lastTime, i);
+
+    removeAt(m_present, i);
+    removeAt(m_debugStorm, i);
+    removeAt(m_occupancy, i);
+    removeAt(m_packets, i);
+    removeAt(m_pfcRx, i);
+    removeAt(m_pfcAux, i);
+    removeAt(m_paused, i);
+
+    removeAt(m_last, i);
+    removeAt(m_packetsLast, i);
+    removeAt(m_pfcRxLast, i);
+    removeAt(m_pfcAuxLast, i);
+    removeAt(m_pausedLast, i);
+
+    removeAt(m_elapsedUs, i);
+    removeAt(m_storm, i);
+
+    m_requestValid = false;
+}
+
+void PfcWdDetector::setStormed(const string &queueOid, bool stormed)
+{
+    auto it = m_index.find(queueOid);
+    if (it == m_index.end())
+    {
+        return;
+    }
+
+    size_t i = it->second;
+    if (stormed && !m_stormed[i])
+    {
+        m_restorationLeft[i] = static_cast<int64_t>(m_restorationUs[i]);
+    }
+    m_stormed[i] = stormed;
+}
+
+vector<PfcWdDetector::Event> PfcWdDetector::poll()
+{
+    vector<Event> events;
+
+    if (m_queueOids.empty())
+    {
+        return events;
+    }
+
+    readSnapshot();
+    evaluate(chrono::steady_clock::now(), events);
+
+    return events;
+}
+
+void PfcWdDetector::formatRequest()
+{
+    const string separator = m_countersTable.getTableNameSeparator();
+    m_request.clear();
+
+    for (size_t i = 0; i < m_queueOids.size(); i++)
+    {
+        vector<string> queueArgs = { "HMGET", COUNTERS_TABLE + separator + m_queueOids[i],
+            "SAI_QUEUE_STAT_CURR_OCCUPANCY_BYTES", "SAI_QUEUE_STAT_PACKETS", PFC_WD_DEBUG_STORM };
+        if (m_policy->usesPauseStatus())
+        {
+            queueArgs.push_back("SAI_QUEUE_ATTR_PAUSE_STATUS");
+        }
+
+        vector<string> portArgs = { "HMGET", COUNTERS_TABLE + separator + m_portOids[i],
+            "SAI_PORT_STAT_PFC_" + to_string(m_tc[i]) + "_RX_PKTS", m_policy->getAuxCounter(m_tc[i]) };
+
+        RedisCommand hmget;
+        hmget.format(queueArgs);
+        m_request.append(hmget.c_str(), hmget.length());
+        hmget.format(portArgs);
+        m_request.append(hmget.c_str(), hmget.length());
+    }
+
+    m_requestValid = true;
+}
+
+size_t PfcWdDetector::readSnapshot()
+{
+    if (m_queueOids.empty())
+    {
+        return 0;
+    }
+
+    if (!m_requestValid)
+    {
+        formatRequest();
+    }
+
+    redisContext *ctx = m_db->getContext();
+    if (redisAppendFormattedCommand(ctx, m_request.data(), m_request.size()) != REDIS_OK)
+    {
+        throw runtime_error("Failed to pipeline HMGET of the PFC watchdog counters");
+    }
+
+    /* Every reply is read, so that none is left on the connection */
+    size_t present = 0;
+    for (size_t i = 0; i < m_queueOids.size(); i++)
+    {
+        Sample sample;
+
+        for (int r = 0; r < 2; r++)
+        {
+            void *reply = nullptr;
+            if (redisGetReply(ctx, &reply) != REDIS_OK)
+            {
+                throw runtime_error("Failed to read HMGET replies of the PFC watchdog counters");
+            }
+
+            if (r == 0)
+            {
+                parseQueueReply(static_cast<redisReply *>(reply), sample);
+            }
+            else
+            {
+                parsePortReply(static_cast<redisReply *>(reply), sample);
+            }
+            freeReplyObject(reply);
+        }
+
+        setSample(i, sample);
+        present += (sample.present == Sample::PRESENT_ALL);
+    }
+
+    return present;
+}
+
+static inline bool isString(const redisReply *value)
+{
+    return value->type == REDIS_REPLY_STRING;
+}
+
+/* Counters are missing until syncd polled the queue and the port once */
+void PfcWdDetector::parseQueueReply(const redisReply *reply, Sample &sample) const
+{
+    const size_t count = m_policy->usesPauseStatus() ? 4 : 3;
+
+    if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != count)
+    {
+        return;
+    }
+
+    const redisReply *occupancy = reply->element[0];
+    const redisReply *packets = reply->element[1];
+    const redisReply *debugStorm = reply->element[2];
+
+    sample.debugStorm = isString(debugStorm) && string(debugStorm->str) == "enabled";
+
+    if (!isString(occupancy) || !isString(packets))
+    {
+        return;
+    }
+
+    if (m_policy->usesPauseStatus())
+    {
+        const redisReply *paused = reply->element[3];
+        if (!isString(paused))
+        {
+            return;
+        }
+        sample.paused = string(paused->str) == "true";
+    }
+
+    sample.occupancy = strtoull(occupancy->str, nullptr, 10);
+    sample.packets = strtoull(packets->str, nullptr, 10);
+    sample.present |= Sample::PRESENT_QUEUE;
+}
+
+void PfcWdDetector::parsePortReply(const redisReply *reply, Sample &sample) const
+{
+    if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != 2)
+    {
+        return;
+    }
+
+    if (isString(reply->element[0]))
+    {
+        sample.pfcRx = strtoull(reply->element[0]->str, nullptr, 10);
+        sample.present |= Sample::PRESENT_PFC_RX;
+    }
+
+    if (isString(reply->element[1]))
+    {
+        sample.pfcAux = strtoull(reply->element[1]->str, nullptr, 10);
+        sample.present |= Sample::PRESENT_PFC_AUX;
+    }
+}
+
+void PfcWdDetector::setSample(size_t i, const Sample &sample)
+{
+    m_present[i] = sample.present;
+    m_debugStorm[i] = sample.debugStorm;
+    m_occupancy[i] = sample.occupancy;
+    m_packets[i] = sample.packets;
+    m_pfcRx[i] = sample.pfcRx;
+    m_pfcAux[i] = sample.pfcAux;
+    m_paused[i] = sample.paused;
+}
+
+void PfcWdDetector::evaluate(chrono::steady_clock::time_point now, vector<Event> &events)
+{
+    const size_t n = m_queueOids.size();
+    const int64_t intervalUs = static_cast<int64_t>(m_intervalMs) * 1000;
+
+    /* Which queues take the sample, and over which time */
+    for (size_t i = 0; i < n; i++)
+    {
+        m_elapsedUs[i] = 0;
+
+        if (!(m_present[i] & Sample::PRESENT_PFC_RX))
+        {
+            continue;
+        }
+
+        if (!m_sampled[i])
+        {
+            m_elapsedUs[i] = static_cast<uint64_t>(intervalUs);
+            continue;
+        }
+
+        int64_t elapsed = chrono::duration_cast<chrono::microseconds>(now - m_lastTime[i]).count();
+        bool unchanged = m_last[i] == LAST_ALL &&
+                m_packets[i] == m_packetsLast[i] &&
+                m_pfcRx[i] == m_pfcRxLast[i] &&
+                m_pfcAux[i] == m_pfcAuxLast[i] &&
+                m_paused[i] == m_pausedLast[i];
+
+        if (elapsed <= 0 || (unchanged && elapsed < 2 * intervalUs))
+        {
+            continue;
+        }
+
+        m_elapsedUs[i] = static_cast<uint64_t>(elapsed);
+    }
+
+    PfcWdCounterArrays c;
+    c.count = n;
+    c.occupancy = m_occupancy.data();
+    c.packets = m_packets.data();
+    c.packetsLast = m_packetsLast.data();
+    c.pfcRx = m_pfcRx.data();
+    c.pfcRxLast = m_pfcRxLast.data();
+    c.pfcAux = m_pfcAux.data();
+    c.pfcAuxLast = m_pfcAuxLast.data();
+    c.paused = m_paused.data();
+    c.pausedLast = m_pausedLast.data();
+    c.elapsedUs = m_elapsedUs.data();
+
+    /* Queues left out are evaluated as well, their result is ignored */
+    m_policy->detect(c, m_storm.data());
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!m_elapsedUs[i])
+        {
+            continue;
+        }
+
+        bool sampled = false;
+        if (!m_stormed[i] || m_alert[i])
+        {
+            sampled = detect(i, events);
+        }
+        else if (m_restorationUs[i])
+        {
+            sampled = restore(i, events);
+        }
+
+        if (sampled)
+        {
+            m_sampled[i] = 1;
+            m_lastTime[i] = now;
+        }
+    }
+}
+
+/* pfc_detect_<platform>.lua */
+bool PfcWdDetector::detect(size_t i, vector<Event> &events)
+{
+    if (m_present[i] != Sample::PRESENT_ALL)
+    {
+        return false;
+    }
+
+    const int64_t elapsed = static_cast<int64_t>(m_elapsedUs[i]);
+    bool detected = false;
+
+    if (m_last[i] == LAST_ALL)
+    {
+        if (m_storm[i] || m_debugStorm[i])
+        {
+            if (m_detectionLeft[i] <= elapsed)
+            {
+                events.push_back({ m_queueOids[i], PFC_WD_EVENT_STORM });
+                m_detectionLeft[i] = static_cast<int64_t>(m_detectionUs[i]);
+                detected = true;
+            }
+            else
+            {
+                m_detectionLeft[i] -= elapsed;
+            }
+        }
+        else
+        {
+            /* An alert does not stop the detection, which also tells when the storm is over */
+            if (m_alert[i] && m_stormed[i])
+            {
+                events.push_back({ m_queueOids[i], PFC_WD_EVENT_RESTORE });
+            }
+            m_detectionLeft[i] = static_cast<int64_t>(m_detectionUs[i]);
+        }
+    }
+
+    m_packetsLast[i] = m_packets[i];
+    m_pausedLast[i] = m_paused[i];
+    m_last[i] |= LAST_QUEUE;
+
+    PfcWdStormPolicy::PortLast portLast = detected ? m_policy->getPortLast() : PfcWdStormPolicy::PortLast::UPDATE;
+    if (portLast == PfcWdStormPolicy::PortLast::FORGET_ON_STORM)
+    {
+        m_last[i] &= static_cast<uint8_t>(~(LAST_PFC_RX | LAST_PFC_AUX));
+    }
+    else if (portLast == PfcWdStormPolicy::PortLast::UPDATE)
+    {
+        m_pfcRxLast[i] = m_pfcRx[i];
+        m_pfcAuxLast[i] = m_pfcAux[i];
+        m_last[i] |= LAST_PFC_RX | LAST_PFC_AUX;
+    }
+
+    return true;
+}
+
+/* pfc_restore.lua */
+bool PfcWdDetector::restore(size_t i, vector<Event> &events)
+{
+    if (!(m_present[i] & Sample::PRESENT_PFC_RX))
+    {
+        return false;
+    }
+
+    const int64_t elapsed = static_cast<int64_t>(m_elapsedUs[i]);
+
+    if (m_last[i] & LAST_PFC_RX)
+    {
+        if (m_pfcRx[i] == m_pfcRxLast[i] && !m_debugStorm[i])
+        {
+            if (m_restorationLeft[i] <= elapsed)
+            {
+                events.push_back({ m_queueOids[i], PFC_WD_EVENT_RESTORE });
+                m_restorationLeft[i] = static_cast<int64_t>(m_restorationUs[i]);
+            }
+            else
+            {
+                m_restorationLeft[i] -= elapsed;
+            }
+        }
+        else
+        {
+            m_restorationLeft[i] = static_cast<int64_t>(m_restorationUs[i]);
+        }
+    }
+
+    m_pfcRxLast[i] = m_pfcRx[i];
+    m_last[i] |= LAST_PFC_RX;
+
+    if (m_present[i] & Sample::PRESENT_QUEUE)
+    {
+        m_packetsLast[i] = m_packets[i];
+        m_pausedLast[i] = m_paused[i];
+        m_last[i] |= LAST_QUEUE;
+    }
+
+    if (m_present[i] & Sample::PRESENT_PFC_AUX)
+    {
+        m_pfcAuxLast[i] = m_pfcAux[i];
+        m_last[i] |= LAST_PFC_AUX;
+    }
+
+    return true;
+}
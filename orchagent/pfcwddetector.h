@@ -0,0 +1,245 @@
+#ifndef SWSS_PFCWDDETECTOR_H
+#define SWSS_PFCWDDETECTOR_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dbconnector.h"
+#include "table.h"
+
+/* Counters of all the queues watched, as arrays indexed by queue, for a storm policy to evaluate */
+struct PfcWdCounterArrays
+{
+    size_t count;
+
+    const uint64_t *occupancy;
+    const uint64_t *packets;
+    const uint64_t *packetsLast;
+    const uint64_t *pfcRx;
+    const uint64_t *pfcRxLast;
+    const uint64_t *pfcAux;
+    const uint64_t *pfcAuxLast;
+    const uint8_t *paused;
+    const uint8_t *pausedLast;
+
+    /* Time since the last sample, in usecs, the poll time of the plugins */
+    const uint64_t *elapsedUs;
+};
+
+/*
+ * Vendor condition of a PFC storm on a queue, as checked by the
+ * pfc_detect_<platform>.lua plugin of the platform.
+ */
+class PfcWdStormPolicy
+{
+public:
+    /* What becomes of the last PFC counters of the port when a storm is detected */
+    enum class PortLast
+    {
+        UPDATE,             /* Saved as on any other sample */
+        KEEP_ON_STORM,      /* Not saved, the next sample is compared with the one before the storm */
+        FORGET_ON_STORM,    /* Forgotten, the next sample is not compared at all */
+    };
+
+    virtual ~PfcWdStormPolicy() {}
+
+    /* Port counter compared along SAI_PORT_STAT_PFC_<tc>_RX_PKTS */
+    virtual std::string getAuxCounter(uint8_t tc) const = 0;
+    virtual bool usesPauseStatus() const { return false; }
+    virtual PortLast getPortLast() const { return PortLast::UPDATE; }
+
+    /* Sets storm[i] for every queue whose counters show a storm since the last sample */
+    virtual void detect(const PfcWdCounterArrays &c, uint8_t *storm) const = 0;
+
+    /* Policy of pfc_detect_<platform>.lua, nullptr for a platform without one */
+    static std::unique_ptr<PfcWdStormPolicy> create(const std::string &platform);
+};
+
+/* Broadcom: PFC frames received without any XON, while the queue stays paused */
+class PfcWdOn2OffPolicy : public PfcWdStormPolicy
+{
+public:
+    std::string getAuxCounter(uint8_t tc) const override;
+    bool usesPauseStatus() const override { return true; }
+
+    void detect(const PfcWdCounterArrays &c, uint8_t *storm) const override;
+};
+
+/*
+ * Mellanox, Barefoot and Nephos: nothing dequeued, while PFC frames are
+ * received, or while the port is paused for most of the poll time.
+ */
+class PfcWdPauseDurationPolicy : public PfcWdStormPolicy
+{
+public:
+    PfcWdPauseDurationPolicy(const std::string &durationSuffix, PortLast portLast);
+
+    std::string getAuxCounter(uint8_t tc) const override;
+    PortLast getPortLast() const override { return m_portLast; }
+
+    void detect(const PfcWdCounterArrays &c, uint8_t *storm) const override;
+
+private:
+    std::string m_durationSuffix;
+    PortLast m_portLast;
+};
+
+/* Innovium: as above, but an empty queue paused for most of the poll time needs PFC frames only */
+class PfcWdInnoviumPolicy : public PfcWdPauseDurationPolicy
+{
+public:
+    PfcWdInnoviumPolicy();
+
+    void detect(const PfcWdCounterArrays &c, uint8_t *storm) const override;
+};
+
+/*
+ * PFC storm detection and restoration of the queues watched by PfcWdSwOrch,
+ * run in orchagent the way the pfc_detect_<platform>.lua and pfc_restore.lua
+ * plugins of syncd run inside redis.
+ *
+ * The plugins issue a score of HGET/HSET per queue and per poll within redis,
+ * and publish PFC_WD_ACTION notifications back to orchagent. Here a poll reads
+ * the counters of all the queues with a single pipeline of HMGET, evaluates
+ * the storm policy of the platform over arrays indexed by queue, and returns
+ * the same storm/restore events for PfcWdSwOrch to act upon. The last samples
+ * and the time left are only kept in memory, the *_last and *_LEFT fields of
+ * COUNTERS_DB are not used.
+ *
+ * The detection and restoration time left is decremented by the time elapsed
+ * since the last sample taken, rather than by the poll interval. These polls
+ * are not aligned with the ones of syncd, so a poll may read the very counters
+ * of the previous one. Such a sample, where the packets, the PFC frames and the
+ * pause status of a queue all stand still, is skipped for up to 2 intervals:
+ * - detection: no policy sees a storm without PFC frames or pause time, so
+ *   taking it would reset the detection time left of a queue in a storm;
+ * - restoration: it shows no PFC frames, so it only counts towards restoring,
+ *   and the next sample taken is credited with the time skipped. Restoration
+ *   may come up to 2 intervals later than with pfc_restore.lua, never sooner.
+ * A queue quiet for 2 intervals is sampled, as the plugins would. A queue
+ * sampled for restoration also has its queue counters saved, so that detection
+ * resumes on the last sample rather than on the one before the storm.
+ */
+class PfcWdDetector
+{
+public:
+    /* Counters of a queue and of the PFC of its priority on its port */
+    struct Sample
+    {
+        enum Present : uint8_t
+        {
+            PRESENT_QUEUE   = 0x1,  /* Occupancy, packets, and pause status when the policy uses it */
+            PRESENT_PFC_RX  = 0x2,
+            PRESENT_PFC_AUX = 0x4,
+            PRESENT_ALL     = 0x7,
+        };
+
+        uint64_t occupancy = 0;
+        uint64_t packets = 0;
+        uint64_t pfcRx = 0;
+        uint64_t pfcAux = 0;
+        bool paused = false;
+        bool debugStorm = false;
+        uint8_t present = 0;
+    };
+
+    /* Event of a queue, as in the PFC_WD_ACTION notifications of the plugins */
+    struct Event
+    {
+        std::string queueOid;
+        std::string event;
+    };
+
+    PfcWdDetector(swss::DBConnector *countersDb, std::unique_ptr<PfcWdStormPolicy> policy, uint32_t intervalMs);
+
+    /*
+     * Queues are identified by their serialized object id, as in COUNTERS:<oid>.
+     * Adding a queue already watched updates its configuration.
+     */
+    void add(const std::string &queueOid, const std::string &portOid, uint8_t tc,
+            uint32_t detectionMs, uint32_t restorationMs, bool alert);
+    void remove(const std::string &queueOid);
+    size_t size() const { return m_queueOids.size(); }
+
+    /* A stormed queue is checked for restoration, unless its action is alert */
+    void setStormed(const std::string &queueOid, bool stormed);
+
+    void setInterval(uint32_t intervalMs) { m_intervalMs = intervalMs; }
+    uint32_t getInterval() const { return m_intervalMs; }
+
+    /* Reads the counters and evaluates every queue */
+    std::vector<Event> poll();
+
+    /* Reads the counters of every queue, returns the number of queues which have them all */
+    size_t readSnapshot();
+    /* Evaluates the last snapshot taken at 'now', appends the events raised */
+    void evaluate(std::chrono::steady_clock::time_point now, std::vector<Event> &events);
+
+    /* Parse the HMGET replies of the queue and of the port counters of a queue */
+    void parseQueueReply(const redisReply *reply, Sample &sample) const;
+    void parsePortReply(const redisReply *reply, Sample &sample) const;
+
+private:
+    enum LastState : uint8_t
+    {
+        LAST_QUEUE      = 0x1,
+        LAST_PFC_RX     = 0x2,
+        LAST_PFC_AUX    = 0x4,
+        LAST_ALL        = 0x7,
+    };
+
+    swss::DBConnector *m_db;
+    std::unique_ptr<PfcWdStormPolicy> m_policy;
+    uint32_t m_intervalMs;
+    swss::Table m_countersTable;
+
+    /* Position of each queue in the arrays below */
+    std::unordered_map<std::string, size_t> m_index;
+    std::vector<std::string> m_queueOids;
+    std::vector<std::string> m_portOids;
+    std::vector<uint8_t> m_tc;
+
+    /* Configuration and state */
+    std::vector<uint64_t> m_detectionUs;
+    std::vector<uint64_t> m_restorationUs;
+    std::vector<uint8_t> m_alert;
+    std::vector<uint8_t> m_stormed;
+    std::vector<int64_t> m_detectionLeft;
+    std::vector<int64_t> m_restorationLeft;
+    std::vector<uint8_t> m_sampled;
+    std::vector<std::chrono::steady_clock::time_point> m_lastTime;
+
+    /* Snapshot */
+    std::vector<uint8_t> m_present;
+    std::vector<uint8_t> m_debugStorm;
+    std::vector<uint64_t> m_occupancy;
+    std::vector<uint64_t> m_packets;
+    std::vector<uint64_t> m_pfcRx;
+    std::vector<uint64_t> m_pfcAux;
+    std::vector<uint8_t> m_paused;
+
+    /* Last samples */
+    std::vector<uint8_t> m_last;
+    std::vector<uint64_t> m_packetsLast;
+    std::vector<uint64_t> m_pfcRxLast;
+    std::vector<uint64_t> m_pfcAuxLast;
+    std::vector<uint8_t> m_pausedLast;
+
+    /* Per poll */
+    std::vector<uint64_t> m_elapsedUs;
+    std::vector<uint8_t> m_storm;
+
+    /* HMGET of the queue and of the port counters of every queue, formatted when queues are added or removed */
+    std::string m_request;
+    bool m_requestValid = false;
+
+    void formatRequest();
+    void setSample(size_t i, const Sample &sample);
+    bool detect(size_t i, std::vector<Event> &events);
+    bool restore(size_t i, std::vector<Event> &events);
+};
+
+#endif /* SWSS_PFCWDDETECTOR_H */
@@ -31,6 +31,7 @@ extern sai_port_api_t *sai_port_api;
 extern sai_queue_api_t *sai_queue_api;
 
 extern PortsOrch *gPortsOrch;
+extern bool gLuaPfcWd;
 
 template <typename DropHandler, typename ForwardHandler>
 PfcWdOrch<DropHandler, ForwardHandler>::PfcWdOrch(DBConnector *db, vector<string> &tableNames):
@@ -301,6 +302,21 @@ task_process_status PfcWdSwOrch<DropHandler, ForwardHandler>::createEntry(const
                 vector<FieldValueTuple> fieldValues;
                 fieldValues.emplace_back(POLL_INTERVAL_FIELD, value);
                 m_flexCounterGroupTable->set(PFC_WD_FLEX_COUNTER_GROUP, fieldValues);
+
+                if (m_detector)
+                {
+                    try
+                    {
+                        uint32_t interval = to_uint<uint32_t>(value, 1);
+                        m_detector->setInterval(interval);
+                        m_detectTimer->setInterval(timespec { .tv_sec = interval / 1000, .tv_nsec = (interval % 1000) * 1000000 });
+                        m_detectTimer->reset();
+                    }
+                    catch (const exception& e)
+                    {
+                        SWSS_LOG_ERROR("Invalid PFC Watchdog %s %s: %s", POLL_INTERVAL_FIELD, value.c_str(), e.what());
+                    }
+                }
             }
             else if (field == BIG_RED_SWITCH_FIELD)
             {
@@ -418,6 +434,11 @@ void PfcWdSwOrch<DropHandler, ForwardHandler>::enableBigRedSwitchMode()
         {
             entry.second.handler->commitCounters();
             entry.second.handler = nullptr;
+
+            if (m_detector)
+            {
+                m_detector->setStormed(sai_serialize_object_id(entry.first), false);
+            }
         }
     }
 
@@ -548,6 +569,12 @@ bool PfcWdSwOrch<DropHandler, ForwardHandler>::registerInWdDb(const Port& port,
         // Create internal entry
         m_entryMap.emplace(queueId, PfcWdQueueEntry(action, port.m_port_id, i, port.m_alias));
 
+        if (m_detector)
+        {
+            m_detector->add(queueIdStr, sai_serialize_object_id(port.m_port_id), i,
+                    detectionTime, restorationTime, action == PfcWdAction::PFC_WD_ACTION_ALERT);
+        }
+
         string key = getFlexCounterTableKey(queueIdStr);
         m_flexCounterTable->set(key, queueFieldValues);
 
@@ -629,6 +656,11 @@ void PfcWdSwOrch<DropHandler, ForwardHandler>::unregisterFromWdDb(const Port& po
 
         m_entryMap.erase(queueId);
 
+        if (m_detector)
+        {
+            m_detector->remove(sai_serialize_object_id(queueId));
+        }
+
         // Clean up
         string countersKey = this->getCountersTable()->getTableName() + this->getCountersTable()->getTableNameSeparator() + sai_serialize_object_id(queueId);
         this->getCountersDb()->hdel(countersKey, {"PFC_WD_DETECTION_TIME", "PFC_WD_RESTORATION_TIME", "PFC_WD_ACTION", "PFC_WD_STATUS"});
@@ -664,31 +696,51 @@ PfcWdSwOrch<DropHandler, ForwardHandler>::PfcWdSwOrch(
         return;
     }
 
-    string detectSha, restoreSha;
-    string detectPluginName = "pfc_detect_" + platform + ".lua";
-    string restorePluginName = "pfc_restore.lua";
+    unique_ptr<PfcWdStormPolicy> policy = gLuaPfcWd ? nullptr : PfcWdStormPolicy::create(platform);
 
-    try
+    if (policy)
     {
-        string detectLuaScript = swss::loadLuaScript(detectPluginName);
-        detectSha = swss::loadRedisScript(
-                this->getCountersDb().get(),
-                detectLuaScript);
-
-        string restoreLuaScript = swss::loadLuaScript(restorePluginName);
-        restoreSha = swss::loadRedisScript(
-                this->getCountersDb().get(),
-                restoreLuaScript);
-
+        // Syncd only polls the counters, the storms are detected in pollDetector()
         vector<FieldValueTuple> fieldValues;
-        fieldValues.emplace_back(QUEUE_PLUGIN_FIELD, detectSha + "," + restoreSha);
         fieldValues.emplace_back(POLL_INTERVAL_FIELD, to_string(m_pollInterval));
         fieldValues.emplace_back(STATS_MODE_FIELD, STATS_MODE_READ);
         m_flexCounterGroupTable->set(PFC_WD_FLEX_COUNTER_GROUP, fieldValues);
+
+        uint32_t interval = static_cast<uint32_t>(m_pollInterval);
+        m_detector = unique_ptr<PfcWdDetector>(new PfcWdDetector(this->getCountersDb().get(), move(policy), interval));
+
+        m_detectTimer = new SelectableTimer(timespec { .tv_sec = interval / 1000, .tv_nsec = (interval % 1000) * 1000000 });
+        Orch::addExecutor(new ExecutableTimer(m_detectTimer, this, "PFC_WD_DETECT_POLL"));
+        m_detectTimer->start();
     }
-    catch (...)
+    else
     {
-        SWSS_LOG_WARN("Lua scripts and polling interval for PFC watchdog were not set successfully");
+        string detectSha, restoreSha;
+        string detectPluginName = "pfc_detect_" + platform + ".lua";
+        string restorePluginName = "pfc_restore.lua";
+
+        try
+        {
+            string detectLuaScript = swss::loadLuaScript(detectPluginName);
+            detectSha = swss::loadRedisScript(
+                    this->getCountersDb().get(),
+                    detectLuaScript);
+
+            string restoreLuaScript = swss::loadLuaScript(restorePluginName);
+            restoreSha = swss::loadRedisScript(
+                    this->getCountersDb().get(),
+                    restoreLuaScript);
+
+            vector<FieldValueTuple> fieldValues;
+            fieldValues.emplace_back(QUEUE_PLUGIN_FIELD, detectSha + "," + restoreSha);
+            fieldValues.emplace_back(POLL_INTERVAL_FIELD, to_string(m_pollInterval));
+            fieldValues.emplace_back(STATS_MODE_FIELD, STATS_MODE_READ);
+            m_flexCounterGroupTable->set(PFC_WD_FLEX_COUNTER_GROUP, fieldValues);
+        }
+        catch (...)
+        {
+            SWSS_LOG_WARN("Lua scripts and polling interval for PFC watchdog were not set successfully");
+        }
     }
 
     auto consumer = new swss::NotificationConsumer(
@@ -882,6 +934,12 @@ void PfcWdSwOrch<DropHandler, ForwardHandler>::doTask(SelectableTimer &timer)
 {
     SWSS_LOG_ENTER();
 
+    if (&timer == m_detectTimer)
+    {
+        pollDetector();
+        return;
+    }
+
     for (auto& handlerPair : m_entryMap)
     {
         if (handlerPair.second.handler != nullptr)
@@ -892,6 +950,40 @@ void PfcWdSwOrch<DropHandler, ForwardHandler>::doTask(SelectableTimer &timer)
 
 }
 
+template <typename DropHandler, typename ForwardHandler>
+void PfcWdSwOrch<DropHandler, ForwardHandler>::pollDetector()
+{
+    SWSS_LOG_ENTER();
+
+    // As the plugins skip the queues in BIG_RED_SWITCH mode
+    if (m_bigRedSwitchFlag)
+    {
+        return;
+    }
+
+    vector<PfcWdDetector::Event> events;
+    try
+    {
+        events = m_detector->poll();
+    }
+    catch (const runtime_error &e)
+    {
+        SWSS_LOG_ERROR("Failed to poll PFC watchdog counters: %s", e.what());
+        return;
+    }
+
+    for (const auto &event : events)
+    {
+        sai_object_id_t queueId = SAI_NULL_OBJECT_ID;
+        sai_deserialize_object_id(event.queueOid, queueId);
+
+        if (!startWdActionOnQueue(event.event, queueId))
+        {
+            SWSS_LOG_ERROR("Failed to start PFC watchdog %s event action on queue %s", event.event.c_str(), event.queueOid.c_str());
+        }
+    }
+}
+
 template <typename DropHandler, typename ForwardHandler>
 bool PfcWdSwOrch<DropHandler, ForwardHandler>::startWdActionOnQueue(const string &event, sai_object_id_t queueId)
 {
@@ -1006,6 +1098,11 @@ bool PfcWdSwOrch<DropHandler, ForwardHandler>::startWdActionOnQueue(const string
         return false;
     }
 
+    if (m_detector)
+    {
+        m_detector->setStormed(sai_serialize_object_id(queueId), entry->second.handler != nullptr);
+    }
+
     return true;
 }
 
@@ -4,6 +4,7 @@
 #include "orch.h"
 #include "port.h"
 #include "pfcactionhandler.h"
+#include "pfcwddetector.h"
 #include "producertable.h"
 #include "notificationconsumer.h"
 #include "timer.h"
@@ -131,6 +132,11 @@ private:
     bool m_bigRedSwitchFlag = false;
     int m_pollInterval;
 
+    // Storm detection run in orchagent, unless left to the Lua plugins
+    unique_ptr<PfcWdDetector> m_detector;
+    SelectableTimer *m_detectTimer = nullptr;
+    void pollDetector();
+
     shared_ptr<DBConnector> m_applDb = nullptr;
     // Track queues in storm
     shared_ptr<Table> m_applTable = nullptr;
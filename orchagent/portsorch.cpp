@@ -53,6 +53,7 @@ extern string gMySwitchType;
 extern int32_t gVoqMySwitchId;
 extern string gMyHostName;
 extern string gMyAsicName;
+extern bool gLuaRates;
 
 #define DEFAULT_SYSTEM_PORT_MTU 9100
 #define VLAN_PREFIX         "Vlan"
@@ -338,9 +339,6 @@ PortsOrch::PortsOrch(DBConnector *db, DBConnector *stateDb, vector<table_name_wi
         string pgLuaScript = swss::loadLuaScript(pgWmPluginName);
         pgWmSha = swss::loadRedisScript(m_counter_db.get(), pgLuaScript);
 
-        string portRateLuaScript = swss::loadLuaScript(portRatePluginName);
-        string portRateSha = swss::loadRedisScript(m_counter_db.get(), portRateLuaScript);
-
         vector<FieldValueTuple> fieldValues;
         fieldValues.emplace_back(QUEUE_PLUGIN_FIELD, queueWmSha);
         fieldValues.emplace_back(POLL_INTERVAL_FIELD, QUEUE_WATERMARK_FLEX_STAT_COUNTER_POLL_MSECS);
@@ -354,7 +352,12 @@ PortsOrch::PortsOrch(DBConnector *db, DBConnector *stateDb, vector<table_name_wi
         m_flexCounterGroupTable->set(PG_WATERMARK_STAT_COUNTER_FLEX_COUNTER_GROUP, fieldValues);
 
         fieldValues.clear();
-        fieldValues.emplace_back(PORT_PLUGIN_FIELD, portRateSha);
+        if (gLuaRates)
+        {
+            string portRateLuaScript = swss::loadLuaScript(portRatePluginName);
+            string portRateSha = swss::loadRedisScript(m_counter_db.get(), portRateLuaScript);
+            fieldValues.emplace_back(PORT_PLUGIN_FIELD, portRateSha);
+        }
         fieldValues.emplace_back(POLL_INTERVAL_FIELD, PORT_RATE_FLEX_COUNTER_POLLING_INTERVAL_MS);
         fieldValues.emplace_back(STATS_MODE_FIELD, STATS_MODE_READ);
         m_flexCounterGroupTable->set(PORT_STAT_COUNTER_FLEX_COUNTER_GROUP, fieldValues);
@@ -369,6 +372,16 @@ PortsOrch::PortsOrch(DBConnector *db, DBConnector *stateDb, vector<table_name_wi
         SWSS_LOG_ERROR("Port flex counter groups were not set successfully: %s", e.what());
     }
 
+    if (!gLuaRates)
+    {
+        uint32_t ratesInterval = static_cast<uint32_t>(stoul(PORT_RATE_FLEX_COUNTER_POLLING_INTERVAL_MS));
+        m_portRates = unique_ptr<RateCounters>(new RateCounters(m_counter_db.get(), RateCounters::Type::PORT, ratesInterval));
+
+        auto interval = timespec { .tv_sec = ratesInterval / 1000, .tv_nsec = (ratesInterval % 1000) * 1000000 };
+        m_portRatesTimer = new SelectableTimer(interval);
+        Orch::addExecutor(new ExecutableTimer(m_portRatesTimer, this, "PORT_RATES_TIMER"));
+    }
+
     uint32_t i, j;
     sai_status_t status;
     sai_attribute_t attr;
@@ -659,42 +672,100 @@ bool PortsOrch::getPort(string alias, Port &p)
     }
 }
 
+/* The object id a port is known by, which depends on its type */
+static sai_object_id_t getPortOid(const Port &port)
+{
+    switch (port.m_type)
+    {
+    case Port::PHY:
+    case Port::SYSTEM:
+        return port.m_port_id;
+    case Port::LAG:
+        return port.m_lag_id;
+    case Port::VLAN:
+        return port.m_vlan_info.vlan_oid;
+    default:
+        return SAI_NULL_OBJECT_ID;
+    }
+}
+
 bool PortsOrch::getPort(sai_object_id_t id, Port &port)
 {
     SWSS_LOG_ENTER();
 
-    for (const auto& portIter: m_portList)
+    const Port *p = findPort(id);
+    if (!p)
     {
-        switch (portIter.second.m_type)
-        {
-        case Port::PHY:
-        case Port::SYSTEM:
-            if(portIter.second.m_port_id == id)
-            {
-                port = portIter.second;
-                return true;
-            }
-            break;
-        case Port::LAG:
-            if(portIter.second.m_lag_id == id)
-            {
-                port = portIter.second;
-                return true;
-            }
-            break;
-        case Port::VLAN:
-            if (portIter.second.m_vlan_info.vlan_oid == id)
-            {
-                port = portIter.second;
-                return true;
-            }
-            break;
-        default:
-            continue;
-        }
+        return false;
     }
 
-    return false;
+    port = *p;
+    return true;
+}
+
+const Port *PortsOrch::findPort(sai_object_id_t id) const
+{
+    auto idx = m_portOidIndex.find(id);
+    if (idx == m_portOidIndex.end())
+    {
+        return nullptr;
+    }
+
+    auto it = m_portList.find(idx->second);
+    if (it == m_portList.end() || getPortOid(it->second) != id)
+    {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+const Port *PortsOrch::findPortByBridgePortId(sai_object_id_t bridge_port_id) const
+{
+    auto idx = m_bridgePortOidIndex.find(bridge_port_id);
+    if (idx == m_bridgePortOidIndex.end())
+    {
+        return nullptr;
+    }
+
+    auto it = m_portList.find(idx->second);
+    if (it == m_portList.end() || it->second.m_bridge_port_id != bridge_port_id)
+    {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+/* Index a port added to m_portList, or whose object ids were set */
+void PortsOrch::indexPort(const Port &port)
+{
+    sai_object_id_t id = getPortOid(port);
+    if (id != SAI_NULL_OBJECT_ID)
+    {
+        m_portOidIndex[id] = port.m_alias;
+    }
+
+    if (port.m_bridge_port_id != SAI_NULL_OBJECT_ID)
+    {
+        m_bridgePortOidIndex[port.m_bridge_port_id] = port.m_alias;
+    }
+}
+
+/* Unindex a port before it is erased from m_portList */
+void PortsOrch::unindexPort(const Port &port)
+{
+    auto idx = m_portOidIndex.find(getPortOid(port));
+    if (idx != m_portOidIndex.end() && idx->second == port.m_alias)
+    {
+        m_portOidIndex.erase(idx);
+    }
+
+    idx = m_bridgePortOidIndex.find(port.m_bridge_port_id);
+    if (idx != m_bridgePortOidIndex.end() && idx->second == port.m_alias)
+    {
+        m_bridgePortOidIndex.erase(idx);
+    }
 }
 
 void PortsOrch::increasePortRefCount(const string &alias)
@@ -713,16 +784,14 @@ bool PortsOrch::getPortByBridgePortId(sai_object_id_t bridge_port_id, Port &port
 {
     SWSS_LOG_ENTER();
 
-    for (auto &it: m_portList)
+    const Port *p = findPortByBridgePortId(bridge_port_id);
+    if (!p)
     {
-        if (it.second.m_bridge_port_id == bridge_port_id)
-        {
-            port = it.second;
-            return true;
-        }
+        return false;
     }
 
-    return false;
+    port = *p;
+    return true;
 }
 
 bool PortsOrch::addSubPort(Port &port, const string &alias, const bool &adminUp, const uint32_t &mtu)
@@ -855,6 +924,7 @@ bool PortsOrch::removeSubPort(const string &alias)
     }
     m_portList[parentPort.m_alias] = parentPort;
 
+    unindexPort(it->second);
     m_portList.erase(it);
 
     // Restore hostif vlan tag for the parent port when the last subport is removed
@@ -904,6 +974,7 @@ void PortsOrch::updateChildPortsMtu(const Port &p, const uint32_t mtu)
 void PortsOrch::setPort(string alias, Port p)
 {
     m_portList[alias] = p;
+    indexPort(p);
 }
 
 void PortsOrch::getCpuPort(Port &port)
@@ -1044,15 +1115,14 @@ bool PortsOrch::getPortPfc(sai_object_id_t portId, uint8_t *pfc_bitmask)
 {
     SWSS_LOG_ENTER();
 
-    Port p;
-
-    if (!getPort(portId, p))
+    const Port *p = findPort(portId);
+    if (!p)
     {
         SWSS_LOG_ERROR("Failed to get port object for port id 0x%" PRIx64, portId);
         return false;
     }
 
-    *pfc_bitmask = p.m_pfc_bitmask;
+    *pfc_bitmask = p->m_pfc_bitmask;
 
     return true;
 }
@@ -2265,6 +2335,7 @@ bool PortsOrch::initPort(const string &alias, const string &role, const int inde
 
                 /* Add port to port list */
                 m_portList[alias] = p;
+                indexPort(p);
                 m_port_ref_count[alias] = 0;
                 m_portOidToIndex[id] = index;
 
@@ -2280,6 +2351,10 @@ bool PortsOrch::initPort(const string &alias, const string &role, const int inde
                     counter_stats.emplace(sai_serialize_port_stat(it));
                 }
                 port_stat_manager.setCounterIdList(p.m_port_id, CounterType::PORT, counter_stats);
+                if (m_portRates)
+                {
+                    m_portRates->add(sai_serialize_object_id(p.m_port_id));
+                }
                 std::unordered_set<std::string> port_buffer_drop_stats;
                 for (const auto& it: port_buffer_drop_stat_ids)
                 {
@@ -2319,6 +2394,10 @@ void PortsOrch::deInitPort(string alias, sai_object_id_t port_id)
 
     /* remove port from flex_counter_table for updating counters  */
     port_stat_manager.clearCounterIdList(p.m_port_id);
+    if (m_portRates)
+    {
+        m_portRates->remove(sai_serialize_object_id(p.m_port_id));
+    }
 
     /* remove port name map from counter table */
     m_counter_db->hdel(COUNTERS_PORT_NAME_MAP, alias);
@@ -3197,6 +3276,7 @@ void PortsOrch::doPortTask(Consumer &consumer)
             removePortFromPortListMap(port_id);
 
             /* Delete port from port list */
+            unindexPort(m_portList[alias]);
             m_portList.erase(alias);
         }
         else
@@ -4166,6 +4246,7 @@ bool PortsOrch::addBridgePort(Port &port)
         return false;
     }
     m_portList[port.m_alias] = port;
+    indexPort(port);
     SWSS_LOG_NOTICE("Add bridge port %s to default 1Q bridge", port.m_alias.c_str());
 
     return true;
@@ -4219,6 +4300,7 @@ bool PortsOrch::removeBridgePort(Port &port)
             return parseHandleSaiStatusFailure(handle_status);
         }
     }
+    m_bridgePortOidIndex.erase(port.m_bridge_port_id);
     port.m_bridge_port_id = SAI_NULL_OBJECT_ID;
 
     SWSS_LOG_NOTICE("Remove bridge port %s from default 1Q bridge", port.m_alias.c_str());
@@ -4294,6 +4376,7 @@ bool PortsOrch::addVlan(string vlan_alias)
     vlan.m_vlan_info.vlan_id = vlan_id;
     vlan.m_members = set<string>();
     m_portList[vlan_alias] = vlan;
+    indexPort(vlan);
     m_port_ref_count[vlan_alias] = 0;
 
     return true;
@@ -4350,6 +4433,7 @@ bool PortsOrch::removeVlan(Port vlan)
     SWSS_LOG_NOTICE("Remove VLAN %s vid:%hu", vlan.m_alias.c_str(),
             vlan.m_vlan_info.vlan_id);
 
+    unindexPort(vlan);
     m_portList.erase(vlan.m_alias);
     m_port_ref_count.erase(vlan.m_alias);
 
@@ -4545,6 +4629,7 @@ bool PortsOrch::addLag(string lag_alias, uint32_t spa_id, int32_t switch_id)
     lag.m_lag_id = lag_id;
     lag.m_members = set<string>();
     m_portList[lag_alias] = lag;
+    indexPort(lag);
     m_port_ref_count[lag_alias] = 0;
 
     PortUpdate update = { lag, true };
@@ -4613,6 +4698,7 @@ bool PortsOrch::removeLag(Port lag)
 
     SWSS_LOG_NOTICE("Remove LAG %s lid:%" PRIx64, lag.m_alias.c_str(), lag.m_lag_id);
 
+    unindexPort(lag);
     m_portList.erase(lag.m_alias);
     m_port_ref_count.erase(lag.m_alias);
 
@@ -4913,6 +4999,7 @@ bool PortsOrch::removeTunnel(Port tunnel)
 {
     SWSS_LOG_ENTER();
 
+    unindexPort(tunnel);
     m_portList.erase(tunnel.m_alias);
 
     return true;
@@ -5072,6 +5159,66 @@ void PortsOrch::generatePriorityGroupMapPerPort(const Port& port)
     CounterCheckOrch::getInstance().addPort(port);
 }
 
+void PortsOrch::setPortRatesInterval(uint32_t intervalMs)
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_portRates || intervalMs == 0)
+    {
+        return;
+    }
+
+    m_portRates->setInterval(intervalMs);
+    m_portRatesTimer->setInterval(timespec { .tv_sec = intervalMs / 1000, .tv_nsec = (intervalMs % 1000) * 1000000 });
+    if (m_portRatesEnabled)
+    {
+        m_portRatesTimer->reset();
+    }
+
+    SWSS_LOG_NOTICE("Port rates are computed every %u ms", intervalMs);
+}
+
+void PortsOrch::setPortRatesStatus(bool enabled)
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_portRates || enabled == m_portRatesEnabled)
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        m_portRatesTimer->start();
+    }
+    else
+    {
+        m_portRatesTimer->stop();
+    }
+    m_portRatesEnabled = enabled;
+
+    SWSS_LOG_NOTICE("Port rates are %s", enabled ? "enabled" : "disabled");
+}
+
+void PortsOrch::doTask(SelectableTimer &timer)
+{
+    SWSS_LOG_ENTER();
+
+    if (&timer != m_portRatesTimer)
+    {
+        return;
+    }
+
+    try
+    {
+        m_portRates->poll();
+    }
+    catch (const runtime_error &e)
+    {
+        SWSS_LOG_ERROR("Failed to update port rates: %s", e.what());
+    }
+}
+
 void PortsOrch::doTask(NotificationConsumer &consumer)
 {
     SWSS_LOG_ENTER();
@@ -5082,25 +5229,52 @@ void PortsOrch::doTask(NotificationConsumer &consumer)
         return;
     }
 
-    std::string op;
-    std::string data;
-    std::vector<swss::FieldValueTuple> values;
-
-    consumer.pop(op, data, values);
+    /* Drain a batch of notifications at once, instead of one per select */
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    consumer.pops(entries);
 
     if (&consumer != m_portStatusNotificationConsumer)
     {
         return;
     }
 
-    if (op == "port_state_change")
+    doPortStatusEvents(entries);
+}
+
+/*
+ * Handles the port state changes of a batch of notifications, deserialized
+ * first. Every change is applied in order so that a flap is seen by the
+ * observers, while the oper speed of a port is read and written once, when
+ * the port is up at the end of the batch.
+ */
+void PortsOrch::doPortStatusEvents(const std::deque<KeyOpFieldsValuesTuple> &entries)
+{
+    SWSS_LOG_ENTER();
+
+    vector<pair<uint32_t, sai_port_oper_status_notification_t *>> events;
+    events.reserve(entries.size());
+
+    for (const auto &entry : entries)
     {
+        if (kfvOp(entry) != "port_state_change")
+        {
+            continue;
+        }
+
         uint32_t count;
         sai_port_oper_status_notification_t *portoperstatus = nullptr;
 
-        sai_deserialize_port_oper_status_ntf(data, count, &portoperstatus);
+        sai_deserialize_port_oper_status_ntf(kfvKey(entry), count, &portoperstatus);
+        events.emplace_back(count, portoperstatus);
+    }
+
+    set<string> upPorts;
+
+    for (const auto &event : events)
+    {
+        sai_port_oper_status_notification_t *portoperstatus = event.second;
 
-        for (uint32_t i = 0; i < count; i++)
+        for (uint32_t i = 0; i < event.first; i++)
         {
             sai_object_id_t id = portoperstatus[i].port_id;
             sai_port_oper_status_t status = portoperstatus[i].port_state;
@@ -5118,19 +5292,33 @@ void PortsOrch::doTask(NotificationConsumer &consumer)
             updatePortOperStatus(port, status);
             if (status == SAI_PORT_OPER_STATUS_UP)
             {
-                sai_uint32_t speed;
-                if (getPortOperSpeed(port, speed))
-                {
-                    SWSS_LOG_NOTICE("%s oper speed is %d", port.m_alias.c_str(), speed);
-                    updateDbPortOperSpeed(port, speed);
-                }
+                upPorts.insert(port.m_alias);
+            }
+            else
+            {
+                upPorts.erase(port.m_alias);
             }
 
             /* update m_portList */
             m_portList[port.m_alias] = port;
         }
+    }
 
-        sai_deserialize_free_port_oper_status_ntf(count, portoperstatus);
+    for (const auto &alias : upPorts)
+    {
+        Port port;
+        sai_uint32_t speed;
+
+        if (getPort(alias, port) && getPortOperSpeed(port, speed))
+        {
+            SWSS_LOG_NOTICE("%s oper speed is %d", port.m_alias.c_str(), speed);
+            updateDbPortOperSpeed(port, speed);
+        }
+    }
+
+    for (const auto &event : events)
+    {
+        sai_deserialize_free_port_oper_status_ntf(event.first, event.second);
     }
 }
 
@@ -13,6 +13,7 @@
 #include "gearboxutils.h"
 #include "saihelper.h"
 #include "lagid.h"
+#include "ratecounters.h"
 
 
 #define FCS_LEN 4
@@ -91,6 +92,14 @@ public:
     void increasePortRefCount(const string &alias);
     void decreasePortRefCount(const string &alias);
     bool getPortByBridgePortId(sai_object_id_t bridge_port_id, Port &port);
+
+    /*
+     * Lookups by port, LAG or VLAN object id and by bridge port id, without
+     * copying the port. The port is owned by the port list: the pointer is
+     * only valid until the port list changes, null when there is no such port.
+     */
+    const Port *findPort(sai_object_id_t id) const;
+    const Port *findPortByBridgePortId(sai_object_id_t bridge_port_id) const;
     void setPort(string alias, Port port);
     void getCpuPort(Port &port);
     bool getInbandPort(Port &port);
@@ -126,6 +135,10 @@ public:
     void generateQueueMap();
     void generatePriorityGroupMap();
 
+    /* Port rates follow the poll interval and the status of the port counters group */
+    void setPortRatesInterval(uint32_t intervalMs);
+    void setPortRatesStatus(bool enabled);
+
     void refreshPortStatus();
     bool removeAclTableGroup(const Port &p);
 
@@ -179,6 +192,11 @@ private:
     FlexCounterManager port_buffer_drop_stat_manager;
     FlexCounterManager queue_stat_manager;
 
+    /* Port rates computed in orchagent, unless they are left to port_rates.lua */
+    unique_ptr<RateCounters> m_portRates;
+    SelectableTimer *m_portRatesTimer = nullptr;
+    bool m_portRatesEnabled = false;
+
     std::map<sai_object_id_t, PortSupportedSpeeds> m_portSupportedSpeeds;
 
     bool m_initDone = false;
@@ -214,6 +232,9 @@ private:
     map<set<int>, tuple<string, uint32_t, int, string, int, string>> m_lanesAliasSpeedMap;
     map<string, Port> m_portList;
     unordered_map<sai_object_id_t, int> m_portOidToIndex;
+    /* Aliases of m_portList by object id and by bridge port id */
+    unordered_map<sai_object_id_t, string> m_portOidIndex;
+    unordered_map<sai_object_id_t, string> m_bridgePortOidIndex;
     map<string, uint32_t> m_port_ref_count;
     unordered_set<string> m_pendingPortSet;
 
@@ -228,9 +249,13 @@ private:
     void doLagMemberTask(Consumer &consumer);
 
     void doTask(NotificationConsumer &consumer);
+    void doTask(SelectableTimer &timer);
+    void doPortStatusEvents(const std::deque<KeyOpFieldsValuesTuple> &entries);
 
     void removePortFromLanesMap(string alias);
     void removePortFromPortListMap(sai_object_id_t port_id);
+    void indexPort(const Port &port);
+    void unindexPort(const Port &port);
     void removeDefaultVlanMembers();
     void removeDefaultBridgePorts();
 
@@ -0,0 +1,333 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ratecounters.h"
+#include "logger.h"
+#include "rediscommand.h"
+#include "schema.h"
+
+using namespace std;
+using namespace swss;
+
+#define RATES_TABLE "RATES"
+
+static const vector<string> rateFields = { "RX_BPS", "RX_PPS", "TX_BPS", "TX_PPS" };
+
+/* Counters summed into each rate, in rateFields order, as port_rates.lua and rif_rates.lua sum them */
+static const vector<vector<string>> portRateCounters =
+{
+    { "SAI_PORT_STAT_IF_IN_OCTETS" },
+    { "SAI_PORT_STAT_IF_IN_UCAST_PKTS", "SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS" },
+    { "SAI_PORT_STAT_IF_OUT_OCTETS" },
+    { "SAI_PORT_STAT_IF_OUT_UCAST_PKTS", "SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS" },
+};
+
+static const vector<vector<string>> rifRateCounters =
+{
+    { "SAI_ROUTER_INTERFACE_STAT_IN_OCTETS" },
+    { "SAI_ROUTER_INTERFACE_STAT_IN_PACKETS" },
+    { "SAI_ROUTER_INTERFACE_STAT_OUT_OCTETS" },
+    { "SAI_ROUTER_INTERFACE_STAT_OUT_PACKETS" },
+};
+
+RateCounters::RateCounters(DBConnector *countersDb, Type type, uint32_t intervalMs) :
+    m_db(countersDb),
+    m_type(type),
+    m_intervalMs(intervalMs),
+    m_rateCounters(type == Type::PORT ? portRateCounters : rifRateCounters),
+    m_pipeline(countersDb),
+    m_ratesTable(&m_pipeline, RATES_TABLE, true),
+    m_configTable(countersDb, RATES_TABLE)
+{
+}
+
+void RateCounters::add(const string &oid)
+{
+    if (m_index.count(oid))
+    {
+        return;
+    }
+
+    m_index[oid] = m_oids.size();
+    m_oids.push_back(oid);
+
+    m_state.push_back(SAMPLE_NONE);
+    m_present.push_back(0);
+    m_updated.push_back(0);
+    m_lastTime.emplace_back();
+    m_weight.push_back(0.0);
+    m_seconds.push_back(1.0);
+
+    m_current.resize(m_current.size() + RATE_COUNT, 0);
+    m_last.resize(m_last.size() + RATE_COUNT, 0);
+    m_rates.resize(m_rates.size() + RATE_COUNT, 0.0);
+
+    m_requestValid = false;
+}
+
+/* The last object takes the place of the removed one, so that the arrays stay contiguous */
+void RateCounters::remove(const string &oid)
+{
+    auto it = m_index.find(oid);
+    if (it == m_index.end())
+    {
+        return;
+    }
+
+    size_t i = it->second;
+    size_t last = m_oids.size() - 1;
+    m_index.erase(it);
+
+    if (i != last)
+    {
+        m_oids[i] = move(m_oids[last]);
+        m_index[m_oids[i]] = i;
+
+        m_state[i] = m_state[last];
+        m_lastTime[i] = m_lastTime[last];
+        for (size_t r = 0; r < RATE_COUNT; r++)
+        {
+            m_current[i * RATE_COUNT + r] = m_current[last * RATE_COUNT + r];
+            m_last[i * RATE_COUNT + r] = m_last[last * RATE_COUNT + r];
+            m_rates[i * RATE_COUNT + r] = m_rates[last * RATE_COUNT + r];
+        }
+    }
+
+    m_oids.pop_back();
+    m_state.pop_back();
+    m_present.pop_back();
+    m_updated.pop_back();
+    m_lastTime.pop_back();
+    m_weight.pop_back();
+    m_seconds.pop_back();
+    m_current.resize(last * RATE_COUNT);
+    m_last.resize(last * RATE_COUNT);
+    m_rates.resize(last * RATE_COUNT);
+
+    m_requestValid = false;
+}
+
+bool RateCounters::getAlpha(double &alpha)
+{
+    const string key = (m_type == Type::PORT) ? "PORT" : "RIF";
+    string value;
+
+    if (!m_configTable.hget(key, key + "_ALPHA", value))
+    {
+        return false;
+    }
+
+    char *end = nullptr;
+    alpha = strtod(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0' || alpha < 0.0 || alpha > 1.0)
+    {
+        SWSS_LOG_ERROR("Invalid %s_ALPHA %s in %s", key.c_str(), value.c_str(), RATES_TABLE);
+        return false;
+    }
+
+    return true;
+}
+
+void RateCounters::poll()
+{
+    double alpha;
+
+    if (m_oids.empty() || !getAlpha(alpha))
+    {
+        return;
+    }
+
+    readSnapshot();
+
+    if (update(alpha, chrono::steady_clock::now()))
+    {
+        write();
+    }
+}
+
+void RateCounters::formatRequest()
+{
+    m_request.clear();
+
+    for (const auto &oid : m_oids)
+    {
+        vector<string> args = { "HMGET", COUNTERS_TABLE + m_configTable.getTableNameSeparator() + oid };
+        for (const auto &counters : m_rateCounters)
+        {
+            args.insert(args.end(), counters.begin(), counters.end());
+        }
+
+        RedisCommand hmget;
+        hmget.format(args);
+        m_request.append(hmget.c_str(), hmget.length());
+    }
+
+    m_requestValid = true;
+}
+
+size_t RateCounters::readSnapshot()
+{
+    if (m_oids.empty())
+    {
+        return 0;
+    }
+
+    if (!m_requestValid)
+    {
+        formatRequest();
+    }
+
+    redisContext *ctx = m_db->getContext();
+    if (redisAppendFormattedCommand(ctx, m_request.data(), m_request.size()) != REDIS_OK)
+    {
+        throw runtime_error("Failed to pipeline HMGET of the rate counters");
+    }
+
+    /* Every reply is read, so that none is left on the connection */
+    size_t present = 0;
+    for (size_t i = 0; i < m_oids.size(); i++)
+    {
+        void *reply = nullptr;
+        if (redisGetReply(ctx, &reply) != REDIS_OK)
+        {
+            throw runtime_error("Failed to read HMGET replies of the rate counters");
+        }
+
+        m_present[i] = parseCountersReply(static_cast<redisReply *>(reply), &m_current[i * RATE_COUNT]);
+        present += m_present[i];
+        freeReplyObject(reply);
+    }
+
+    return present;
+}
+
+/* False when any counter is missing, which is the case until syncd polled the object once */
+bool RateCounters::parseCountersReply(const redisReply *reply, uint64_t *totals) const
+{
+    size_t count = 0;
+    for (const auto &counters : m_rateCounters)
+    {
+        count += counters.size();
+    }
+
+    if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != count)
+    {
+        return false;
+    }
+
+    size_t e = 0;
+    for (size_t r = 0; r < RATE_COUNT; r++)
+    {
+        totals[r] = 0;
+        for (size_t c = 0; c < m_rateCounters[r].size(); c++, e++)
+        {
+            const redisReply *value = reply->element[e];
+            if (value->type != REDIS_REPLY_STRING)
+            {
+                return false;
+            }
+            totals[r] += strtoull(value->str, nullptr, 10);
+        }
+    }
+
+    return true;
+}
+
+size_t RateCounters::update(double alpha, chrono::steady_clock::time_point now)
+{
+    const size_t n = m_oids.size();
+    const double staleSeconds = 2 * m_intervalMs / 1000.0;
+    size_t updated = 0;
+
+    /* Which objects take the sample, and with which weight */
+    for (size_t i = 0; i < n; i++)
+    {
+        m_updated[i] = 0;
+        m_weight[i] = 0.0;
+        m_seconds[i] = 1.0;
+
+        if (!m_present[i])
+        {
+            continue;
+        }
+
+        const uint64_t *current = &m_current[i * RATE_COUNT];
+        uint64_t *last = &m_last[i * RATE_COUNT];
+
+        if (m_state[i] == SAMPLE_NONE)
+        {
+            copy(current, current + RATE_COUNT, last);
+            m_lastTime[i] = now;
+            m_state[i] = SAMPLE_COUNTERS;
+            continue;
+        }
+
+        double seconds = chrono::duration<double>(now - m_lastTime[i]).count();
+        if (seconds <= 0.0 || (equal(current, current + RATE_COUNT, last) && seconds < staleSeconds))
+        {
+            continue;
+        }
+
+        m_weight[i] = (m_state[i] == SAMPLE_RATES) ? alpha : 1.0;
+        m_seconds[i] = seconds;
+        m_updated[i] = 1;
+        updated++;
+    }
+
+    /*
+     * Objects left out have a weight of 0 and keep their rates. The counters
+     * are unsigned, a counter cleared gives a negative rate as with the plugins.
+     */
+    const uint64_t *current = m_current.data();
+    const uint64_t *last = m_last.data();
+    const double *weight = m_weight.data();
+    const double *seconds = m_seconds.data();
+    double *rates = m_rates.data();
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const double w = weight[i];
+        const double perSecond = 1.0 / seconds[i];
+
+        for (size_t r = 0; r < RATE_COUNT; r++)
+        {
+            const size_t k = i * RATE_COUNT + r;
+            const double rate = static_cast<double>(static_cast<int64_t>(current[k] - last[k])) * perSecond;
+            rates[k] = w * rate + (1.0 - w) * rates[k];
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (m_updated[i])
+        {
+            copy(&m_current[i * RATE_COUNT], &m_current[(i + 1) * RATE_COUNT], &m_last[i * RATE_COUNT]);
+            m_lastTime[i] = now;
+            m_state[i] = SAMPLE_RATES;
+        }
+    }
+
+    return updated;
+}
+
+void RateCounters::write()
+{
+    for (size_t i = 0; i < m_oids.size(); i++)
+    {
+        if (!m_updated[i])
+        {
+            continue;
+        }
+
+        vector<FieldValueTuple> fvs;
+        fvs.reserve(RATE_COUNT);
+        for (size_t r = 0; r < RATE_COUNT; r++)
+        {
+            fvs.emplace_back(rateFields[r], to_string(m_rates[i * RATE_COUNT + r]));
+        }
+        m_ratesTable.set(m_oids[i], fvs);
+    }
+
+    m_pipeline.flush();
+}
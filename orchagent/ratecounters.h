@@ -0,0 +1,110 @@
+#ifndef SWSS_RATECOUNTERS_H
+#define SWSS_RATECOUNTERS_H
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dbconnector.h"
+#include "redispipeline.h"
+#include "table.h"
+
+/*
+ * Smoothed RX/TX bps and pps of the ports or of the router interfaces,
+ * computed in orchagent the way the port_rates.lua and rif_rates.lua plugins
+ * of syncd compute them inside redis.
+ *
+ * The plugins issue a dozen HGET/HSET per object and per poll within redis.
+ * Here a poll reads the counters of all the objects with a single pipeline of
+ * HMGET, computes the rates over arrays indexed by object, and writes them to
+ * RATES:<oid> with a single pipeline of HSET. The previous samples are only
+ * kept in memory, so RATES:<oid>:PORT/RIF and the *_last fields are not used.
+ *
+ * The rates are computed over the time elapsed between two samples. As the
+ * polls are not aligned with the ones of syncd, a sample where the counters of
+ * an object did not move is skipped for up to 2 intervals, rather than taken
+ * as a zero rate followed by a doubled one. The owner polls at the interval of
+ * the flex counter group of the counters, and only while that group is
+ * enabled, as syncd runs the plugins after each poll of the group.
+ */
+class RateCounters
+{
+public:
+    enum class Type
+    {
+        PORT,
+        RIF,
+    };
+
+    /* RX_BPS, RX_PPS, TX_BPS, TX_PPS */
+    static const size_t RATE_COUNT = 4;
+
+    RateCounters(swss::DBConnector *countersDb, Type type, uint32_t intervalMs);
+
+    /* Objects are identified by their serialized object id, as in COUNTERS:<oid> */
+    void add(const std::string &oid);
+    void remove(const std::string &oid);
+    size_t size() const { return m_oids.size(); }
+
+    uint32_t getInterval() const { return m_intervalMs; }
+    void setInterval(uint32_t intervalMs) { m_intervalMs = intervalMs; }
+
+    /* Reads the counters and writes the rates of every object */
+    void poll();
+
+    /* Reads the counters of every object, returns the number of objects which have them */
+    size_t readSnapshot();
+    /* Computes the rates from the last snapshot taken at 'now', returns the number of objects updated */
+    size_t update(double alpha, std::chrono::steady_clock::time_point now);
+    /* Writes the rates of the objects updated */
+    void write();
+
+    /* Smoothing factor configured in RATES:PORT or RATES:RIF, false when not configured */
+    bool getAlpha(double &alpha);
+
+    /* Parse an HMGET reply of the counters into the totals of each rate */
+    bool parseCountersReply(const redisReply *reply, uint64_t *totals) const;
+
+private:
+    enum SampleState : uint8_t
+    {
+        SAMPLE_NONE,
+        SAMPLE_COUNTERS,    /* Counters of a first sample, no rate yet */
+        SAMPLE_RATES,       /* Rates computed, smoothed from now on */
+    };
+
+    swss::DBConnector *m_db;
+    Type m_type;
+    uint32_t m_intervalMs;
+    std::vector<std::vector<std::string>> m_rateCounters;
+
+    swss::RedisPipeline m_pipeline;
+    swss::Table m_ratesTable;
+    swss::Table m_configTable;
+
+    /* Position of each object in the arrays below */
+    std::unordered_map<std::string, size_t> m_index;
+    std::vector<std::string> m_oids;
+
+    /* Per object */
+    std::vector<uint8_t> m_state;
+    std::vector<uint8_t> m_present;
+    std::vector<uint8_t> m_updated;
+    std::vector<std::chrono::steady_clock::time_point> m_lastTime;
+    std::vector<double> m_weight;
+    std::vector<double> m_seconds;
+
+    /* RATE_COUNT per object */
+    std::vector<uint64_t> m_current;
+    std::vector<uint64_t> m_last;
+    std::vector<double> m_rates;
+
+    /* HMGET of every object, formatted when objects are added or removed */
+    std::string m_request;
+    bool m_requestValid = false;
+
+    void formatRequest();
+};
+
+#endif /* SWSS_RATECOUNTERS_H */
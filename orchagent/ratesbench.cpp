@@ -0,0 +1,221 @@
+/*
+ * Computes the rates of synthetic ports for a number of polls, once with the
+ * port_rates.lua plugin the way syncd runs it, once with RateCounters, and
+ * reports the CPU time redis spent on each, as reported by INFO cpu.
+ *
+ * Every poll moves the counters of all the ports in COUNTERS:<oid> before the
+ * rates are computed. Only the computation of the rates is accounted for, the
+ * writes of the counters are not.
+ *
+ * It needs a redis server, whose database -d is flushed before each run.
+ *
+ * Usage: orchagent-ratesbench [-n <ports>] [-p <polls>] [-H <host>] [-P <port>] [-d <db>] [-f <port_rates.lua>]
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "dbconnector.h"
+#include "redisreply.h"
+#include "redispipeline.h"
+#include "table.h"
+#include "ratecounters.h"
+
+using namespace std;
+using namespace swss;
+
+struct Options
+{
+    size_t  ports;
+    size_t  polls;
+    string  host;
+    int     port;
+    int     db;
+    string  script;
+};
+
+struct Result
+{
+    double  redisSeconds;
+    double  wallSeconds;
+};
+
+static string portOid(size_t i)
+{
+    ostringstream oid;
+    oid << "oid:0x1000000" << hex << (0x10000 + i);
+    return oid.str();
+}
+
+/* used_cpu_sys + used_cpu_user of the redis server */
+static double redisCpu(DBConnector &db)
+{
+    RedisReply reply(&db, "INFO cpu", REDIS_REPLY_STRING);
+    istringstream info(reply.getReply<string>());
+    double cpu = 0;
+    string line;
+
+    while (getline(info, line))
+    {
+        if (line.compare(0, 13, "used_cpu_sys:") == 0)
+        {
+            cpu += stod(line.substr(13));
+        }
+        else if (line.compare(0, 14, "used_cpu_user:") == 0)
+        {
+            cpu += stod(line.substr(14));
+        }
+    }
+
+    return cpu;
+}
+
+static void setup(DBConnector &db)
+{
+    RedisReply flush(&db, "FLUSHDB", REDIS_REPLY_STATUS);
+    Table rates(&db, "RATES");
+    rates.set("PORT", { { "PORT_ALPHA", "0.18" }, { "PORT_SMOOTH_INTERVAL", "10" } });
+}
+
+static void moveCounters(RedisPipeline &pipeline, const Options &o, size_t poll)
+{
+    Table counters(&pipeline, "COUNTERS", true);
+
+    for (size_t i = 0; i < o.ports; i++)
+    {
+        uint64_t pkts = poll * (1000 + i);
+        counters.set(portOid(i), {
+            { "SAI_PORT_STAT_IF_IN_UCAST_PKTS", to_string(pkts) },
+            { "SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS", to_string(pkts / 10) },
+            { "SAI_PORT_STAT_IF_OUT_UCAST_PKTS", to_string(pkts * 2) },
+            { "SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS", to_string(pkts / 5) },
+            { "SAI_PORT_STAT_IF_IN_OCTETS", to_string(pkts * 512) },
+            { "SAI_PORT_STAT_IF_OUT_OCTETS", to_string(pkts * 1024) },
+        });
+    }
+
+    pipeline.flush();
+}
+
+template <typename Compute>
+static Result run(DBConnector &db, const Options &o, Compute compute)
+{
+    RedisPipeline pipeline(&db);
+    Result r = {};
+
+    for (size_t poll = 1; poll <= o.polls; poll++)
+    {
+        moveCounters(pipeline, o, poll);
+
+        double cpu = redisCpu(db);
+        auto begin = chrono::steady_clock::now();
+        compute();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+        r.redisSeconds += redisCpu(db) - cpu;
+        r.wallSeconds += elapsed.count();
+    }
+
+    return r;
+}
+
+static Result runLua(DBConnector &db, const Options &o)
+{
+    ifstream file(o.script);
+    if (!file)
+    {
+        cerr << "Failed to read " << o.script << endl;
+        exit(EXIT_FAILURE);
+    }
+    stringstream script;
+    script << file.rdbuf();
+
+    setup(db);
+    string sha = loadRedisScript(&db, script.str());
+
+    vector<string> keys;
+    for (size_t i = 0; i < o.ports; i++)
+    {
+        keys.push_back(portOid(i));
+    }
+    vector<string> argv = { to_string(o.db), "COUNTERS", "1" };
+
+    return run(db, o, [&]() {
+        runRedisScript(db, sha, keys, argv);
+    });
+}
+
+static Result runNative(DBConnector &db, const Options &o)
+{
+    setup(db);
+
+    RateCounters rates(&db, RateCounters::Type::PORT, 1000);
+    for (size_t i = 0; i < o.ports; i++)
+    {
+        rates.add(portOid(i));
+    }
+
+    return run(db, o, [&]() {
+        rates.poll();
+    });
+}
+
+static void report(const char *name, const Result &r, const Options &o)
+{
+    cout << name << o.ports << " ports, " << o.polls << " polls, redis CPU "
+         << r.redisSeconds * 1000 / static_cast<double>(o.polls) << " ms/poll, wall "
+         << r.wallSeconds * 1000 / static_cast<double>(o.polls) << " ms/poll" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    Options o = { 512, 20, "127.0.0.1", 6379, 15, "/usr/share/swss/port_rates.lua" };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:H:P:d:f:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                o.ports = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                o.polls = strtoul(optarg, NULL, 0);
+                break;
+            case 'H':
+                o.host = optarg;
+                break;
+            case 'P':
+                o.port = atoi(optarg);
+                break;
+            case 'd':
+                o.db = atoi(optarg);
+                break;
+            case 'f':
+                o.script = optarg;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n <ports>] [-p <polls>] [-H <host>] [-P <port>] [-d <db>] [-f <port_rates.lua>]" << endl;
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (!o.ports || !o.polls)
+    {
+        cerr << "Usage: " << argv[0] << " [-n <ports>] [-p <polls>] [-H <host>] [-P <port>] [-d <db>] [-f <port_rates.lua>]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    DBConnector db(o.db, o.host, o.port, 0);
+
+    Result lua = runLua(db, o);
+    Result native = runNative(db, o);
+
+    report("lua:    ", lua, o);
+    report("native: ", native, o);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+#ifndef SWSS_RESYNCEPOCH_H
+#define SWSS_RESYNCEPOCH_H
+
+#include <cstdint>
+#include <cstddef>
+
+typedef uint32_t resync_epoch_t;
+
+/*
+ * Generation number of the entries an application resyncs.
+ *
+ * Entries record the epoch they were last set in. A resync opens a new epoch,
+ * and the application sets again all the entries it still has. When the resync
+ * completes, the entries left with an older epoch are stale. Nothing is done
+ * per entry when the resync starts.
+ */
+class ResyncEpoch
+{
+public:
+    resync_epoch_t current() const
+    {
+        return m_epoch;
+    }
+
+    bool inProgress() const
+    {
+        return m_inProgress;
+    }
+
+    void start()
+    {
+        m_epoch++;
+        m_inProgress = true;
+    }
+
+    void complete()
+    {
+        m_inProgress = false;
+    }
+
+    bool isStale(resync_epoch_t epoch) const
+    {
+        return epoch != m_epoch;
+    }
+
+    /*
+     * Calls stale(key, value) on the entries of the table set before the current
+     * epoch, epochOf(value) giving the epoch of an entry. The table must not be
+     * changed by the callback. Returns the number of stale entries.
+     */
+    template <typename Table, typename EpochOf, typename Stale>
+    size_t sweep(const Table &table, EpochOf epochOf, Stale stale) const
+    {
+        size_t count = 0;
+        for (const auto &entry : table)
+        {
+            if (isStale(epochOf(entry.second)))
+            {
+                stale(entry.first, entry.second);
+                count++;
+            }
+        }
+        return count;
+    }
+
+private:
+    resync_epoch_t  m_epoch = 0;
+    bool            m_inProgress = false;
+};
+
+#endif /* SWSS_RESYNCEPOCH_H */
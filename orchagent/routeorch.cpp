@@ -19,6 +19,7 @@ extern CrmOrch *gCrmOrch;
 extern Directory<Orch*> gDirectory;
 
 extern size_t gMaxBulkSize;
+extern bool gRoutePipeline;
 
 /* Default maximum number of next hop groups */
 #define DEFAULT_NUMBER_OF_ECMP_GROUPS   128
@@ -26,9 +27,10 @@ extern size_t gMaxBulkSize;
 
 const int routeorch_pri = 5;
 
-RouteOrch::RouteOrch(DBConnector *db, string tableName, SwitchOrch *switchOrch, NeighOrch *neighOrch, IntfsOrch *intfsOrch, VRFOrch *vrfOrch, FgNhgOrch *fgNhgOrch) :
+RouteOrch::RouteOrch(DBConnector *db, string tableName, TableConnector stateDbRouteStats, SwitchOrch *switchOrch, NeighOrch *neighOrch, IntfsOrch *intfsOrch, VRFOrch *vrfOrch, FgNhgOrch *fgNhgOrch) :
         gRouteBulker(sai_route_api, gMaxBulkSize),
         gNextHopGroupMemberBulker(sai_next_hop_group_api, gSwitchId, gMaxBulkSize),
+        m_routeBulkPipeline(sai_route_api, gMaxBulkSize),
         Orch(db, tableName, routeorch_pri),
         m_switchOrch(switchOrch),
         m_neighOrch(neighOrch),
@@ -36,7 +38,7 @@ RouteOrch::RouteOrch(DBConnector *db, string tableName, SwitchOrch *switchOrch,
         m_vrfOrch(vrfOrch),
         m_fgNhgOrch(fgNhgOrch),
         m_nextHopGroupCount(0),
-        m_resync(false)
+        m_routeStatsTable(new Table(stateDbRouteStats.first, stateDbRouteStats.second))
 {
     SWSS_LOG_ENTER();
 
@@ -96,7 +98,7 @@ RouteOrch::RouteOrch(DBConnector *db, string tableName, SwitchOrch *switchOrch,
     gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
 
     /* Add default IPv4 route into the m_syncdRoutes */
-    m_syncdRoutes[gVirtualRouterId][default_ip_prefix] = NextHopGroupKey();
+    m_syncdRoutes[gVirtualRouterId][default_ip_prefix] = { NextHopGroupKey(), m_resyncEpoch.current() };
 
     SWSS_LOG_NOTICE("Create IPv4 default route with packet action drop");
 
@@ -115,7 +117,8 @@ RouteOrch::RouteOrch(DBConnector *db, string tableName, SwitchOrch *switchOrch,
     gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
 
     /* Add default IPv6 route into the m_syncdRoutes */
-    m_syncdRoutes[gVirtualRouterId][v6_default_ip_prefix] = NextHopGroupKey();
+    m_syncdRoutes[gVirtualRouterId][v6_default_ip_prefix] = { NextHopGroupKey(), m_resyncEpoch.current() };
+    markRouteStats(gVirtualRouterId);
 
     SWSS_LOG_NOTICE("Create IPv6 default route with packet action drop");
 
@@ -231,17 +234,15 @@ void RouteOrch::attach(Observer *observer, const IpAddress& dstAddr, sai_object_
         observerEntry = m_nextHopObservers.find(host);
 
         /* Find the prefixes that cover the destination IP */
-        if (m_syncdRoutes.find(vrf_id) != m_syncdRoutes.end())
+        auto it_routes = m_syncdRoutes.find(vrf_id);
+        if (it_routes != m_syncdRoutes.end())
         {
-            for (auto route : m_syncdRoutes.at(vrf_id))
+            for (auto route : it_routes->second.matches(dstAddr))
             {
-                if (route.first.isAddressInSubnet(dstAddr))
-                {
-                    SWSS_LOG_INFO("Prefix %s covers destination address",
-                            route.first.to_string().c_str());
-                    observerEntry->second.routeTable.emplace(
-                            route.first, route.second);
-                }
+                SWSS_LOG_INFO("Prefix %s covers destination address",
+                        route->first.to_string().c_str());
+                observerEntry->second.routeTable.emplace(
+                        route->first, route->second.nhg_key);
             }
         }
     }
@@ -249,12 +250,11 @@ void RouteOrch::attach(Observer *observer, const IpAddress& dstAddr, sai_object_
     observerEntry->second.observers.push_back(observer);
 
     // Trigger next hop change for the first time the observer is attached
-    // Note that rbegin() is pointing to the entry with longest prefix match
-    auto route = observerEntry->second.routeTable.rbegin();
-    if (route != observerEntry->second.routeTable.rend())
+    auto route = observerEntry->second.routeTable.longest_match(dstAddr);
+    if (route != observerEntry->second.routeTable.end())
     {
         SWSS_LOG_NOTICE("Attached next hop observer of route %s for destination IP %s",
-                observerEntry->second.routeTable.rbegin()->first.to_string().c_str(),
+                route->first.to_string().c_str(),
                 dstAddr.to_string().c_str());
         NextHopUpdate update = { vrf_id, dstAddr, route->first, route->second };
         observer->update(SUBJECT_TYPE_NEXTHOP_CHANGE, static_cast<void *>(&update));
@@ -412,17 +412,27 @@ void RouteOrch::doTask(Consumer& consumer)
         return;
     }
 
+    /*
+     * In the pipelined mode, the tasks are cut into batches of the maximum bulk size,
+     * and the next batch is collected while the bulk calls of the previous one are
+     * in flight. A route depending on the batch in flight ends the batch being
+     * collected, so that it is collected again once the batch in flight is done.
+     *
+     * The SAI is not called by this thread while a batch is in flight: a route
+     * needing SAI calls out of the route bulker, e.g. to create its next hop group,
+     * ends the batch being collected the same way.
+     */
+    std::unique_ptr<RouteBulkBatch> inflight;
+
     auto it = consumer.m_toSync.begin();
-    while (it != consumer.m_toSync.end())
+    while (it != consumer.m_toSync.end() || inflight)
     {
         // Route bulk results will be stored in a map
-        std::map<
-                std::pair<
-                        std::string,            // Key
-                        std::string             // Op
-                >,
-                RouteBulkContext
-        >                                       toBulk;
+        std::unique_ptr<RouteBulkBatch> batch(new RouteBulkBatch());
+        auto& toBulk = batch->toBulk;
+
+        // Set when the batch must be flushed before the next one is collected
+        bool barrier = false;
 
         // Add or remove routes with a route bulker
         while (it != consumer.m_toSync.end())
@@ -432,6 +442,11 @@ void RouteOrch::doTask(Consumer& consumer)
             string key = kfvKey(t);
             string op = kfvOp(t);
 
+            if (gRoutePipeline && (toBulk.size() >= gMaxBulkSize || (inflight && key == "resync")))
+            {
+                break;
+            }
+
             auto rc = toBulk.emplace(std::piecewise_construct,
                     std::forward_as_tuple(key, op),
                     std::forward_as_tuple());
@@ -445,53 +460,29 @@ void RouteOrch::doTask(Consumer& consumer)
 
             /* Get notification from application */
             /* resync application:
-             * When routeorch receives 'resync' message, it marks all current
-             * routes as dirty and waits for 'resync complete' message. For all
-             * newly received routes, if they match current dirty routes, it unmarks
-             * them dirty. After receiving 'resync complete' message, it creates all
-             * newly added routes and removes all dirty routes.
+             * When routeorch receives 'resync' message, it starts a new resync
+             * epoch, and every route set from then on is stamped with it. After
+             * receiving 'resync complete' message, it removes the routes left
+             * with an older epoch.
              */
             if (key == "resync")
             {
                 if (op == "SET")
                 {
-                    /* Mark all current routes as dirty (DEL) in consumer.m_toSync map */
                     SWSS_LOG_NOTICE("Start resync routes\n");
-                    for (auto j : m_syncdRoutes)
-                    {
-                        string vrf;
-
-                        if (j.first != gVirtualRouterId)
-                        {
-                            vrf = m_vrfOrch->getVRFname(j.first) + ":";
-                        }
-
-                        for (auto i : j.second)
-                        {
-                            vector<FieldValueTuple> v;
-                            key = vrf + i.first.to_string();
-                            auto x = KeyOpFieldsValuesTuple(key, DEL_COMMAND, v);
-                            consumer.addToSync(x);
-                        }
-                    }
-                    m_resync = true;
+                    m_resyncEpoch.start();
                 }
                 else
                 {
                     SWSS_LOG_NOTICE("Complete resync routes\n");
-                    m_resync = false;
+                    removeStaleRoutes(consumer);
+                    m_resyncEpoch.complete();
                 }
 
                 it = consumer.m_toSync.erase(it);
                 continue;
             }
 
-            if (m_resync)
-            {
-                it++;
-                continue;
-            }
-
             sai_object_id_t& vrf_id = ctx.vrf_id;
             IpPrefix& ip_prefix = ctx.ip_prefix;
 
@@ -514,6 +505,12 @@ void RouteOrch::doTask(Consumer& consumer)
                 ip_prefix = IpPrefix(key);
             }
 
+            if (inflight && dependsOnBulkBatch(*inflight, ctx))
+            {
+                toBulk.erase(rc.first);
+                break;
+            }
+
             if (op == SET_COMMAND)
             {
                 string ips;
@@ -678,6 +675,12 @@ void RouteOrch::doTask(Consumer& consumer)
                     /* subnet route, vrf leaked route, etc */
                     else
                     {
+                        if (inflight && needsSaiCalls(ctx, nhg))
+                        {
+                            toBulk.erase(rc.first);
+                            break;
+                        }
+
                         if (addRoute(ctx, nhg))
                             it = consumer.m_toSync.erase(it);
                         else
@@ -686,21 +689,31 @@ void RouteOrch::doTask(Consumer& consumer)
                 }
                 else if (m_syncdRoutes.find(vrf_id) == m_syncdRoutes.end() ||
                     m_syncdRoutes.at(vrf_id).find(ip_prefix) == m_syncdRoutes.at(vrf_id).end() ||
-                    m_syncdRoutes.at(vrf_id).at(ip_prefix) != nhg)
+                    m_syncdRoutes.at(vrf_id).at(ip_prefix).nhg_key != nhg)
                 {
+                    if (inflight && (dependsOnBulkBatch(*inflight, nhg) || needsSaiCalls(ctx, nhg)))
+                    {
+                        toBulk.erase(rc.first);
+                        break;
+                    }
+
                     if (addRoute(ctx, nhg))
                         it = consumer.m_toSync.erase(it);
                     else
                         it++;
                 }
                 else
+                {
                     /* Duplicate entry */
+                    m_syncdRoutes.at(vrf_id).at(ip_prefix).epoch = m_resyncEpoch.current();
                     it = consumer.m_toSync.erase(it);
+                }
 
                 // If already exhaust the nexthop groups, and there are pending removing routes in bulker,
                 // flush the bulker and possibly collect some released nexthop groups
                 if (m_nextHopGroupCount >= m_maxNextHopGroupCount && gRouteBulker.removing_entries_count() > 0)
                 {
+                    barrier = true;
                     break;
                 }
             }
@@ -718,94 +731,299 @@ void RouteOrch::doTask(Consumer& consumer)
             }
         }
 
-        // Flush the route bulker, so routes will be written to syncd and ASIC
-        gRouteBulker.flush();
+        if (inflight)
+        {
+            // Wait for the batch in flight, the routes depending on it are not collected yet
+            m_routeBulkPipeline.wait();
+            postBulkBatch(consumer, *inflight, it);
+            inflight.reset();
+        }
 
-        // Go through the bulker results
-        auto it_prev = consumer.m_toSync.begin();
-        m_bulkNhgReducedRefCnt.clear();
-        while (it_prev != it)
+        if (toBulk.empty())
         {
-            KeyOpFieldsValuesTuple t = it_prev->second;
+            continue;
+        }
 
-            string key = kfvKey(t);
-            string op = kfvOp(t);
-            auto found = toBulk.find(make_pair(key, op));
-            if (found == toBulk.end())
-            {
-                it_prev++;
-                continue;
-            }
+        if (gRoutePipeline && !barrier)
+        {
+            // Flush the route bulker in the background, and collect the next batch meanwhile
+            trackBulkBatch(*batch);
+            m_routeBulkPipeline.dispatch(gRouteBulker);
+            inflight = std::move(batch);
+        }
+        else
+        {
+            // Flush the route bulker, so routes will be written to syncd and ASIC
+            gRouteBulker.flush();
+            postBulkBatch(consumer, *batch, it);
+        }
+    }
 
-            const auto& ctx = found->second;
-            const auto& object_statuses = ctx.object_statuses;
-            if (object_statuses.empty())
-            {
-                it_prev++;
-                continue;
-            }
+    publishRouteStats();
+}
 
-            const sai_object_id_t& vrf_id = ctx.vrf_id;
-            const IpPrefix& ip_prefix = ctx.ip_prefix;
+void RouteOrch::removeStaleRoutes(Consumer& consumer)
+{
+    SWSS_LOG_ENTER();
 
-            if (op == SET_COMMAND)
-            {
-                const bool& excp_intfs_flag = ctx.excp_intfs_flag;
-                const vector<string>& ipv = ctx.ipv;
+    size_t count = 0;
+    for (const auto& it_route_table : m_syncdRoutes)
+    {
+        string vrf;
+        if (it_route_table.first != gVirtualRouterId)
+        {
+            vrf = m_vrfOrch->getVRFname(it_route_table.first) + ":";
+        }
 
-                if (excp_intfs_flag)
+        m_resyncEpoch.sweep(it_route_table.second,
+            [](const RouteNhg& route) { return route.epoch; },
+            [&](const IpPrefix& prefix, const RouteNhg& route)
+            {
+                /* A route with pending tasks, e.g. being retried, is not stale */
+                string key = vrf + prefix.to_string();
+                if (consumer.m_toSync.find(key) == consumer.m_toSync.end())
                 {
-                    /* If any existing routes are updated to point to the
-                     * above interfaces, remove them from the ASIC. */
-                    if (removeRoutePost(ctx))
-                        it_prev = consumer.m_toSync.erase(it_prev);
-                    else
-                        it_prev++;
-                    continue;
+                    consumer.addToSync(KeyOpFieldsValuesTuple(key, DEL_COMMAND, vector<FieldValueTuple>()));
+                    count++;
                 }
+            });
+    }
 
-                const NextHopGroupKey& nhg = ctx.nhg;
+    SWSS_LOG_NOTICE("Removing %zu stale routes after resync", count);
+}
 
-                if (ipv.size() == 1 && IpAddress(ipv[0]).isZero())
-                {
-                    if (addRoutePost(ctx, nhg))
-                        it_prev = consumer.m_toSync.erase(it_prev);
-                    else
-                        it_prev++;
-                }
-                else if (m_syncdRoutes.find(vrf_id) == m_syncdRoutes.end() ||
-                    m_syncdRoutes.at(vrf_id).find(ip_prefix) == m_syncdRoutes.at(vrf_id).end() ||
-                    m_syncdRoutes.at(vrf_id).at(ip_prefix) != nhg)
-                {
-                    if (addRoutePost(ctx, nhg))
-                        it_prev = consumer.m_toSync.erase(it_prev);
-                    else
-                        it_prev++;
-                }
-            }
-            else if (op == DEL_COMMAND)
+void RouteOrch::markRouteStats(sai_object_id_t vrf_id)
+{
+    if (m_dirtyRouteStats.find(vrf_id) != m_dirtyRouteStats.end())
+    {
+        return;
+    }
+
+    /* The VRF name is kept, the VRF may be gone when its empty table is published */
+    m_dirtyRouteStats.emplace(vrf_id, vrf_id == gVirtualRouterId ?
+            DEFAULT_VRF_ROUTE_STATS_KEY : m_vrfOrch->getVRFname(vrf_id));
+}
+
+void RouteOrch::publishRouteStats()
+{
+    SWSS_LOG_ENTER();
+
+    for (const auto& dirty : m_dirtyRouteStats)
+    {
+        auto it_route_table = m_syncdRoutes.find(dirty.first);
+        if (it_route_table == m_syncdRoutes.end())
+        {
+            m_routeStatsTable->del(dirty.second);
+            continue;
+        }
+
+        const auto& table = it_route_table->second;
+        vector<FieldValueTuple> fvs = {
+            { "route_count", to_string(table.size()) },
+            { "ipv4_route_count", to_string(table.size_v4()) },
+            { "ipv6_route_count", to_string(table.size_v6()) },
+            { "memory_bytes", to_string(table.bytes()) }
+        };
+        m_routeStatsTable->set(dirty.second, fvs);
+    }
+
+    m_dirtyRouteStats.clear();
+}
+
+void RouteOrch::postBulkBatch(Consumer& consumer, RouteBulkBatch& batch, SyncMap::iterator end)
+{
+    SWSS_LOG_ENTER();
+
+    auto& toBulk = batch.toBulk;
+
+    // Go through the bulker results
+    auto it_prev = consumer.m_toSync.begin();
+    m_bulkNhgReducedRefCnt.clear();
+    while (it_prev != end)
+    {
+        KeyOpFieldsValuesTuple t = it_prev->second;
+
+        string key = kfvKey(t);
+        string op = kfvOp(t);
+        auto found = toBulk.find(make_pair(key, op));
+        if (found == toBulk.end())
+        {
+            it_prev++;
+            continue;
+        }
+
+        const auto& ctx = found->second;
+        const auto& object_statuses = ctx.object_statuses;
+        if (object_statuses.empty())
+        {
+            it_prev++;
+            continue;
+        }
+
+        const sai_object_id_t& vrf_id = ctx.vrf_id;
+        const IpPrefix& ip_prefix = ctx.ip_prefix;
+
+        if (op == SET_COMMAND)
+        {
+            const bool& excp_intfs_flag = ctx.excp_intfs_flag;
+            const vector<string>& ipv = ctx.ipv;
+
+            if (excp_intfs_flag)
             {
-                /* Cannot locate the route or remove succeed */
+                /* If any existing routes are updated to point to the
+                 * above interfaces, remove them from the ASIC. */
                 if (removeRoutePost(ctx))
                     it_prev = consumer.m_toSync.erase(it_prev);
                 else
                     it_prev++;
+                continue;
             }
-        }
 
-        /* Remove next hop group if the reference count decreases to zero */
-        for (auto& it_nhg : m_bulkNhgReducedRefCnt)
-        {
-            if (it_nhg.first.is_overlay_nexthop() && it_nhg.second != 0)
+            const NextHopGroupKey& nhg = ctx.nhg;
+
+            if (ipv.size() == 1 && IpAddress(ipv[0]).isZero())
             {
-                removeOverlayNextHops(it_nhg.second, it_nhg.first);
+                if (addRoutePost(ctx, nhg))
+                    it_prev = consumer.m_toSync.erase(it_prev);
+                else
+                    it_prev++;
             }
-            else if (m_syncdNextHopGroups[it_nhg.first].ref_count == 0)
+            else if (m_syncdRoutes.find(vrf_id) == m_syncdRoutes.end() ||
+                m_syncdRoutes.at(vrf_id).find(ip_prefix) == m_syncdRoutes.at(vrf_id).end() ||
+                m_syncdRoutes.at(vrf_id).at(ip_prefix).nhg_key != nhg)
+            {
+                if (addRoutePost(ctx, nhg))
+                    it_prev = consumer.m_toSync.erase(it_prev);
+                else
+                    it_prev++;
+            }
+        }
+        else if (op == DEL_COMMAND)
+        {
+            /* Cannot locate the route or remove succeed */
+            if (removeRoutePost(ctx))
+                it_prev = consumer.m_toSync.erase(it_prev);
+            else
+                it_prev++;
+        }
+    }
+
+    /* Remove next hop group if the reference count decreases to zero */
+    for (auto& it_nhg : m_bulkNhgReducedRefCnt)
+    {
+        if (it_nhg.first.is_overlay_nexthop() && it_nhg.second != 0)
+        {
+            removeOverlayNextHops(it_nhg.second, it_nhg.first);
+        }
+        else if (m_syncdNextHopGroups[it_nhg.first].ref_count == 0)
+        {
+            removeNextHopGroup(it_nhg.first);
+        }
+    }
+}
+
+void RouteOrch::trackBulkBatch(RouteBulkBatch& batch)
+{
+    SWSS_LOG_ENTER();
+
+    for (const auto& it_ctx : batch.toBulk)
+    {
+        const auto& ctx = it_ctx.second;
+        if (ctx.object_statuses.empty())
+        {
+            continue;
+        }
+
+        batch.routes.emplace(ctx.vrf_id, ctx.ip_prefix);
+
+        auto it_route_table = m_syncdRoutes.find(ctx.vrf_id);
+        if (it_route_table == m_syncdRoutes.end())
+        {
+            continue;
+        }
+
+        auto it_route = it_route_table->second.find(ctx.ip_prefix);
+        if (it_route == it_route_table->second.end())
+        {
+            continue;
+        }
+
+        /* The route post releases the next hop group the route is pointing to */
+        const NextHopGroupKey& nhg = it_route->second.nhg_key;
+        if (nhg.getSize() > 1 || nhg.is_overlay_nexthop())
+        {
+            batch.releasedNhgs[nhg]++;
+        }
+
+        if (it_ctx.first.second == DEL_COMMAND || ctx.excp_intfs_flag)
+        {
+            batch.removedRoutes[ctx.vrf_id]++;
+        }
+    }
+}
+
+bool RouteOrch::dependsOnBulkBatch(const RouteBulkBatch& batch, const RouteBulkContext& ctx) const
+{
+    if (batch.routes.find(make_pair(ctx.vrf_id, ctx.ip_prefix)) != batch.routes.end())
+    {
+        return true;
+    }
+
+    /* The batch may remove the last routes of the VRF, and its route table with them */
+    auto it_removed = batch.removedRoutes.find(ctx.vrf_id);
+    if (it_removed != batch.removedRoutes.end())
+    {
+        auto it_route_table = m_syncdRoutes.find(ctx.vrf_id);
+        if (it_route_table == m_syncdRoutes.end() || it_route_table->second.size() <= it_removed->second)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool RouteOrch::dependsOnBulkBatch(const RouteBulkBatch& batch, const NextHopGroupKey& nextHops) const
+{
+    auto it_released = batch.releasedNhgs.find(nextHops);
+    if (it_released == batch.releasedNhgs.end())
+    {
+        return false;
+    }
+
+    if (nextHops.is_overlay_nexthop())
+    {
+        return true;
+    }
+
+    /* The batch may release the last references of the next hop group, and remove it */
+    auto it_nhg = m_syncdNextHopGroups.find(nextHops);
+    return it_nhg == m_syncdNextHopGroups.end() || it_nhg->second.ref_count <= it_released->second;
+}
+
+bool RouteOrch::needsSaiCalls(const RouteBulkContext& ctx, const NextHopGroupKey& nextHops) const
+{
+    /* Fine grained next hop groups are set up by FgNhgOrch with direct SAI calls */
+    if (m_fgNhgOrch->isRouteFineGrained(ctx.vrf_id, ctx.ip_prefix, nextHops))
+    {
+        return true;
+    }
+
+    /* Remote VTEPs and tunnel next hops are created on demand */
+    if (nextHops.is_overlay_nexthop())
+    {
+        for (const auto& nexthop : nextHops.getNextHops())
+        {
+            if (!m_neighOrch->hasNextHop(nexthop))
             {
-                removeNextHopGroup(it_nhg.first);
+                return true;
             }
         }
+        return false;
     }
+
+    /* A new next hop group is created, with its members */
+    return nextHops.getSize() > 1 && !hasNextHopGroup(nextHops);
 }
 
 void RouteOrch::notifyNextHopChangeObservers(sai_object_id_t vrf_id, const IpPrefix &prefix, const NextHopGroupKey &nexthops, bool add)
@@ -831,7 +1049,9 @@ void RouteOrch::notifyNextHopChangeObservers(sai_object_id_t vrf_id, const IpPre
             if (route == entry.second.routeTable.end())
             {
                 /* If added route is best match update observers */
-                if (entry.second.routeTable.rbegin()->first < prefix)
+                auto best = entry.second.routeTable.longest_match(entry.first.second);
+                if (best == entry.second.routeTable.end() ||
+                    best->first.getMaskLength() < prefix.getMaskLength())
                 {
                     update_required = true;
                 }
@@ -844,7 +1064,7 @@ void RouteOrch::notifyNextHopChangeObservers(sai_object_id_t vrf_id, const IpPre
                 {
                     route->second = nexthops;
                     /* If changed route is best match update observers */
-                    if (entry.second.routeTable.rbegin()->first == route->first)
+                    if (entry.second.routeTable.longest_match(entry.first.second) == route)
                     {
                         update_required = true;
                     }
@@ -865,14 +1085,14 @@ void RouteOrch::notifyNextHopChangeObservers(sai_object_id_t vrf_id, const IpPre
             if (route != entry.second.routeTable.end())
             {
                 /* If removed route was best match find another best match route */
-                if (route->first == entry.second.routeTable.rbegin()->first)
+                if (entry.second.routeTable.longest_match(entry.first.second) == route)
                 {
                     entry.second.routeTable.erase(route);
 
                     /* Table should not be empty. Default route should always exists. */
                     assert(!entry.second.routeTable.empty());
 
-                    auto route = entry.second.routeTable.rbegin();
+                    auto route = entry.second.routeTable.longest_match(entry.first.second);
                     NextHopUpdate update = { vrf_id, entry.first.second, route->first, route->second };
 
                     for (auto observer : entry.second.observers)
@@ -970,7 +1190,7 @@ const NextHopGroupKey RouteOrch::getSyncdRouteNhgKey(sai_object_id_t vrf_id, con
         auto route_entry = route_table->second.find(ipPrefix);
         if (route_entry != route_table->second.end())
         {
-            nhg = route_entry->second;
+            nhg = route_entry->second.nhg_key;
         }
     }
     return nhg;
@@ -1292,17 +1512,17 @@ bool RouteOrch::updateNextHopRoutes(const NextHopKey& nextHop, uint32_t& numRout
     sai_attribute_t route_attr;
     sai_object_id_t next_hop_id;
 
-    for (auto rt_table : m_syncdRoutes)
+    for (const auto& rt_table : m_syncdRoutes)
     {
         for (auto rt_entry : rt_table.second)
         {
             // Skip routes with ecmp nexthops
-            if (rt_entry.second.getSize() > 1)
+            if (rt_entry.second.nhg_key.getSize() > 1)
             {
                 continue;
             }
 
-            if (rt_entry.second.contains(nextHop))
+            if (rt_entry.second.nhg_key.contains(nextHop))
             {
                 SWSS_LOG_INFO("Updating route %s during nexthop status change",
                                rt_entry.first.to_string().c_str());
@@ -1535,15 +1755,15 @@ bool RouteOrch::addRoute(RouteBulkContext& ctx, const NextHopGroupKey &nextHops)
 
                 /* If the current next hop is part of the next hop group to sync,
                  * then return false and no need to add another temporary route. */
-                if (it_route != m_syncdRoutes.at(vrf_id).end() && it_route->second.getSize() == 1)
+                if (it_route != m_syncdRoutes.at(vrf_id).end() && it_route->second.nhg_key.getSize() == 1)
                 {
                     NextHopKey nexthop;
-                    auto old_nextHops = it_route->second;
+                    auto old_nextHops = it_route->second.nhg_key;
 
                     if (old_nextHops.is_overlay_nexthop()) {
                         nexthop = NextHopKey(old_nextHops.to_string(), true);
                     } else {
-                        nexthop = NextHopKey(it_route->second.to_string());
+                        nexthop = NextHopKey(it_route->second.nhg_key.to_string());
                     }
 
                     if (nextHops.contains(nexthop))
@@ -1605,7 +1825,7 @@ bool RouteOrch::addRoute(RouteBulkContext& ctx, const NextHopGroupKey &nextHops)
     else
     {
         /* Set the packet action to forward when there was no next hop (dropped) and not pointing to blackhole*/
-        if (it_route->second.getSize() == 0 && !blackhole)
+        if (it_route->second.nhg_key.getSize() == 0 && !blackhole)
         {
             route_attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
             route_attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
@@ -1745,16 +1965,16 @@ bool RouteOrch::addRoutePost(const RouteBulkContext& ctx, const NextHopGroupKey
         else
         {
             /* Route already exists */
-            auto nh_entry = m_syncdNextHopGroups.find(it_route->second);
+            auto nh_entry = m_syncdNextHopGroups.find(it_route->second.nhg_key);
             if (nh_entry != m_syncdNextHopGroups.end())
             {
                 /* Case where route was pointing to non-fine grained nhs in the past,
                  * and transitioned to Fine Grained ECMP */
-                decreaseNextHopRefCount(it_route->second);
-                if (it_route->second.getSize() > 1
-                    && m_syncdNextHopGroups[it_route->second].ref_count == 0)
+                decreaseNextHopRefCount(it_route->second.nhg_key);
+                if (it_route->second.nhg_key.getSize() > 1
+                    && m_syncdNextHopGroups[it_route->second.nhg_key].ref_count == 0)
                 {
-                    m_bulkNhgReducedRefCnt.emplace(it_route->second, 0);
+                    m_bulkNhgReducedRefCnt.emplace(it_route->second.nhg_key, 0);
                 }
             }
             SWSS_LOG_INFO("FG Post set route %s with next hop(s) %s",
@@ -1800,7 +2020,7 @@ bool RouteOrch::addRoutePost(const RouteBulkContext& ctx, const NextHopGroupKey
         sai_status_t status;
 
         /* Set the packet action to forward when there was no next hop (dropped) and not pointing to blackhole */
-        if (it_route->second.getSize() == 0 && !blackhole)
+        if (it_route->second.nhg_key.getSize() == 0 && !blackhole)
         {
             status = *it_status++;
             if (status != SAI_STATUS_SUCCESS)
@@ -1837,12 +2057,12 @@ bool RouteOrch::addRoutePost(const RouteBulkContext& ctx, const NextHopGroupKey
         }
         else
         {
-            decreaseNextHopRefCount(it_route->second);
-            auto ol_nextHops = it_route->second;
-            if (it_route->second.getSize() > 1
-                && m_syncdNextHopGroups[it_route->second].ref_count == 0)
+            decreaseNextHopRefCount(it_route->second.nhg_key);
+            auto ol_nextHops = it_route->second.nhg_key;
+            if (it_route->second.nhg_key.getSize() > 1
+                && m_syncdNextHopGroups[it_route->second.nhg_key].ref_count == 0)
             {
-                m_bulkNhgReducedRefCnt.emplace(it_route->second, 0);
+                m_bulkNhgReducedRefCnt.emplace(it_route->second.nhg_key, 0);
             } else if (ol_nextHops.is_overlay_nexthop()){
                 SWSS_LOG_NOTICE("Update overlay Nexthop %s", ol_nextHops.to_string().c_str());
                 m_bulkNhgReducedRefCnt.emplace(ol_nextHops, vrf_id);
@@ -1869,7 +2089,8 @@ bool RouteOrch::addRoutePost(const RouteBulkContext& ctx, const NextHopGroupKey
                 ipPrefix.to_string().c_str(), nextHops.to_string().c_str());
     }
 
-    m_syncdRoutes[vrf_id][ipPrefix] = nextHops;
+    m_syncdRoutes[vrf_id][ipPrefix] = { nextHops, m_resyncEpoch.current() };
+    markRouteStats(vrf_id);
 
     notifyNextHopChangeObservers(vrf_id, ipPrefix, nextHops, true);
     return true;
@@ -2013,14 +2234,14 @@ bool RouteOrch::removeRoutePost(const RouteBulkContext& ctx)
         /*
          * Decrease the reference count only when the route is pointing to a next hop.
          */
-        decreaseNextHopRefCount(it_route->second);
+        decreaseNextHopRefCount(it_route->second.nhg_key);
 
-        auto ol_nextHops = it_route->second;
+        auto ol_nextHops = it_route->second.nhg_key;
 
-        if (it_route->second.getSize() > 1
-            && m_syncdNextHopGroups[it_route->second].ref_count == 0)
+        if (it_route->second.nhg_key.getSize() > 1
+            && m_syncdNextHopGroups[it_route->second.nhg_key].ref_count == 0)
         {
-            m_bulkNhgReducedRefCnt.emplace(it_route->second, 0);
+            m_bulkNhgReducedRefCnt.emplace(it_route->second.nhg_key, 0);
         } else if (ol_nextHops.is_overlay_nexthop()){
             SWSS_LOG_NOTICE("Remove overlay Nexthop %s", ol_nextHops.to_string().c_str());
             m_bulkNhgReducedRefCnt.emplace(ol_nextHops, vrf_id);
@@ -2028,18 +2249,19 @@ bool RouteOrch::removeRoutePost(const RouteBulkContext& ctx)
     }
 
     SWSS_LOG_INFO("Remove route %s with next hop(s) %s",
-            ipPrefix.to_string().c_str(), it_route->second.to_string().c_str());
+            ipPrefix.to_string().c_str(), it_route->second.nhg_key.to_string().c_str());
 
     if (ipPrefix.isDefaultRoute() && vrf_id == gVirtualRouterId)
     {
-        it_route_table->second[ipPrefix] = NextHopGroupKey();
+        it_route_table->second[ipPrefix] = { NextHopGroupKey(), m_resyncEpoch.current() };
 
         /* Notify about default route next hop change */
-        notifyNextHopChangeObservers(vrf_id, ipPrefix, it_route_table->second[ipPrefix], true);
+        notifyNextHopChangeObservers(vrf_id, ipPrefix, NextHopGroupKey(), true);
     }
     else
     {
         it_route_table->second.erase(ipPrefix);
+        markRouteStats(vrf_id);
 
         /* Notify about the route next hop removal */
         notifyNextHopChangeObservers(vrf_id, ipPrefix, NextHopGroupKey(), false);
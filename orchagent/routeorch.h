@@ -12,9 +12,13 @@
 #include "ipaddresses.h"
 #include "ipprefix.h"
 #include "nexthopgroupkey.h"
+#include "routetrie.h"
+#include "resyncepoch.h"
 #include "bulker.h"
 #include "fgnhgorch.h"
 #include <map>
+#include <set>
+#include <unordered_map>
 
 /* Maximum next hop group number */
 #define NHGRP_MAX_SIZE 128
@@ -23,6 +27,14 @@
 
 #define LOOPBACK_PREFIX     "Loopback"
 
+/*
+ * STATE_DB VRF_ROUTE_STATS_TABLE|<vrf name>, "default" for the default VRF
+ *     route_count, ipv4_route_count, ipv6_route_count, memory_bytes
+ * Size of the route tables, updated once per doTask() for the VRFs changed.
+ */
+#define STATE_VRF_ROUTE_STATS_TABLE_NAME    "VRF_ROUTE_STATS_TABLE"
+#define DEFAULT_VRF_ROUTE_STATS_KEY         "default"
+
 typedef std::map<NextHopKey, sai_object_id_t> NextHopGroupMembers;
 
 struct NextHopGroupEntry
@@ -43,9 +55,15 @@ struct NextHopUpdate
 struct NextHopObserverEntry;
 
 /* NextHopGroupTable: NextHopGroupKey, NextHopGroupEntry */
-typedef std::map<NextHopGroupKey, NextHopGroupEntry> NextHopGroupTable;
-/* RouteTable: destination network, NextHopGroupKey */
-typedef std::map<IpPrefix, NextHopGroupKey> RouteTable;
+typedef std::unordered_map<NextHopGroupKey, NextHopGroupEntry> NextHopGroupTable;
+struct RouteNhg
+{
+    NextHopGroupKey         nhg_key;                // next hop group key
+    resync_epoch_t          epoch;                  // resync epoch the route was last set in
+};
+
+/* RouteTable: destination network, RouteNhg */
+typedef RouteTrie<RouteNhg> RouteTable;
 /* RouteTables: vrf_id, RouteTable */
 typedef std::map<sai_object_id_t, RouteTable> RouteTables;
 /* Host: vrf_id, IpAddress */
@@ -55,7 +73,7 @@ typedef std::map<Host, NextHopObserverEntry> NextHopObserverTable;
 
 struct NextHopObserverEntry
 {
-    RouteTable routeTable;
+    RouteTrie<NextHopGroupKey> routeTable;
     list<Observer *> observers;
 };
 
@@ -89,10 +107,30 @@ struct RouteBulkContext
     }
 };
 
+/* RouteBulkContexts: (key, op), route bulk context */
+typedef std::map<std::pair<std::string, std::string>, RouteBulkContext> RouteBulkContexts;
+
+/*
+ * Routes handed to the route bulker by one batch of the consumer tasks. While its
+ * bulk calls are in flight, the next batch stops at the first route depending on it,
+ * or needing SAI calls of its own: the SAI is only called from one thread at a time.
+ */
+struct RouteBulkBatch
+{
+    RouteBulkContexts                                   toBulk;
+
+    /* Routes of the batch: vrf_id, prefix */
+    std::set<std::pair<sai_object_id_t, IpPrefix>>      routes;
+    /* Next hop groups the batch may release: next hop group, released references */
+    std::unordered_map<NextHopGroupKey, int>            releasedNhgs;
+    /* Routes the batch may remove: vrf_id, route count */
+    std::map<sai_object_id_t, size_t>                   removedRoutes;
+};
+
 class RouteOrch : public Orch, public Subject
 {
 public:
-    RouteOrch(DBConnector *db, string tableName, SwitchOrch *switchOrch, NeighOrch *neighOrch, IntfsOrch *intfsOrch, VRFOrch *vrfOrch, FgNhgOrch *fgNhgOrch);
+    RouteOrch(DBConnector *db, string tableName, TableConnector stateDbRouteStats, SwitchOrch *switchOrch, NeighOrch *neighOrch, IntfsOrch *intfsOrch, VRFOrch *vrfOrch, FgNhgOrch *fgNhgOrch);
 
     bool hasNextHopGroup(const NextHopGroupKey&) const;
     sai_object_id_t getNextHopGroupId(const NextHopGroupKey&);
@@ -130,7 +168,7 @@ private:
 
     int m_nextHopGroupCount;
     int m_maxNextHopGroupCount;
-    bool m_resync;
+    ResyncEpoch m_resyncEpoch;
 
     RouteTables m_syncdRoutes;
     NextHopGroupTable m_syncdNextHopGroups;
@@ -140,8 +178,13 @@ private:
 
     NextHopObserverTable m_nextHopObservers;
 
+    std::unique_ptr<Table> m_routeStatsTable;
+    /* Route tables changed since the last stats update: vrf_id, stats key */
+    std::map<sai_object_id_t, string> m_dirtyRouteStats;
+
     EntityBulker<sai_route_api_t>           gRouteBulker;
     ObjectBulker<sai_next_hop_group_api_t>  gNextHopGroupMemberBulker;
+    BulkPipeline<EntityBulker<sai_route_api_t>> m_routeBulkPipeline;
 
     void addTempRoute(RouteBulkContext& ctx, const NextHopGroupKey&);
     bool addRoute(RouteBulkContext& ctx, const NextHopGroupKey&);
@@ -149,6 +192,17 @@ private:
     bool addRoutePost(const RouteBulkContext& ctx, const NextHopGroupKey &nextHops);
     bool removeRoutePost(const RouteBulkContext& ctx);
 
+    void removeStaleRoutes(Consumer& consumer);
+
+    void markRouteStats(sai_object_id_t vrf_id);
+    void publishRouteStats();
+
+    void trackBulkBatch(RouteBulkBatch& batch);
+    bool dependsOnBulkBatch(const RouteBulkBatch& batch, const RouteBulkContext& ctx) const;
+    bool dependsOnBulkBatch(const RouteBulkBatch& batch, const NextHopGroupKey& nextHops) const;
+    bool needsSaiCalls(const RouteBulkContext& ctx, const NextHopGroupKey& nextHops) const;
+    void postBulkBatch(Consumer& consumer, RouteBulkBatch& batch, SyncMap::iterator end);
+
     std::string getLinkLocalEui64Addr(void);
     void        addLinkLocalRouteToMe(sai_object_id_t vrf_id, IpPrefix linklocal_prefix);
 
@@ -0,0 +1,750 @@
+#ifndef SWSS_ROUTETRIE_H
+#define SWSS_ROUTETRIE_H
+
+#include <array>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <sys/socket.h>
+
+#include "ipaddress.h"
+#include "ipprefix.h"
+
+/*
+ * Path-compressed binary trie of the prefixes of one address family, N being the
+ * address length in bytes.
+ *
+ * A node is either a route, or a branch where the paths of its two children split.
+ * Branches always have two children, so that there are fewer branches than routes.
+ * The routes are visited in prefix order: by address, the shorter prefix first.
+ */
+template <size_t N, typename T>
+class PrefixTrie
+{
+public:
+    typedef std::array<uint8_t, N> Address;
+
+    static const unsigned max_length = N * 8;
+
+    struct Node
+    {
+        Node       *child[2];
+        Address     addr;
+        uint8_t     len;
+        bool        has_value;
+    };
+
+    struct ValueNode : Node
+    {
+        T           value;
+    };
+
+    PrefixTrie() = default;
+
+    PrefixTrie(const PrefixTrie &) = delete;
+    PrefixTrie &operator=(const PrefixTrie &) = delete;
+
+    PrefixTrie(PrefixTrie &&o) noexcept :
+        m_root(o.m_root),
+        m_size(o.m_size),
+        m_bytes(o.m_bytes)
+    {
+        o.m_root = nullptr;
+        o.m_size = 0;
+        o.m_bytes = 0;
+    }
+
+    PrefixTrie &operator=(PrefixTrie &&o) noexcept
+    {
+        std::swap(m_root, o.m_root);
+        std::swap(m_size, o.m_size);
+        std::swap(m_bytes, o.m_bytes);
+        return *this;
+    }
+
+    ~PrefixTrie()
+    {
+        clear();
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /* Memory held by the nodes */
+    size_t bytes() const
+    {
+        return m_bytes;
+    }
+
+    static Address mask(Address addr, unsigned len)
+    {
+        for (size_t byte = 0; byte < N; byte++)
+        {
+            if (len >= 8 * (byte + 1))
+            {
+                continue;
+            }
+
+            unsigned keep = len > 8 * byte ? len - 8 * static_cast<unsigned>(byte) : 0;
+            addr[byte] = static_cast<uint8_t>(keep ? addr[byte] & (0xff << (8 - keep)) : 0);
+        }
+        return addr;
+    }
+
+    ValueNode *find(const Address &addr, unsigned len) const
+    {
+        Node *n = m_root;
+        while (n && n->len <= len)
+        {
+            if (commonLength(n->addr, addr, n->len) < n->len)
+            {
+                return nullptr;
+            }
+            if (n->len == len)
+            {
+                return n->has_value ? static_cast<ValueNode *>(n) : nullptr;
+            }
+            n = n->child[bit(addr, n->len)];
+        }
+        return nullptr;
+    }
+
+    /* Longest prefix of at most len bits matching the address */
+    ValueNode *longestMatch(const Address &addr, unsigned len) const
+    {
+        ValueNode *best = nullptr;
+        for (Node *n = m_root; n && n->len <= len && commonLength(n->addr, addr, n->len) == n->len;
+             n = n->len < len ? n->child[bit(addr, n->len)] : nullptr)
+        {
+            if (n->has_value)
+            {
+                best = static_cast<ValueNode *>(n);
+            }
+        }
+        return best;
+    }
+
+    /* All the prefixes matching the address, the shorter first */
+    std::vector<ValueNode *> matches(const Address &addr) const
+    {
+        std::vector<ValueNode *> found;
+        for (Node *n = m_root; n && commonLength(n->addr, addr, n->len) == n->len;
+             n = n->len < max_length ? n->child[bit(addr, n->len)] : nullptr)
+        {
+            if (n->has_value)
+            {
+                found.push_back(static_cast<ValueNode *>(n));
+            }
+        }
+        return found;
+    }
+
+    /* Returns the node of the prefix, and whether it was inserted */
+    std::pair<ValueNode *, bool> insert(const Address &addr, unsigned len)
+    {
+        Node **link = &m_root;
+        while (Node *n = *link)
+        {
+            unsigned common = commonLength(n->addr, addr, std::min<unsigned>(n->len, len));
+            if (common < n->len)
+            {
+                ValueNode *v = newValueNode(addr, len);
+                if (common == len)
+                {
+                    /* The new prefix covers the node */
+                    v->child[bit(n->addr, len)] = n;
+                    *link = v;
+                }
+                else
+                {
+                    /* The paths split at the common length */
+                    Node *b = newNode(mask(addr, common), common);
+                    b->child[bit(addr, common)] = v;
+                    b->child[bit(n->addr, common)] = n;
+                    *link = b;
+                }
+                return std::make_pair(v, true);
+            }
+
+            if (n->len == len)
+            {
+                if (n->has_value)
+                {
+                    return std::make_pair(static_cast<ValueNode *>(n), false);
+                }
+
+                /* The branch becomes a route */
+                ValueNode *v = newValueNode(addr, len);
+                v->child[0] = n->child[0];
+                v->child[1] = n->child[1];
+                deleteNode(n);
+                *link = v;
+                return std::make_pair(v, true);
+            }
+
+            link = &n->child[bit(addr, n->len)];
+        }
+
+        ValueNode *v = newValueNode(addr, len);
+        *link = v;
+        return std::make_pair(v, true);
+    }
+
+    bool erase(const Address &addr, unsigned len)
+    {
+        Node **parentLink = nullptr;
+        Node **link = &m_root;
+        while (Node *n = *link)
+        {
+            if (n->len > len || commonLength(n->addr, addr, n->len) < n->len)
+            {
+                return false;
+            }
+
+            if (n->len == len)
+            {
+                if (!n->has_value)
+                {
+                    return false;
+                }
+                eraseNode(parentLink, link);
+                return true;
+            }
+
+            parentLink = link;
+            link = &n->child[bit(addr, n->len)];
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        std::vector<Node *> pending;
+        if (m_root)
+        {
+            pending.push_back(m_root);
+        }
+
+        while (!pending.empty())
+        {
+            Node *n = pending.back();
+            pending.pop_back();
+
+            for (auto c : n->child)
+            {
+                if (c)
+                {
+                    pending.push_back(c);
+                }
+            }
+
+            if (n->has_value)
+            {
+                delete static_cast<ValueNode *>(n);
+            }
+            else
+            {
+                delete n;
+            }
+        }
+
+        m_root = nullptr;
+        m_size = 0;
+        m_bytes = 0;
+    }
+
+    /* Route visited first, nullptr if none */
+    const Node *first() const
+    {
+        return m_root ? firstValue(m_root) : nullptr;
+    }
+
+    /* Route visited after the node, nullptr if none */
+    const Node *next(const Node *n) const
+    {
+        if (n->child[0])
+        {
+            return firstValue(n->child[0]);
+        }
+        if (n->child[1])
+        {
+            return firstValue(n->child[1]);
+        }
+
+        /* Closest subtree on the right of the path to the node */
+        const Node *right = nullptr;
+        for (const Node *p = m_root; p != n;)
+        {
+            bool b = bit(n->addr, p->len);
+            if (!b && p->child[1])
+            {
+                right = p->child[1];
+            }
+            p = p->child[b];
+        }
+        return right ? firstValue(right) : nullptr;
+    }
+
+private:
+    Node       *m_root = nullptr;
+    size_t      m_size = 0;
+    size_t      m_bytes = 0;
+
+    static bool bit(const Address &addr, unsigned pos)
+    {
+        return (addr[pos / 8] >> (7 - pos % 8)) & 1;
+    }
+
+    static unsigned commonLength(const Address &a, const Address &b, unsigned len)
+    {
+        unsigned common = 0;
+        for (size_t byte = 0; byte < N && common < len; byte++)
+        {
+            unsigned diff = static_cast<unsigned>(a[byte] ^ b[byte]);
+            if (diff)
+            {
+                common += static_cast<unsigned>(__builtin_clz(diff)) - 24;
+                break;
+            }
+            common += 8;
+        }
+        return std::min(common, len);
+    }
+
+    static const Node *firstValue(const Node *n)
+    {
+        while (!n->has_value)
+        {
+            n = n->child[0];
+        }
+        return n;
+    }
+
+    Node *newNode(const Address &addr, unsigned len)
+    {
+        Node *n = new Node();
+        n->addr = addr;
+        n->len = static_cast<uint8_t>(len);
+        m_bytes += sizeof(Node);
+        return n;
+    }
+
+    ValueNode *newValueNode(const Address &addr, unsigned len)
+    {
+        ValueNode *v = new ValueNode();
+        v->addr = addr;
+        v->len = static_cast<uint8_t>(len);
+        v->has_value = true;
+        m_size++;
+        m_bytes += sizeof(ValueNode);
+        return v;
+    }
+
+    void deleteNode(Node *n)
+    {
+        m_bytes -= sizeof(Node);
+        delete n;
+    }
+
+    void deleteValueNode(Node *n)
+    {
+        m_size--;
+        m_bytes -= sizeof(ValueNode);
+        delete static_cast<ValueNode *>(n);
+    }
+
+    void eraseNode(Node **parentLink, Node **link)
+    {
+        Node *n = *link;
+        if (n->child[0] && n->child[1])
+        {
+            /* The route becomes a branch */
+            Node *b = newNode(n->addr, n->len);
+            b->child[0] = n->child[0];
+            b->child[1] = n->child[1];
+            deleteValueNode(n);
+            *link = b;
+            return;
+        }
+
+        Node *rest = n->child[0] ? n->child[0] : n->child[1];
+        deleteValueNode(n);
+        *link = rest;
+
+        /* A branch left with a single child is merged into it */
+        if (!rest && parentLink && !(*parentLink)->has_value)
+        {
+            Node *p = *parentLink;
+            *parentLink = p->child[0] ? p->child[0] : p->child[1];
+            deleteNode(p);
+        }
+    }
+};
+
+/*
+ * Routes of a VRF by prefix, in an IPv4 and an IPv6 PrefixTrie.
+ *
+ * The interface is the subset of std::map<IpPrefix, T> used on the route tables,
+ * plus the longest prefix match. Prefixes are keyed on their network address.
+ * Iterators dereference to a (prefix, value reference) pair built on the fly, and
+ * operator-> returns a proxy holding that pair; they stay valid until their route
+ * is erased.
+ */
+template <typename T>
+class RouteTrie
+{
+    typedef PrefixTrie<4, T> V4Trie;
+    typedef PrefixTrie<16, T> V6Trie;
+
+public:
+    template <typename V>
+    struct Entry
+    {
+        IpPrefix    first;
+        V          &second;
+    };
+
+    /* Returned by operator->, owns the entry the arrow is applied to */
+    template <typename V>
+    struct EntryPointer
+    {
+        Entry<V>    entry;
+
+        Entry<V> *operator->()
+        {
+            return &entry;
+        }
+    };
+
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        typedef typename std::conditional<Const, const T, T>::type mapped_type;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Entry<mapped_type> value_type;
+        typedef Entry<mapped_type> reference;
+        typedef EntryPointer<mapped_type> pointer;
+        typedef std::ptrdiff_t difference_type;
+
+        Iterator() = default;
+
+        Iterator(const RouteTrie *trie, const typename V4Trie::Node *v4, const typename V6Trie::Node *v6) :
+            m_trie(trie),
+            m_v4(v4),
+            m_v6(v6)
+        {
+        }
+
+        template <bool C, typename = typename std::enable_if<Const && !C>::type>
+        Iterator(const Iterator<C> &o) :
+            m_trie(o.m_trie),
+            m_v4(o.m_v4),
+            m_v6(o.m_v6)
+        {
+        }
+
+        reference operator*() const
+        {
+            if (m_v4)
+            {
+                auto v = static_cast<const typename V4Trie::ValueNode *>(m_v4);
+                return { toPrefix(AF_INET, v->addr.data(), v->addr.size(), v->len), const_cast<mapped_type &>(v->value) };
+            }
+
+            auto v = static_cast<const typename V6Trie::ValueNode *>(m_v6);
+            return { toPrefix(AF_INET6, v->addr.data(), v->addr.size(), v->len), const_cast<mapped_type &>(v->value) };
+        }
+
+        pointer operator->() const
+        {
+            return { **this };
+        }
+
+        Iterator &operator++()
+        {
+            if (m_v4)
+            {
+                m_v4 = m_trie->m_v4.next(m_v4);
+                if (!m_v4)
+                {
+                    m_v6 = m_trie->m_v6.first();
+                }
+            }
+            else if (m_v6)
+            {
+                m_v6 = m_trie->m_v6.next(m_v6);
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        bool operator==(const Iterator &o) const
+        {
+            return m_v4 == o.m_v4 && m_v6 == o.m_v6;
+        }
+
+        bool operator!=(const Iterator &o) const
+        {
+            return !(*this == o);
+        }
+
+    private:
+        friend class RouteTrie;
+        template <bool C> friend class Iterator;
+
+        const RouteTrie                *m_trie = nullptr;
+        const typename V4Trie::Node    *m_v4 = nullptr;
+        const typename V6Trie::Node    *m_v6 = nullptr;
+    };
+
+    typedef IpPrefix key_type;
+    typedef T mapped_type;
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    RouteTrie() = default;
+    RouteTrie(RouteTrie &&) = default;
+    RouteTrie &operator=(RouteTrie &&) = default;
+
+    RouteTrie(const RouteTrie &o)
+    {
+        for (auto it = o.begin(); it != o.end(); ++it)
+        {
+            (*this)[it->first] = it->second;
+        }
+    }
+
+    RouteTrie &operator=(const RouteTrie &o)
+    {
+        RouteTrie copy(o);
+        *this = std::move(copy);
+        return *this;
+    }
+
+    size_t size() const
+    {
+        return m_v4.size() + m_v6.size();
+    }
+
+    size_t size_v4() const
+    {
+        return m_v4.size();
+    }
+
+    size_t size_v6() const
+    {
+        return m_v6.size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /* Memory held by the routes */
+    size_t bytes() const
+    {
+        return sizeof(*this) + m_v4.bytes() + m_v6.bytes();
+    }
+
+    iterator begin()
+    {
+        auto v4 = m_v4.first();
+        return iterator(this, v4, v4 ? nullptr : m_v6.first());
+    }
+
+    const_iterator begin() const
+    {
+        return const_cast<RouteTrie *>(this)->begin();
+    }
+
+    iterator end()
+    {
+        return iterator(this, nullptr, nullptr);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, nullptr, nullptr);
+    }
+
+    iterator find(const IpPrefix &prefix)
+    {
+        const auto ip = prefix.getIp().getIp();
+        unsigned len = static_cast<unsigned>(prefix.getMaskLength());
+
+        if (prefix.isV4())
+        {
+            return iterator(this, m_v4.find(v4Address(ip, len), len), nullptr);
+        }
+        return iterator(this, nullptr, m_v6.find(v6Address(ip, len), len));
+    }
+
+    const_iterator find(const IpPrefix &prefix) const
+    {
+        return const_cast<RouteTrie *>(this)->find(prefix);
+    }
+
+    size_t count(const IpPrefix &prefix) const
+    {
+        return find(prefix) == end() ? 0 : 1;
+    }
+
+    T &at(const IpPrefix &prefix)
+    {
+        auto it = find(prefix);
+        if (it == end())
+        {
+            throw std::out_of_range("RouteTrie::at");
+        }
+        return it->second;
+    }
+
+    const T &at(const IpPrefix &prefix) const
+    {
+        return const_cast<RouteTrie *>(this)->at(prefix);
+    }
+
+    T &operator[](const IpPrefix &prefix)
+    {
+        return insert(prefix).first->second;
+    }
+
+    std::pair<iterator, bool> emplace(const IpPrefix &prefix, const T &value)
+    {
+        auto rc = insert(prefix);
+        if (rc.second)
+        {
+            rc.first->second = value;
+        }
+        return rc;
+    }
+
+    size_t erase(const IpPrefix &prefix)
+    {
+        const auto ip = prefix.getIp().getIp();
+        unsigned len = static_cast<unsigned>(prefix.getMaskLength());
+
+        if (prefix.isV4())
+        {
+            return m_v4.erase(v4Address(ip, len), len) ? 1 : 0;
+        }
+        return m_v6.erase(v6Address(ip, len), len) ? 1 : 0;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        iterator next(this, pos.m_v4, pos.m_v6);
+        ++next;
+        erase(pos->first);
+        return next;
+    }
+
+    void clear()
+    {
+        m_v4.clear();
+        m_v6.clear();
+    }
+
+    /* Longest prefix matching the address, end() if none */
+    iterator longest_match(const IpAddress &addr)
+    {
+        const auto ip = addr.getIp();
+        if (addr.isV4())
+        {
+            return iterator(this, m_v4.longestMatch(v4Address(ip, V4Trie::max_length), V4Trie::max_length), nullptr);
+        }
+        return iterator(this, nullptr, m_v6.longestMatch(v6Address(ip, V6Trie::max_length), V6Trie::max_length));
+    }
+
+    const_iterator longest_match(const IpAddress &addr) const
+    {
+        return const_cast<RouteTrie *>(this)->longest_match(addr);
+    }
+
+    /* All the prefixes matching the address, the shorter first */
+    std::vector<const_iterator> matches(const IpAddress &addr) const
+    {
+        std::vector<const_iterator> found;
+        const auto ip = addr.getIp();
+        if (addr.isV4())
+        {
+            for (auto n : m_v4.matches(v4Address(ip, V4Trie::max_length)))
+            {
+                found.emplace_back(this, n, nullptr);
+            }
+        }
+        else
+        {
+            for (auto n : m_v6.matches(v6Address(ip, V6Trie::max_length)))
+            {
+                found.emplace_back(this, nullptr, n);
+            }
+        }
+        return found;
+    }
+
+private:
+    V4Trie  m_v4;
+    V6Trie  m_v6;
+
+    std::pair<iterator, bool> insert(const IpPrefix &prefix)
+    {
+        const auto ip = prefix.getIp().getIp();
+        unsigned len = static_cast<unsigned>(prefix.getMaskLength());
+
+        if (prefix.isV4())
+        {
+            auto rc = m_v4.insert(v4Address(ip, len), len);
+            return std::make_pair(iterator(this, rc.first, nullptr), rc.second);
+        }
+
+        auto rc = m_v6.insert(v6Address(ip, len), len);
+        return std::make_pair(iterator(this, nullptr, rc.first), rc.second);
+    }
+
+    static typename V4Trie::Address v4Address(const ip_addr_t &ip, unsigned len)
+    {
+        typename V4Trie::Address addr;
+        memcpy(addr.data(), &ip.ip_addr.ipv4_addr, addr.size());
+        return V4Trie::mask(addr, len);
+    }
+
+    static typename V6Trie::Address v6Address(const ip_addr_t &ip, unsigned len)
+    {
+        typename V6Trie::Address addr;
+        memcpy(addr.data(), ip.ip_addr.ipv6_addr, addr.size());
+        return V6Trie::mask(addr, len);
+    }
+
+    static IpPrefix toPrefix(int family, const uint8_t *addr, size_t size, unsigned len)
+    {
+        ip_addr_t ip;
+        memset(&ip, 0, sizeof(ip));
+        ip.family = static_cast<decltype(ip.family)>(family);
+        if (family == AF_INET)
+        {
+            memcpy(&ip.ip_addr.ipv4_addr, addr, size);
+        }
+        else
+        {
+            memcpy(ip.ip_addr.ipv6_addr, addr, size);
+        }
+        return IpPrefix(ip, static_cast<int>(len));
+    }
+};
+
+#endif /* SWSS_ROUTETRIE_H */
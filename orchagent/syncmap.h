@@ -0,0 +1,251 @@
+#ifndef SWSS_SYNCMAP_H
+#define SWSS_SYNCMAP_H
+
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+
+#include "table.h"
+
+/*
+ * Pending tasks of a Consumer.
+ *
+ * Tasks are kept in a list in the order their keys arrived, which is the drain
+ * order, and a hash index points to the first task of each key. All the tasks
+ * of one key are adjacent: at most a DEL followed by a SET.
+ *
+ * The interface is the subset of std::multimap used on m_toSync, so that
+ * it->first is the key and it->second the KeyOpFieldsValuesTuple, and erase()
+ * returns the next task. Erased list nodes are kept on a free list and reused
+ * by later tasks.
+ *
+ * The epoch is bumped whenever a task is added or erased, so that the scheduler
+ * sees a consumer progress even when its size is unchanged, e.g. when a task
+ * was done and another one added in the same pass.
+ */
+class SyncMap
+{
+public:
+    typedef std::pair<std::string, swss::KeyOpFieldsValuesTuple> value_type;
+    typedef std::list<value_type>::iterator iterator;
+    typedef std::list<value_type>::const_iterator const_iterator;
+    typedef std::list<value_type>::reverse_iterator reverse_iterator;
+    typedef std::list<value_type>::const_reverse_iterator const_reverse_iterator;
+
+    /* Upper bound of list nodes kept for reuse */
+    static const size_t max_free_nodes = 1024;
+
+    iterator begin() { return m_tasks.begin(); }
+    iterator end() { return m_tasks.end(); }
+    const_iterator begin() const { return m_tasks.begin(); }
+    const_iterator end() const { return m_tasks.end(); }
+    reverse_iterator rbegin() { return m_tasks.rbegin(); }
+    reverse_iterator rend() { return m_tasks.rend(); }
+    const_reverse_iterator rbegin() const { return m_tasks.rbegin(); }
+    const_reverse_iterator rend() const { return m_tasks.rend(); }
+
+    size_t size() const { return m_tasks.size(); }
+    bool empty() const { return m_tasks.empty(); }
+
+    uint64_t epoch() const { return m_epoch; }
+
+    /* Returns the first task of the key */
+    iterator find(const std::string &key)
+    {
+        auto it = m_index.find(key);
+        return it == m_index.end() ? m_tasks.end() : it->second;
+    }
+
+    size_t count(const std::string &key) const
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end())
+        {
+            return 0;
+        }
+
+        size_t n = 0;
+        for (const_iterator t = it->second; t != m_tasks.end() && t->first == key; ++t)
+        {
+            n++;
+        }
+        return n;
+    }
+
+    std::pair<iterator, iterator> equal_range(const std::string &key)
+    {
+        auto first = find(key);
+        auto last = first;
+        while (last != m_tasks.end() && last->first == key)
+        {
+            ++last;
+        }
+        return std::make_pair(first, last);
+    }
+
+    /* Append a task after the tasks already pending for the key */
+    iterator emplace(const std::string &key, swss::KeyOpFieldsValuesTuple entry)
+    {
+        m_epoch++;
+
+        auto range = equal_range(key);
+        auto it = insertNode(range.second, key, std::move(entry));
+        if (range.first == m_tasks.end())
+        {
+            m_index.emplace(key, it);
+        }
+        return it;
+    }
+
+    iterator erase(iterator pos)
+    {
+        m_epoch++;
+
+        auto next = std::next(pos);
+
+        auto idx = m_index.find(pos->first);
+        if (idx != m_index.end() && idx->second == pos)
+        {
+            if (next != m_tasks.end() && next->first == pos->first)
+            {
+                idx->second = next;
+            }
+            else
+            {
+                m_index.erase(idx);
+            }
+        }
+
+        releaseNode(pos);
+        return next;
+    }
+
+    size_t erase(const std::string &key)
+    {
+        auto range = equal_range(key);
+        if (range.first == m_tasks.end())
+        {
+            return 0;
+        }
+        m_epoch++;
+        m_index.erase(range.first->first);
+
+        size_t n = 0;
+        for (auto it = range.first; it != range.second; n++)
+        {
+            auto cur = it++;
+            releaseNode(cur);
+        }
+        return n;
+    }
+
+    void clear()
+    {
+        m_epoch++;
+        m_tasks.clear();
+        m_free.clear();
+        m_index.clear();
+    }
+
+    /*
+     * Merge a new task into the pending ones:
+     * - a new key is appended to the tail;
+     * - a DEL overrides all the pending tasks of the key and moves it to the tail;
+     * - a SET is appended after a pending DEL, or is merged into the pending SET,
+     *   a field being updated is moved after the other fields.
+     * The entry is moved in, no field is copied.
+     */
+    void add(swss::KeyOpFieldsValuesTuple &&entry)
+    {
+        m_epoch++;
+
+        const std::string &key = kfvKey(entry);
+
+        auto idx = m_index.find(key);
+        if (idx == m_index.end())
+        {
+            auto it = insertNode(m_tasks.end(), key, std::move(entry));
+            m_index.emplace(it->first, it);
+            return;
+        }
+
+        auto first = idx->second;
+        if (kfvOp(entry) == DEL_COMMAND)
+        {
+            auto it = std::next(first);
+            while (it != m_tasks.end() && it->first == first->first)
+            {
+                auto cur = it++;
+                releaseNode(cur);
+            }
+
+            first->second = std::move(entry);
+            m_tasks.splice(m_tasks.end(), m_tasks, first);
+            return;
+        }
+
+        auto last = first;
+        for (; last != m_tasks.end() && last->first == first->first; ++last)
+        {
+            if (kfvOp(last->second) == SET_COMMAND)
+            {
+                break;
+            }
+        }
+
+        if (last == m_tasks.end() || last->first != first->first)
+        {
+            insertNode(last, first->first, std::move(entry));
+            return;
+        }
+
+        auto &existing = kfvFieldsValues(last->second);
+        for (auto &fv : kfvFieldsValues(entry))
+        {
+            const std::string &field = fvField(fv);
+            existing.erase(std::remove_if(existing.begin(), existing.end(),
+                    [&field](const swss::FieldValueTuple &ofv) { return fvField(ofv) == field; }),
+                    existing.end());
+            existing.push_back(std::move(fv));
+        }
+        kfvOp(last->second) = std::move(kfvOp(entry));
+    }
+
+private:
+    std::list<value_type> m_tasks;
+    std::list<value_type> m_free;
+    std::unordered_map<std::string, iterator> m_index;
+    uint64_t m_epoch = 0;
+
+    iterator insertNode(iterator pos, const std::string &key, swss::KeyOpFieldsValuesTuple &&entry)
+    {
+        if (m_free.empty())
+        {
+            return m_tasks.emplace(pos, key, std::move(entry));
+        }
+
+        auto it = m_free.begin();
+        m_tasks.splice(pos, m_free, it);
+        it->first.assign(key);
+        it->second = std::move(entry);
+        return it;
+    }
+
+    void releaseNode(iterator pos)
+    {
+        if (m_free.size() >= max_free_nodes)
+        {
+            m_tasks.erase(pos);
+            return;
+        }
+
+        kfvFieldsValues(pos->second).clear();
+        m_free.splice(m_free.begin(), m_tasks, pos);
+    }
+};
+
+#endif /* SWSS_SYNCMAP_H */
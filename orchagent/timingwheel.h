@@ -0,0 +1,151 @@
+#ifndef SWSS_TIMINGWHEEL_H
+#define SWSS_TIMINGWHEEL_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/*
+ * Hierarchical timing wheel of keys, each due on a tick of a clock which
+ * only moves forward.
+ *
+ * Level l has SLOT_COUNT slots of SLOT_COUNT^l ticks each. A key goes to
+ * the lowest level whose span covers the ticks left until it is due, and
+ * is moved down a level whenever the clock enters its slot, so that it is
+ * only touched LEVEL_COUNT times at most, whatever the number of keys.
+ * Keys due beyond the span of the top level stay in its last slot until
+ * they get closer.
+ *
+ * Keys are not removed from the wheel: a key rescheduled or no longer of
+ * interest is to be dropped by the owner once due, by comparing the tick
+ * it was due on with the one it expects.
+ */
+template <typename Key>
+class TimingWheel
+{
+public:
+    /* Tick a key is due on, and the key */
+    typedef std::pair<uint64_t, Key> Timer;
+
+    explicit TimingWheel(uint64_t tick = 0) : m_tick(tick) {}
+
+    uint64_t getTick() const { return m_tick; }
+    /* Keys scheduled, due ones not popped yet included */
+    size_t size() const { return m_count + m_due.size(); }
+    /* Keys due, not popped yet */
+    size_t backlog() const { return m_due.size(); }
+
+    /* A key due on the current tick or before is due right away */
+    void schedule(const Key &key, uint64_t tick)
+    {
+        insert(Timer(tick, key));
+    }
+
+    /* Moves the clock up to 'tick', the keys due by then are queued in the order they are due */
+    void advance(uint64_t tick)
+    {
+        while (m_tick < tick)
+        {
+            if (!m_count)
+            {
+                m_tick = tick;
+                break;
+            }
+
+            m_tick++;
+
+            for (unsigned level = LEVEL_COUNT - 1; level > 0; level--)
+            {
+                if (m_tick & ((1ULL << (SLOT_BITS * level)) - 1))
+                {
+                    continue;
+                }
+                cascade(level, (m_tick >> (SLOT_BITS * level)) & SLOT_MASK);
+            }
+
+            std::vector<Timer> &slot = m_slots[0][m_tick & SLOT_MASK];
+            m_count -= slot.size();
+            std::move(slot.begin(), slot.end(), std::back_inserter(m_due));
+            slot.clear();
+        }
+    }
+
+    /* Pops the key due first, false if none is due */
+    bool pop(Timer &timer)
+    {
+        if (m_due.empty())
+        {
+            return false;
+        }
+
+        timer = std::move(m_due.front());
+        m_due.pop_front();
+        return true;
+    }
+
+    /* Drops all the keys, the clock stays on its tick */
+    void clear()
+    {
+        for (auto &level : m_slots)
+        {
+            for (auto &slot : level)
+            {
+                std::vector<Timer>().swap(slot);
+            }
+        }
+        m_count = 0;
+        m_due.clear();
+    }
+
+private:
+    static const unsigned SLOT_BITS = 6;
+    static const uint64_t SLOT_COUNT = 1ULL << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOT_COUNT - 1;
+    static const unsigned LEVEL_COUNT = 4;
+
+    uint64_t m_tick;
+    /* Keys in the slots */
+    size_t m_count = 0;
+    std::vector<Timer> m_slots[LEVEL_COUNT][SLOT_COUNT];
+    std::deque<Timer> m_due;
+
+    void insert(Timer &&timer)
+    {
+        if (timer.first <= m_tick)
+        {
+            m_due.push_back(std::move(timer));
+            return;
+        }
+
+        uint64_t ticks = timer.first - m_tick;
+        unsigned level = 0;
+        while (level < LEVEL_COUNT - 1 && ticks >= (SLOT_COUNT << (SLOT_BITS * level)))
+        {
+            level++;
+        }
+
+        /* Beyond the span of the top level, the key waits in its last slot */
+        uint64_t span = SLOT_COUNT << (SLOT_BITS * level);
+        uint64_t tick = ticks < span ? timer.first : m_tick + span - 1;
+
+        m_slots[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK].push_back(std::move(timer));
+        m_count++;
+    }
+
+    void cascade(unsigned level, uint64_t slot)
+    {
+        std::vector<Timer> timers;
+        timers.swap(m_slots[level][slot]);
+        m_count -= timers.size();
+
+        for (auto &timer : timers)
+        {
+            insert(std::move(timer));
+        }
+    }
+};
+
+#endif /* SWSS_TIMINGWHEEL_H */
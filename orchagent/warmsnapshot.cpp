@@ -0,0 +1,455 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <random>
+
+#include "warmsnapshot.h"
+#include "orch.h"
+#include "logger.h"
+
+using namespace std;
+using namespace swss;
+
+#define WARM_SNAPSHOT_MAGIC         "SWSSORCH"
+#define WARM_SNAPSHOT_BYTE_ORDER    0x01020304
+#define WARM_SNAPSHOT_WRITE_SIZE    (1024 * 1024)
+
+namespace
+{
+
+/* FNV-1a, continued from hash */
+uint64_t checksum(uint64_t hash, const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+const uint64_t CHECKSUM_INIT = 0xcbf29ce484222325ULL;
+
+void putUint32(string &buffer, uint32_t value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void putString(string &buffer, const string &value)
+{
+    putUint32(buffer, static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+/* Bounds-checked cursor over the mapped payload */
+class Reader
+{
+public:
+    Reader(const char *data, size_t size, size_t offset = 0) :
+        m_data(data), m_size(size), m_offset(offset)
+    {
+    }
+
+    size_t offset() const { return m_offset; }
+
+    bool getUint32(uint32_t &value)
+    {
+        if (m_size - m_offset < sizeof(value))
+        {
+            return false;
+        }
+        memcpy(&value, m_data + m_offset, sizeof(value));
+        m_offset += sizeof(value);
+        return true;
+    }
+
+    bool getString(string *value)
+    {
+        uint32_t len;
+        if (!getUint32(len) || m_size - m_offset < len)
+        {
+            return false;
+        }
+        if (value)
+        {
+            value->assign(m_data + m_offset, len);
+        }
+        m_offset += len;
+        return true;
+    }
+
+    /* Reads an entry, or only skips it when kco is null */
+    bool getEntry(KeyOpFieldsValuesTuple *kco)
+    {
+        uint32_t count;
+        if (!getString(kco ? &kfvKey(*kco) : nullptr) || !getUint32(count))
+        {
+            return false;
+        }
+
+        if (kco)
+        {
+            kfvOp(*kco) = SET_COMMAND;
+            kfvFieldsValues(*kco).resize(count);
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!getString(kco ? &fvField(kfvFieldsValues(*kco)[i]) : nullptr) ||
+                !getString(kco ? &fvValue(kfvFieldsValues(*kco)[i]) : nullptr))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const char *m_data;
+    size_t m_size;
+    size_t m_offset;
+};
+
+}
+
+WarmSnapshot::WarmSnapshot(const string &path) :
+    m_path(path)
+{
+}
+
+WarmSnapshot::~WarmSnapshot()
+{
+    abort();
+    unmap();
+}
+
+uint64_t WarmSnapshot::newId()
+{
+    random_device rd;
+    uint64_t id = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    return id ^ static_cast<uint64_t>(chrono::system_clock::now().time_since_epoch().count());
+}
+
+/* The snapshot is written to a temporary file, renamed over the previous one on commit() */
+bool WarmSnapshot::begin(uint64_t id)
+{
+    SWSS_LOG_ENTER();
+
+    abort();
+
+    string tmpPath = m_path + ".tmp";
+    m_fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (m_fd < 0)
+    {
+        SWSS_LOG_ERROR("Failed to create warm snapshot %s: %s", tmpPath.c_str(), strerror(errno));
+        return false;
+    }
+
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, WARM_SNAPSHOT_MAGIC, sizeof(m_header.magic));
+    m_header.byteOrder = WARM_SNAPSHOT_BYTE_ORDER;
+    m_header.version = VERSION;
+    m_header.id = id;
+    m_header.checksum = CHECKSUM_INIT;
+
+    /* Room for the header, written last */
+    if (write(m_fd, &m_header, sizeof(m_header)) != static_cast<ssize_t>(sizeof(m_header)))
+    {
+        SWSS_LOG_ERROR("Failed to write warm snapshot %s: %s", tmpPath.c_str(), strerror(errno));
+        abort();
+        return false;
+    }
+
+    m_buffer.clear();
+    return true;
+}
+
+bool WarmSnapshot::add(const string &table, const deque<KeyOpFieldsValuesTuple> &entries)
+{
+    if (m_fd < 0)
+    {
+        return false;
+    }
+
+    addTable(table, entries.size());
+    for (const auto &entry : entries)
+    {
+        if (!addEntry(kfvKey(entry), kfvFieldsValues(entry)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool WarmSnapshot::add(const Orch &orch)
+{
+    if (m_fd < 0)
+    {
+        return false;
+    }
+
+    for (const auto &it : orch.getConsumerMap())
+    {
+        auto consumer = dynamic_cast<const Consumer *>(it.second.get());
+        if (consumer == nullptr)
+        {
+            continue;
+        }
+
+        string name = consumer->getWarmSnapshotName();
+        if (name.empty())
+        {
+            continue;
+        }
+
+        /* One table is held at a time */
+        deque<KeyOpFieldsValuesTuple> entries;
+        consumer->readConsumedTable(entries);
+        if (!add(name, entries))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void WarmSnapshot::addTable(const string &table, size_t count)
+{
+    putString(m_buffer, table);
+    putUint32(m_buffer, static_cast<uint32_t>(count));
+    m_header.tableCount++;
+}
+
+bool WarmSnapshot::addEntry(const string &key, const vector<FieldValueTuple> &values)
+{
+    putString(m_buffer, key);
+    putUint32(m_buffer, static_cast<uint32_t>(values.size()));
+
+    for (const auto &fv : values)
+    {
+        putString(m_buffer, fvField(fv));
+        putString(m_buffer, fvValue(fv));
+    }
+
+    return m_buffer.size() < WARM_SNAPSHOT_WRITE_SIZE || writeBuffer();
+}
+
+bool WarmSnapshot::commit()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_fd < 0 || !writeBuffer())
+    {
+        return false;
+    }
+
+    string tmpPath = m_path + ".tmp";
+    if (pwrite(m_fd, &m_header, sizeof(m_header), 0) != static_cast<ssize_t>(sizeof(m_header)) ||
+        fsync(m_fd) < 0 || rename(tmpPath.c_str(), m_path.c_str()) < 0)
+    {
+        SWSS_LOG_ERROR("Failed to write warm snapshot %s: %s", m_path.c_str(), strerror(errno));
+        abort();
+        return false;
+    }
+
+    close(m_fd);
+    m_fd = -1;
+
+    SWSS_LOG_NOTICE("Wrote warm snapshot %s: %u tables, %" PRIu64 " bytes",
+                    m_path.c_str(), m_header.tableCount, m_header.payloadSize);
+    return true;
+}
+
+bool WarmSnapshot::writeBuffer()
+{
+    m_header.checksum = checksum(m_header.checksum, m_buffer.data(), m_buffer.size());
+    m_header.payloadSize += m_buffer.size();
+
+    size_t written = 0;
+    while (written < m_buffer.size())
+    {
+        ssize_t ret = write(m_fd, m_buffer.data() + written, m_buffer.size() - written);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            SWSS_LOG_ERROR("Failed to write warm snapshot %s: %s", m_path.c_str(), strerror(errno));
+            abort();
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+
+    m_buffer.clear();
+    return true;
+}
+
+void WarmSnapshot::abort()
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+
+    close(m_fd);
+    m_fd = -1;
+    m_buffer.clear();
+    unlink((m_path + ".tmp").c_str());
+}
+
+bool WarmSnapshot::load(uint64_t id)
+{
+    SWSS_LOG_ENTER();
+
+    unmap();
+
+    int fd = open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        SWSS_LOG_NOTICE("No warm snapshot %s: %s", m_path.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header))
+    {
+        SWSS_LOG_WARN("Warm snapshot %s is truncated", m_path.c_str());
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        SWSS_LOG_ERROR("Failed to map warm snapshot %s: %s", m_path.c_str(), strerror(errno));
+        return false;
+    }
+
+    m_map = static_cast<const char *>(map);
+    m_mapSize = static_cast<size_t>(st.st_size);
+    m_payload = m_map + sizeof(Header);
+
+    Header header;
+    memcpy(&header, m_map, sizeof(header));
+
+    const char *error = nullptr;
+    if (memcmp(header.magic, WARM_SNAPSHOT_MAGIC, sizeof(header.magic)) ||
+        header.byteOrder != WARM_SNAPSHOT_BYTE_ORDER)
+    {
+        error = "not a warm snapshot of this platform";
+    }
+    else if (header.version != VERSION)
+    {
+        error = "incompatible version";
+    }
+    else if (header.id != id)
+    {
+        error = "not the snapshot of the last freeze";
+    }
+    else if (header.payloadSize != m_mapSize - sizeof(Header))
+    {
+        error = "truncated";
+    }
+    else if (header.checksum != checksum(CHECKSUM_INIT, m_payload, m_mapSize - sizeof(Header)))
+    {
+        error = "corrupted";
+    }
+
+    m_header = header;
+    if (error || !indexTables())
+    {
+        SWSS_LOG_WARN("Discarding warm snapshot %s: %s", m_path.c_str(), error ? error : "malformed");
+        unmap();
+        return false;
+    }
+
+    SWSS_LOG_NOTICE("Loaded warm snapshot %s: %zu tables", m_path.c_str(), m_tables.size());
+    return true;
+}
+
+/* Walks the tables, recording where the entries of each start */
+bool WarmSnapshot::indexTables()
+{
+    Reader reader(m_payload, m_mapSize - sizeof(Header));
+
+    for (uint32_t i = 0; i < m_header.tableCount; i++)
+    {
+        string name;
+        TableRef ref;
+
+        if (!reader.getString(&name) || !reader.getUint32(ref.count))
+        {
+            return false;
+        }
+
+        ref.offset = reader.offset();
+        for (uint32_t j = 0; j < ref.count; j++)
+        {
+            if (!reader.getEntry(nullptr))
+            {
+                return false;
+            }
+        }
+
+        m_tables[name] = ref;
+    }
+
+    return reader.offset() == m_mapSize - sizeof(Header);
+}
+
+/* Each table is taken once, returns false when the snapshot does not have it */
+bool WarmSnapshot::take(const string &table, deque<KeyOpFieldsValuesTuple> &entries)
+{
+    auto it = m_tables.find(table);
+    if (it == m_tables.end())
+    {
+        return false;
+    }
+
+    Reader reader(m_payload, m_mapSize - sizeof(Header), it->second.offset);
+    for (uint32_t i = 0; i < it->second.count; i++)
+    {
+        KeyOpFieldsValuesTuple kco;
+
+        /* Validated by indexTables() */
+        reader.getEntry(&kco);
+        entries.push_back(move(kco));
+    }
+
+    m_tables.erase(it);
+    return true;
+}
+
+void WarmSnapshot::unmap()
+{
+    if (m_map)
+    {
+        munmap(const_cast<char *>(m_map), m_mapSize);
+    }
+
+    m_map = nullptr;
+    m_mapSize = 0;
+    m_payload = nullptr;
+    m_tables.clear();
+}
+
+void WarmSnapshot::remove()
+{
+    unmap();
+
+    if (unlink(m_path.c_str()) < 0 && errno != ENOENT)
+    {
+        SWSS_LOG_WARN("Failed to remove warm snapshot %s: %s", m_path.c_str(), strerror(errno));
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef SWSS_WARMSNAPSHOT_H
+#define SWSS_WARMSNAPSHOT_H
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "table.h"
+
+class Orch;
+
+/*
+ * Snapshot of the tables consumed by orchagent, written to a local file when
+ * orchagent freezes for warm restart.
+ *
+ * On warm start, Consumer::refillToSync() takes the entries of its table from
+ * the snapshot instead of reading them back from redis key by key. Only the
+ * tables which solely change when orchagent pops them (ConsumerStateTable) are
+ * kept. They are read from redis once frozen, in the chunks of the warm start
+ * refill: the snapshot moves that read from the warm start to the freeze, it
+ * does not remove it.
+ *
+ * The file is a header followed by the tables, each made of its entries with
+ * their field-values, all as length-prefixed strings. It is mapped in memory
+ * and adopted only when its magic, byte order, format version, checksum and id
+ * match: the id is recorded in STATE_DB along with the snapshot, so that a
+ * snapshot left by an earlier freeze is not mistaken for the last one. Any
+ * table missing from an adopted snapshot is read from redis as before.
+ */
+class WarmSnapshot
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    WarmSnapshot(const std::string &path);
+    ~WarmSnapshot();
+
+    /* Writing: begin(), then add() for each table or orch, then commit() */
+    bool begin(uint64_t id);
+    bool add(const std::string &table, const std::deque<swss::KeyOpFieldsValuesTuple> &entries);
+    /* Add the tables of the consumers of orch kept in snapshots, read from redis */
+    bool add(const Orch &orch);
+    bool commit();
+
+    /* Reading: load() the snapshot written with the given id, then take() each table */
+    bool load(uint64_t id);
+    bool take(const std::string &table, std::deque<swss::KeyOpFieldsValuesTuple> &entries);
+
+    size_t getTableCount() const { return m_tables.size(); }
+
+    /* Remove the snapshot file, so that it is never adopted twice */
+    void remove();
+
+    static uint64_t newId();
+
+private:
+    struct Header
+    {
+        char        magic[8];
+        uint32_t    byteOrder;
+        uint32_t    version;
+        uint64_t    id;
+        uint64_t    payloadSize;
+        uint64_t    checksum;
+        uint32_t    tableCount;
+        uint32_t    reserved;
+    };
+
+    struct TableRef
+    {
+        size_t      offset;
+        uint32_t    count;
+    };
+
+    std::string m_path;
+
+    /* Writing state */
+    int         m_fd = -1;
+    std::string m_buffer;
+    Header      m_header;
+
+    /* Reading state: mapped payload and where each table starts in it */
+    const char *m_map = nullptr;
+    size_t      m_mapSize = 0;
+    const char *m_payload = nullptr;
+    std::unordered_map<std::string, TableRef> m_tables;
+
+    bool writeBuffer();
+    void addTable(const std::string &table, size_t count);
+    bool addEntry(const std::string &key, const std::vector<swss::FieldValueTuple> &values);
+    void abort();
+    void unmap();
+
+    bool indexTables();
+};
+
+#endif /* SWSS_WARMSNAPSHOT_H */
@@ -0,0 +1,217 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+#include "aclorch.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace aclorch_bench
+{
+    using namespace std;
+
+    struct AclOrchBench : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_app_db;
+        shared_ptr<swss::DBConnector> m_config_db;
+        shared_ptr<swss::DBConnector> m_state_db;
+        shared_ptr<swss::DBConnector> m_chassis_app_db;
+
+        PolicerOrch *m_policerOrch = nullptr;
+        AclOrch *m_aclOrch = nullptr;
+
+        virtual void SetUp() override
+        {
+            ::testing_db::reset();
+
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_config_db = make_shared<swss::DBConnector>("CONFIG_DB", 0);
+            m_state_db = make_shared<swss::DBConnector>("STATE_DB", 0);
+            m_chassis_app_db = make_shared<swss::DBConnector>("CHASSIS_APP_DB", 0);
+
+            map<string, string> profile = {
+                { "SAI_VS_SWITCH_TYPE", "SAI_VS_SWITCH_TYPE_BCM56850" },
+                { "KV_DEVICE_MAC_ADDRESS", "20:03:04:05:06:00" }
+            };
+
+            ut_helper::initSaiApi(profile);
+
+            sai_attribute_t attr;
+            attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+            attr.value.booldata = true;
+            ASSERT_EQ(sai_switch_api->create_switch(&gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+
+            attr.id = SAI_SWITCH_ATTR_SRC_MAC_ADDRESS;
+            ASSERT_EQ(sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+            gMacAddress = attr.value.mac;
+
+            attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+            ASSERT_EQ(sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+            gVirtualRouterId = attr.value.oid;
+
+            TableConnector stateDbSwitchTable(m_state_db.get(), "SWITCH_CAPABILITY");
+            TableConnector conf_asic_sensors(m_config_db.get(), CFG_ASIC_SENSORS_TABLE_NAME);
+            TableConnector app_switch_table(m_app_db.get(), APP_SWITCH_TABLE_NAME);
+            vector<TableConnector> switch_tables = { conf_asic_sensors, app_switch_table };
+            gSwitchOrch = new SwitchOrch(m_app_db.get(), switch_tables, stateDbSwitchTable);
+
+            const int portsorch_base_pri = 40;
+            vector<table_name_with_pri_t> ports_tables = {
+                { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+                { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+                { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+                { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+                { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+            };
+            gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+            gCrmOrch = new CrmOrch(m_config_db.get(), CFG_CRM_TABLE_NAME);
+            gVrfOrch = new VRFOrch(m_app_db.get(), APP_VRF_TABLE_NAME, m_state_db.get(), STATE_VRF_OBJECT_TABLE_NAME);
+            gIntfsOrch = new IntfsOrch(m_app_db.get(), APP_INTF_TABLE_NAME, gVrfOrch, m_chassis_app_db.get());
+
+            TableConnector stateDbFdb(m_state_db.get(), STATE_FDB_TABLE_NAME);
+            vector<table_name_with_pri_t> app_fdb_tables = {
+                { APP_FDB_TABLE_NAME, FdbOrch::fdborch_pri },
+                { APP_VXLAN_FDB_TABLE_NAME, FdbOrch::fdborch_pri }
+            };
+            gFdbOrch = new FdbOrch(m_app_db.get(), app_fdb_tables, stateDbFdb, gPortsOrch);
+
+            gNeighOrch = new NeighOrch(m_app_db.get(), APP_NEIGH_TABLE_NAME, gIntfsOrch, gFdbOrch, gPortsOrch, m_chassis_app_db.get());
+
+            const int fgnhgorch_pri = 15;
+            vector<table_name_with_pri_t> fgnhg_tables = {
+                { CFG_FG_NHG, fgnhgorch_pri },
+                { CFG_FG_NHG_PREFIX, fgnhgorch_pri },
+                { CFG_FG_NHG_MEMBER, fgnhgorch_pri }
+            };
+            gFgNhgOrch = new FgNhgOrch(m_config_db.get(), m_app_db.get(), m_state_db.get(), fgnhg_tables, gNeighOrch, gIntfsOrch, gVrfOrch);
+
+            TableConnector stateDbRouteStats(m_state_db.get(), STATE_VRF_ROUTE_STATS_TABLE_NAME);
+            gRouteOrch = new RouteOrch(m_app_db.get(), APP_ROUTE_TABLE_NAME, stateDbRouteStats, gSwitchOrch, gNeighOrch, gIntfsOrch, gVrfOrch, gFgNhgOrch);
+
+            m_policerOrch = new PolicerOrch(m_config_db.get(), "POLICER");
+
+            TableConnector stateDbMirrorSession(m_state_db.get(), STATE_MIRROR_SESSION_TABLE_NAME);
+            TableConnector confDbMirrorSession(m_config_db.get(), CFG_MIRROR_SESSION_TABLE_NAME);
+            gMirrorOrch = new MirrorOrch(stateDbMirrorSession, confDbMirrorSession,
+                                         gPortsOrch, gRouteOrch, gNeighOrch, gFdbOrch, m_policerOrch);
+
+            auto consumer = unique_ptr<Consumer>(new Consumer(
+                new swss::ConsumerStateTable(m_app_db.get(), APP_PORT_TABLE_NAME, 1, 1), gPortsOrch, APP_PORT_TABLE_NAME));
+            consumer->addToSync({ { "PortInitDone", EMPTY_PREFIX, { { "", "" } } } });
+            static_cast<Orch *>(gPortsOrch)->doTask(*consumer.get());
+
+            TableConnector confDbAclTable(m_config_db.get(), CFG_ACL_TABLE_TABLE_NAME);
+            TableConnector confDbAclRuleTable(m_config_db.get(), CFG_ACL_RULE_TABLE_NAME);
+            vector<TableConnector> acl_table_connectors = { confDbAclTable, confDbAclRuleTable };
+            m_aclOrch = new AclOrch(acl_table_connectors, gSwitchOrch, gPortsOrch, gMirrorOrch, gNeighOrch, gRouteOrch);
+        }
+
+        virtual void TearDown() override
+        {
+            delete m_aclOrch;
+            m_aclOrch = nullptr;
+            delete gMirrorOrch;
+            gMirrorOrch = nullptr;
+            delete m_policerOrch;
+            m_policerOrch = nullptr;
+            delete gRouteOrch;
+            gRouteOrch = nullptr;
+            delete gFgNhgOrch;
+            gFgNhgOrch = nullptr;
+            delete gNeighOrch;
+            gNeighOrch = nullptr;
+            delete gFdbOrch;
+            gFdbOrch = nullptr;
+            delete gIntfsOrch;
+            gIntfsOrch = nullptr;
+            delete gVrfOrch;
+            gVrfOrch = nullptr;
+            delete gCrmOrch;
+            gCrmOrch = nullptr;
+            delete gPortsOrch;
+            gPortsOrch = nullptr;
+            delete gSwitchOrch;
+            gSwitchOrch = nullptr;
+
+            sai_switch_api->remove_switch(gSwitchId);
+            gSwitchId = 0;
+            ut_helper::uninitSaiApi();
+
+            ::testing_db::reset();
+        }
+
+        void doTask(const string &tableName, const deque<KeyOpFieldsValuesTuple> &entries)
+        {
+            auto consumer = unique_ptr<Consumer>(new Consumer(
+                new swss::ConsumerStateTable(m_config_db.get(), tableName, 1, 1), m_aclOrch, tableName));
+
+            consumer->addToSync(entries);
+            static_cast<Orch *>(m_aclOrch)->doTask(*consumer);
+        }
+    };
+
+    /* Many rules across many tables: how long loading, updating and removing them takes */
+    TEST_F(AclOrchBench, RuleLoad)
+    {
+        const size_t tableCount = 50;
+        const size_t rulesPerTable = 200;
+
+        deque<KeyOpFieldsValuesTuple> kvfAclTable, kvfAclRule;
+        for (size_t t = 0; t < tableCount; t++)
+        {
+            string acl_table_id = "acl_table_" + to_string(t);
+
+            kvfAclTable.push_back({ acl_table_id,
+                                    SET_COMMAND,
+                                    { { ACL_TABLE_DESCRIPTION, "load test" },
+                                      { ACL_TABLE_TYPE, TABLE_TYPE_L3 },
+                                      { ACL_TABLE_STAGE, STAGE_INGRESS },
+                                      { ACL_TABLE_PORTS, "1,2" } } });
+
+            for (size_t r = 0; r < rulesPerTable; r++)
+            {
+                kvfAclRule.push_back({ acl_table_id + "|acl_rule_" + to_string(r),
+                                       SET_COMMAND,
+                                       { { ACTION_PACKET_ACTION, PACKET_ACTION_DROP },
+                                         { RULE_PRIORITY, to_string(r + 1) },
+                                         { MATCH_SRC_IP, "10." + to_string(t) + "." + to_string(r / 256) + "." + to_string(r % 256) } } });
+            }
+        }
+
+        doTask(CFG_ACL_TABLE_TABLE_NAME, kvfAclTable);
+
+        auto begin = chrono::steady_clock::now();
+        doTask(CFG_ACL_RULE_TABLE_NAME, kvfAclRule);
+        chrono::duration<double> load = chrono::steady_clock::now() - begin;
+
+        for (auto &kvf : kvfAclRule)
+        {
+            kfvFieldsValues(kvf)[0] = { ACTION_PACKET_ACTION, PACKET_ACTION_FORWARD };
+        }
+
+        begin = chrono::steady_clock::now();
+        doTask(CFG_ACL_RULE_TABLE_NAME, kvfAclRule);
+        chrono::duration<double> update = chrono::steady_clock::now() - begin;
+
+        for (auto &kvf : kvfAclRule)
+        {
+            kfvOp(kvf) = DEL_COMMAND;
+            kfvFieldsValues(kvf).clear();
+        }
+
+        begin = chrono::steady_clock::now();
+        doTask(CFG_ACL_RULE_TABLE_NAME, kvfAclRule);
+        chrono::duration<double> remove = chrono::steady_clock::now() - begin;
+
+        cout << kvfAclRule.size() << " ACL rules across " << tableCount << " tables: load "
+             << load.count() << " s, update " << update.count() << " s, remove " << remove.count() << " s" << endl;
+
+        for (auto &kvf : kvfAclTable)
+        {
+            kfvOp(kvf) = DEL_COMMAND;
+            kfvFieldsValues(kvf).clear();
+        }
+        doTask(CFG_ACL_TABLE_TABLE_NAME, kvfAclTable);
+    }
+}
@@ -178,6 +178,11 @@ namespace aclorch_test
         {
             return Portal::AclOrchInternal::getAclTables(m_aclOrch);
         }
+
+        void pollCounters()
+        {
+            Portal::AclOrchInternal::pollCounters(m_aclOrch);
+        }
     };
 
     struct AclOrchTest : public AclTest
@@ -353,7 +358,8 @@ namespace aclorch_test
             gFgNhgOrch = new FgNhgOrch(m_config_db.get(), m_app_db.get(), m_state_db.get(), fgnhg_tables, gNeighOrch, gIntfsOrch, gVrfOrch);
 
             ASSERT_EQ(gRouteOrch, nullptr);
-            gRouteOrch = new RouteOrch(m_app_db.get(), APP_ROUTE_TABLE_NAME, gSwitchOrch, gNeighOrch, gIntfsOrch, gVrfOrch, gFgNhgOrch);
+            TableConnector stateDbRouteStats(m_state_db.get(), STATE_VRF_ROUTE_STATS_TABLE_NAME);
+            gRouteOrch = new RouteOrch(m_app_db.get(), APP_ROUTE_TABLE_NAME, stateDbRouteStats, gSwitchOrch, gNeighOrch, gIntfsOrch, gVrfOrch, gFgNhgOrch);
 
             PolicerOrch *policer_orch = new PolicerOrch(m_config_db.get(), "POLICER");
 
@@ -1170,4 +1176,344 @@ namespace aclorch_test
         }
     }
 
+
+    // Load rules across many tables, which looks each table up by id for
+    // every rule, and remove them.
+    TEST_F(AclOrchTest, AclRuleLoad_ManyTables)
+    {
+        const size_t tableCount = 10;
+        const size_t rulesPerTable = 20;
+
+        auto orch = createAclOrch();
+
+        deque<KeyOpFieldsValuesTuple> kvfAclTable, kvfAclRule;
+        for (size_t t = 0; t < tableCount; t++)
+        {
+            string acl_table_id = "acl_table_" + to_string(t);
+
+            kvfAclTable.push_back({ acl_table_id,
+                                    SET_COMMAND,
+                                    { { ACL_TABLE_DESCRIPTION, "load test" },
+                                      { ACL_TABLE_TYPE, TABLE_TYPE_L3 },
+                                      { ACL_TABLE_STAGE, STAGE_INGRESS },
+                                      { ACL_TABLE_PORTS, "1,2" } } });
+
+            for (size_t r = 0; r < rulesPerTable; r++)
+            {
+                kvfAclRule.push_back({ acl_table_id + "|acl_rule_" + to_string(r),
+                                       SET_COMMAND,
+                                       { { ACTION_PACKET_ACTION, PACKET_ACTION_DROP },
+                                         { RULE_PRIORITY, to_string(r + 1) },
+                                         { MATCH_SRC_IP, "10." + to_string(t) + "." + to_string(r / 256) + "." + to_string(r % 256) } } });
+            }
+        }
+
+        orch->doAclTableTask(kvfAclTable);
+
+        orch->doAclRuleTask(kvfAclRule);
+
+        const auto &acl_tables = orch->getAclTables();
+        ASSERT_EQ(acl_tables.size(), tableCount);
+        for (size_t t = 0; t < tableCount; t++)
+        {
+            auto oid = orch->getTableById("acl_table_" + to_string(t));
+            ASSERT_NE(oid, SAI_NULL_OBJECT_ID);
+
+            auto it = acl_tables.find(oid);
+            ASSERT_NE(it, acl_tables.end());
+            ASSERT_EQ(it->second.rules.size(), rulesPerTable);
+        }
+
+        for (auto &kvf : kvfAclRule)
+        {
+            kfvOp(kvf) = DEL_COMMAND;
+            kfvFieldsValues(kvf).clear();
+        }
+
+        orch->doAclRuleTask(kvfAclRule);
+
+        for (const auto &it : acl_tables)
+        {
+            ASSERT_TRUE(it.second.rules.empty());
+        }
+
+        for (auto &kvf : kvfAclTable)
+        {
+            kfvOp(kvf) = DEL_COMMAND;
+            kfvFieldsValues(kvf).clear();
+        }
+        orch->doAclTableTask(kvfAclTable);
+
+        ASSERT_TRUE(orch->getAclTables().empty());
+        ASSERT_EQ(orch->getTableById("acl_table_0"), SAI_NULL_OBJECT_ID);
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+    }
+
+    // By default the counters of the rules are read by the local poller, and
+    // published under COUNTERS:<table>:<rule> until the rule is removed.
+    TEST_F(AclOrchTest, AclRuleCounter_LocalPoller)
+    {
+        string acl_table_id = "acl_table_1";
+        string acl_rule_id = "acl_rule_1";
+        string counter_key = acl_table_id + ":" + acl_rule_id;
+
+        auto orch = createAclOrch();
+
+        auto kvfAclTable = deque<KeyOpFieldsValuesTuple>(
+            { { acl_table_id,
+                SET_COMMAND,
+                { { ACL_TABLE_DESCRIPTION, "counter test" },
+                  { ACL_TABLE_TYPE, TABLE_TYPE_L3 },
+                  { ACL_TABLE_STAGE, STAGE_INGRESS },
+                  { ACL_TABLE_PORTS, "1,2" } } } });
+        orch->doAclTableTask(kvfAclTable);
+
+        auto kvfAclRule = deque<KeyOpFieldsValuesTuple>(
+            { { acl_table_id + "|" + acl_rule_id,
+                SET_COMMAND,
+                { { ACTION_PACKET_ACTION, PACKET_ACTION_DROP },
+                  { RULE_PRIORITY, "10" },
+                  { MATCH_SRC_IP, "10.0.0.1" } } } });
+        orch->doAclRuleTask(kvfAclRule);
+
+        auto oid = orch->getTableById(acl_table_id);
+        const auto &rule = orch->getAclTables().at(oid).rules.at(acl_rule_id);
+        ASSERT_NE(rule->getCounterOid(), SAI_NULL_OBJECT_ID);
+
+        DBConnector counters_db("COUNTERS_DB", 0);
+        Table counterRuleMap(&counters_db, ACL_COUNTER_RULE_MAP);
+        Table countersTable(&counters_db, "COUNTERS");
+
+        string counter_oid;
+        ASSERT_FALSE(counterRuleMap.hget("", counter_key, counter_oid));
+
+        orch->pollCounters();
+
+        vector<FieldValueTuple> values;
+        ASSERT_TRUE(countersTable.get(counter_key, values));
+        ASSERT_EQ(values.size(), 2u);
+        ASSERT_EQ(fvField(values[0]), "Packets");
+        ASSERT_EQ(fvField(values[1]), "Bytes");
+
+        kfvOp(kvfAclRule.front()) = DEL_COMMAND;
+        kfvFieldsValues(kvfAclRule.front()).clear();
+        orch->doAclRuleTask(kvfAclRule);
+        ASSERT_FALSE(countersTable.get(counter_key, values));
+        ASSERT_FALSE(counterRuleMap.hget("", counter_key, counter_oid));
+
+        kfvOp(kvfAclTable.front()) = DEL_COMMAND;
+        kfvFieldsValues(kvfAclTable.front()).clear();
+        orch->doAclTableTask(kvfAclTable);
+
+        ASSERT_TRUE(orch->getAclTables().empty());
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+    }
+
+#ifdef ACL_COUNTER_ATTR_ID_LIST
+    // With flex counters, the counter of a rule is registered to be polled by
+    // syncd along with the map of the rule to it, and the poller publishes the
+    // stats of syncd under COUNTERS:<table>:<rule>.
+    TEST_F(AclOrchTest, AclRuleCounter_FlexCounter)
+    {
+        string acl_table_id = "acl_table_1";
+        string acl_rule_id = "acl_rule_1";
+        string counter_key = acl_table_id + ":" + acl_rule_id;
+
+        gAclFlexCounters = true;
+        auto orch = createAclOrch();
+        gAclFlexCounters = false;
+
+        auto kvfAclTable = deque<KeyOpFieldsValuesTuple>(
+            { { acl_table_id,
+                SET_COMMAND,
+                { { ACL_TABLE_DESCRIPTION, "counter test" },
+                  { ACL_TABLE_TYPE, TABLE_TYPE_L3 },
+                  { ACL_TABLE_STAGE, STAGE_INGRESS },
+                  { ACL_TABLE_PORTS, "1,2" } } } });
+        orch->doAclTableTask(kvfAclTable);
+
+        auto kvfAclRule = deque<KeyOpFieldsValuesTuple>(
+            { { acl_table_id + "|" + acl_rule_id,
+                SET_COMMAND,
+                { { ACTION_PACKET_ACTION, PACKET_ACTION_DROP },
+                  { RULE_PRIORITY, "10" },
+                  { MATCH_SRC_IP, "10.0.0.1" } } } });
+        orch->doAclRuleTask(kvfAclRule);
+
+        auto oid = orch->getTableById(acl_table_id);
+        const auto &rule = orch->getAclTables().at(oid).rules.at(acl_rule_id);
+        ASSERT_NE(rule->getCounterOid(), SAI_NULL_OBJECT_ID);
+
+        DBConnector counters_db("COUNTERS_DB", 0);
+        Table counterRuleMap(&counters_db, ACL_COUNTER_RULE_MAP);
+        Table countersTable(&counters_db, "COUNTERS");
+
+        string counter_oid;
+        ASSERT_TRUE(counterRuleMap.hget("", counter_key, counter_oid));
+        ASSERT_EQ(counter_oid, sai_serialize_object_id(rule->getCounterOid()));
+
+        // Not polled by syncd yet
+        orch->pollCounters();
+
+        vector<FieldValueTuple> values;
+        ASSERT_FALSE(countersTable.get(counter_key, values));
+
+        countersTable.set(counter_oid, { { "SAI_ACL_COUNTER_ATTR_PACKETS", "10" },
+                                         { "SAI_ACL_COUNTER_ATTR_BYTES", "1000" } });
+        orch->pollCounters();
+
+        ASSERT_TRUE(countersTable.get(counter_key, values));
+        ASSERT_EQ(values, vector<FieldValueTuple>({ { "Packets", "10" }, { "Bytes", "1000" } }));
+
+        kfvOp(kvfAclRule.front()) = DEL_COMMAND;
+        kfvFieldsValues(kvfAclRule.front()).clear();
+        orch->doAclRuleTask(kvfAclRule);
+        ASSERT_FALSE(countersTable.get(counter_key, values));
+        ASSERT_FALSE(counterRuleMap.hget("", counter_key, counter_oid));
+
+        kfvOp(kvfAclTable.front()) = DEL_COMMAND;
+        kfvFieldsValues(kvfAclTable.front()).clear();
+        orch->doAclTableTask(kvfAclTable);
+
+        ASSERT_TRUE(orch->getAclTables().empty());
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+    }
+#endif
+
+    // Rules are programmed in bulk: an updated rule replaces the previous one,
+    // and a rule deleted then set again in the same batch ends up set.
+    TEST_F(AclOrchTest, AclRuleUpdate_Bulk)
+    {
+        string acl_table_id = "acl_table_1";
+
+        auto orch = createAclOrch();
+
+        auto kvfAclTable = deque<KeyOpFieldsValuesTuple>(
+            { { acl_table_id,
+                SET_COMMAND,
+                { { ACL_TABLE_DESCRIPTION, "bulk test" },
+                  { ACL_TABLE_TYPE, TABLE_TYPE_L3 },
+                  { ACL_TABLE_STAGE, STAGE_INGRESS },
+                  { ACL_TABLE_PORTS, "1,2" } } } });
+        orch->doAclTableTask(kvfAclTable);
+
+        auto oid = orch->getTableById(acl_table_id);
+        ASSERT_NE(oid, SAI_NULL_OBJECT_ID);
+
+        auto ruleTask = [&](const string &rule_id, const string &op, const string &src_ip) {
+            vector<FieldValueTuple> fvs;
+            if (op == SET_COMMAND)
+            {
+                fvs = { { ACTION_PACKET_ACTION, PACKET_ACTION_DROP },
+                        { RULE_PRIORITY, "10" },
+                        { MATCH_SRC_IP, src_ip } };
+            }
+            return KeyOpFieldsValuesTuple(acl_table_id + "|" + rule_id, op, fvs);
+        };
+
+        orch->doAclRuleTask(deque<KeyOpFieldsValuesTuple>(
+            { ruleTask("acl_rule_1", SET_COMMAND, "10.0.0.1"),
+              ruleTask("acl_rule_2", SET_COMMAND, "10.0.0.2") }));
+
+        const auto &rules = orch->getAclTables().at(oid).rules;
+        ASSERT_EQ(rules.size(), 2u);
+        auto previous = rules.at("acl_rule_1");
+
+        orch->doAclRuleTask(deque<KeyOpFieldsValuesTuple>(
+            { ruleTask("acl_rule_1", SET_COMMAND, "10.0.0.3"),
+              ruleTask("acl_rule_2", DEL_COMMAND, ""),
+              ruleTask("acl_rule_2", SET_COMMAND, "10.0.0.4") }));
+
+        ASSERT_EQ(rules.size(), 2u);
+        ASSERT_NE(rules.at("acl_rule_1"), previous);
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+
+        orch->doAclRuleTask(deque<KeyOpFieldsValuesTuple>(
+            { ruleTask("acl_rule_1", DEL_COMMAND, ""),
+              ruleTask("acl_rule_2", DEL_COMMAND, "") }));
+
+        ASSERT_TRUE(rules.empty());
+
+        kfvOp(kvfAclTable.front()) = DEL_COMMAND;
+        kfvFieldsValues(kvfAclTable.front()).clear();
+        orch->doAclTableTask(kvfAclTable);
+
+        ASSERT_TRUE(orch->getAclTables().empty());
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+    }
+
+    // A replaced rule which fails to be removed stays referenced, and its
+    // removal is retried before the task of the rule is handled again.
+    TEST_F(AclOrchTest, AclRuleUpdate_BulkRemoveFailure)
+    {
+        string acl_table_id = "acl_table_1";
+
+        auto orch = createAclOrch();
+
+        auto kvfAclTable = deque<KeyOpFieldsValuesTuple>(
+            { { acl_table_id,
+                SET_COMMAND,
+                { { ACL_TABLE_DESCRIPTION, "bulk test" },
+                  { ACL_TABLE_TYPE, TABLE_TYPE_L3 },
+                  { ACL_TABLE_STAGE, STAGE_INGRESS },
+                  { ACL_TABLE_PORTS, "1,2" } } } });
+        orch->doAclTableTask(kvfAclTable);
+
+        auto oid = orch->getTableById(acl_table_id);
+        ASSERT_NE(oid, SAI_NULL_OBJECT_ID);
+
+        auto ruleTask = [&](const string &op, const string &src_ip) {
+            vector<FieldValueTuple> fvs;
+            if (op == SET_COMMAND)
+            {
+                fvs = { { ACTION_PACKET_ACTION, PACKET_ACTION_DROP },
+                        { RULE_PRIORITY, "10" },
+                        { MATCH_SRC_IP, src_ip } };
+            }
+            return deque<KeyOpFieldsValuesTuple>({ { acl_table_id + "|acl_rule_1", op, fvs } });
+        };
+
+        orch->doAclRuleTask(ruleTask(SET_COMMAND, "10.0.0.1"));
+
+        const auto &rules = orch->getAclTables().at(oid).rules;
+        auto previous = rules.at("acl_rule_1");
+        auto counter_oid = previous->getCounterOid();
+        ASSERT_NE(counter_oid, SAI_NULL_OBJECT_ID);
+
+        // Another entry holds the counter of the rule, which can not be removed
+        vector<sai_attribute_t> attrs(3);
+        attrs[0].id = SAI_ACL_ENTRY_ATTR_TABLE_ID;
+        attrs[0].value.oid = oid;
+        attrs[1].id = SAI_ACL_ENTRY_ATTR_PRIORITY;
+        attrs[1].value.u32 = 20;
+        attrs[2].id = SAI_ACL_ENTRY_ATTR_ACTION_COUNTER;
+        attrs[2].value.aclaction.enable = true;
+        attrs[2].value.aclaction.parameter.oid = counter_oid;
+        sai_object_id_t holder_oid;
+        ASSERT_EQ(sai_acl_api->create_acl_entry(&holder_oid, gSwitchId, (uint32_t)attrs.size(), attrs.data()), SAI_STATUS_SUCCESS);
+
+        orch->doAclRuleTask(ruleTask(SET_COMMAND, "10.0.0.2"));
+
+        ASSERT_NE(rules.at("acl_rule_1"), previous);
+        ASSERT_EQ(previous->getCounterOid(), counter_oid);
+
+        // The counter is released, the retry removes it before updating the rule again
+        ASSERT_EQ(sai_acl_api->remove_acl_entry(holder_oid), SAI_STATUS_SUCCESS);
+        orch->doAclRuleTask(ruleTask(SET_COMMAND, "10.0.0.2"));
+
+        ASSERT_EQ(previous->getCounterOid(), SAI_NULL_OBJECT_ID);
+        ASSERT_EQ(rules.size(), 1u);
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+
+        orch->doAclRuleTask(ruleTask(DEL_COMMAND, ""));
+        ASSERT_TRUE(rules.empty());
+
+        kfvOp(kvfAclTable.front()) = DEL_COMMAND;
+        kfvFieldsValues(kvfAclTable.front()).clear();
+        orch->doAclTableTask(kvfAclTable);
+
+        ASSERT_TRUE(orch->getAclTables().empty());
+        ASSERT_TRUE(validateLowerLayerDb(orch.get()));
+    }
+
 } // namespace nsAclOrchTest
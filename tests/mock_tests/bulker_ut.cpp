@@ -106,4 +106,114 @@ namespace bulker_test
         ASSERT_EQ(ia->first.id, SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION);
         ASSERT_EQ(ia->first.value.s32, SAI_PACKET_ACTION_FORWARD);
     }
+
+    TEST_F(BulkerTest, NeighborBulkerFlush)
+    {
+        static uint32_t bulk_calls;
+        static uint32_t bulk_objects;
+        bulk_calls = 0;
+        bulk_objects = 0;
+
+        sai_neighbor_api_t neighbor_api = {};
+        neighbor_api.create_neighbor_entries = [](uint32_t object_count, const sai_neighbor_entry_t *,
+                                                  const uint32_t *, const sai_attribute_t **,
+                                                  sai_bulk_op_error_mode_t, sai_status_t *object_statuses) {
+            bulk_calls++;
+            bulk_objects += object_count;
+            for (uint32_t i = 0; i < object_count; i++)
+            {
+                object_statuses[i] = SAI_STATUS_SUCCESS;
+            }
+            return (sai_status_t)SAI_STATUS_SUCCESS;
+        };
+
+        // Create bulker
+        EntityBulker<sai_neighbor_api_t> gNeighBulker(&neighbor_api, 4);
+        deque<sai_status_t> object_statuses;
+
+        sai_attribute_t neighbor_attr;
+        neighbor_attr.id = SAI_NEIGHBOR_ENTRY_ATTR_DST_MAC_ADDRESS;
+        memset(neighbor_attr.value.mac, 0, sizeof(sai_mac_t));
+
+        // Create 10 neighbors, the same neighbor twice is rejected
+        for (uint32_t i = 0; i < 10; i++)
+        {
+            sai_neighbor_entry_t neighbor_entry;
+            memset(&neighbor_entry, 0, sizeof(neighbor_entry));
+            neighbor_entry.ip_address.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+            neighbor_entry.ip_address.addr.ip4 = htonl(0x0a000001 + i);
+
+            object_statuses.emplace_back();
+            ASSERT_EQ(gNeighBulker.create_entry(&object_statuses.back(), &neighbor_entry, 1, &neighbor_attr),
+                      SAI_STATUS_NOT_EXECUTED);
+
+            object_statuses.emplace_back();
+            ASSERT_EQ(gNeighBulker.create_entry(&object_statuses.back(), &neighbor_entry, 1, &neighbor_attr),
+                      SAI_STATUS_ITEM_ALREADY_EXISTS);
+            object_statuses.pop_back();
+        }
+        ASSERT_EQ(gNeighBulker.creating_entries_count(), 10);
+
+        // The neighbors are created with 3 bulk calls of at most 4 neighbors
+        gNeighBulker.flush();
+        ASSERT_EQ(bulk_calls, 3);
+        ASSERT_EQ(bulk_objects, 10);
+        ASSERT_EQ(gNeighBulker.creating_entries_count(), 0);
+        for (auto status : object_statuses)
+        {
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+        }
+    }
+
+    TEST_F(BulkerTest, FdbBulkerFallback)
+    {
+        static uint32_t create_calls;
+        static uint32_t remove_calls;
+        create_calls = 0;
+        remove_calls = 0;
+
+        // No bulk API for FDB, the entries are created one at a time
+        sai_fdb_api_t fdb_api = {};
+        fdb_api.create_fdb_entry = [](const sai_fdb_entry_t *, uint32_t, const sai_attribute_t *) {
+            create_calls++;
+            return (sai_status_t)SAI_STATUS_SUCCESS;
+        };
+        fdb_api.remove_fdb_entry = [](const sai_fdb_entry_t *fdb_entry) {
+            remove_calls++;
+            return (sai_status_t)(fdb_entry->mac_address[5] == 0 ? SAI_STATUS_ITEM_NOT_FOUND : SAI_STATUS_SUCCESS);
+        };
+
+        EntityBulker<sai_fdb_api_t> gFdbBulker(&fdb_api, 1000);
+        deque<sai_status_t> object_statuses;
+
+        sai_attribute_t fdb_attr;
+        fdb_attr.id = SAI_FDB_ENTRY_ATTR_TYPE;
+        fdb_attr.value.s32 = SAI_FDB_ENTRY_TYPE_DYNAMIC;
+
+        sai_fdb_entry_t fdb_entry;
+        memset(&fdb_entry, 0, sizeof(fdb_entry));
+        for (uint8_t i = 0; i < 5; i++)
+        {
+            fdb_entry.mac_address[5] = i;
+            object_statuses.emplace_back();
+            gFdbBulker.remove_entry(&object_statuses.back(), &fdb_entry);
+        }
+        for (uint8_t i = 5; i < 8; i++)
+        {
+            fdb_entry.mac_address[5] = i;
+            object_statuses.emplace_back();
+            gFdbBulker.create_entry(&object_statuses.back(), &fdb_entry, 1, &fdb_attr);
+        }
+
+        gFdbBulker.flush();
+        ASSERT_EQ(remove_calls, 5);
+        ASSERT_EQ(create_calls, 3);
+
+        // Each entry gets its own status
+        ASSERT_EQ(object_statuses[0], SAI_STATUS_ITEM_NOT_FOUND);
+        for (size_t i = 1; i < object_statuses.size(); i++)
+        {
+            ASSERT_EQ(object_statuses[i], SAI_STATUS_SUCCESS);
+        }
+    }
 }
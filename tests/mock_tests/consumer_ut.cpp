@@ -3,6 +3,7 @@
 #include "mock_table.h"
 
 #include <sstream>
+#include <string.h>
 
 extern PortsOrch *gPortsOrch;
 
@@ -322,4 +323,330 @@ namespace consumer_test
         validate_syncmap(consumer->m_toSync, 1, key, exp_kofv);
 
     }
+
+    TEST_F(ConsumerTest, ConsumerAddToSync_Insertion_Order)
+    {
+        // Test case, tasks are drained in the order their keys arrived
+        vector<string> keys = { "key_c", "key_a", "key_b" };
+        for (const auto &k : keys)
+        {
+            consumer->addToSync(KeyOpFieldsValuesTuple({ k, SET_COMMAND, { { f1, v1a } } }));
+        }
+
+        // SET on a pending key is merged in place and does not move it
+        consumer->addToSync(KeyOpFieldsValuesTuple({ "key_c", SET_COMMAND, { { f2, v2a } } }));
+
+        ASSERT_EQ(consumer->m_toSync.size(), keys.size());
+        auto it = consumer->m_toSync.begin();
+        for (const auto &k : keys)
+        {
+            ASSERT_EQ(it->first, k);
+            ASSERT_EQ(kfvKey(it->second), k);
+            it++;
+        }
+
+        exp_kofv = KeyOpFieldsValuesTuple(
+            { "key_c",
+                SET_COMMAND,
+                { { f1, v1a },
+                    { f2, v2a } } });
+        validate_syncmap(consumer->m_toSync, 3, "key_c", exp_kofv);
+    }
+
+    TEST_F(ConsumerTest, ConsumerAddToSync_Del_Moves_To_Tail)
+    {
+        // Test case, SET key, SET other, DEL key then SET key
+        // expect other, then DEL and SET of key adjacent at the tail
+        auto entrya = KeyOpFieldsValuesTuple(
+            { key,
+                SET_COMMAND,
+                { { f1, v1a } } });
+
+        auto entryb = KeyOpFieldsValuesTuple(
+            { "other",
+                SET_COMMAND,
+                { { f2, v2a } } });
+
+        auto entryc = KeyOpFieldsValuesTuple(
+            { key,
+                DEL_COMMAND,
+                { { } } });
+
+        auto entryd = KeyOpFieldsValuesTuple(
+            { key,
+                SET_COMMAND,
+                { { f3, v3a } } });
+
+        kofv_q.push_back(entrya);
+        kofv_q.push_back(entryb);
+        kofv_q.push_back(entryc);
+        kofv_q.push_back(entryd);
+        consumer->addToSync(kofv_q);
+
+        ASSERT_EQ(consumer->m_toSync.size(), 3);
+        ASSERT_EQ(consumer->m_toSync.count(key), 2);
+
+        auto it = consumer->m_toSync.begin();
+        ASSERT_EQ(it->second, entryb);
+        it++;
+        ASSERT_EQ(it->second, entryc);
+        it++;
+        ASSERT_EQ(it->second, entryd);
+
+        auto range = consumer->m_toSync.equal_range(key);
+        ASSERT_EQ(range.first->second, entryc);
+        ASSERT_EQ(std::distance(range.first, range.second), 2);
+    }
+
+    TEST_F(ConsumerTest, ConsumerAddToSync_Erase_Del_Keeps_Set)
+    {
+        // Test case, DEL then SET, erase the DEL as a drain would do
+        auto entrya = KeyOpFieldsValuesTuple(
+            { key,
+                DEL_COMMAND,
+                { { } } });
+
+        auto entryb = KeyOpFieldsValuesTuple(
+            { key,
+                SET_COMMAND,
+                { { f1, v1a },
+                    { f2, v2a } } });
+
+        consumer->addToSync(entrya);
+        consumer->addToSync(entryb);
+
+        auto it = consumer->m_toSync.find(key);
+        ASSERT_EQ(it->second, entrya);
+        it = consumer->m_toSync.erase(it);
+        ASSERT_EQ(it->second, entryb);
+
+        // expect the SET to be found and merged with the next SET
+        ASSERT_EQ(consumer->m_toSync.find(key), it);
+        consumer->addToSync(KeyOpFieldsValuesTuple({ key, SET_COMMAND, { { f1, v1b } } }));
+
+        exp_kofv = KeyOpFieldsValuesTuple(
+            { key,
+                SET_COMMAND,
+                { { f2, v2a },
+                    { f1, v1b } } });
+        validate_syncmap(consumer->m_toSync, 1, key, exp_kofv);
+
+        ASSERT_EQ(consumer->m_toSync.find(key), consumer->m_toSync.end());
+        ASSERT_EQ(consumer->m_toSync.count(key), 0);
+    }
+
+    TEST_F(ConsumerTest, ConsumerAddToSync_Reverse_Erase_Del)
+    {
+        // Test case, remove a pending DEL found backward from the SET, as NeighOrch does
+        auto entrya = KeyOpFieldsValuesTuple(
+            { key,
+                DEL_COMMAND,
+                { { } } });
+
+        auto entryb = KeyOpFieldsValuesTuple(
+            { key,
+                SET_COMMAND,
+                { { f1, v1a } } });
+
+        consumer->addToSync(entrya);
+        consumer->addToSync(entryb);
+        consumer->addToSync(KeyOpFieldsValuesTuple({ "other", SET_COMMAND, { { f2, v2a } } }));
+
+        auto it = consumer->m_toSync.erase(std::next(consumer->m_toSync.begin()));
+        auto rit = make_reverse_iterator(it);
+        while (rit != consumer->m_toSync.rend() && rit->first == key && kfvOp(rit->second) == DEL_COMMAND)
+        {
+            consumer->m_toSync.erase(next(rit).base());
+        }
+
+        ASSERT_EQ(consumer->m_toSync.size(), 1);
+        ASSERT_EQ(consumer->m_toSync.find(key), consumer->m_toSync.end());
+        ASSERT_EQ(consumer->m_toSync.begin()->first, "other");
+    }
+
+    TEST_F(ConsumerTest, ConsumerBatchSizer_GrowsWithBacklog)
+    {
+        ConsumerBatchSizer sizer(128);
+        ASSERT_EQ(sizer.getBatchSize(), 128);
+        ASSERT_EQ(sizer.getMinSize(), 128);
+        ASSERT_EQ(sizer.getMaxSize(), 128 * 32);
+
+        // Full batches with a backlog left double the batch size up to the max
+        size_t expected = 128;
+        for (int i = 0; i < 10; i++)
+        {
+            sizer.update(sizer.getBatchSize(), true, 10);
+            expected = min(expected * 2, (size_t)128 * 32);
+            ASSERT_EQ(sizer.getBatchSize(), expected);
+        }
+        ASSERT_EQ(sizer.getBatchSize(), sizer.getMaxSize());
+        ASSERT_EQ(sizer.getGrowCount(), 5);
+
+        // A partial batch or no backlog keeps the size
+        sizer.resetLimits();
+        sizer.update(64, false, 10);
+        ASSERT_EQ(sizer.getBatchSize(), sizer.getMaxSize());
+        sizer.update(sizer.getBatchSize() - 1, true, 10);
+        ASSERT_EQ(sizer.getBatchSize(), sizer.getMaxSize());
+        sizer.update(sizer.getBatchSize(), false, 10);
+        ASSERT_EQ(sizer.getBatchSize(), sizer.getMaxSize());
+    }
+
+    TEST_F(ConsumerTest, ConsumerBatchSizer_ShrinksOverLatencyBudget)
+    {
+        ConsumerBatchSizer sizer(128);
+        sizer.setLimits(128, 4096, 1000);
+        for (int i = 0; i < 5; i++)
+        {
+            sizer.update(sizer.getBatchSize(), true, 10);
+        }
+        ASSERT_EQ(sizer.getBatchSize(), 4096);
+        ASSERT_TRUE(sizer.fetchChanged());
+        ASSERT_FALSE(sizer.fetchChanged());
+
+        // Over the budget halves the size even with a backlog left
+        sizer.update(4096, true, 1001);
+        ASSERT_EQ(sizer.getBatchSize(), 2048);
+        ASSERT_EQ(sizer.getShrinkCount(), 1);
+        ASSERT_TRUE(sizer.fetchChanged());
+
+        // Exactly the budget is not over it
+        sizer.update(100, false, 1000);
+        ASSERT_EQ(sizer.getBatchSize(), 2048);
+        ASSERT_FALSE(sizer.fetchChanged());
+
+        // Never below the min size
+        for (int i = 0; i < 10; i++)
+        {
+            sizer.update(sizer.getBatchSize(), true, 5000);
+        }
+        ASSERT_EQ(sizer.getBatchSize(), 128);
+        ASSERT_EQ(sizer.getShrinkCount(), 5);
+        ASSERT_EQ(sizer.getLastLatency(), 5000);
+    }
+
+    TEST_F(ConsumerTest, ConsumerBatchSizer_Limits)
+    {
+        ConsumerBatchSizer sizer(128);
+        for (int i = 0; i < 3; i++)
+        {
+            sizer.update(sizer.getBatchSize(), true, 10);
+        }
+        ASSERT_EQ(sizer.getBatchSize(), 1024);
+
+        // The current size is clamped into the new limits
+        sizer.setLimits(128, 512, 50000);
+        ASSERT_EQ(sizer.getBatchSize(), 512);
+        sizer.setLimits(2048, 8192, 50000);
+        ASSERT_EQ(sizer.getBatchSize(), 2048);
+
+        // The min size is at least 1 and the max size at least the min size
+        sizer.setLimits(0, 0, 50000);
+        ASSERT_EQ(sizer.getMinSize(), 1);
+        ASSERT_EQ(sizer.getMaxSize(), 1);
+        ASSERT_EQ(sizer.getBatchSize(), 1);
+        sizer.update(1, true, 10);
+        ASSERT_EQ(sizer.getBatchSize(), 1);
+
+        sizer.resetLimits();
+        ASSERT_EQ(sizer.getMinSize(), 128);
+        ASSERT_EQ(sizer.getMaxSize(), 128 * 32);
+        ASSERT_EQ(sizer.getLatencyBudget(), 50000);
+        ASSERT_EQ(sizer.getBatchSize(), 128);
+    }
+
+    /* String reply, owned by the caller */
+    static redisReply *stringReply(const string &str)
+    {
+        auto reply = static_cast<redisReply *>(calloc(1, sizeof(redisReply)));
+        reply->type = REDIS_REPLY_STRING;
+        reply->str = strdup(str.c_str());
+        reply->len = static_cast<decltype(reply->len)>(str.size());
+        return reply;
+    }
+
+    static redisReply *arrayReply(const vector<redisReply *> &elements)
+    {
+        auto reply = static_cast<redisReply *>(calloc(1, sizeof(redisReply)));
+        reply->type = REDIS_REPLY_ARRAY;
+        reply->elements = elements.size();
+        reply->element = static_cast<redisReply **>(calloc(elements.size() + 1, sizeof(redisReply *)));
+        copy(elements.begin(), elements.end(), reply->element);
+        return reply;
+    }
+
+    TEST_F(ConsumerTest, TableBulkReader_ParseReplies)
+    {
+        unique_ptr<redisReply, void (*)(void *)> hash(arrayReply({
+            stringReply("nexthop"), stringReply("10.1.0.1,10.1.0.2"),
+            stringReply("ifname"), stringReply("Ethernet0,Ethernet4") }),
+            freeReplyObject);
+
+        vector<FieldValueTuple> values;
+        TableBulkReader::parseHashReply(hash.get(), values);
+        ASSERT_EQ(values, vector<FieldValueTuple>({ { "nexthop", "10.1.0.1,10.1.0.2" }, { "ifname", "Ethernet0,Ethernet4" } }));
+
+        /* Odd number of elements */
+        unique_ptr<redisReply, void (*)(void *)> bad(arrayReply({ stringReply("nexthop") }), freeReplyObject);
+        ASSERT_THROW(TableBulkReader::parseHashReply(bad.get(), values), runtime_error);
+
+        /* Not an array */
+        unique_ptr<redisReply, void (*)(void *)> str(stringReply("nexthop"), freeReplyObject);
+        ASSERT_THROW(TableBulkReader::parseHashReply(str.get(), values), runtime_error);
+    }
+
+    TEST_F(ConsumerTest, ConsumerRefillToSync_Pipelined)
+    {
+        // 7 keys in chunks of 3, the HGETALL are answered by the mocked pipeline
+        Consumer::setRefillChunkSize(3);
+
+        Table table(m_config_db.get(), "CFG_TEST_TABLE");
+        map<string, vector<FieldValueTuple>> expected;
+        for (int i = 0; i < 7; i++)
+        {
+            string k = "key" + to_string(i);
+            expected[k] = { { f1, v1a + to_string(i) }, { f2, v2a } };
+            table.set(k, expected[k]);
+        }
+
+        // Not read with the table
+        Table other(m_config_db.get(), "CFG_TEST_TABLE_OTHER");
+        other.set("key0", { { f3, v3a } });
+
+        ASSERT_EQ(consumer->refillToSync(), 7);
+        ASSERT_EQ(consumer->m_toSync.size(), 7);
+        for (const auto &it : consumer->m_toSync)
+        {
+            ASSERT_EQ(kfvOp(it.second), SET_COMMAND);
+            ASSERT_EQ(kfvFieldsValues(it.second), expected[it.first]);
+        }
+
+        TableBulkReader reader(m_config_db.get(), &table, 3);
+        deque<KeyOpFieldsValuesTuple> entries;
+        size_t chunks = 0;
+        while (reader.next(entries))
+        {
+            chunks++;
+        }
+        ASSERT_EQ(chunks, 3);
+        ASSERT_EQ(entries.size(), 7);
+        ASSERT_FALSE(reader.next(entries));
+
+        Consumer::setRefillChunkSize(1024);
+    }
+
+    TEST_F(ConsumerTest, ConsumerRefillToSync_OneKeyAtATime)
+    {
+        Consumer::setRefillChunkSize(0);
+
+        Table table(m_config_db.get(), "CFG_TEST_TABLE");
+        table.set("key1", { { f1, v1a } });
+        table.set("key2", { { f2, v2a } });
+
+        ASSERT_EQ(consumer->refillToSync(), 2);
+        ASSERT_EQ(consumer->m_toSync.size(), 2);
+        ASSERT_EQ(kfvFieldsValues(consumer->m_toSync.find("key2")->second), vector<FieldValueTuple>({ { f2, v2a } }));
+
+        Consumer::setRefillChunkSize(1024);
+    }
 }
@@ -0,0 +1,231 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace fdborch_bench
+{
+    using namespace std;
+
+    /* Counts the FDB changes FdbOrch notifies */
+    struct FdbChangeCounter : public Observer
+    {
+        size_t changes = 0;
+
+        void update(SubjectType type, void *cntx) override
+        {
+            if (type == SUBJECT_TYPE_FDB_CHANGE)
+            {
+                changes++;
+            }
+        }
+    };
+
+    struct FdbOrchBench : public ::testing::Test
+    {
+        const size_t memberCount = 8;
+
+        shared_ptr<swss::DBConnector> m_app_db;
+        shared_ptr<swss::DBConnector> m_config_db;
+        shared_ptr<swss::DBConnector> m_state_db;
+        shared_ptr<swss::DBConnector> m_chassis_app_db;
+
+        vector<Port> m_members;
+        Port m_vlan;
+
+        virtual void SetUp() override
+        {
+            ::testing_db::reset();
+
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_config_db = make_shared<swss::DBConnector>("CONFIG_DB", 0);
+            m_state_db = make_shared<swss::DBConnector>("STATE_DB", 0);
+            m_chassis_app_db = make_shared<swss::DBConnector>("CHASSIS_APP_DB", 0);
+
+            map<string, string> profile = {
+                { "SAI_VS_SWITCH_TYPE", "SAI_VS_SWITCH_TYPE_BCM56850" },
+                { "KV_DEVICE_MAC_ADDRESS", "20:03:04:05:06:00" }
+            };
+
+            ut_helper::initSaiApi(profile);
+
+            sai_attribute_t attr;
+            attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+            attr.value.booldata = true;
+            ASSERT_EQ(sai_switch_api->create_switch(&gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+
+            attr.id = SAI_SWITCH_ATTR_SRC_MAC_ADDRESS;
+            ASSERT_EQ(sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+            gMacAddress = attr.value.mac;
+
+            attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+            ASSERT_EQ(sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+            gVirtualRouterId = attr.value.oid;
+
+            const int portsorch_base_pri = 40;
+            vector<table_name_with_pri_t> ports_tables = {
+                { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+                { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+                { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+                { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+                { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+            };
+            gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+            gCrmOrch = new CrmOrch(m_config_db.get(), CFG_CRM_TABLE_NAME);
+
+            TableConnector stateDbFdb(m_state_db.get(), STATE_FDB_TABLE_NAME);
+            vector<table_name_with_pri_t> app_fdb_tables = {
+                { APP_FDB_TABLE_NAME, FdbOrch::fdborch_pri },
+                { APP_VXLAN_FDB_TABLE_NAME, FdbOrch::fdborch_pri }
+            };
+            gFdbOrch = new FdbOrch(m_app_db.get(), app_fdb_tables, stateDbFdb, gPortsOrch);
+
+            Table portTable = Table(m_app_db.get(), APP_PORT_TABLE_NAME);
+            Table vlanTable = Table(m_app_db.get(), APP_VLAN_TABLE_NAME);
+            Table vlanMemberTable = Table(m_app_db.get(), APP_VLAN_MEMBER_TABLE_NAME);
+
+            auto ports = ut_helper::getInitialSaiPorts();
+            for (const auto &it : ports)
+            {
+                portTable.set(it.first, it.second);
+            }
+            portTable.set("PortConfigDone", { { "count", to_string(ports.size()) } });
+            portTable.set("PortInitDone", { { } });
+
+            vlanTable.set("Vlan2", { { "admin_status", "up" }, { "mtu", "9100" } });
+
+            vector<string> aliases;
+            for (const auto &it : ports)
+            {
+                if (aliases.size() == memberCount)
+                {
+                    break;
+                }
+                aliases.push_back(it.first);
+                vlanMemberTable.set(
+                    std::string("Vlan2") + vlanMemberTable.getTableNameSeparator() + it.first,
+                    { { "tagging_mode", "untagged" } });
+            }
+
+            gPortsOrch->addExistingData(&portTable);
+            gPortsOrch->addExistingData(&vlanTable);
+            gPortsOrch->addExistingData(&vlanMemberTable);
+            static_cast<Orch *>(gPortsOrch)->doTask();
+
+            ASSERT_TRUE(gPortsOrch->getPort("Vlan2", m_vlan));
+            for (const auto &alias : aliases)
+            {
+                Port port;
+                ASSERT_TRUE(gPortsOrch->getPort(alias, port));
+                m_members.push_back(port);
+            }
+        }
+
+        virtual void TearDown() override
+        {
+            delete gFdbOrch;
+            gFdbOrch = nullptr;
+            delete gCrmOrch;
+            gCrmOrch = nullptr;
+            delete gPortsOrch;
+            gPortsOrch = nullptr;
+
+            sai_switch_api->remove_switch(gSwitchId);
+            gSwitchId = 0;
+            ut_helper::uninitSaiApi();
+
+            ::testing_db::reset();
+        }
+
+        MacAddress macOf(size_t i)
+        {
+            uint8_t mac[ETHER_ADDR_LEN] = { 0x00, 0x11, 0x22, 0x00,
+                                           static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i) };
+            return MacAddress(mac);
+        }
+
+        /* An fdb_event notification of one event, as syncd sends it */
+        KeyOpFieldsValuesTuple fdbEvent(sai_fdb_event_t type, size_t mac, const Port &port)
+        {
+            sai_attribute_t attrs[2];
+            attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+            attrs[0].value.s32 = SAI_FDB_ENTRY_TYPE_DYNAMIC;
+            attrs[1].id = SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID;
+            attrs[1].value.oid = port.m_bridge_port_id;
+
+            sai_fdb_event_notification_data_t data;
+            data.event_type = type;
+            data.fdb_entry.switch_id = gSwitchId;
+            memcpy(data.fdb_entry.mac_address, macOf(mac).getMac(), sizeof(sai_mac_t));
+            data.fdb_entry.bv_id = m_vlan.m_vlan_info.vlan_oid;
+            data.attr_count = 2;
+            data.attr = attrs;
+
+            return KeyOpFieldsValuesTuple(sai_serialize_fdb_event_ntf(1, &data), "fdb_event", vector<FieldValueTuple>());
+        }
+
+        /* Hands the notifications to FdbOrch in batches of batchSize, returns the time taken */
+        double replay(const deque<KeyOpFieldsValuesTuple> &events, size_t batchSize)
+        {
+            auto begin = chrono::steady_clock::now();
+            for (size_t i = 0; i < events.size(); i += batchSize)
+            {
+                deque<KeyOpFieldsValuesTuple> batch(events.begin() + static_cast<ptrdiff_t>(i),
+                                                    events.begin() + static_cast<ptrdiff_t>(min(i + batchSize, events.size())));
+                Portal::FdbOrchInternal::doFdbEvents(gFdbOrch, batch);
+            }
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+            return elapsed.count();
+        }
+    };
+
+    /*
+     * A MAC move storm of 100k FDB events: MACs learnt, moved around the VLAN
+     * members and aged, one notification at a time then in batches
+     */
+    TEST_F(FdbOrchBench, FdbEventStorm)
+    {
+        const size_t macCount = 1000;
+        const size_t moves = 98;
+        const size_t batchSize = 2048;
+
+        deque<KeyOpFieldsValuesTuple> learnAndMove, age;
+        for (size_t m = 0; m < macCount; m++)
+        {
+            learnAndMove.push_back(fdbEvent(SAI_FDB_EVENT_LEARNED, m, m_members[0]));
+        }
+        for (size_t n = 1; n <= moves; n++)
+        {
+            for (size_t m = 0; m < macCount; m++)
+            {
+                learnAndMove.push_back(fdbEvent(SAI_FDB_EVENT_MOVE, m, m_members[(m + n) % m_members.size()]));
+            }
+        }
+        for (size_t m = 0; m < macCount; m++)
+        {
+            age.push_back(fdbEvent(SAI_FDB_EVENT_AGED, m, m_members[(m + moves) % m_members.size()]));
+        }
+
+        FdbChangeCounter counter;
+        gFdbOrch->attach(&counter);
+
+        for (size_t size : { size_t(1), batchSize })
+        {
+            counter.changes = 0;
+
+            double seconds = replay(learnAndMove, size);
+            ASSERT_EQ(Portal::FdbOrchInternal::getEntries(gFdbOrch).size(), macCount);
+
+            seconds += replay(age, size);
+            ASSERT_TRUE(Portal::FdbOrchInternal::getEntries(gFdbOrch).empty());
+
+            cout << learnAndMove.size() + age.size() << " FDB events in batches of " << size << ": "
+                 << seconds << " s, " << counter.changes << " FDB changes notified" << endl;
+        }
+
+        gFdbOrch->detach(&counter);
+    }
+}
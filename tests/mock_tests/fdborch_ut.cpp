@@ -0,0 +1,444 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+
+#include <tuple>
+
+namespace fdborch_test
+{
+    using namespace std;
+
+    struct FdbOrchTest : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_app_db;
+        shared_ptr<swss::DBConnector> m_config_db;
+        shared_ptr<swss::DBConnector> m_state_db;
+        shared_ptr<swss::DBConnector> m_chassis_app_db;
+
+        vector<Port> m_members;
+        Port m_vlan;
+
+        FdbOrchTest()
+        {
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_config_db = make_shared<swss::DBConnector>("CONFIG_DB", 0);
+            m_state_db = make_shared<swss::DBConnector>("STATE_DB", 0);
+            m_chassis_app_db = make_shared<swss::DBConnector>("CHASSIS_APP_DB", 0);
+        }
+
+        void SetUp() override
+        {
+            const size_t memberCount = 8;
+
+            ::testing_db::reset();
+
+            map<string, string> profile = {
+                { "SAI_VS_SWITCH_TYPE", "SAI_VS_SWITCH_TYPE_BCM56850" },
+                { "KV_DEVICE_MAC_ADDRESS", "20:03:04:05:06:00" }
+            };
+
+            auto status = ut_helper::initSaiApi(profile);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+
+            sai_attribute_t attr;
+
+            attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+            attr.value.booldata = true;
+
+            status = sai_switch_api->create_switch(&gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+
+            attr.id = SAI_SWITCH_ATTR_SRC_MAC_ADDRESS;
+            status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gMacAddress = attr.value.mac;
+
+            attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+            status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gVirtualRouterId = attr.value.oid;
+
+            const int portsorch_base_pri = 40;
+
+            vector<table_name_with_pri_t> ports_tables = {
+                { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+                { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+                { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+                { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+                { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+            };
+
+            ASSERT_EQ(gPortsOrch, nullptr);
+            gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+            ASSERT_EQ(gCrmOrch, nullptr);
+            gCrmOrch = new CrmOrch(m_config_db.get(), CFG_CRM_TABLE_NAME);
+
+            TableConnector stateDbFdb(m_state_db.get(), STATE_FDB_TABLE_NAME);
+
+            vector<table_name_with_pri_t> app_fdb_tables = {
+                { APP_FDB_TABLE_NAME,        FdbOrch::fdborch_pri},
+                { APP_VXLAN_FDB_TABLE_NAME,  FdbOrch::fdborch_pri}
+            };
+
+            ASSERT_EQ(gFdbOrch, nullptr);
+            gFdbOrch = new FdbOrch(m_app_db.get(), app_fdb_tables, stateDbFdb, gPortsOrch);
+
+            // Ports, and a VLAN with some of them as members
+
+            Table portTable = Table(m_app_db.get(), APP_PORT_TABLE_NAME);
+            Table vlanTable = Table(m_app_db.get(), APP_VLAN_TABLE_NAME);
+            Table vlanMemberTable = Table(m_app_db.get(), APP_VLAN_MEMBER_TABLE_NAME);
+
+            auto ports = ut_helper::getInitialSaiPorts();
+            for (const auto &it : ports)
+            {
+                portTable.set(it.first, it.second);
+            }
+            portTable.set("PortConfigDone", { { "count", to_string(ports.size()) } });
+            portTable.set("PortInitDone", { { } });
+
+            vlanTable.set("Vlan2", { { "admin_status", "up" }, { "mtu", "9100" } });
+
+            vector<string> aliases;
+            for (const auto &it : ports)
+            {
+                if (aliases.size() == memberCount)
+                {
+                    break;
+                }
+                aliases.push_back(it.first);
+                vlanMemberTable.set(
+                    std::string("Vlan2") + vlanMemberTable.getTableNameSeparator() + it.first,
+                    { { "tagging_mode", "untagged" } });
+            }
+
+            gPortsOrch->addExistingData(&portTable);
+            gPortsOrch->addExistingData(&vlanTable);
+            gPortsOrch->addExistingData(&vlanMemberTable);
+            static_cast<Orch *>(gPortsOrch)->doTask();
+
+            ASSERT_TRUE(gPortsOrch->getPort("Vlan2", m_vlan));
+            for (const auto &alias : aliases)
+            {
+                Port port;
+                ASSERT_TRUE(gPortsOrch->getPort(alias, port));
+                ASSERT_NE(port.m_bridge_port_id, SAI_NULL_OBJECT_ID);
+                m_members.push_back(port);
+            }
+        }
+
+        void TearDown() override
+        {
+            delete gFdbOrch;
+            gFdbOrch = nullptr;
+            delete gCrmOrch;
+            gCrmOrch = nullptr;
+            delete gPortsOrch;
+            gPortsOrch = nullptr;
+
+            auto status = sai_switch_api->remove_switch(gSwitchId);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gSwitchId = 0;
+
+            ut_helper::uninitSaiApi();
+
+            ::testing_db::reset();
+        }
+
+        MacAddress macOf(size_t i)
+        {
+            uint8_t mac[ETHER_ADDR_LEN] = { 0x00, 0x11, 0x22, 0x00,
+                                           static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i) };
+            return MacAddress(mac);
+        }
+
+        /* An fdb_event notification of one event, as syncd sends it */
+        KeyOpFieldsValuesTuple fdbEvent(sai_fdb_event_t type, size_t mac, const Port &port)
+        {
+            sai_attribute_t attrs[2];
+            attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+            attrs[0].value.s32 = SAI_FDB_ENTRY_TYPE_DYNAMIC;
+            attrs[1].id = SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID;
+            attrs[1].value.oid = port.m_bridge_port_id;
+
+            sai_fdb_event_notification_data_t data;
+            data.event_type = type;
+            data.fdb_entry.switch_id = gSwitchId;
+            memcpy(data.fdb_entry.mac_address, macOf(mac).getMac(), sizeof(sai_mac_t));
+            data.fdb_entry.bv_id = m_vlan.m_vlan_info.vlan_oid;
+            data.attr_count = 2;
+            data.attr = attrs;
+
+            return KeyOpFieldsValuesTuple(sai_serialize_fdb_event_ntf(1, &data), "fdb_event", vector<FieldValueTuple>());
+        }
+
+        Consumer *fdbConsumer()
+        {
+            return dynamic_cast<Consumer *>(gFdbOrch->getExecutor(APP_FDB_TABLE_NAME));
+        }
+
+        void addStaticFdb(Consumer *consumer, size_t mac, const Port &port)
+        {
+            consumer->addToSync({ m_vlan.m_alias + ":" + macOf(mac).to_string(), SET_COMMAND,
+                                  { { "port", port.m_alias }, { "type", "static" } } });
+        }
+
+        void removeStaticFdb(Consumer *consumer, size_t mac)
+        {
+            consumer->addToSync({ m_vlan.m_alias + ":" + macOf(mac).to_string(), DEL_COMMAND, { } });
+        }
+
+        uint32_t fdbCount(const string &alias)
+        {
+            Port port;
+            gPortsOrch->getPort(alias, port);
+            return port.m_fdb_count;
+        }
+
+        /* Hands the notifications to FdbOrch in batches of batchSize */
+        void replay(const deque<KeyOpFieldsValuesTuple> &events, size_t batchSize)
+        {
+            for (size_t i = 0; i < events.size(); i += batchSize)
+            {
+                deque<KeyOpFieldsValuesTuple> batch(events.begin() + static_cast<ptrdiff_t>(i),
+                                                    events.begin() + static_cast<ptrdiff_t>(min(i + batchSize, events.size())));
+                Portal::FdbOrchInternal::doFdbEvents(gFdbOrch, batch);
+            }
+        }
+
+        /* FDB entries of FdbOrch and of the STATE_DB FDB_TABLE */
+        struct FdbSnapshot
+        {
+            map<FdbEntry, tuple<sai_object_id_t, string, int, string, string, unsigned int>> entries;
+            map<string, vector<FieldValueTuple>> state;
+        };
+
+        FdbSnapshot snapshot()
+        {
+            FdbSnapshot snap;
+
+            for (const auto &it : Portal::FdbOrchInternal::getEntries(gFdbOrch))
+            {
+                const FdbData &data = it.second;
+                snap.entries[it.first] = make_tuple(data.bridge_port_id, data.type, static_cast<int>(data.origin),
+                                                    data.remote_ip, data.esi, data.vni);
+            }
+
+            Table stateFdbTable(m_state_db.get(), STATE_FDB_TABLE_NAME);
+            vector<string> keys;
+            stateFdbTable.getKeys(keys);
+            for (const auto &key : keys)
+            {
+                stateFdbTable.get(key, snap.state[key]);
+            }
+
+            return snap;
+        }
+    };
+
+    /*
+     * Replays a MAC move storm: MACs learnt, moved around the VLAN members and
+     * aged. They are handled one notification at a time, as they were before,
+     * then in batches, and both must leave the same FDB in FdbOrch and in
+     * STATE_DB after every phase.
+     */
+    TEST_F(FdbOrchTest, FdbEventStorm)
+    {
+        const size_t macCount = 200;
+        const size_t moves = 10;
+        const size_t batchSize = 97;
+
+        deque<KeyOpFieldsValuesTuple> learnAndMove, age;
+        for (size_t m = 0; m < macCount; m++)
+        {
+            learnAndMove.push_back(fdbEvent(SAI_FDB_EVENT_LEARNED, m, m_members[0]));
+        }
+        for (size_t n = 1; n <= moves; n++)
+        {
+            for (size_t m = 0; m < macCount; m++)
+            {
+                learnAndMove.push_back(fdbEvent(SAI_FDB_EVENT_MOVE, m, m_members[(m + n) % m_members.size()]));
+            }
+        }
+        /* Half of the MACs age */
+        for (size_t m = 0; m < macCount; m += 2)
+        {
+            age.push_back(fdbEvent(SAI_FDB_EVENT_AGED, m, m_members[(m + moves) % m_members.size()]));
+        }
+
+        replay(learnAndMove, 1);
+        auto learnt = snapshot();
+        ASSERT_EQ(learnt.entries.size(), macCount);
+        ASSERT_EQ(learnt.state.size(), macCount);
+
+        string key = "Vlan" + to_string(m_vlan.m_vlan_info.vlan_id) + ":" + macOf(7).to_string();
+        ASSERT_EQ(learnt.state[key], vector<FieldValueTuple>({ { "port", m_members[(7 + moves) % m_members.size()].m_alias },
+                                                               { "type", "dynamic" } }));
+
+        replay(age, 1);
+        auto aged = snapshot();
+        ASSERT_EQ(aged.entries.size(), macCount / 2);
+        ASSERT_EQ(aged.state.size(), macCount / 2);
+
+        /* Flush the rest, to replay the storm in batches from an empty FDB */
+        deque<KeyOpFieldsValuesTuple> flush;
+        for (size_t m = 1; m < macCount; m += 2)
+        {
+            flush.push_back(fdbEvent(SAI_FDB_EVENT_AGED, m, m_members[(m + moves) % m_members.size()]));
+        }
+        replay(flush, 1);
+        ASSERT_TRUE(snapshot().entries.empty());
+        ASSERT_TRUE(snapshot().state.empty());
+
+        replay(learnAndMove, batchSize);
+        auto batchLearnt = snapshot();
+        ASSERT_TRUE(batchLearnt.entries == learnt.entries);
+        ASSERT_EQ(batchLearnt.state, learnt.state);
+
+        replay(age, batchSize);
+        auto batchAged = snapshot();
+        ASSERT_TRUE(batchAged.entries == aged.entries);
+        ASSERT_EQ(batchAged.state, aged.state);
+    }
+
+    TEST_F(FdbOrchTest, BulkStaticFdbEntries)
+    {
+        const size_t macCount = 64;
+
+        auto consumer = fdbConsumer();
+        ASSERT_NE(consumer, nullptr);
+
+        Table stateFdbTable(m_state_db.get(), STATE_FDB_TABLE_NAME);
+        auto crmUsed = [] {
+            return Portal::CrmOrchInternal::getResUsedCounter(gCrmOrch, CrmResourceType::CRM_FDB_ENTRY);
+        };
+        uint32_t crmBase = crmUsed();
+
+        for (size_t m = 0; m < macCount; m++)
+        {
+            addStaticFdb(consumer, m, m_members[m % m_members.size()]);
+        }
+        static_cast<Orch *>(gFdbOrch)->doTask(*consumer);
+
+        EXPECT_TRUE(consumer->m_toSync.empty());
+
+        const auto &entries = Portal::FdbOrchInternal::getEntries(gFdbOrch);
+        ASSERT_EQ(entries.size(), macCount);
+        for (size_t m = 0; m < macCount; m++)
+        {
+            const auto &port = m_members[m % m_members.size()];
+            FdbEntry entry;
+            entry.mac = macOf(m);
+            entry.bv_id = m_vlan.m_vlan_info.vlan_oid;
+
+            auto it = entries.find(entry);
+            ASSERT_NE(it, entries.end());
+            EXPECT_EQ(it->second.bridge_port_id, port.m_bridge_port_id);
+            EXPECT_EQ(it->second.type, "static");
+
+            string key = "Vlan" + to_string(m_vlan.m_vlan_info.vlan_id) + ":" + macOf(m).to_string();
+            string value;
+            ASSERT_TRUE(stateFdbTable.hget(key, "port", value));
+            EXPECT_EQ(value, port.m_alias);
+            ASSERT_TRUE(stateFdbTable.hget(key, "type", value));
+            EXPECT_EQ(value, "static");
+        }
+
+        EXPECT_EQ(crmUsed(), crmBase + macCount);
+        for (const auto &port : m_members)
+        {
+            EXPECT_EQ(fdbCount(port.m_alias), macCount / m_members.size());
+        }
+        EXPECT_EQ(fdbCount(m_vlan.m_alias), macCount);
+
+        for (size_t m = 0; m < macCount; m++)
+        {
+            removeStaticFdb(consumer, m);
+        }
+        static_cast<Orch *>(gFdbOrch)->doTask(*consumer);
+
+        EXPECT_TRUE(consumer->m_toSync.empty());
+        EXPECT_TRUE(entries.empty());
+
+        vector<string> keys;
+        stateFdbTable.getKeys(keys);
+        EXPECT_TRUE(keys.empty());
+
+        EXPECT_EQ(crmUsed(), crmBase);
+        for (const auto &port : m_members)
+        {
+            EXPECT_EQ(fdbCount(port.m_alias), 0u);
+        }
+        EXPECT_EQ(fdbCount(m_vlan.m_alias), 0u);
+    }
+
+    TEST_F(FdbOrchTest, BulkRemoveThenAddFdbEntry)
+    {
+        auto consumer = fdbConsumer();
+        ASSERT_NE(consumer, nullptr);
+
+        addStaticFdb(consumer, 0, m_members[0]);
+        addStaticFdb(consumer, 1, m_members[0]);
+        static_cast<Orch *>(gFdbOrch)->doTask(*consumer);
+
+        uint32_t crmUsed = Portal::CrmOrchInternal::getResUsedCounter(gCrmOrch, CrmResourceType::CRM_FDB_ENTRY);
+
+        /* The entry removed and added back on another port in the same batch is removed first */
+        removeStaticFdb(consumer, 0);
+        addStaticFdb(consumer, 0, m_members[1]);
+        ASSERT_EQ(consumer->m_toSync.size(), 2u);
+        static_cast<Orch *>(gFdbOrch)->doTask(*consumer);
+
+        EXPECT_TRUE(consumer->m_toSync.empty());
+
+        const auto &entries = Portal::FdbOrchInternal::getEntries(gFdbOrch);
+        ASSERT_EQ(entries.size(), 2u);
+
+        FdbEntry entry;
+        entry.mac = macOf(0);
+        entry.bv_id = m_vlan.m_vlan_info.vlan_oid;
+        ASSERT_NE(entries.find(entry), entries.end());
+        EXPECT_EQ(entries.at(entry).bridge_port_id, m_members[1].m_bridge_port_id);
+
+        Table stateFdbTable(m_state_db.get(), STATE_FDB_TABLE_NAME);
+        string port;
+        ASSERT_TRUE(stateFdbTable.hget("Vlan" + to_string(m_vlan.m_vlan_info.vlan_id) + ":" + macOf(0).to_string(), "port", port));
+        EXPECT_EQ(port, m_members[1].m_alias);
+
+        EXPECT_EQ(Portal::CrmOrchInternal::getResUsedCounter(gCrmOrch, CrmResourceType::CRM_FDB_ENTRY), crmUsed);
+        EXPECT_EQ(fdbCount(m_members[0].m_alias), 1u);
+        EXPECT_EQ(fdbCount(m_members[1].m_alias), 1u);
+        EXPECT_EQ(fdbCount(m_vlan.m_alias), 2u);
+    }
+
+    TEST_F(FdbOrchTest, BulkFdbEntryOnPortOutsideVlanSaved)
+    {
+        auto consumer = fdbConsumer();
+        ASSERT_NE(consumer, nullptr);
+
+        /* Ports not in the VLAN have no bridge port: the entry is saved until they join */
+        Port outsider;
+        for (const auto &it : ut_helper::getInitialSaiPorts())
+        {
+            ASSERT_TRUE(gPortsOrch->getPort(it.first, outsider));
+            if (outsider.m_bridge_port_id == SAI_NULL_OBJECT_ID)
+            {
+                break;
+            }
+        }
+        ASSERT_EQ(outsider.m_bridge_port_id, SAI_NULL_OBJECT_ID);
+
+        addStaticFdb(consumer, 0, outsider);
+        addStaticFdb(consumer, 1, m_members[0]);
+        static_cast<Orch *>(gFdbOrch)->doTask(*consumer);
+
+        EXPECT_TRUE(consumer->m_toSync.empty());
+
+        const auto &entries = Portal::FdbOrchInternal::getEntries(gFdbOrch);
+        ASSERT_EQ(entries.size(), 1u);
+        EXPECT_EQ(entries.begin()->first.mac, macOf(1));
+        EXPECT_EQ(fdbCount(outsider.m_alias), 0u);
+        EXPECT_EQ(fdbCount(m_members[0].m_alias), 1u);
+    }
+}
@@ -5,8 +5,15 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <map>
+
 #include "dbconnector.h"
 
+namespace testing_db
+{
+    extern std::map<const redisContext *, int> gContextDbs;
+}
+
 namespace swss
 {
     DBConnector::DBConnector(int dbId, const std::string &hostname, int port, unsigned int timeout) :
@@ -18,6 +25,7 @@ namespace swss
         conn->tcp.port = port;
         conn->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
         setContext(conn);
+        testing_db::gContextDbs[conn] = m_dbId;
     }
 
     DBConnector::DBConnector(int dbId, const std::string &unixPath, unsigned int timeout) :
@@ -28,6 +36,7 @@ namespace swss
         conn->unix_sock.path = strdup(unixPath.c_str());
         conn->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
         setContext(conn);
+        testing_db::gContextDbs[conn] = m_dbId;
     }
 
     DBConnector::DBConnector(const std::string& dbName, unsigned int timeout, bool isTcpConn)
@@ -44,6 +53,7 @@ namespace swss
             conn->tcp.port = swss::SonicDBConfig::getDbPort(dbName);
             conn->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
             setContext(conn);
+        testing_db::gContextDbs[conn] = m_dbId;
         }
         else
         {
@@ -52,6 +62,7 @@ namespace swss
             conn->unix_sock.path = strdup(swss::SonicDBConfig::getDbSock(dbName).c_str());
             conn->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
             setContext(conn);
+        testing_db::gContextDbs[conn] = m_dbId;
         }
     }
 
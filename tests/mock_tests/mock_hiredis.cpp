@@ -1,8 +1,81 @@
 #include <stdlib.h>
+#include <string.h>
 #include <hiredis/hiredis.h>
 
+#include <deque>
+#include <map>
+#include <string>
+
+#include "table.h"
+
+using TableDataT = std::map<std::string, std::vector<swss::FieldValueTuple>>;
+using TablesT = std::map<std::string, TableDataT>;
+
+namespace testing_db
+{
+    extern std::map<int, TablesT> gDB;
+
+    /* Database of each mocked connection, see mock_dbconnector.cpp */
+    std::map<const redisContext *, int> gContextDbs;
+
+    /* Keys of the HGETALL pipelined on each connection, answered from gDB */
+    static std::map<const redisContext *, std::deque<std::string>> gPipelined;
+
+    static redisReply *stringReply(const std::string &str)
+    {
+        auto reply = (redisReply *)calloc(1, sizeof(redisReply));
+        reply->type = REDIS_REPLY_STRING;
+        reply->str = strdup(str.c_str());
+        reply->len = str.size();
+        return reply;
+    }
+
+    static redisReply *hashReply(const redisContext *c, const std::string &key)
+    {
+        auto reply = (redisReply *)calloc(1, sizeof(redisReply));
+        reply->type = REDIS_REPLY_ARRAY;
+
+        for (auto &table : gDB[gContextDbs[c]])
+        {
+            const std::string &name = table.first;
+            if (key.size() <= name.size() || key.compare(0, name.size(), name) ||
+                (key[name.size()] != ':' && key[name.size()] != '|'))
+            {
+                continue;
+            }
+
+            auto it = table.second.find(key.substr(name.size() + 1));
+            if (it == table.second.end())
+            {
+                continue;
+            }
+
+            reply->elements = it->second.size() * 2;
+            reply->element = (redisReply **)calloc(reply->elements + 1, sizeof(redisReply *));
+            for (size_t i = 0; i < it->second.size(); i++)
+            {
+                reply->element[2 * i] = stringReply(fvField(it->second[i]));
+                reply->element[2 * i + 1] = stringReply(fvValue(it->second[i]));
+            }
+            break;
+        }
+
+        return reply;
+    }
+}
+
+using namespace testing_db;
+
 int redisGetReply(redisContext *c, void **reply)
 {
+    auto &pipelined = gPipelined[c];
+    if (!pipelined.empty())
+    {
+        *reply = hashReply(c, pipelined.front());
+        pipelined.pop_front();
+        return 0;
+    }
+
     *reply = calloc(sizeof(redisReply), 1);
     ((redisReply *)*reply)->type = 3;
     return 0;
@@ -15,10 +88,20 @@ int redisAppendFormattedCommand(redisContext *c, const char *cmd, size_t len)
 
 int redisvAppendCommand(redisContext *c, const char *format, va_list ap)
 {
+    if (!strcmp(format, "HGETALL %b"))
+    {
+        const char *key = va_arg(ap, const char *);
+        size_t len = va_arg(ap, size_t);
+        gPipelined[c].emplace_back(key, len);
+    }
     return 0;
 }
 
 int redisAppendCommand(redisContext *c, const char *format, ...)
 {
-    return 0;
-}
\ No newline at end of file
+    va_list ap;
+    va_start(ap, format);
+    int ret = redisvAppendCommand(c, format, ap);
+    va_end(ap);
+    return ret;
+}
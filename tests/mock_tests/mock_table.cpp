@@ -62,6 +62,12 @@ namespace swss
         table[key] = values;
     }
 
+    void Table::del(const std::string &key, const std::string &op, const std::string &prefix)
+    {
+        auto &table = gDB[m_pipe->getDbId()][getTableName()];
+        table.erase(key);
+    }
+
     void Table::getKeys(std::vector<std::string> &keys)
     {
         keys.clear();
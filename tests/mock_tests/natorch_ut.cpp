@@ -0,0 +1,95 @@
+#include "ut_helper.h"
+#include "portal.h"
+
+namespace natorch_test
+{
+    using namespace std;
+
+    typedef TimingWheel<uint32_t> Wheel;
+
+    struct AgingResult
+    {
+        uint64_t maxLag = 0;     // Ticks the flow queried the most late was due before
+        size_t agedOut = 0;
+        size_t agedOutLate = 0;  // Aged out after the tick they expired on
+    };
+
+    /*
+     * Flows aged the way NatOrch::queryHitBits() ages the entries of a table,
+     * all added on the same tick. One flow in 'idleEvery' never hits and is
+     * removed once aged out, the others hit on every query.
+     */
+    static AgingResult age(uint32_t flowCount, int timeout, uint32_t idleEvery, uint64_t tickCount, bool scaledBudget)
+    {
+        const time_t period = NAT_HITBIT_N_CNTRS_QUERY_PERIOD;
+        const uint64_t start = 1000;
+
+        Wheel wheel(start);
+        vector<time_t> activeTime(flowCount, static_cast<time_t>(start) * period);
+        uint64_t spread = 0;
+        for (uint32_t i = 0; i < flowCount; i++)
+        {
+            wheel.schedule(i, Portal::NatOrchInternal::getHitBitQueryTick(activeTime[i], timeout, activeTime[i], &spread));
+        }
+
+        AgingResult result;
+        size_t entries = flowCount;
+        for (uint64_t tick = start + 1; tick <= start + tickCount; tick++)
+        {
+            time_t now = static_cast<time_t>(tick) * period;
+            uint32_t budget = scaledBudget ? Portal::NatOrchInternal::getHitBitQueryBudget(entries) : NAT_HITBIT_QUERIES_PER_TICK;
+            uint32_t queried = 0;
+            Wheel::Timer timer;
+
+            wheel.advance(tick);
+            while ((queried < budget) && wheel.pop(timer))
+            {
+                uint32_t i = timer.second;
+                queried++;
+                result.maxLag = max(result.maxLag, tick - timer.first);
+
+                if (i % idleEvery)
+                {
+                    activeTime[i] = now;
+                }
+                else if (now - activeTime[i] >= timeout)
+                {
+                    result.agedOut++;
+                    result.agedOutLate += now - activeTime[i] >= timeout + period;
+                    entries--;
+                    continue;
+                }
+
+                wheel.schedule(i, Portal::NatOrchInternal::getHitBitQueryTick(activeTime[i], timeout, now, nullptr));
+            }
+        }
+
+        return result;
+    }
+
+    TEST(NatOrchTest, HitBitQueryBudget)
+    {
+        ASSERT_EQ(Portal::NatOrchInternal::getHitBitQueryBudget(0), static_cast<uint32_t>(NAT_HITBIT_QUERIES_PER_TICK));
+        ASSERT_EQ(Portal::NatOrchInternal::getHitBitQueryBudget(6000), static_cast<uint32_t>(NAT_HITBIT_QUERIES_PER_TICK));
+        ASSERT_EQ(Portal::NatOrchInternal::getHitBitQueryBudget(100000), 33334u);
+    }
+
+    TEST(NatOrchTest, AgingKeepsUpWith100kFlows)
+    {
+        /* UDP NAPT flows on the default 300 secs timeout, queried every 7 ticks, over 4 timeouts */
+        const uint32_t flowCount = 100000;
+        const int timeout = 300;
+        const uint32_t idleEvery = 10;
+        const uint64_t tickCount = 4 * timeout / NAT_HITBIT_N_CNTRS_QUERY_PERIOD;
+
+        AgingResult result = age(flowCount, timeout, idleEvery, tickCount, true);
+        ASSERT_EQ(result.maxLag, 0u);
+        ASSERT_EQ(result.agedOut, flowCount / idleEvery);
+        ASSERT_EQ(result.agedOutLate, 0u);
+
+        /* The fixed budget falls behind the ~14k flows due every tick */
+        result = age(flowCount, timeout, idleEvery, tickCount, false);
+        ASSERT_GT(result.maxLag, 0u);
+        ASSERT_GT(result.agedOutLate, 0u);
+    }
+}
@@ -0,0 +1,620 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+#include "muxorch.h"
+
+#include <algorithm>
+#include <set>
+
+extern Directory<Orch*> gDirectory;
+
+namespace neighorch_test
+{
+    using namespace std;
+
+    /*
+     * Neighbor and next hop APIs of syncd: the bulk calls are applied one entry
+     * at a time to the virtual switch. The order of the operations is kept for
+     * the checks, and the neighbors listed in existing are reported as already
+     * in the ASIC.
+     */
+    struct NeighborApiStub
+    {
+        static sai_neighbor_api_t *vsNeighborApi;
+        static sai_neighbor_api_t neighborApi;
+        static sai_next_hop_api_t *vsNextHopApi;
+        static sai_next_hop_api_t nextHopApi;
+
+        static set<string> existing;
+        static map<sai_object_id_t, string> nextHops;
+        static vector<pair<string, string>> ops;
+        static size_t bulkCalls;
+
+        static void install()
+        {
+            vsNeighborApi = sai_neighbor_api;
+            neighborApi = *vsNeighborApi;
+            neighborApi.create_neighbor_entries = createNeighborEntries;
+            neighborApi.remove_neighbor_entries = removeNeighborEntries;
+            neighborApi.set_neighbor_entries_attribute = setNeighborEntriesAttribute;
+            sai_neighbor_api = &neighborApi;
+
+            vsNextHopApi = sai_next_hop_api;
+            nextHopApi = *vsNextHopApi;
+            nextHopApi.create_next_hops = createNextHops;
+            nextHopApi.remove_next_hops = removeNextHops;
+            sai_next_hop_api = &nextHopApi;
+
+            existing.clear();
+            nextHops.clear();
+            ops.clear();
+            bulkCalls = 0;
+        }
+
+        static void uninstall()
+        {
+            sai_neighbor_api = vsNeighborApi;
+            vsNeighborApi = nullptr;
+            sai_next_hop_api = vsNextHopApi;
+            vsNextHopApi = nullptr;
+        }
+
+        static size_t opIndex(const string &op, const string &ip)
+        {
+            return static_cast<size_t>(find(ops.begin(), ops.end(), make_pair(op, ip)) - ops.begin());
+        }
+
+        static sai_status_t bulkStatus(uint32_t count, const sai_status_t *statuses)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (statuses[i] != SAI_STATUS_SUCCESS)
+                {
+                    return SAI_STATUS_FAILURE;
+                }
+            }
+            return SAI_STATUS_SUCCESS;
+        }
+
+        static sai_status_t createNeighborEntries(uint32_t count, const sai_neighbor_entry_t *entries,
+                                                  const uint32_t *attr_count, const sai_attribute_t **attr_list,
+                                                  sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                string ip = sai_serialize_ip_address(entries[i].ip_address);
+                if (existing.count(ip))
+                {
+                    statuses[i] = SAI_STATUS_ITEM_ALREADY_EXISTS;
+                    continue;
+                }
+
+                statuses[i] = vsNeighborApi->create_neighbor_entry(&entries[i], attr_count[i], attr_list[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    ops.emplace_back("create_neighbor", ip);
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t removeNeighborEntries(uint32_t count, const sai_neighbor_entry_t *entries,
+                                                  sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsNeighborApi->remove_neighbor_entry(&entries[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    ops.emplace_back("remove_neighbor", sai_serialize_ip_address(entries[i].ip_address));
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t setNeighborEntriesAttribute(uint32_t count, const sai_neighbor_entry_t *entries,
+                                                        const sai_attribute_t *attr_list,
+                                                        sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsNeighborApi->set_neighbor_entry_attribute(&entries[i], &attr_list[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    ops.emplace_back("set_neighbor", sai_serialize_ip_address(entries[i].ip_address));
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t createNextHops(sai_object_id_t switch_id, uint32_t count,
+                                           const uint32_t *attr_count, const sai_attribute_t **attr_list,
+                                           sai_bulk_op_error_mode_t mode, sai_object_id_t *object_id,
+                                           sai_status_t *statuses)
+        {
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsNextHopApi->create_next_hop(&object_id[i], switch_id, attr_count[i], attr_list[i]);
+                if (statuses[i] != SAI_STATUS_SUCCESS)
+                {
+                    continue;
+                }
+
+                for (uint32_t j = 0; j < attr_count[i]; j++)
+                {
+                    if (attr_list[i][j].id == SAI_NEXT_HOP_ATTR_IP)
+                    {
+                        nextHops[object_id[i]] = sai_serialize_ip_address(attr_list[i][j].value.ipaddr);
+                    }
+                }
+                ops.emplace_back("create_next_hop", nextHops[object_id[i]]);
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t removeNextHops(uint32_t count, const sai_object_id_t *object_id,
+                                           sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsNextHopApi->remove_next_hop(object_id[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    ops.emplace_back("remove_next_hop", nextHops[object_id[i]]);
+                    nextHops.erase(object_id[i]);
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+    };
+
+    sai_neighbor_api_t *NeighborApiStub::vsNeighborApi = nullptr;
+    sai_neighbor_api_t NeighborApiStub::neighborApi;
+    sai_next_hop_api_t *NeighborApiStub::vsNextHopApi = nullptr;
+    sai_next_hop_api_t NeighborApiStub::nextHopApi;
+    set<string> NeighborApiStub::existing;
+    map<sai_object_id_t, string> NeighborApiStub::nextHops;
+    vector<pair<string, string>> NeighborApiStub::ops;
+    size_t NeighborApiStub::bulkCalls = 0;
+
+    struct NeighOrchTest : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_app_db;
+        shared_ptr<swss::DBConnector> m_config_db;
+        shared_ptr<swss::DBConnector> m_state_db;
+        shared_ptr<swss::DBConnector> m_chassis_app_db;
+
+        Consumer *m_consumer = nullptr;
+
+        NeighOrchTest()
+        {
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_config_db = make_shared<swss::DBConnector>("CONFIG_DB", 0);
+            m_state_db = make_shared<swss::DBConnector>("STATE_DB", 0);
+            m_chassis_app_db = make_shared<swss::DBConnector>("CHASSIS_APP_DB", 0);
+        }
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+
+            map<string, string> profile = {
+                { "SAI_VS_SWITCH_TYPE", "SAI_VS_SWITCH_TYPE_BCM56850" },
+                { "KV_DEVICE_MAC_ADDRESS", "20:03:04:05:06:00" }
+            };
+
+            auto status = ut_helper::initSaiApi(profile);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+
+            sai_attribute_t attr;
+
+            attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+            attr.value.booldata = true;
+
+            status = sai_switch_api->create_switch(&gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+
+            attr.id = SAI_SWITCH_ATTR_SRC_MAC_ADDRESS;
+            status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gMacAddress = attr.value.mac;
+
+            attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+            status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gVirtualRouterId = attr.value.oid;
+
+            /* The neighbor and next hop bulkers are set up from the APIs at the neighbor orch creation */
+            NeighborApiStub::install();
+
+            const int portsorch_base_pri = 40;
+
+            vector<table_name_with_pri_t> ports_tables = {
+                { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+                { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+                { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+                { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+                { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+            };
+
+            ASSERT_EQ(gPortsOrch, nullptr);
+            gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+            ASSERT_EQ(gCrmOrch, nullptr);
+            gCrmOrch = new CrmOrch(m_config_db.get(), CFG_CRM_TABLE_NAME);
+
+            ASSERT_EQ(gVrfOrch, nullptr);
+            gVrfOrch = new VRFOrch(m_app_db.get(), APP_VRF_TABLE_NAME, m_state_db.get(), STATE_VRF_OBJECT_TABLE_NAME);
+
+            ASSERT_EQ(gIntfsOrch, nullptr);
+            gIntfsOrch = new IntfsOrch(m_app_db.get(), APP_INTF_TABLE_NAME, gVrfOrch, m_chassis_app_db.get());
+
+            TableConnector stateDbFdb(m_state_db.get(), STATE_FDB_TABLE_NAME);
+
+            vector<table_name_with_pri_t> app_fdb_tables = {
+                { APP_FDB_TABLE_NAME,        FdbOrch::fdborch_pri},
+                { APP_VXLAN_FDB_TABLE_NAME,  FdbOrch::fdborch_pri}
+            };
+
+            ASSERT_EQ(gFdbOrch, nullptr);
+            gFdbOrch = new FdbOrch(m_app_db.get(), app_fdb_tables, stateDbFdb, gPortsOrch);
+
+            ASSERT_EQ(gNeighOrch, nullptr);
+            gNeighOrch = new NeighOrch(m_app_db.get(), APP_NEIGH_TABLE_NAME, gIntfsOrch, gFdbOrch, gPortsOrch, m_chassis_app_db.get());
+
+            const int fgnhgorch_pri = 15;
+
+            vector<table_name_with_pri_t> fgnhg_tables = {
+                { CFG_FG_NHG,                 fgnhgorch_pri },
+                { CFG_FG_NHG_PREFIX,          fgnhgorch_pri },
+                { CFG_FG_NHG_MEMBER,          fgnhgorch_pri }
+            };
+
+            ASSERT_EQ(gFgNhgOrch, nullptr);
+            gFgNhgOrch = new FgNhgOrch(m_config_db.get(), m_app_db.get(), m_state_db.get(), fgnhg_tables, gNeighOrch, gIntfsOrch, gVrfOrch);
+
+            /*
+             * NeighOrch asks MuxOrch whether a neighbor is active. The directory
+             * cannot drop an orch, so one MuxOrch without any mux cable is kept
+             * for the whole run.
+             */
+            if (gDirectory.get<MuxOrch *>() == nullptr)
+            {
+                static swss::DBConnector muxConfigDb("CONFIG_DB", 0);
+                gDirectory.set(new MuxOrch(&muxConfigDb, { CFG_MUX_CABLE_TABLE_NAME, CFG_PEER_SWITCH_TABLE_NAME },
+                                           nullptr, gNeighOrch, gFdbOrch));
+            }
+
+            Table portTable = Table(m_app_db.get(), APP_PORT_TABLE_NAME);
+
+            auto ports = ut_helper::getInitialSaiPorts();
+            for (const auto &it : ports)
+            {
+                portTable.set(it.first, it.second);
+            }
+            portTable.set("PortConfigDone", { { "count", to_string(ports.size()) } });
+            portTable.set("PortInitDone", { { } });
+
+            gPortsOrch->addExistingData(&portTable);
+            static_cast<Orch *>(gPortsOrch)->doTask();
+
+            /* Router interface on Ethernet0 only */
+            ASSERT_TRUE(gIntfsOrch->setIntf("Ethernet0"));
+
+            m_consumer = dynamic_cast<Consumer *>(gNeighOrch->getExecutor(APP_NEIGH_TABLE_NAME));
+            ASSERT_NE(m_consumer, nullptr);
+        }
+
+        void TearDown() override
+        {
+            delete gFgNhgOrch;
+            gFgNhgOrch = nullptr;
+            delete gNeighOrch;
+            gNeighOrch = nullptr;
+            delete gFdbOrch;
+            gFdbOrch = nullptr;
+            delete gIntfsOrch;
+            gIntfsOrch = nullptr;
+            delete gVrfOrch;
+            gVrfOrch = nullptr;
+            delete gCrmOrch;
+            gCrmOrch = nullptr;
+            delete gPortsOrch;
+            gPortsOrch = nullptr;
+
+            NeighborApiStub::uninstall();
+
+            auto status = sai_switch_api->remove_switch(gSwitchId);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gSwitchId = 0;
+
+            ut_helper::uninitSaiApi();
+
+            ::testing_db::reset();
+        }
+
+        static string ipOf(size_t i)
+        {
+            return "10.0." + to_string((i >> 8) & 0xff) + "." + to_string((i & 0xff) + 1);
+        }
+
+        static string macOf(size_t i)
+        {
+            char mac[18];
+            snprintf(mac, sizeof(mac), "00:00:0a:00:%02zx:%02zx", (i >> 8) & 0xff, i & 0xff);
+            return mac;
+        }
+
+        void addNeighbor(const string &alias, size_t i, const string &mac)
+        {
+            m_consumer->addToSync({ alias + ":" + ipOf(i), SET_COMMAND, { { "neigh", mac }, { "family", "IPv4" } } });
+        }
+
+        void removeNeighbor(const string &alias, size_t i)
+        {
+            m_consumer->addToSync({ alias + ":" + ipOf(i), DEL_COMMAND, { } });
+        }
+
+        void doTask()
+        {
+            static_cast<Orch *>(gNeighOrch)->doTask(*m_consumer);
+        }
+
+        static bool hasNeighbor(size_t i, MacAddress &mac)
+        {
+            NeighborEntry entry;
+            return gNeighOrch->getNeighborEntry(IpAddress(ipOf(i)), entry, mac);
+        }
+
+        static NextHopKey nextHopOf(const string &alias, size_t i)
+        {
+            return NextHopKey(IpAddress(ipOf(i)), alias);
+        }
+
+        static int rifRefCount(const string &alias)
+        {
+            return gIntfsOrch->getSyncdIntfses().at(alias).ref_count;
+        }
+
+        static uint32_t crmUsed(CrmResourceType resource)
+        {
+            return Portal::CrmOrchInternal::getResUsedCounter(gCrmOrch, resource);
+        }
+    };
+
+    TEST_F(NeighOrchTest, BulkAddRemove)
+    {
+        const size_t count = 64;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            addNeighbor("Ethernet0", i, macOf(i));
+        }
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+
+        /* One bulk call for the neighbors, then one for their next hops */
+        EXPECT_EQ(NeighborApiStub::bulkCalls, 2u);
+        for (size_t i = 0; i < count; i++)
+        {
+            MacAddress mac;
+            ASSERT_TRUE(hasNeighbor(i, mac));
+            EXPECT_EQ(mac, MacAddress(macOf(i)));
+
+            auto nexthop = nextHopOf("Ethernet0", i);
+            ASSERT_TRUE(gNeighOrch->hasNextHop(nexthop));
+            EXPECT_EQ(NeighborApiStub::nextHops.at(gNeighOrch->getNextHopId(nexthop)), ipOf(i));
+            EXPECT_LT(NeighborApiStub::opIndex("create_neighbor", ipOf(i)),
+                      NeighborApiStub::opIndex("create_next_hop", ipOf(i)));
+        }
+
+        /* Each neighbor and each next hop hold the router interface */
+        EXPECT_EQ(rifRefCount("Ethernet0"), static_cast<int>(2 * count));
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), count);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), count);
+
+        NeighborApiStub::bulkCalls = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            removeNeighbor("Ethernet0", i);
+        }
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+
+        /* The next hops are removed in one bulk call, then their neighbors in another */
+        EXPECT_EQ(NeighborApiStub::bulkCalls, 2u);
+        for (size_t i = 0; i < count; i++)
+        {
+            MacAddress mac;
+            EXPECT_FALSE(hasNeighbor(i, mac));
+            EXPECT_FALSE(gNeighOrch->hasNextHop(nextHopOf("Ethernet0", i)));
+            EXPECT_LT(NeighborApiStub::opIndex("remove_next_hop", ipOf(i)),
+                      NeighborApiStub::opIndex("remove_neighbor", ipOf(i)));
+        }
+
+        EXPECT_TRUE(NeighborApiStub::nextHops.empty());
+        EXPECT_EQ(rifRefCount("Ethernet0"), 0);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 0u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 0u);
+    }
+
+    TEST_F(NeighOrchTest, BulkUpdateMac)
+    {
+        addNeighbor("Ethernet0", 0, macOf(0));
+        addNeighbor("Ethernet0", 1, macOf(1));
+        doTask();
+
+        auto nexthop = nextHopOf("Ethernet0", 0);
+        auto nextHopId = gNeighOrch->getNextHopId(nexthop);
+
+        /* A new MAC is set on the neighbor, its next hop is kept */
+        NeighborApiStub::ops.clear();
+        addNeighbor("Ethernet0", 0, macOf(100));
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_EQ(NeighborApiStub::ops, (vector<pair<string, string>>{ { "set_neighbor", ipOf(0) } }));
+
+        MacAddress mac;
+        ASSERT_TRUE(hasNeighbor(0, mac));
+        EXPECT_EQ(mac, MacAddress(macOf(100)));
+        EXPECT_EQ(gNeighOrch->getNextHopId(nexthop), nextHopId);
+        EXPECT_EQ(rifRefCount("Ethernet0"), 4);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 2u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 2u);
+    }
+
+    TEST_F(NeighOrchTest, BulkRemoveThenAdd)
+    {
+        addNeighbor("Ethernet0", 0, macOf(0));
+        addNeighbor("Ethernet0", 1, macOf(1));
+        doTask();
+
+        /* The neighbor removed and added back in the same batch is removed first */
+        NeighborApiStub::ops.clear();
+        removeNeighbor("Ethernet0", 0);
+        addNeighbor("Ethernet0", 0, macOf(100));
+        ASSERT_EQ(m_consumer->m_toSync.size(), 2u);
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_EQ(NeighborApiStub::ops, (vector<pair<string, string>>{
+            { "remove_next_hop", ipOf(0) },
+            { "remove_neighbor", ipOf(0) },
+            { "create_neighbor", ipOf(0) },
+            { "create_next_hop", ipOf(0) } }));
+
+        MacAddress mac;
+        ASSERT_TRUE(hasNeighbor(0, mac));
+        EXPECT_EQ(mac, MacAddress(macOf(100)));
+        EXPECT_TRUE(gNeighOrch->hasNextHop(nextHopOf("Ethernet0", 0)));
+        EXPECT_EQ(rifRefCount("Ethernet0"), 4);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 2u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 2u);
+    }
+
+    TEST_F(NeighOrchTest, BulkRemoveThenAddSameMac)
+    {
+        addNeighbor("Ethernet0", 0, macOf(0));
+        addNeighbor("Ethernet0", 1, macOf(1));
+        doTask();
+
+        /* Added back with its MAC, the neighbor is not a duplicate of the one being removed */
+        NeighborApiStub::ops.clear();
+        removeNeighbor("Ethernet0", 0);
+        addNeighbor("Ethernet0", 0, macOf(0));
+        ASSERT_EQ(m_consumer->m_toSync.size(), 2u);
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_EQ(NeighborApiStub::ops, (vector<pair<string, string>>{
+            { "remove_next_hop", ipOf(0) },
+            { "remove_neighbor", ipOf(0) },
+            { "create_neighbor", ipOf(0) },
+            { "create_next_hop", ipOf(0) } }));
+
+        MacAddress mac;
+        ASSERT_TRUE(hasNeighbor(0, mac));
+        EXPECT_EQ(mac, MacAddress(macOf(0)));
+        EXPECT_TRUE(gNeighOrch->hasNextHop(nextHopOf("Ethernet0", 0)));
+        EXPECT_EQ(rifRefCount("Ethernet0"), 4);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 2u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 2u);
+    }
+
+    TEST_F(NeighOrchTest, ReferencedNeighborKept)
+    {
+        addNeighbor("Ethernet0", 0, macOf(0));
+        addNeighbor("Ethernet0", 1, macOf(1));
+        doTask();
+
+        /* A route uses the first next hop: only the second neighbor is removed */
+        auto nexthop = nextHopOf("Ethernet0", 0);
+        gNeighOrch->increaseNextHopRefCount(nexthop);
+
+        removeNeighbor("Ethernet0", 0);
+        removeNeighbor("Ethernet0", 1);
+        doTask();
+
+        ASSERT_EQ(m_consumer->m_toSync.size(), 1u);
+        EXPECT_EQ(m_consumer->m_toSync.begin()->first, "Ethernet0:" + ipOf(0));
+
+        MacAddress mac;
+        EXPECT_TRUE(hasNeighbor(0, mac));
+        EXPECT_TRUE(gNeighOrch->hasNextHop(nexthop));
+        EXPECT_FALSE(hasNeighbor(1, mac));
+        EXPECT_EQ(rifRefCount("Ethernet0"), 2);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 1u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 1u);
+
+        /* Removed once the route is gone */
+        gNeighOrch->decreaseNextHopRefCount(nexthop);
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_FALSE(hasNeighbor(0, mac));
+        EXPECT_FALSE(gNeighOrch->hasNextHop(nexthop));
+        EXPECT_EQ(rifRefCount("Ethernet0"), 0);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 0u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 0u);
+    }
+
+    TEST_F(NeighOrchTest, NeighborWithoutRouterInterfacePending)
+    {
+        addNeighbor("Ethernet0", 0, macOf(0));
+        addNeighbor("Ethernet4", 1, macOf(1));
+        doTask();
+
+        /* The neighbor on Ethernet4 waits for its router interface, the other one is programmed */
+        ASSERT_EQ(m_consumer->m_toSync.size(), 1u);
+        EXPECT_EQ(m_consumer->m_toSync.begin()->first, "Ethernet4:" + ipOf(1));
+
+        MacAddress mac;
+        EXPECT_TRUE(hasNeighbor(0, mac));
+        EXPECT_FALSE(hasNeighbor(1, mac));
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 1u);
+
+        ASSERT_TRUE(gIntfsOrch->setIntf("Ethernet4"));
+        doTask();
+
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_TRUE(hasNeighbor(1, mac));
+        EXPECT_TRUE(gNeighOrch->hasNextHop(nextHopOf("Ethernet4", 1)));
+        EXPECT_EQ(rifRefCount("Ethernet0"), 2);
+        EXPECT_EQ(rifRefCount("Ethernet4"), 2);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 2u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 2u);
+    }
+
+    TEST_F(NeighOrchTest, NeighborAlreadyInAsic)
+    {
+        /* The first neighbor fails in the bulk, the others of the bulk are programmed */
+        NeighborApiStub::existing.insert(ipOf(0));
+
+        addNeighbor("Ethernet0", 0, macOf(0));
+        addNeighbor("Ethernet0", 1, macOf(1));
+        addNeighbor("Ethernet0", 2, macOf(2));
+        doTask();
+
+        /* Not retried, nor cached, and no next hop nor reference is taken for it */
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+
+        MacAddress mac;
+        EXPECT_FALSE(hasNeighbor(0, mac));
+        EXPECT_FALSE(gNeighOrch->hasNextHop(nextHopOf("Ethernet0", 0)));
+        EXPECT_EQ(NeighborApiStub::opIndex("create_next_hop", ipOf(0)), NeighborApiStub::ops.size());
+
+        EXPECT_TRUE(hasNeighbor(1, mac));
+        EXPECT_TRUE(hasNeighbor(2, mac));
+        EXPECT_EQ(rifRefCount("Ethernet0"), 4);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEIGHBOR), 2u);
+        EXPECT_EQ(crmUsed(CrmResourceType::CRM_IPV4_NEXTHOP), 2u);
+    }
+}
@@ -0,0 +1,61 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "nexthopgroupkey.h"
+
+#include <unordered_map>
+
+namespace nexthopgroupkey_test
+{
+    using namespace std;
+
+    TEST(NextHopGroupKey, Interning)
+    {
+        auto &pool = NextHopGroupPool::instance();
+        auto size = pool.size();
+
+        NextHopGroupKey a("10.0.0.1@Ethernet0,10.0.0.2@Ethernet4");
+        NextHopGroupKey b("10.0.0.2@Ethernet4,10.0.0.1@Ethernet0");
+
+        /* Keys of the same next hop set share one entry */
+        EXPECT_NE(a.getId(), 0u);
+        EXPECT_EQ(a.getId(), b.getId());
+        EXPECT_TRUE(a == b);
+        EXPECT_EQ(a.to_string(), "10.0.0.1@Ethernet0,10.0.0.2@Ethernet4");
+        EXPECT_EQ(pool.size(), size + 1);
+
+        /* Weights tell the next hop sets apart */
+        NextHopGroupKey w("10.0.0.1@Ethernet0,10.0.0.2@Ethernet4", string("1,2"));
+        EXPECT_TRUE(w != a);
+        EXPECT_EQ(pool.size(), size + 2);
+
+        /* The ID of a released set is reused */
+        auto id = w.getId();
+        w.clear();
+        EXPECT_EQ(w.getId(), 0u);
+        EXPECT_EQ(pool.size(), size + 1);
+
+        NextHopGroupKey c("10.0.0.3@Ethernet8");
+        EXPECT_EQ(c.getId(), id);
+
+        /* Updates intern the new next hop set */
+        c.add("10.0.0.1@Ethernet0");
+        c.remove("10.0.0.3@Ethernet8");
+        EXPECT_TRUE(c == NextHopGroupKey("10.0.0.1@Ethernet0"));
+        EXPECT_TRUE(c.contains("10.0.0.1@Ethernet0"));
+        EXPECT_EQ(c.getSize(), 1u);
+
+        c.add("10.0.0.2@Ethernet4");
+        EXPECT_TRUE(c == a);
+
+        /* The empty set is not interned */
+        NextHopGroupKey e;
+        EXPECT_EQ(e.getId(), 0u);
+        EXPECT_EQ(e.getSize(), 0u);
+        EXPECT_TRUE(e == NextHopGroupKey(""));
+
+        unordered_map<NextHopGroupKey, int> table;
+        table[a] = 1;
+        EXPECT_EQ(table.count(b), 1u);
+        EXPECT_EQ(table.count(e), 0u);
+    }
+}
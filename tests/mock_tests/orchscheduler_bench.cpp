@@ -0,0 +1,149 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+#include "orchscheduler.h"
+#include "taskorch.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace orchscheduler_bench
+{
+    using namespace std;
+    using namespace mock_orch;
+
+    struct OrchSchedulerBench : public ::testing::Test
+    {
+        /* Route flood spread over the low priority tables, a port down every few passes */
+        const size_t floodTasks = 20000;
+        const size_t floodChunk = 500;
+        const chrono::nanoseconds floodCost = chrono::microseconds(2);
+        const size_t portDownInterval = 5;
+
+        shared_ptr<swss::DBConnector> m_app_db;
+        vector<string> m_runLog;
+        vector<TaskOrch *> m_floodOrchs;
+        TaskOrch *m_portOrch = nullptr;
+        vector<Orch *> m_orchList;
+
+        virtual void SetUp() override
+        {
+            ::testing_db::reset();
+
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+
+            m_floodOrchs.push_back(new TaskOrch(m_app_db.get(), APP_ROUTE_TABLE_NAME, 5,
+                                                floodChunk, floodCost, m_runLog));
+            m_floodOrchs.push_back(new TaskOrch(m_app_db.get(), APP_FG_ROUTE_TABLE_NAME, 15,
+                                                floodChunk, floodCost, m_runLog));
+            m_floodOrchs.push_back(new TaskOrch(m_app_db.get(), APP_VNET_RT_TABLE_NAME, 0,
+                                                floodChunk, floodCost, m_runLog));
+            m_portOrch = new TaskOrch(m_app_db.get(), APP_PORT_TABLE_NAME, 45,
+                                      1, chrono::nanoseconds(0), m_runLog);
+
+            m_orchList.assign(m_floodOrchs.begin(), m_floodOrchs.end());
+            m_orchList.push_back(m_portOrch);
+        }
+
+        virtual void TearDown() override
+        {
+            for (auto o : m_orchList)
+            {
+                delete o;
+            }
+            m_orchList.clear();
+            m_floodOrchs.clear();
+
+            ::testing_db::reset();
+        }
+
+        bool flooding() const
+        {
+            for (auto o : m_floodOrchs)
+            {
+                if (o->getPending())
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /*
+         * Flood the route tables and pop a port down between passes, returns the
+         * latencies in microseconds until the port task is handled
+         */
+        template <typename Pass>
+        vector<int64_t> runFlood(Pass pass)
+        {
+            for (auto o : m_floodOrchs)
+            {
+                o->addTasks(floodTasks);
+            }
+
+            vector<int64_t> latencies;
+            for (size_t passes = 0; flooding(); passes++)
+            {
+                auto start = sched_clock_t::now();
+                if (passes % portDownInterval == 0)
+                {
+                    m_portOrch->queueTasks(1);
+                    m_portOrch->getConsumer()->popTasks();
+                }
+
+                do
+                {
+                    pass();
+                }
+                while (m_portOrch->getPending());
+
+                if (passes % portDownInterval == 0)
+                {
+                    latencies.push_back(chrono::duration_cast<chrono::microseconds>(
+                        sched_clock_t::now() - start).count());
+                }
+            }
+
+            return latencies;
+        }
+
+        void report(const string &name, vector<int64_t> latencies)
+        {
+            ASSERT_FALSE(latencies.empty());
+
+            sort(latencies.begin(), latencies.end());
+            int64_t sum = 0;
+            for (auto l : latencies)
+            {
+                sum += l;
+            }
+
+            cout << name << ": " << latencies.size() << " port down events, latency usecs"
+                 << " avg " << sum / static_cast<int64_t>(latencies.size())
+                 << " p50 " << latencies[latencies.size() / 2]
+                 << " p99 " << latencies[latencies.size() * 99 / 100]
+                 << " max " << latencies.back() << endl;
+        }
+    };
+
+    TEST_F(OrchSchedulerBench, PortDownLatencyUnderRouteFlood)
+    {
+        /* Reference: every ready orch run once per pass in the orch list order */
+        report("List order", runFlood([this]() {
+            OrchSchedulerStats stats;
+            auto nextRetry = sched_clock_t::time_point::max();
+            for (auto o : m_orchList)
+            {
+                if (o->hasReadyConsumers())
+                {
+                    o->doReadyTasks(sched_clock_t::now(), nextRetry, stats);
+                }
+            }
+        }));
+
+        OrchScheduler scheduler(m_orchList);
+        report("Weighted-fair scheduler", runFlood([&scheduler]() {
+            scheduler.doReadyTasks(1000);
+        }));
+    }
+}
@@ -0,0 +1,243 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+#include "orchscheduler.h"
+#include "taskorch.h"
+
+#include <chrono>
+
+namespace orchscheduler_test
+{
+    using namespace std;
+    using namespace mock_orch;
+
+    /* Hands each task over to a follow-up task: it progresses with as many tasks pending */
+    class HandOverOrch : public TaskOrch
+    {
+    public:
+        using TaskOrch::TaskOrch;
+
+        void doTask(Consumer &consumer) override
+        {
+            auto it = consumer.m_toSync.begin();
+            if (it == consumer.m_toSync.end())
+            {
+                return;
+            }
+
+            string key = it->first + "+";
+            consumer.m_toSync.erase(it);
+            consumer.m_toSync.emplace(key, KeyOpFieldsValuesTuple(key, SET_COMMAND, {}));
+        }
+    };
+
+    struct OrchSchedulerTest : public ::testing::Test
+    {
+        /* Route flood spread over the low priority tables */
+        const size_t floodTasks = 2000;
+        const size_t floodChunk = 100;
+
+        shared_ptr<swss::DBConnector> m_app_db;
+        vector<string> m_runLog;
+        vector<TaskOrch *> m_floodOrchs;
+        TaskOrch *m_portOrch = nullptr;
+        vector<Orch *> m_orchList;
+
+        virtual void SetUp() override
+        {
+            ::testing_db::reset();
+
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+
+            /* Same relative order as in OrchDaemon::init, port table last */
+            m_floodOrchs.push_back(new TaskOrch(m_app_db.get(), APP_ROUTE_TABLE_NAME, 5,
+                                                floodChunk, chrono::nanoseconds(0), m_runLog));
+            m_floodOrchs.push_back(new TaskOrch(m_app_db.get(), APP_FG_ROUTE_TABLE_NAME, 15,
+                                                floodChunk, chrono::nanoseconds(0), m_runLog));
+            m_floodOrchs.push_back(new TaskOrch(m_app_db.get(), APP_VNET_RT_TABLE_NAME, 0,
+                                                floodChunk, chrono::nanoseconds(0), m_runLog));
+            m_portOrch = new TaskOrch(m_app_db.get(), APP_PORT_TABLE_NAME, 45,
+                                      1, chrono::nanoseconds(0), m_runLog);
+
+            m_orchList.assign(m_floodOrchs.begin(), m_floodOrchs.end());
+            m_orchList.push_back(m_portOrch);
+        }
+
+        virtual void TearDown() override
+        {
+            for (auto o : m_orchList)
+            {
+                delete o;
+            }
+            m_orchList.clear();
+            m_floodOrchs.clear();
+
+            ::testing_db::reset();
+        }
+
+        bool flooding() const
+        {
+            for (auto o : m_floodOrchs)
+            {
+                if (o->getPending())
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    TEST_F(OrchSchedulerTest, Weight)
+    {
+        EXPECT_EQ(OrchScheduler::getWeight(-1), 1u);
+        EXPECT_EQ(OrchScheduler::getWeight(0), 1u);
+        EXPECT_EQ(OrchScheduler::getWeight(45), 46u);
+    }
+
+    TEST_F(OrchSchedulerTest, ListOrderPortWaitsForRoutes)
+    {
+        /* Reference: every ready orch run once per pass in the orch list order */
+        for (auto o : m_floodOrchs)
+        {
+            o->addTasks(floodTasks);
+        }
+        m_portOrch->addTasks(1);
+
+        OrchSchedulerStats stats;
+        auto nextRetry = sched_clock_t::time_point::max();
+        for (auto o : m_orchList)
+        {
+            o->doReadyTasks(sched_clock_t::now(), nextRetry, stats);
+        }
+
+        EXPECT_EQ(m_portOrch->getPending(), 0u);
+        EXPECT_EQ(m_runLog.size(), m_orchList.size());
+        EXPECT_EQ(m_runLog.back(), APP_PORT_TABLE_NAME);
+    }
+
+    TEST_F(OrchSchedulerTest, PortDownLatencyUnderRouteFlood)
+    {
+        /*
+         * With a zero time slice, a pass runs a single orch: the port task must be
+         * handled by the first pass after it is queued, ahead of all the route tables,
+         * however many route tasks are pending.
+         */
+        OrchScheduler scheduler(m_orchList);
+        scheduler.setTimeSlice(sched_clock_t::duration::zero());
+
+        for (auto o : m_floodOrchs)
+        {
+            o->addTasks(floodTasks);
+        }
+
+        size_t portEvents = 0;
+        for (size_t passes = 0; flooding(); passes++)
+        {
+            if (passes % 5 == 0)
+            {
+                m_portOrch->addTasks(1);
+                portEvents++;
+            }
+
+            size_t ready = 0;
+            for (auto o : m_orchList)
+            {
+                ready += o->hasReadyConsumers();
+            }
+
+            m_runLog.clear();
+            int timeout = scheduler.doReadyTasks(1000);
+
+            ASSERT_EQ(m_runLog.size(), 1u);
+            if (passes % 5 == 0)
+            {
+                ASSERT_EQ(m_runLog.front(), APP_PORT_TABLE_NAME);
+                ASSERT_EQ(m_portOrch->getPending(), 0u);
+            }
+            else
+            {
+                ASSERT_NE(m_runLog.front(), APP_PORT_TABLE_NAME);
+            }
+
+            /* The other ready orchs are postponed and run right away */
+            ASSERT_EQ(scheduler.getLastStats().orchsPreempted, ready - 1);
+            if (ready > 1)
+            {
+                ASSERT_EQ(timeout, 0);
+            }
+        }
+
+        EXPECT_GT(portEvents, 10u);
+        EXPECT_EQ(scheduler.getStats().consumersStalled, 0u);
+        EXPECT_EQ(m_portOrch->getPending(), 0u);
+    }
+
+    TEST_F(OrchSchedulerTest, PoppedTasksDrainedByScheduler)
+    {
+        OrchScheduler scheduler(m_orchList);
+        scheduler.setTimeSlice(sched_clock_t::duration::zero());
+
+        for (auto o : m_floodOrchs)
+        {
+            o->addTasks(floodTasks);
+        }
+
+        /* Popping port events does not drain them, nor the route backlog */
+        m_portOrch->queueTasks(3);
+        auto *consumer = m_portOrch->getConsumer();
+        consumer->popTasks();
+        EXPECT_EQ(consumer->m_toSync.size(), 3u);
+        EXPECT_TRUE(m_runLog.empty());
+        EXPECT_TRUE(m_portOrch->hasReadyConsumers());
+
+        /* The popped batch is scheduled ahead of the routes */
+        scheduler.doReadyTasks(1000);
+        ASSERT_EQ(m_runLog, vector<string>({ APP_PORT_TABLE_NAME }));
+        EXPECT_EQ(m_portOrch->getPending(), 2u);
+
+        while (m_portOrch->getPending())
+        {
+            scheduler.doReadyTasks(1000);
+        }
+        EXPECT_FALSE(m_portOrch->hasReadyConsumers());
+
+        /* The batch size is updated once the batch is drained */
+        EXPECT_EQ(consumer->m_batchSizer.getLastPopped(), 3u);
+        EXPECT_FALSE(consumer->m_batchSizer.hasBacklog());
+
+        /* An empty pop does not leave a batch pending */
+        consumer->popTasks();
+        EXPECT_EQ(consumer->m_batchSizer.getLastPopped(), 0u);
+        EXPECT_FALSE(m_portOrch->hasReadyConsumers());
+    }
+
+    TEST_F(OrchSchedulerTest, ExecuteDrainsRightAway)
+    {
+        /* Consumers run outside of OrchScheduler, as in cfgmgr, still drain on execute() */
+        m_portOrch->queueTasks(1);
+        m_portOrch->getConsumer()->execute();
+        EXPECT_EQ(m_runLog, vector<string>({ APP_PORT_TABLE_NAME }));
+        EXPECT_EQ(m_portOrch->getPending(), 0u);
+        EXPECT_EQ(m_portOrch->getConsumer()->m_batchSizer.getLastPopped(), 1u);
+    }
+
+    TEST_F(OrchSchedulerTest, ProgressWithoutFewerTasks)
+    {
+        /* Progress is seen from the tasks added or erased, not from the number of tasks */
+        HandOverOrch handOver(m_app_db.get(), "HAND_OVER_TABLE", 0, 1, chrono::nanoseconds(0), m_runLog);
+        TaskOrch stuck(m_app_db.get(), "STUCK_TABLE", 0, 0, chrono::nanoseconds(0), m_runLog);
+        handOver.addTasks(1);
+        stuck.addTasks(1);
+
+        OrchSchedulerStats stats;
+        auto nextRetry = sched_clock_t::time_point::max();
+        handOver.doReadyTasks(sched_clock_t::now(), nextRetry, stats);
+        stuck.doReadyTasks(sched_clock_t::now(), nextRetry, stats);
+
+        EXPECT_EQ(handOver.getConsumer()->m_toSync.size(), 1u);
+        EXPECT_FALSE(handOver.getConsumer()->m_sched.stalled);
+        EXPECT_TRUE(stuck.getConsumer()->m_sched.stalled);
+        EXPECT_EQ(stats.consumersStalled, 1u);
+    }
+}
@@ -0,0 +1,72 @@
+#include "ut_helper.h"
+#include "mock_table.h"
+#include "portal.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace pfcwddetector_bench
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    struct PfcWdDetectorBench : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_counters_db;
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+            m_counters_db = make_shared<swss::DBConnector>("COUNTERS_DB", 0);
+        }
+
+        void TearDown() override
+        {
+            ::testing_db::reset();
+        }
+    };
+
+    /* Detection over 2 lossless queues of 512 ports, the snapshot taken from memory */
+    TEST_F(PfcWdDetectorBench, Evaluate)
+    {
+        const size_t queueCount = 512 * 2;
+        const size_t pollCount = 10000;
+
+        PfcWdDetector detector(m_counters_db.get(), PfcWdStormPolicy::create("nephos"), 100);
+        vector<string> oids;
+        for (size_t i = 0; i < queueCount; i++)
+        {
+            oids.push_back("oid:0x" + to_string(0x1000 + i));
+            detector.add(oids.back(), "oid:0x" + to_string(0x100 + i / 2), static_cast<uint8_t>(3 + i % 2), 200, 200, false);
+        }
+
+        auto begin = steady_clock::now();
+        size_t storms = 0;
+        vector<PfcWdDetector::Event> events;
+        for (size_t poll = 0; poll < pollCount; poll++)
+        {
+            for (size_t i = 0; i < queueCount; i++)
+            {
+                /* One queue in 64 is stormed */
+                bool storm = (i % 64) == 0;
+
+                PfcWdDetector::Sample s;
+                s.occupancy = storm ? 1000 : 0;
+                s.packets = storm ? 0 : poll * 100;
+                s.pfcRx = storm ? poll * 10 : 0;
+                s.present = PfcWdDetector::Sample::PRESENT_ALL;
+                Portal::PfcWdDetectorInternal::setSample(detector, oids[i], s);
+            }
+
+            events.clear();
+            detector.evaluate(begin + milliseconds(poll * 100), events);
+            storms += events.size();
+        }
+        duration<double> elapsed = steady_clock::now() - begin;
+
+        /* The events are not acted upon, a queue in storm raises one every detection time */
+        ASSERT_EQ(storms, (queueCount / 64) * ((pollCount - 1) / 2));
+        cout << "PFC watchdog detection of " << queueCount << " queues over " << pollCount << " polls: "
+             << elapsed.count() * 1e6 / static_cast<double>(pollCount) << " usecs/poll, snapshot included" << endl;
+    }
+}
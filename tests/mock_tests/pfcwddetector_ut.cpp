@@ -0,0 +1,310 @@
+#include "ut_helper.h"
+#include "mock_table.h"
+#include "portal.h"
+
+#include <string.h>
+#include <chrono>
+
+namespace pfcwddetector_test
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    typedef PfcWdDetector::Sample Sample;
+
+    static Sample sample(uint64_t occupancy, uint64_t packets, uint64_t pfcRx, uint64_t pfcAux, bool paused = false)
+    {
+        Sample s;
+        s.occupancy = occupancy;
+        s.packets = packets;
+        s.pfcRx = pfcRx;
+        s.pfcAux = pfcAux;
+        s.paused = paused;
+        s.present = Sample::PRESENT_ALL;
+        return s;
+    }
+
+    static Sample debugStorm(Sample s)
+    {
+        s.debugStorm = true;
+        return s;
+    }
+
+    /* Storm condition of a policy on a single queue */
+    static bool isStorm(const PfcWdStormPolicy &policy, uint64_t elapsedUs,
+            uint64_t occupancy, uint64_t packetsLast, uint64_t packets,
+            uint64_t pfcRxLast, uint64_t pfcRx, uint64_t pfcAuxLast, uint64_t pfcAux,
+            uint8_t pausedLast = 0, uint8_t paused = 0)
+    {
+        PfcWdCounterArrays c;
+        c.count = 1;
+        c.occupancy = &occupancy;
+        c.packets = &packets;
+        c.packetsLast = &packetsLast;
+        c.pfcRx = &pfcRx;
+        c.pfcRxLast = &pfcRxLast;
+        c.pfcAux = &pfcAux;
+        c.pfcAuxLast = &pfcAuxLast;
+        c.paused = &paused;
+        c.pausedLast = &pausedLast;
+        c.elapsedUs = &elapsedUs;
+
+        uint8_t storm = 0;
+        policy.detect(c, &storm);
+        return storm;
+    }
+
+    struct PfcWdDetectorTest : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_counters_db;
+        steady_clock::time_point m_start;
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+            m_counters_db = make_shared<swss::DBConnector>("COUNTERS_DB", 0);
+            m_start = steady_clock::now();
+        }
+
+        void TearDown() override
+        {
+            ::testing_db::reset();
+        }
+
+        unique_ptr<PfcWdDetector> create(const string &platform)
+        {
+            return unique_ptr<PfcWdDetector>(new PfcWdDetector(m_counters_db.get(), PfcWdStormPolicy::create(platform), 100));
+        }
+
+        /*
+         * Evaluate the counters of the queues at m_start + ms, and act upon the
+         * events as PfcWdSwOrch does. Returns the events as "<queue>:<event>".
+         */
+        vector<string> step(PfcWdDetector &detector, int ms, const map<string, Sample> &samples)
+        {
+            for (const auto &it : samples)
+            {
+                Portal::PfcWdDetectorInternal::setSample(detector, it.first, it.second);
+            }
+
+            vector<PfcWdDetector::Event> events;
+            detector.evaluate(m_start + milliseconds(ms), events);
+
+            vector<string> result;
+            for (const auto &event : events)
+            {
+                detector.setStormed(event.queueOid, event.event == "storm");
+                result.push_back(event.queueOid + ":" + event.event);
+            }
+            return result;
+        }
+    };
+
+    TEST_F(PfcWdDetectorTest, Policies)
+    {
+        ASSERT_TRUE(PfcWdStormPolicy::create("vs") == nullptr);
+
+        auto mellanox = PfcWdStormPolicy::create("mellanox");
+        ASSERT_EQ(mellanox->getAuxCounter(3), "SAI_PORT_STAT_PFC_3_RX_PAUSE_DURATION_US");
+        ASSERT_EQ(mellanox->getPortLast(), PfcWdStormPolicy::PortLast::FORGET_ON_STORM);
+        ASSERT_FALSE(mellanox->usesPauseStatus());
+
+        /* Occupied queue not dequeued while PFC frames come in */
+        ASSERT_TRUE(isStorm(*mellanox, 100000, 1000, 5, 5, 10, 20, 0, 0));
+        ASSERT_FALSE(isStorm(*mellanox, 100000, 1000, 5, 6, 10, 20, 0, 0));
+        ASSERT_FALSE(isStorm(*mellanox, 100000, 1000, 5, 5, 20, 20, 0, 0));
+        /* A cleared counter is a negative delta */
+        ASSERT_FALSE(isStorm(*mellanox, 100000, 1000, 5, 5, 20, 10, 0, 0));
+        /* Empty queue paused for more than 80% of the time elapsed */
+        ASSERT_TRUE(isStorm(*mellanox, 100000, 0, 5, 5, 10, 10, 0, 80001));
+        ASSERT_FALSE(isStorm(*mellanox, 100000, 0, 5, 5, 10, 10, 0, 80000));
+        ASSERT_FALSE(isStorm(*mellanox, 200000, 0, 5, 5, 10, 10, 0, 100000));
+        ASSERT_FALSE(isStorm(*mellanox, 100000, 0, 5, 6, 10, 20, 0, 90000));
+
+        auto barefoot = PfcWdStormPolicy::create("barefoot");
+        ASSERT_EQ(barefoot->getAuxCounter(3), "SAI_PORT_STAT_PFC_3_RX_PAUSE_DURATION");
+        ASSERT_EQ(barefoot->getPortLast(), PfcWdStormPolicy::PortLast::FORGET_ON_STORM);
+
+        auto nephos = PfcWdStormPolicy::create("nephos");
+        ASSERT_EQ(nephos->getAuxCounter(3), "SAI_PORT_STAT_PFC_3_RX_PAUSE_DURATION");
+        ASSERT_EQ(nephos->getPortLast(), PfcWdStormPolicy::PortLast::UPDATE);
+
+        /* An empty queue paused needs PFC frames, not to be idle */
+        auto innovium = PfcWdStormPolicy::create("innovium");
+        ASSERT_EQ(innovium->getPortLast(), PfcWdStormPolicy::PortLast::KEEP_ON_STORM);
+        ASSERT_TRUE(isStorm(*innovium, 100000, 1000, 5, 5, 10, 20, 0, 0));
+        ASSERT_TRUE(isStorm(*innovium, 100000, 0, 5, 6, 10, 20, 0, 90000));
+        ASSERT_FALSE(isStorm(*innovium, 100000, 0, 5, 5, 10, 10, 0, 90000));
+
+        /* PFC frames without XON while the queue stays paused */
+        auto broadcom = PfcWdStormPolicy::create("broadcom");
+        ASSERT_EQ(broadcom->getAuxCounter(3), "SAI_PORT_STAT_PFC_3_ON2OFF_RX_PKTS");
+        ASSERT_TRUE(broadcom->usesPauseStatus());
+        ASSERT_TRUE(isStorm(*broadcom, 100000, 0, 5, 6, 10, 20, 2, 2, 1, 1));
+        ASSERT_FALSE(isStorm(*broadcom, 100000, 0, 5, 6, 10, 20, 2, 3, 1, 1));
+        ASSERT_FALSE(isStorm(*broadcom, 100000, 0, 5, 6, 10, 20, 2, 2, 0, 1));
+        ASSERT_FALSE(isStorm(*broadcom, 100000, 0, 5, 6, 10, 10, 2, 2, 1, 1));
+    }
+
+    TEST_F(PfcWdDetectorTest, StormAndRestore)
+    {
+        auto detector = create("mellanox");
+        detector->add("oid:0x1", "oid:0x100", 3, 200, 300, false);
+        detector->add("oid:0x2", "oid:0x100", 4, 200, 300, false);
+
+        /* The first sample only records the counters */
+        ASSERT_EQ(step(*detector, 0, { { "oid:0x1", sample(1000, 500, 0, 0) }, { "oid:0x2", sample(0, 0, 0, 0) } }), vector<string>());
+
+        /* Storm for the detection time */
+        ASSERT_EQ(step(*detector, 100, { { "oid:0x1", sample(1000, 500, 10, 0) }, { "oid:0x2", sample(0, 10, 0, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 200, { { "oid:0x1", sample(1000, 500, 20, 0) }, { "oid:0x2", sample(0, 20, 0, 0) } }),
+                vector<string>({ "oid:0x1:storm" }));
+
+        /* The last PFC counters were forgotten, the first sample of the restoration only records them */
+        ASSERT_EQ(step(*detector, 300, { { "oid:0x1", sample(0, 500, 30, 0) } }), vector<string>());
+
+        /* No more PFC frames for the restoration time, the sample at 400 is not refreshed and skipped */
+        ASSERT_EQ(step(*detector, 400, { { "oid:0x1", sample(0, 500, 30, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 500, { { "oid:0x1", sample(0, 500, 30, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 600, { { "oid:0x1", sample(0, 600, 30, 0) } }), vector<string>({ "oid:0x1:restore" }));
+
+        /* Back to detection, where a storm shorter than the detection time is nothing */
+        ASSERT_EQ(step(*detector, 700, { { "oid:0x1", sample(0, 700, 30, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 800, { { "oid:0x1", sample(1000, 700, 40, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 900, { { "oid:0x1", sample(1000, 800, 40, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 1000, { { "oid:0x1", sample(1000, 800, 50, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 1100, { { "oid:0x1", sample(1000, 800, 60, 0) } }), vector<string>({ "oid:0x1:storm" }));
+
+        /* PFC frames keep coming in, the restoration time starts over */
+        ASSERT_EQ(step(*detector, 1200, { { "oid:0x1", sample(1000, 800, 70, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 1300, { { "oid:0x1", sample(1000, 800, 70, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 1400, { { "oid:0x1", sample(1000, 800, 80, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 1600, { { "oid:0x1", sample(1000, 800, 80, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 1700, { { "oid:0x1", sample(1000, 900, 80, 0) } }), vector<string>({ "oid:0x1:restore" }));
+    }
+
+    TEST_F(PfcWdDetectorTest, Alert)
+    {
+        auto detector = create("nephos");
+        detector->add("oid:0x1", "oid:0x100", 3, 100, 0, true);
+
+        ASSERT_EQ(step(*detector, 0, { { "oid:0x1", sample(1000, 0, 0, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 100, { { "oid:0x1", sample(1000, 0, 10, 0) } }), vector<string>({ "oid:0x1:storm" }));
+
+        /* An alert keeps on detecting, as the plugins do */
+        ASSERT_EQ(step(*detector, 200, { { "oid:0x1", sample(1000, 0, 20, 0) } }), vector<string>({ "oid:0x1:storm" }));
+        ASSERT_EQ(step(*detector, 300, { { "oid:0x1", sample(0, 100, 20, 0) } }), vector<string>({ "oid:0x1:restore" }));
+        ASSERT_EQ(step(*detector, 400, { { "oid:0x1", sample(0, 200, 20, 0) } }), vector<string>());
+
+        /* Without restoration time nor alert, a stormed queue is left alone */
+        detector->add("oid:0x1", "oid:0x100", 3, 100, 0, false);
+        ASSERT_EQ(step(*detector, 500, { { "oid:0x1", sample(1000, 200, 30, 0) } }), vector<string>({ "oid:0x1:storm" }));
+        ASSERT_EQ(step(*detector, 600, { { "oid:0x1", sample(0, 300, 30, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 700, { { "oid:0x1", sample(0, 400, 30, 0) } }), vector<string>());
+    }
+
+    TEST_F(PfcWdDetectorTest, DebugStorm)
+    {
+        auto detector = create("broadcom");
+        detector->add("oid:0x1", "oid:0x100", 3, 200, 100, false);
+
+        ASSERT_EQ(step(*detector, 0, { { "oid:0x1", sample(0, 0, 0, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 100, { { "oid:0x1", debugStorm(sample(0, 10, 0, 0)) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 200, { { "oid:0x1", debugStorm(sample(0, 20, 0, 0)) } }), vector<string>({ "oid:0x1:storm" }));
+
+        /* Not restored for as long as the debug storm is enabled */
+        ASSERT_EQ(step(*detector, 300, { { "oid:0x1", debugStorm(sample(0, 30, 0, 0)) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 400, { { "oid:0x1", debugStorm(sample(0, 40, 0, 0)) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 500, { { "oid:0x1", sample(0, 50, 0, 0) } }), vector<string>({ "oid:0x1:restore" }));
+
+        /* Missing counters */
+        Sample missing = sample(0, 60, 0, 0);
+        missing.present = Sample::PRESENT_QUEUE;
+        ASSERT_EQ(step(*detector, 600, { { "oid:0x1", debugStorm(missing) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 700, { { "oid:0x1", debugStorm(missing) } }), vector<string>());
+    }
+
+    TEST_F(PfcWdDetectorTest, AddRemove)
+    {
+        auto detector = create("mellanox");
+        detector->add("oid:0x1", "oid:0x100", 3, 100, 100, false);
+        detector->add("oid:0x2", "oid:0x100", 4, 100, 100, false);
+        detector->add("oid:0x3", "oid:0x200", 3, 100, 100, false);
+        detector->add("oid:0x3", "oid:0x200", 3, 100, 100, false);
+        ASSERT_EQ(detector->size(), 3u);
+
+        ASSERT_EQ(step(*detector, 0, { { "oid:0x1", sample(0, 0, 0, 0) }, { "oid:0x2", sample(0, 0, 0, 0) }, { "oid:0x3", sample(1000, 0, 0, 0) } }), vector<string>());
+
+        /* oid:0x3 takes the place of oid:0x1, with its last sample */
+        detector->remove("oid:0x1");
+        detector->remove("oid:0x4");
+        ASSERT_EQ(detector->size(), 2u);
+
+        ASSERT_EQ(step(*detector, 100, { { "oid:0x2", sample(0, 10, 0, 0) }, { "oid:0x3", sample(1000, 0, 10, 0) } }),
+                vector<string>({ "oid:0x3:storm" }));
+
+        /* A new queue starts over */
+        detector->add("oid:0x1", "oid:0x100", 3, 100, 100, false);
+        ASSERT_EQ(step(*detector, 200, { { "oid:0x1", sample(1000, 0, 10, 0) } }), vector<string>());
+        ASSERT_EQ(step(*detector, 300, { { "oid:0x1", sample(1000, 0, 20, 0) } }), vector<string>({ "oid:0x1:storm" }));
+
+        /* Nothing is read back in the mock, the queues are left as they are */
+        ASSERT_TRUE(detector->poll().empty());
+        detector->setStormed("oid:0x4", true);
+    }
+
+    TEST_F(PfcWdDetectorTest, ParseReplies)
+    {
+        auto detector = create("broadcom");
+
+        vector<const char *> values = { "100", "10", nullptr, "true", "5", "7" };
+        vector<redisReply> elements(values.size());
+        vector<redisReply *> elementPtrs;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            elements[i] = {};
+            elements[i].type = values[i] ? REDIS_REPLY_STRING : REDIS_REPLY_NIL;
+            elements[i].str = const_cast<char *>(values[i]);
+            elements[i].len = values[i] ? static_cast<decltype(elements[i].len)>(strlen(values[i])) : 0;
+            elementPtrs.push_back(&elements[i]);
+        }
+
+        /* Occupancy, packets, DEBUG_STORM and pause status, then PFC RX and ON2OFF */
+        redisReply queueReply = {};
+        queueReply.type = REDIS_REPLY_ARRAY;
+        queueReply.elements = 4;
+        queueReply.element = elementPtrs.data();
+
+        redisReply portReply = {};
+        portReply.type = REDIS_REPLY_ARRAY;
+        portReply.elements = 2;
+        portReply.element = elementPtrs.data() + 4;
+
+        Sample s;
+        detector->parseQueueReply(&queueReply, s);
+        detector->parsePortReply(&portReply, s);
+        ASSERT_EQ(s.present, Sample::PRESENT_ALL);
+        ASSERT_EQ(s.occupancy, 100u);
+        ASSERT_EQ(s.packets, 10u);
+        ASSERT_TRUE(s.paused);
+        ASSERT_FALSE(s.debugStorm);
+        ASSERT_EQ(s.pfcRx, 5u);
+        ASSERT_EQ(s.pfcAux, 7u);
+
+        /* Not polled by syncd yet */
+        elements[3].type = REDIS_REPLY_NIL;
+        elements[5].type = REDIS_REPLY_NIL;
+        elements[2].type = REDIS_REPLY_STRING;
+        elements[2].str = const_cast<char *>("enabled");
+        s = Sample();
+        detector->parseQueueReply(&queueReply, s);
+        detector->parsePortReply(&portReply, s);
+        ASSERT_EQ(s.present, Sample::PRESENT_PFC_RX);
+        ASSERT_TRUE(s.debugStorm);
+
+        /* Without pause status */
+        s = Sample();
+        create("mellanox")->parseQueueReply(&queueReply, s);
+        ASSERT_EQ(s.present, 0);
+    }
+}
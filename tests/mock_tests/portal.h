@@ -5,6 +5,11 @@
 
 #include "aclorch.h"
 #include "crmorch.h"
+#include "fdborch.h"
+#include "neighorch.h"
+#include "natorch.h"
+#include "ratecounters.h"
+#include "pfcwddetector.h"
 
 #undef protected
 #undef private
@@ -35,6 +40,72 @@ struct Portal
         {
             return aclOrch->m_AclTables;
         }
+
+        static void pollCounters(AclOrch *aclOrch)
+        {
+            SelectableTimer timer(timespec { .tv_sec = COUNTERS_READ_INTERVAL, .tv_nsec = 0 });
+            aclOrch->doTask(timer);
+        }
+    };
+
+    struct FdbOrchInternal
+    {
+        static void doFdbEvents(FdbOrch *fdbOrch, const std::deque<KeyOpFieldsValuesTuple> &entries)
+        {
+            fdbOrch->doFdbEvents(entries);
+        }
+
+        static const map<FdbEntry, FdbData> &getEntries(const FdbOrch *fdbOrch)
+        {
+            return fdbOrch->m_entries;
+        }
+    };
+
+    struct NeighOrchInternal
+    {
+        /* A next hop as addNextHopPost() would have synced it */
+        static void addNextHop(NeighOrch *neighOrch, const NextHopKey &nexthop, sai_object_id_t nextHopId)
+        {
+            neighOrch->m_syncdNextHops[nexthop] = { nextHopId, 0, 0 };
+        }
+    };
+
+    struct RateCountersInternal
+    {
+        /* Counters of an object as readSnapshot() would have read them, in RX_BPS, RX_PPS, TX_BPS, TX_PPS order */
+        static void setSnapshot(RateCounters &rates, const std::string &oid, const std::vector<uint64_t> &totals)
+        {
+            size_t i = rates.m_index.at(oid);
+            std::copy(totals.begin(), totals.end(), rates.m_current.begin() + static_cast<std::ptrdiff_t>(i * RateCounters::RATE_COUNT));
+            rates.m_present[i] = 1;
+        }
+
+        static void clearSnapshot(RateCounters &rates)
+        {
+            std::fill(rates.m_present.begin(), rates.m_present.end(), 0);
+        }
+    };
+
+    struct PfcWdDetectorInternal
+    {
+        /* Counters of a queue as readSnapshot() would have read them */
+        static void setSample(PfcWdDetector &detector, const std::string &queueOid, const PfcWdDetector::Sample &sample)
+        {
+            detector.setSample(detector.m_index.at(queueOid), sample);
+        }
+    };
+
+    struct NatOrchInternal
+    {
+        static uint32_t getHitBitQueryBudget(size_t entries)
+        {
+            return NatOrch::getHitBitQueryBudget(entries);
+        }
+
+        static uint64_t getHitBitQueryTick(time_t activeTime, int timeout, time_t now, uint64_t *spread)
+        {
+            return NatOrch::getHitBitQueryTick(activeTime, timeout, now, spread);
+        }
     };
 
     struct CrmOrchInternal
@@ -58,5 +129,15 @@ struct Portal
         {
             crmOrch->getResAvailableCounters();
         }
+
+        static uint32_t getResUsedCounter(const CrmOrch *crmOrch, CrmResourceType resource)
+        {
+            uint32_t used = 0;
+            for (const auto &it : crmOrch->m_resourcesMap.at(resource).countersMap)
+            {
+                used += it.second.usedCounter;
+            }
+            return used;
+        }
     };
 };
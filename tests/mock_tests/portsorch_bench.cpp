@@ -0,0 +1,152 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace portsorch_bench
+{
+    using namespace std;
+
+    struct PortsOrchBench : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_app_db;
+        shared_ptr<swss::DBConnector> m_state_db;
+        shared_ptr<swss::DBConnector> m_chassis_app_db;
+
+        virtual void SetUp() override
+        {
+            ::testing_db::reset();
+
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_state_db = make_shared<swss::DBConnector>("STATE_DB", 0);
+            m_chassis_app_db = make_shared<swss::DBConnector>("CHASSIS_APP_DB", 0);
+
+            map<string, string> profile = {
+                { "SAI_VS_SWITCH_TYPE", "SAI_VS_SWITCH_TYPE_BCM56850" },
+                { "KV_DEVICE_MAC_ADDRESS", "20:03:04:05:06:00" }
+            };
+
+            ut_helper::initSaiApi(profile);
+
+            sai_attribute_t attr;
+            attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+            attr.value.booldata = true;
+            ASSERT_EQ(sai_switch_api->create_switch(&gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+
+            attr.id = SAI_SWITCH_ATTR_SRC_MAC_ADDRESS;
+            ASSERT_EQ(sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+            gMacAddress = attr.value.mac;
+
+            attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+            ASSERT_EQ(sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr), SAI_STATUS_SUCCESS);
+            gVirtualRouterId = attr.value.oid;
+        }
+
+        virtual void TearDown() override
+        {
+            delete gPortsOrch;
+            gPortsOrch = nullptr;
+
+            sai_switch_api->remove_switch(gSwitchId);
+            gSwitchId = 0;
+            ut_helper::uninitSaiApi();
+
+            ::testing_db::reset();
+        }
+    };
+
+    /* Lookup of the port list as getPort(oid) did it before the object id index */
+    static const Port *scanPort(sai_object_id_t id)
+    {
+        for (const auto &it : gPortsOrch->getAllPorts())
+        {
+            const Port &port = it.second;
+            if (((port.m_type == Port::PHY || port.m_type == Port::SYSTEM) && port.m_port_id == id) ||
+                (port.m_type == Port::LAG && port.m_lag_id == id) ||
+                (port.m_type == Port::VLAN && port.m_vlan_info.vlan_oid == id))
+            {
+                return &port;
+            }
+        }
+        return nullptr;
+    }
+
+    /* Ports and a full VLAN range: getPort by object id through a scan and through the index */
+    TEST_F(PortsOrchBench, FindPortByOid)
+    {
+        const size_t vlanCount = 4000;
+        const size_t rounds = 16;
+
+        Table portTable = Table(m_app_db.get(), APP_PORT_TABLE_NAME);
+        Table vlanTable = Table(m_app_db.get(), APP_VLAN_TABLE_NAME);
+
+        auto ports = ut_helper::getInitialSaiPorts();
+
+        const int portsorch_base_pri = 40;
+
+        vector<table_name_with_pri_t> ports_tables = {
+            { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+            { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+            { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+            { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+            { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+        };
+
+        gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+        for (const auto &it : ports)
+        {
+            portTable.set(it.first, it.second);
+        }
+        portTable.set("PortConfigDone", { { "count", to_string(ports.size()) } });
+        portTable.set("PortInitDone", { { } });
+        for (size_t i = 0; i < vlanCount; i++)
+        {
+            vlanTable.set("Vlan" + to_string(i + 2), { { "admin_status", "up" }, { "mtu", "9100" } });
+        }
+
+        gPortsOrch->addExistingData(&portTable);
+        gPortsOrch->addExistingData(&vlanTable);
+        static_cast<Orch *>(gPortsOrch)->doTask();
+
+        vector<sai_object_id_t> oids;
+        for (const auto &it : gPortsOrch->getAllPorts())
+        {
+            if (it.second.m_type == Port::PHY)
+            {
+                oids.push_back(it.second.m_port_id);
+            }
+            else if (it.second.m_type == Port::VLAN)
+            {
+                oids.push_back(it.second.m_vlan_info.vlan_oid);
+            }
+        }
+        ASSERT_EQ(oids.size(), ports.size() + vlanCount);
+
+        auto begin = chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (auto oid : oids)
+            {
+                ASSERT_NE(scanPort(oid), nullptr);
+            }
+        }
+        chrono::duration<double, micro> scan = chrono::steady_clock::now() - begin;
+
+        begin = chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (auto oid : oids)
+            {
+                ASSERT_NE(gPortsOrch->findPort(oid), nullptr);
+            }
+        }
+        chrono::duration<double, micro> index = chrono::steady_clock::now() - begin;
+
+        cout << "getPort by oid over " << oids.size() << " ports: scan "
+             << scan.count() / static_cast<double>(rounds * oids.size()) << " us, index "
+             << index.count() / static_cast<double>(rounds * oids.size()) << " us" << endl;
+    }
+}
@@ -594,4 +594,131 @@ namespace portsorch_test
         ASSERT_FALSE(bridgePortCalledBeforeLagMember); // bridge port created on lag before lag member was created
     }
 
+
+    /* Linear scan of the port list by object id, to compare the index with */
+    static const Port *scanPort(sai_object_id_t id)
+    {
+        for (const auto &it : gPortsOrch->getAllPorts())
+        {
+            const Port &port = it.second;
+            if (((port.m_type == Port::PHY || port.m_type == Port::SYSTEM) && port.m_port_id == id) ||
+                (port.m_type == Port::LAG && port.m_lag_id == id) ||
+                (port.m_type == Port::VLAN && port.m_vlan_info.vlan_oid == id))
+            {
+                return &port;
+            }
+        }
+        return nullptr;
+    }
+
+    /*
+     * The scope of this test is to verify that ports, LAGs, VLANs and bridge
+     * ports are found by object id as they are created and removed, and that
+     * the object id index finds the same port as a scan of the port list.
+     */
+    TEST_F(PortsOrchTest, FindPortByOid)
+    {
+        const size_t vlanCount = 64;
+
+        Table portTable = Table(m_app_db.get(), APP_PORT_TABLE_NAME);
+        Table lagTable = Table(m_app_db.get(), APP_LAG_TABLE_NAME);
+        Table lagMemberTable = Table(m_app_db.get(), APP_LAG_MEMBER_TABLE_NAME);
+        Table vlanTable = Table(m_app_db.get(), APP_VLAN_TABLE_NAME);
+        Table vlanMemberTable = Table(m_app_db.get(), APP_VLAN_MEMBER_TABLE_NAME);
+
+        auto ports = ut_helper::getInitialSaiPorts();
+
+        const int portsorch_base_pri = 40;
+
+        vector<table_name_with_pri_t> ports_tables = {
+            { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+            { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+            { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+            { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+            { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+        };
+
+        ASSERT_EQ(gPortsOrch, nullptr);
+        gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+        for (const auto &it : ports)
+        {
+            portTable.set(it.first, it.second);
+        }
+        portTable.set("PortConfigDone", { { "count", to_string(ports.size()) } });
+        portTable.set("PortInitDone", { { } });
+
+        lagTable.set("PortChannel0001", { { "admin_status", "up" }, { "mtu", "9100" } });
+        lagMemberTable.set(
+            std::string("PortChannel0001") + lagMemberTable.getTableNameSeparator() + ports.begin()->first,
+            { { "status", "enabled" } });
+        for (size_t i = 0; i < vlanCount; i++)
+        {
+            vlanTable.set("Vlan" + to_string(i + 2), { { "admin_status", "up" }, { "mtu", "9100" } });
+        }
+        vlanMemberTable.set(
+            std::string("Vlan2") + vlanMemberTable.getTableNameSeparator() + std::string("PortChannel0001"),
+            { { "tagging_mode", "untagged" } });
+
+        gPortsOrch->addExistingData(&portTable);
+        gPortsOrch->addExistingData(&lagTable);
+        gPortsOrch->addExistingData(&lagMemberTable);
+        gPortsOrch->addExistingData(&vlanTable);
+        gPortsOrch->addExistingData(&vlanMemberTable);
+        static_cast<Orch *>(gPortsOrch)->doTask();
+
+        vector<sai_object_id_t> oids;
+        for (const auto &it : gPortsOrch->getAllPorts())
+        {
+            const Port &port = it.second;
+            switch (port.m_type)
+            {
+            case Port::PHY:
+                oids.push_back(port.m_port_id);
+                break;
+            case Port::LAG:
+                oids.push_back(port.m_lag_id);
+                break;
+            case Port::VLAN:
+                oids.push_back(port.m_vlan_info.vlan_oid);
+                break;
+            default:
+                continue;
+            }
+
+            ASSERT_EQ(gPortsOrch->findPort(oids.back()), &port);
+        }
+        ASSERT_EQ(oids.size(), ports.size() + 1 + vlanCount);
+
+        Port lag;
+        ASSERT_TRUE(gPortsOrch->getPort("PortChannel0001", lag));
+        ASSERT_NE(lag.m_bridge_port_id, SAI_NULL_OBJECT_ID);
+        ASSERT_EQ(gPortsOrch->findPortByBridgePortId(lag.m_bridge_port_id)->m_alias, "PortChannel0001");
+
+        Port port;
+        ASSERT_TRUE(gPortsOrch->getPort(lag.m_lag_id, port));
+        ASSERT_EQ(port.m_alias, "PortChannel0001");
+        ASSERT_EQ(gPortsOrch->findPort(SAI_NULL_OBJECT_ID), nullptr);
+
+        // The index finds what a scan of the port list finds
+
+        for (auto oid : oids)
+        {
+            ASSERT_NE(scanPort(oid), nullptr);
+            ASSERT_EQ(gPortsOrch->findPort(oid), scanPort(oid));
+        }
+
+        // Removed VLANs are not found anymore
+
+        Port vlan;
+        ASSERT_TRUE(gPortsOrch->getPort("Vlan3", vlan));
+        vlanTable.del("Vlan3");
+        auto consumer = static_cast<Consumer *>(gPortsOrch->getExecutor(APP_VLAN_TABLE_NAME));
+        consumer->addToSync(KeyOpFieldsValuesTuple("Vlan3", DEL_COMMAND, vector<FieldValueTuple>()));
+        static_cast<Orch *>(gPortsOrch)->doTask();
+
+        ASSERT_FALSE(gPortsOrch->getPort("Vlan3", vlan));
+        ASSERT_EQ(gPortsOrch->findPort(vlan.m_vlan_info.vlan_oid), nullptr);
+        ASSERT_FALSE(gPortsOrch->getPort(vlan.m_vlan_info.vlan_oid, port));
+    }
 }
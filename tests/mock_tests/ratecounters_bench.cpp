@@ -0,0 +1,60 @@
+#include "ut_helper.h"
+#include "mock_table.h"
+#include "portal.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace ratecounters_bench
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    struct RateCountersBench : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_counters_db;
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+            m_counters_db = make_shared<swss::DBConnector>("COUNTERS_DB", 0);
+        }
+
+        void TearDown() override
+        {
+            ::testing_db::reset();
+        }
+    };
+
+    /* Rate computation of a full chassis of ports, the snapshot taken from memory */
+    TEST_F(RateCountersBench, Update)
+    {
+        const size_t portCount = 512;
+        const size_t pollCount = 10000;
+
+        RateCounters rates(m_counters_db.get(), RateCounters::Type::PORT, 1000);
+        vector<string> oids;
+        for (size_t i = 0; i < portCount; i++)
+        {
+            oids.push_back("oid:0x" + to_string(0x1000 + i));
+            rates.add(oids.back());
+        }
+
+        auto begin = steady_clock::now();
+        size_t updated = 0;
+        for (size_t poll = 0; poll < pollCount; poll++)
+        {
+            for (size_t i = 0; i < portCount; i++)
+            {
+                uint64_t pkts = poll * (i + 1);
+                Portal::RateCountersInternal::setSnapshot(rates, oids[i], { pkts * 512, pkts, pkts * 1024, pkts * 2 });
+            }
+            updated += rates.update(0.18, begin + seconds(poll));
+        }
+        duration<double> elapsed = steady_clock::now() - begin;
+
+        ASSERT_EQ(updated, portCount * (pollCount - 1));
+        cout << "Rates of " << portCount << " ports over " << pollCount << " polls: "
+             << elapsed.count() * 1e6 / static_cast<double>(pollCount) << " usecs/poll, snapshot included" << endl;
+    }
+}
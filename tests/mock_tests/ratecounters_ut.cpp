@@ -0,0 +1,185 @@
+#include "ut_helper.h"
+#include "mock_table.h"
+#include "portal.h"
+
+#include <chrono>
+
+namespace ratecounters_test
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    struct RateCountersTest : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_counters_db;
+        steady_clock::time_point m_start;
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+            m_counters_db = make_shared<swss::DBConnector>("COUNTERS_DB", 0);
+            m_start = steady_clock::now();
+
+            Table config(m_counters_db.get(), "RATES");
+            config.set("PORT", { { "PORT_ALPHA", "0.5" } });
+        }
+
+        void TearDown() override
+        {
+            ::testing_db::reset();
+        }
+
+        /* Snapshot, update and write at m_start + seconds */
+        size_t poll(RateCounters &rates, double seconds, const map<string, vector<uint64_t>> &snapshot)
+        {
+            Portal::RateCountersInternal::clearSnapshot(rates);
+            for (const auto &it : snapshot)
+            {
+                Portal::RateCountersInternal::setSnapshot(rates, it.first, it.second);
+            }
+
+            double alpha;
+            EXPECT_TRUE(rates.getAlpha(alpha));
+
+            auto now = m_start + duration_cast<steady_clock::duration>(duration<double>(seconds));
+            size_t updated = rates.update(alpha, now);
+            rates.write();
+            return updated;
+        }
+
+        string getRate(const string &oid, const string &field)
+        {
+            Table table(m_counters_db.get(), "RATES");
+            string value;
+            table.hget(oid, field, value);
+            return value;
+        }
+    };
+
+    TEST_F(RateCountersTest, SmoothedRates)
+    {
+        RateCounters rates(m_counters_db.get(), RateCounters::Type::PORT, 1000);
+        rates.add("oid:0x1");
+        rates.add("oid:0x2");
+
+        /* The first sample only records the counters */
+        ASSERT_EQ(poll(rates, 0, { { "oid:0x1", { 1000, 10, 2000, 20 } }, { "oid:0x2", { 0, 0, 0, 0 } } }), 0u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), "");
+
+        /* The second one gives the rates unsmoothed */
+        ASSERT_EQ(poll(rates, 2, { { "oid:0x1", { 3000, 30, 6000, 60 } }, { "oid:0x2", { 100, 1, 100, 1 } } }), 2u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), to_string(1000.0));
+        ASSERT_EQ(getRate("oid:0x1", "RX_PPS"), to_string(10.0));
+        ASSERT_EQ(getRate("oid:0x1", "TX_BPS"), to_string(2000.0));
+        ASSERT_EQ(getRate("oid:0x1", "TX_PPS"), to_string(20.0));
+        ASSERT_EQ(getRate("oid:0x2", "RX_BPS"), to_string(50.0));
+
+        /* Then smoothed with alpha */
+        ASSERT_EQ(poll(rates, 3, { { "oid:0x1", { 6000, 30, 6000, 60 } }, { "oid:0x2", { 200, 2, 200, 2 } } }), 2u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), to_string(0.5 * 3000 + 0.5 * 1000));
+        ASSERT_EQ(getRate("oid:0x1", "RX_PPS"), to_string(0.5 * 0 + 0.5 * 10));
+        ASSERT_EQ(getRate("oid:0x2", "RX_BPS"), to_string(0.5 * 100 + 0.5 * 50));
+
+        /* A cleared counter gives a negative rate, as with port_rates.lua */
+        ASSERT_EQ(poll(rates, 4, { { "oid:0x1", { 0, 30, 6000, 60 } } }), 1u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), to_string(0.5 * -6000 + 0.5 * 2000));
+    }
+
+    TEST_F(RateCountersTest, SkippedSamples)
+    {
+        RateCounters rates(m_counters_db.get(), RateCounters::Type::PORT, 1000);
+        rates.add("oid:0x1");
+
+        ASSERT_EQ(poll(rates, 0, { { "oid:0x1", { 0, 0, 0, 0 } } }), 0u);
+        ASSERT_EQ(poll(rates, 1, { { "oid:0x1", { 1000, 10, 1000, 10 } } }), 1u);
+
+        /* Counters not refreshed by syncd since the last poll */
+        ASSERT_EQ(poll(rates, 2, { { "oid:0x1", { 1000, 10, 1000, 10 } } }), 0u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), to_string(1000.0));
+
+        /* The rate is taken over both intervals */
+        ASSERT_EQ(poll(rates, 3, { { "oid:0x1", { 3000, 30, 3000, 30 } } }), 1u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), to_string(0.5 * 1000 + 0.5 * 1000));
+
+        /* Counters missing */
+        ASSERT_EQ(poll(rates, 4, {}), 0u);
+
+        /* Idle for 2 intervals */
+        ASSERT_EQ(poll(rates, 5, { { "oid:0x1", { 3000, 30, 3000, 30 } } }), 1u);
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), to_string(0.5 * 0 + 0.5 * 1000));
+
+        /* Alpha not configured */
+        Table config(m_counters_db.get(), "RATES");
+        config.del("PORT");
+        double alpha;
+        ASSERT_FALSE(rates.getAlpha(alpha));
+        config.set("PORT", { { "PORT_ALPHA", "1.5" } });
+        ASSERT_FALSE(rates.getAlpha(alpha));
+    }
+
+    TEST_F(RateCountersTest, AddRemove)
+    {
+        RateCounters rates(m_counters_db.get(), RateCounters::Type::PORT, 1000);
+        rates.add("oid:0x1");
+        rates.add("oid:0x2");
+        rates.add("oid:0x3");
+        rates.add("oid:0x3");
+        ASSERT_EQ(rates.size(), 3u);
+
+        ASSERT_EQ(poll(rates, 0, { { "oid:0x1", { 0, 0, 0, 0 } }, { "oid:0x2", { 0, 0, 0, 0 } }, { "oid:0x3", { 0, 0, 0, 0 } } }), 0u);
+
+        /* oid:0x3 takes the place of oid:0x1, with its previous sample */
+        rates.remove("oid:0x1");
+        rates.remove("oid:0x4");
+        ASSERT_EQ(rates.size(), 2u);
+
+        ASSERT_EQ(poll(rates, 1, { { "oid:0x2", { 200, 2, 200, 2 } }, { "oid:0x3", { 300, 3, 300, 3 } } }), 2u);
+        ASSERT_EQ(getRate("oid:0x2", "RX_BPS"), to_string(200.0));
+        ASSERT_EQ(getRate("oid:0x3", "RX_BPS"), to_string(300.0));
+
+        /* A new object starts over */
+        rates.add("oid:0x1");
+        ASSERT_EQ(poll(rates, 2, { { "oid:0x1", { 500, 5, 500, 5 } } }), 0u);
+
+        /* Nothing is read back in the mock, the objects are left as they are */
+        rates.poll();
+        ASSERT_EQ(getRate("oid:0x1", "RX_BPS"), "");
+    }
+
+    TEST_F(RateCountersTest, ParseCountersReply)
+    {
+        RateCounters rates(m_counters_db.get(), RateCounters::Type::PORT, 1000);
+
+        vector<string> values = { "100", "10", "1", "200", "20", "2" };
+        vector<redisReply> elements(values.size());
+        vector<redisReply *> elementPtrs;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            elements[i] = {};
+            elements[i].type = REDIS_REPLY_STRING;
+            elements[i].str = const_cast<char *>(values[i].c_str());
+            elements[i].len = static_cast<decltype(elements[i].len)>(values[i].size());
+            elementPtrs.push_back(&elements[i]);
+        }
+
+        redisReply reply = {};
+        reply.type = REDIS_REPLY_ARRAY;
+        reply.elements = elementPtrs.size();
+        reply.element = elementPtrs.data();
+
+        /* IN_OCTETS, IN_UCAST + IN_NON_UCAST, OUT_OCTETS, OUT_UCAST + OUT_NON_UCAST */
+        uint64_t totals[RateCounters::RATE_COUNT];
+        ASSERT_TRUE(rates.parseCountersReply(&reply, totals));
+        ASSERT_EQ(totals[0], 100u);
+        ASSERT_EQ(totals[1], 11u);
+        ASSERT_EQ(totals[2], 200u);
+        ASSERT_EQ(totals[3], 22u);
+
+        /* Not polled by syncd yet */
+        elements[3].type = REDIS_REPLY_NIL;
+        ASSERT_FALSE(rates.parseCountersReply(&reply, totals));
+
+        reply.elements = 4;
+        ASSERT_FALSE(rates.parseCountersReply(&reply, totals));
+    }
+}
@@ -0,0 +1,590 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+#include "swssnet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+extern size_t gMaxBulkSize;
+extern bool gRoutePipeline;
+extern sai_next_hop_group_api_t *sai_next_hop_group_api;
+
+namespace routeorch_test
+{
+    using namespace std;
+
+    /*
+     * Route API of a remote syncd: the bulk calls are delayed, and applied one
+     * entry at a time to the virtual switch. The routes it holds and the order of
+     * the route operations are kept for the checks.
+     */
+    struct RouteApiStub
+    {
+        static sai_route_api_t *vsApi;
+        static sai_route_api_t api;
+        static sai_next_hop_group_api_t *vsNhgApi;
+        static sai_next_hop_group_api_t nhgApi;
+        static chrono::microseconds bulkDelay;
+
+        static mutex lock;
+        static set<string> routes;
+        static vector<pair<string, string>> ops;
+        static size_t bulkCalls;
+
+        /* Set while a route bulk call is in flight, SAI calls made meanwhile are counted */
+        static atomic<bool> inBulk;
+        static size_t overlappingCalls;
+
+        /* A route bulk call, delayed */
+        struct BulkCall
+        {
+            BulkCall()
+            {
+                inBulk = true;
+                this_thread::sleep_for(bulkDelay);
+            }
+
+            ~BulkCall()
+            {
+                inBulk = false;
+            }
+        };
+
+        static void install()
+        {
+            vsApi = sai_route_api;
+            api = *vsApi;
+            api.create_route_entries = createRouteEntries;
+            api.remove_route_entries = removeRouteEntries;
+            api.set_route_entries_attribute = setRouteEntriesAttribute;
+            sai_route_api = &api;
+
+            vsNhgApi = sai_next_hop_group_api;
+            nhgApi = *vsNhgApi;
+            nhgApi.create_next_hop_group = createNextHopGroup;
+            nhgApi.create_next_hop_group_members = createNextHopGroupMembers;
+            sai_next_hop_group_api = &nhgApi;
+
+            routes.clear();
+            ops.clear();
+            bulkCalls = 0;
+            overlappingCalls = 0;
+        }
+
+        static void uninstall()
+        {
+            sai_route_api = vsApi;
+            vsApi = nullptr;
+            sai_next_hop_group_api = vsNhgApi;
+            vsNhgApi = nullptr;
+        }
+
+        static string routeKey(const sai_route_entry_t &entry)
+        {
+            return sai_serialize_ip_prefix(entry.destination);
+        }
+
+        static size_t opIndex(const string &op, const string &prefix)
+        {
+            return static_cast<size_t>(find(ops.begin(), ops.end(), make_pair(op, prefix)) - ops.begin());
+        }
+
+        static sai_status_t bulkStatus(uint32_t count, const sai_status_t *statuses)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (statuses[i] != SAI_STATUS_SUCCESS)
+                {
+                    return SAI_STATUS_FAILURE;
+                }
+            }
+            return SAI_STATUS_SUCCESS;
+        }
+
+        static sai_status_t createRouteEntries(uint32_t count, const sai_route_entry_t *entries,
+                                               const uint32_t *attr_count, const sai_attribute_t **attr_list,
+                                               sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            BulkCall call;
+
+            lock_guard<mutex> guard(lock);
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsApi->create_route_entry(&entries[i], attr_count[i], attr_list[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    routes.insert(routeKey(entries[i]));
+                    ops.emplace_back("create", routeKey(entries[i]));
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t removeRouteEntries(uint32_t count, const sai_route_entry_t *entries,
+                                               sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            BulkCall call;
+
+            lock_guard<mutex> guard(lock);
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsApi->remove_route_entry(&entries[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    routes.erase(routeKey(entries[i]));
+                    ops.emplace_back("remove", routeKey(entries[i]));
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t setRouteEntriesAttribute(uint32_t count, const sai_route_entry_t *entries,
+                                                     const sai_attribute_t *attr_list,
+                                                     sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+        {
+            BulkCall call;
+
+            lock_guard<mutex> guard(lock);
+            bulkCalls++;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsApi->set_route_entry_attribute(&entries[i], &attr_list[i]);
+                if (statuses[i] == SAI_STATUS_SUCCESS)
+                {
+                    ops.emplace_back("set", routeKey(entries[i]));
+                }
+            }
+            return bulkStatus(count, statuses);
+        }
+
+        static sai_status_t createNextHopGroup(sai_object_id_t *next_hop_group_id, sai_object_id_t switch_id,
+                                               uint32_t attr_count, const sai_attribute_t *attr_list)
+        {
+            overlappingCalls += inBulk;
+
+            lock_guard<mutex> guard(lock);
+            ops.emplace_back("create_nhg", "");
+            return vsNhgApi->create_next_hop_group(next_hop_group_id, switch_id, attr_count, attr_list);
+        }
+
+        static sai_status_t createNextHopGroupMembers(sai_object_id_t switch_id, uint32_t count,
+                                                      const uint32_t *attr_count, const sai_attribute_t **attr_list,
+                                                      sai_bulk_op_error_mode_t mode, sai_object_id_t *object_id,
+                                                      sai_status_t *statuses)
+        {
+            overlappingCalls += inBulk;
+
+            lock_guard<mutex> guard(lock);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                statuses[i] = vsNhgApi->create_next_hop_group_member(&object_id[i], switch_id, attr_count[i], attr_list[i]);
+            }
+            return bulkStatus(count, statuses);
+        }
+    };
+
+    sai_route_api_t *RouteApiStub::vsApi = nullptr;
+    sai_route_api_t RouteApiStub::api;
+    sai_next_hop_group_api_t *RouteApiStub::vsNhgApi = nullptr;
+    sai_next_hop_group_api_t RouteApiStub::nhgApi;
+    chrono::microseconds RouteApiStub::bulkDelay(0);
+    mutex RouteApiStub::lock;
+    set<string> RouteApiStub::routes;
+    vector<pair<string, string>> RouteApiStub::ops;
+    size_t RouteApiStub::bulkCalls = 0;
+    atomic<bool> RouteApiStub::inBulk(false);
+    size_t RouteApiStub::overlappingCalls = 0;
+
+    struct RouteOrchTest : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_app_db;
+        shared_ptr<swss::DBConnector> m_config_db;
+        shared_ptr<swss::DBConnector> m_state_db;
+        shared_ptr<swss::DBConnector> m_chassis_app_db;
+
+        size_t m_maxBulkSize;
+        unique_ptr<Consumer> m_consumer;
+
+        RouteOrchTest()
+        {
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_config_db = make_shared<swss::DBConnector>("CONFIG_DB", 0);
+            m_state_db = make_shared<swss::DBConnector>("STATE_DB", 0);
+            m_chassis_app_db = make_shared<swss::DBConnector>("CHASSIS_APP_DB", 0);
+        }
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+
+            map<string, string> profile = {
+                { "SAI_VS_SWITCH_TYPE", "SAI_VS_SWITCH_TYPE_BCM56850" },
+                { "KV_DEVICE_MAC_ADDRESS", "20:03:04:05:06:00" }
+            };
+
+            auto status = ut_helper::initSaiApi(profile);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+
+            sai_api_query(SAI_API_NEXT_HOP_GROUP, (void **)&sai_next_hop_group_api);
+
+            sai_attribute_t attr;
+
+            attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+            attr.value.booldata = true;
+
+            status = sai_switch_api->create_switch(&gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+
+            attr.id = SAI_SWITCH_ATTR_SRC_MAC_ADDRESS;
+            status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gMacAddress = attr.value.mac;
+
+            attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+            status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gVirtualRouterId = attr.value.oid;
+
+            /* The route and next hop group member bulkers are set up from the APIs at the route orch creation */
+            RouteApiStub::install();
+            m_maxBulkSize = gMaxBulkSize;
+
+            TableConnector stateDbSwitchTable(m_state_db.get(), "SWITCH_CAPABILITY");
+            TableConnector conf_asic_sensors(m_config_db.get(), CFG_ASIC_SENSORS_TABLE_NAME);
+            TableConnector app_switch_table(m_app_db.get(), APP_SWITCH_TABLE_NAME);
+
+            vector<TableConnector> switch_tables = {
+                conf_asic_sensors,
+                app_switch_table
+            };
+
+            ASSERT_EQ(gSwitchOrch, nullptr);
+            gSwitchOrch = new SwitchOrch(m_app_db.get(), switch_tables, stateDbSwitchTable);
+
+            const int portsorch_base_pri = 40;
+
+            vector<table_name_with_pri_t> ports_tables = {
+                { APP_PORT_TABLE_NAME, portsorch_base_pri + 5 },
+                { APP_VLAN_TABLE_NAME, portsorch_base_pri + 2 },
+                { APP_VLAN_MEMBER_TABLE_NAME, portsorch_base_pri },
+                { APP_LAG_TABLE_NAME, portsorch_base_pri + 4 },
+                { APP_LAG_MEMBER_TABLE_NAME, portsorch_base_pri }
+            };
+
+            ASSERT_EQ(gPortsOrch, nullptr);
+            gPortsOrch = new PortsOrch(m_app_db.get(), m_state_db.get(), ports_tables, m_chassis_app_db.get());
+
+            ASSERT_EQ(gCrmOrch, nullptr);
+            gCrmOrch = new CrmOrch(m_config_db.get(), CFG_CRM_TABLE_NAME);
+
+            ASSERT_EQ(gVrfOrch, nullptr);
+            gVrfOrch = new VRFOrch(m_app_db.get(), APP_VRF_TABLE_NAME, m_state_db.get(), STATE_VRF_OBJECT_TABLE_NAME);
+
+            ASSERT_EQ(gIntfsOrch, nullptr);
+            gIntfsOrch = new IntfsOrch(m_app_db.get(), APP_INTF_TABLE_NAME, gVrfOrch, m_chassis_app_db.get());
+
+            TableConnector stateDbFdb(m_state_db.get(), STATE_FDB_TABLE_NAME);
+
+            vector<table_name_with_pri_t> app_fdb_tables = {
+                { APP_FDB_TABLE_NAME,        FdbOrch::fdborch_pri},
+                { APP_VXLAN_FDB_TABLE_NAME,  FdbOrch::fdborch_pri}
+            };
+
+            ASSERT_EQ(gFdbOrch, nullptr);
+            gFdbOrch = new FdbOrch(m_app_db.get(), app_fdb_tables, stateDbFdb, gPortsOrch);
+
+            ASSERT_EQ(gNeighOrch, nullptr);
+            gNeighOrch = new NeighOrch(m_app_db.get(), APP_NEIGH_TABLE_NAME, gIntfsOrch, gFdbOrch, gPortsOrch, m_chassis_app_db.get());
+
+            const int fgnhgorch_pri = 15;
+
+            vector<table_name_with_pri_t> fgnhg_tables = {
+                { CFG_FG_NHG,                 fgnhgorch_pri },
+                { CFG_FG_NHG_PREFIX,          fgnhgorch_pri },
+                { CFG_FG_NHG_MEMBER,          fgnhgorch_pri }
+            };
+
+            ASSERT_EQ(gFgNhgOrch, nullptr);
+            gFgNhgOrch = new FgNhgOrch(m_config_db.get(), m_app_db.get(), m_state_db.get(), fgnhg_tables, gNeighOrch, gIntfsOrch, gVrfOrch);
+
+            auto consumer = unique_ptr<Consumer>(new Consumer(
+                new swss::ConsumerStateTable(m_app_db.get(), APP_PORT_TABLE_NAME, 1, 1), gPortsOrch, APP_PORT_TABLE_NAME));
+
+            consumer->addToSync({ { "PortInitDone", EMPTY_PREFIX, { { "", "" } } } });
+            static_cast<Orch *>(gPortsOrch)->doTask(*consumer.get());
+        }
+
+        void TearDown() override
+        {
+            m_consumer.reset();
+
+            delete gRouteOrch;
+            gRouteOrch = nullptr;
+            delete gFgNhgOrch;
+            gFgNhgOrch = nullptr;
+            delete gNeighOrch;
+            gNeighOrch = nullptr;
+            delete gFdbOrch;
+            gFdbOrch = nullptr;
+            delete gIntfsOrch;
+            gIntfsOrch = nullptr;
+            delete gVrfOrch;
+            gVrfOrch = nullptr;
+            delete gCrmOrch;
+            gCrmOrch = nullptr;
+            delete gPortsOrch;
+            gPortsOrch = nullptr;
+            delete gSwitchOrch;
+            gSwitchOrch = nullptr;
+
+            gMaxBulkSize = m_maxBulkSize;
+            gRoutePipeline = false;
+            RouteApiStub::bulkDelay = chrono::microseconds(0);
+            RouteApiStub::uninstall();
+
+            auto status = sai_switch_api->remove_switch(gSwitchId);
+            ASSERT_EQ(status, SAI_STATUS_SUCCESS);
+            gSwitchId = 0;
+
+            ut_helper::uninitSaiApi();
+            sai_next_hop_group_api = nullptr;
+
+            ::testing_db::reset();
+        }
+
+        void createRouteOrch(size_t maxBulkSize)
+        {
+            gMaxBulkSize = maxBulkSize;
+
+            ASSERT_EQ(gRouteOrch, nullptr);
+            TableConnector stateDbRouteStats(m_state_db.get(), STATE_VRF_ROUTE_STATS_TABLE_NAME);
+            gRouteOrch = new RouteOrch(m_app_db.get(), APP_ROUTE_TABLE_NAME, stateDbRouteStats, gSwitchOrch, gNeighOrch, gIntfsOrch, gVrfOrch, gFgNhgOrch);
+
+            m_consumer.reset(new Consumer(
+                new swss::ConsumerStateTable(m_app_db.get(), APP_ROUTE_TABLE_NAME, 1, 1), gRouteOrch, APP_ROUTE_TABLE_NAME));
+        }
+
+        static string prefix(size_t i)
+        {
+            return "10." + to_string((i >> 8) & 0xff) + "." + to_string(i & 0xff) + ".0/24";
+        }
+
+        void addRoute(const string &prefix)
+        {
+            m_consumer->addToSync({ prefix, SET_COMMAND, { { "blackhole", "true" } } });
+        }
+
+        void removeRoute(const string &prefix)
+        {
+            m_consumer->addToSync({ prefix, DEL_COMMAND, { } });
+        }
+
+        void doTask()
+        {
+            static_cast<Orch *>(gRouteOrch)->doTask(*m_consumer.get());
+        }
+
+        /* Programs count routes from first, returns the routes per second */
+        double feedRoutes(size_t first, size_t count)
+        {
+            for (size_t i = first; i < first + count; i++)
+            {
+                addRoute(prefix(i));
+            }
+
+            auto start = chrono::steady_clock::now();
+            doTask();
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+            return static_cast<double>(count) / elapsed.count();
+        }
+    };
+
+    TEST_F(RouteOrchTest, PipelinedRouteFeed)
+    {
+        const size_t bulkSize = 500;
+        const size_t routeCount = 8 * bulkSize;
+
+        createRouteOrch(bulkSize);
+        RouteApiStub::bulkDelay = chrono::milliseconds(5);
+
+        auto serial = feedRoutes(0, routeCount);
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_EQ(RouteApiStub::bulkCalls, 1u * routeCount / bulkSize);
+
+        gRoutePipeline = true;
+        RouteApiStub::bulkCalls = 0;
+
+        auto pipelined = feedRoutes(routeCount, routeCount);
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_EQ(RouteApiStub::bulkCalls, 1u * routeCount / bulkSize);
+
+        for (size_t i = 0; i < 2 * routeCount; i++)
+        {
+            EXPECT_EQ(RouteApiStub::routes.count(prefix(i)), 1u);
+        }
+
+        cout << "Route feed, routes/s: serial " << static_cast<uint64_t>(serial)
+             << " pipelined " << static_cast<uint64_t>(pipelined) << endl;
+    }
+
+    TEST_F(RouteOrchTest, PrefixInBothBatches)
+    {
+        const size_t bulkSize = 8;
+        const string shared = prefix(1000);
+
+        createRouteOrch(bulkSize);
+        gRoutePipeline = true;
+
+        addRoute(shared);
+        doTask();
+        ASSERT_EQ(RouteApiStub::routes.count(shared), 1u);
+        RouteApiStub::ops.clear();
+
+        /* The removal ends the first batch, and the new route starts the second one */
+        for (size_t i = 0; i < bulkSize - 1; i++)
+        {
+            addRoute(prefix(i));
+        }
+        removeRoute(shared);
+        addRoute(shared);
+        RouteApiStub::bulkDelay = chrono::milliseconds(20);
+
+        doTask();
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+
+        auto removed = RouteApiStub::opIndex("remove", shared);
+        auto created = RouteApiStub::opIndex("create", shared);
+        ASSERT_LT(removed, RouteApiStub::ops.size());
+        ASSERT_LT(created, RouteApiStub::ops.size());
+        EXPECT_LT(removed, created);
+        EXPECT_EQ(RouteApiStub::routes.count(shared), 1u);
+
+        for (size_t i = 0; i < bulkSize - 1; i++)
+        {
+            EXPECT_EQ(RouteApiStub::routes.count(prefix(i)), 1u);
+        }
+    }
+
+    TEST_F(RouteOrchTest, VrfRouteStats)
+    {
+        createRouteOrch(m_maxBulkSize);
+        feedRoutes(0, 100);
+        removeRoute(prefix(0));
+        doTask();
+
+        swss::Table statsTable(m_state_db.get(), STATE_VRF_ROUTE_STATS_TABLE_NAME);
+        string value;
+
+        /* The default routes and the routes fed */
+        ASSERT_TRUE(statsTable.hget(DEFAULT_VRF_ROUTE_STATS_KEY, "route_count", value));
+        EXPECT_EQ(value, "101");
+        ASSERT_TRUE(statsTable.hget(DEFAULT_VRF_ROUTE_STATS_KEY, "ipv4_route_count", value));
+        EXPECT_EQ(value, "100");
+        ASSERT_TRUE(statsTable.hget(DEFAULT_VRF_ROUTE_STATS_KEY, "ipv6_route_count", value));
+        EXPECT_EQ(value, "1");
+        ASSERT_TRUE(statsTable.hget(DEFAULT_VRF_ROUTE_STATS_KEY, "memory_bytes", value));
+        EXPECT_GT(stoul(value), 0u);
+    }
+
+    TEST_F(RouteOrchTest, ResyncRemovesStaleRoutes)
+    {
+        const size_t routeCount = 10;
+
+        createRouteOrch(m_maxBulkSize);
+        feedRoutes(0, routeCount);
+
+        /* The application sets again the first half of its routes only */
+        m_consumer->addToSync({ "resync", SET_COMMAND, { } });
+        for (size_t i = 0; i < routeCount / 2; i++)
+        {
+            addRoute(prefix(i));
+        }
+        doTask();
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+        EXPECT_EQ(RouteApiStub::routes.size(), routeCount);
+
+        m_consumer->addToSync({ "resync", DEL_COMMAND, { } });
+        doTask();
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+
+        for (size_t i = 0; i < routeCount; i++)
+        {
+            EXPECT_EQ(RouteApiStub::routes.count(prefix(i)), i < routeCount / 2 ? 1u : 0u);
+        }
+    }
+
+    TEST_F(RouteOrchTest, PipelineSerializesSaiCalls)
+    {
+        const size_t bulkSize = 8;
+        const string ecmp = "20.0.0.0/24";
+
+        createRouteOrch(bulkSize);
+        gRoutePipeline = true;
+
+        /* Two next hops, on a loopback router interface */
+        sai_attribute_t attr;
+        vector<sai_attribute_t> attrs;
+
+        attr.id = SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID;
+        attr.value.oid = gVirtualRouterId;
+        attrs.push_back(attr);
+        attr.id = SAI_ROUTER_INTERFACE_ATTR_TYPE;
+        attr.value.s32 = SAI_ROUTER_INTERFACE_TYPE_LOOPBACK;
+        attrs.push_back(attr);
+
+        sai_object_id_t rifId;
+        ASSERT_EQ(sai_router_intfs_api->create_router_interface(&rifId, gSwitchId, (uint32_t)attrs.size(), attrs.data()),
+                  SAI_STATUS_SUCCESS);
+
+        for (const string ip : { "10.1.0.1", "10.1.0.2" })
+        {
+            attrs.clear();
+            attr.id = SAI_NEXT_HOP_ATTR_TYPE;
+            attr.value.s32 = SAI_NEXT_HOP_TYPE_IP;
+            attrs.push_back(attr);
+            attr.id = SAI_NEXT_HOP_ATTR_IP;
+            copy(attr.value.ipaddr, IpAddress(ip));
+            attrs.push_back(attr);
+            attr.id = SAI_NEXT_HOP_ATTR_ROUTER_INTERFACE_ID;
+            attr.value.oid = rifId;
+            attrs.push_back(attr);
+
+            sai_object_id_t nextHopId;
+            ASSERT_EQ(sai_next_hop_api->create_next_hop(&nextHopId, gSwitchId, (uint32_t)attrs.size(), attrs.data()),
+                      SAI_STATUS_SUCCESS);
+            Portal::NeighOrchInternal::addNextHop(gNeighOrch, NextHopKey(ip, "Ethernet0"), nextHopId);
+        }
+
+        /* A full batch, then a route whose next hop group is created while the batch is in flight */
+        for (size_t i = 0; i < bulkSize; i++)
+        {
+            addRoute(prefix(i));
+        }
+        m_consumer->addToSync({ ecmp, SET_COMMAND, { { "nexthop", "10.1.0.1,10.1.0.2" }, { "ifname", "Ethernet0,Ethernet0" } } });
+        RouteApiStub::bulkDelay = chrono::milliseconds(20);
+
+        doTask();
+        EXPECT_TRUE(m_consumer->m_toSync.empty());
+
+        /* The next hop group is created once the batch is done, not next to its bulk call */
+        EXPECT_EQ(RouteApiStub::overlappingCalls, 0u);
+
+        auto nhgCreated = RouteApiStub::opIndex("create_nhg", "");
+        ASSERT_LT(nhgCreated, RouteApiStub::ops.size());
+        for (size_t i = 0; i < bulkSize; i++)
+        {
+            EXPECT_LT(RouteApiStub::opIndex("create", prefix(i)), nhgCreated);
+        }
+        EXPECT_LT(nhgCreated, RouteApiStub::opIndex("create", ecmp));
+        EXPECT_EQ(RouteApiStub::routes.count(ecmp), 1u);
+    }
+}
@@ -0,0 +1,102 @@
+#include "ut_helper.h"
+#include "nexthopgroupkey.h"
+#include "routetrie.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+
+namespace routetrie_bench
+{
+    using namespace std;
+
+    /*
+     * Full IPv4 table plus IPv6 routes: memory and lookup throughput of the trie
+     * against the std::map it replaces
+     */
+    TEST(RouteTrieBench, FullTable)
+    {
+        const size_t v4Routes = 900000;
+        const size_t v6Routes = 100000;
+        /* Red-black tree node header of std::map */
+        const size_t mapNodeOverhead = 4 * sizeof(void *);
+
+        mt19937 rng(2);
+        vector<IpPrefix> prefixes;
+        prefixes.reserve(v4Routes + v6Routes);
+        for (size_t i = 0; i < v4Routes + v6Routes; i++)
+        {
+            ip_addr_t ip;
+            memset(&ip, 0, sizeof(ip));
+            if (i < v4Routes)
+            {
+                ip.family = AF_INET;
+                ip.ip_addr.ipv4_addr = static_cast<uint32_t>(rng());
+                prefixes.push_back(IpPrefix(ip, 16 + static_cast<int>(rng() % 9)).getSubnet());
+            }
+            else
+            {
+                ip.family = AF_INET6;
+                for (size_t b = 0; b < 8; b++)
+                {
+                    ip.ip_addr.ipv6_addr[b] = static_cast<uint8_t>(rng());
+                }
+                prefixes.push_back(IpPrefix(ip, 32 + static_cast<int>(rng() % 33)).getSubnet());
+            }
+        }
+
+        RouteTrie<NextHopGroupKey> trie;
+        map<IpPrefix, NextHopGroupKey> reference;
+
+        auto start = chrono::steady_clock::now();
+        for (const auto &prefix : prefixes)
+        {
+            trie[prefix] = NextHopGroupKey();
+        }
+        chrono::duration<double> trieInsert = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        for (const auto &prefix : prefixes)
+        {
+            reference[prefix] = NextHopGroupKey();
+        }
+        chrono::duration<double> mapInsert = chrono::steady_clock::now() - start;
+
+        ASSERT_EQ(trie.size(), reference.size());
+
+        shuffle(prefixes.begin(), prefixes.end(), rng);
+
+        size_t found = 0;
+        start = chrono::steady_clock::now();
+        for (const auto &prefix : prefixes)
+        {
+            found += trie.find(prefix) != trie.end();
+        }
+        chrono::duration<double> trieFind = chrono::steady_clock::now() - start;
+        ASSERT_EQ(found, prefixes.size());
+
+        found = 0;
+        start = chrono::steady_clock::now();
+        for (const auto &prefix : prefixes)
+        {
+            found += reference.find(prefix) != reference.end();
+        }
+        chrono::duration<double> mapFind = chrono::steady_clock::now() - start;
+        ASSERT_EQ(found, prefixes.size());
+
+        size_t mapBytes = reference.size() * (sizeof(map<IpPrefix, NextHopGroupKey>::value_type) + mapNodeOverhead);
+
+        auto rate = [](size_t count, chrono::duration<double> elapsed) {
+            return static_cast<uint64_t>(static_cast<double>(count) / elapsed.count());
+        };
+
+        cout << "Route table of " << trie.size() << " routes:" << endl
+             << "  memory bytes: trie " << trie.bytes() << " map " << mapBytes << endl
+             << "  inserts/s: trie " << rate(prefixes.size(), trieInsert)
+             << " map " << rate(prefixes.size(), mapInsert) << endl
+             << "  finds/s: trie " << rate(prefixes.size(), trieFind)
+             << " map " << rate(prefixes.size(), mapFind) << endl;
+    }
+}
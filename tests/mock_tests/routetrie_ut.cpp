@@ -0,0 +1,229 @@
+#include "ut_helper.h"
+#include "nexthopgroupkey.h"
+#include "routetrie.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace routetrie_test
+{
+    using namespace std;
+
+    /* Prefix of the address with the host bits cleared */
+    IpPrefix makePrefix(ip_addr_t ip, int len)
+    {
+        uint8_t *bytes = ip.family == AF_INET ? reinterpret_cast<uint8_t *>(&ip.ip_addr.ipv4_addr) : ip.ip_addr.ipv6_addr;
+        int size = ip.family == AF_INET ? 4 : 16;
+
+        for (int i = 0; i < size; i++)
+        {
+            int keep = len - 8 * i;
+            if (keep < 8)
+            {
+                bytes[i] = static_cast<uint8_t>(keep > 0 ? bytes[i] & (0xff << (8 - keep)) : 0);
+            }
+        }
+        return IpPrefix(ip, len);
+    }
+
+    ip_addr_t randomAddress(mt19937 &rng, bool v4)
+    {
+        ip_addr_t ip;
+        memset(&ip, 0, sizeof(ip));
+
+        /* Few distinct bits, so that the prefixes nest and share paths */
+        if (v4)
+        {
+            ip.family = AF_INET;
+            ip.ip_addr.ipv4_addr = static_cast<uint32_t>(rng() & 0x0f0f0f0f);
+        }
+        else
+        {
+            ip.family = AF_INET6;
+            for (size_t i = 0; i < 4; i++)
+            {
+                ip.ip_addr.ipv6_addr[i] = static_cast<uint8_t>(rng() & 0x3);
+            }
+        }
+        return ip;
+    }
+
+    TEST(RouteTrie, SameAsMap)
+    {
+        mt19937 rng(1);
+        RouteTrie<int> trie;
+        map<IpPrefix, int> reference;
+
+        for (int i = 0; i < 20000; i++)
+        {
+            bool v4 = rng() % 3 != 0;
+            auto prefix = makePrefix(randomAddress(rng, v4), static_cast<int>(rng() % (v4 ? 33 : 129)));
+
+            if (rng() % 3 != 0)
+            {
+                trie[prefix] = i;
+                reference[prefix] = i;
+            }
+            else
+            {
+                ASSERT_EQ(trie.erase(prefix), reference.erase(prefix));
+            }
+            ASSERT_EQ(trie.size(), reference.size());
+        }
+
+        /* Same routes */
+        size_t visited = 0;
+        for (auto route : trie)
+        {
+            ASSERT_EQ(reference.count(route.first), 1u);
+            EXPECT_EQ(route.second, reference.at(route.first));
+            visited++;
+        }
+        EXPECT_EQ(visited, reference.size());
+
+        for (const auto &route : reference)
+        {
+            EXPECT_EQ(trie.at(route.first), route.second);
+        }
+
+        /* Longest match and covering prefixes of addresses */
+        for (int i = 0; i < 1000; i++)
+        {
+            IpAddress addr(randomAddress(rng, i % 2 == 0));
+
+            vector<IpPrefix> covering;
+            for (const auto &route : reference)
+            {
+                if (route.first.isAddressInSubnet(addr))
+                {
+                    covering.push_back(route.first);
+                }
+            }
+
+            sort(covering.begin(), covering.end(), [](const IpPrefix &a, const IpPrefix &b) {
+                return a.getMaskLength() < b.getMaskLength();
+            });
+
+            auto best = trie.longest_match(addr);
+            auto matches = trie.matches(addr);
+            ASSERT_EQ(matches.size(), covering.size());
+            if (covering.empty())
+            {
+                EXPECT_TRUE(best == trie.end());
+                continue;
+            }
+
+            EXPECT_EQ(best->first, covering.back());
+            for (size_t m = 0; m < matches.size(); m++)
+            {
+                EXPECT_EQ(matches[m]->first, covering[m]);
+            }
+        }
+
+        /* Copies are deep, and erasing all the routes frees all the nodes */
+        RouteTrie<int> copy(trie);
+        EXPECT_EQ(copy.size(), trie.size());
+        for (auto c = copy.begin(); c != copy.end();)
+        {
+            c = copy.erase(c);
+        }
+        EXPECT_TRUE(copy.empty());
+        EXPECT_EQ(copy.bytes(), sizeof(copy));
+        EXPECT_EQ(trie.size(), reference.size());
+
+        for (const auto &route : reference)
+        {
+            EXPECT_EQ(trie.erase(route.first), 1u);
+        }
+        EXPECT_TRUE(trie.empty());
+        EXPECT_EQ(trie.bytes(), sizeof(trie));
+    }
+
+    TEST(RouteTrie, Prefixes)
+    {
+        RouteTrie<string> trie;
+
+        trie[IpPrefix("0.0.0.0/0")] = "default";
+        trie[IpPrefix("10.0.0.0/8")] = "10/8";
+        trie[IpPrefix("10.1.0.0/16")] = "10.1/16";
+        trie[IpPrefix("::/0")] = "v6 default";
+        trie[IpPrefix("2001:db8::/32")] = "doc";
+
+        EXPECT_EQ(trie.size(), 5u);
+        EXPECT_EQ(trie.size_v4(), 3u);
+        EXPECT_EQ(trie.size_v6(), 2u);
+
+        EXPECT_EQ(trie.longest_match(IpAddress("10.1.2.3"))->second, "10.1/16");
+        EXPECT_EQ(trie.longest_match(IpAddress("10.2.2.3"))->second, "10/8");
+        EXPECT_EQ(trie.longest_match(IpAddress("11.0.0.1"))->second, "default");
+        EXPECT_EQ(trie.longest_match(IpAddress("2001:db8::1"))->second, "doc");
+        EXPECT_EQ(trie.longest_match(IpAddress("2002::1"))->second, "v6 default");
+        EXPECT_EQ(trie.matches(IpAddress("10.1.2.3")).size(), 3u);
+
+        /* Prefixes match on their exact length */
+        EXPECT_TRUE(trie.emplace(IpPrefix("10.1.2.3/32"), "host").second);
+        EXPECT_FALSE(trie.emplace(IpPrefix("10.1.2.3/32"), "other").second);
+        EXPECT_EQ(trie.at(IpPrefix("10.1.2.3/32")), "host");
+        EXPECT_TRUE(trie.find(IpPrefix("10.1.2.2/32")) == trie.end());
+        EXPECT_TRUE(trie.find(IpPrefix("10.1.0.0/24")) == trie.end());
+        EXPECT_THROW(trie.at(IpPrefix("10.1.0.0/24")), out_of_range);
+
+        /* Removing a route falls back to the covering one */
+        EXPECT_EQ(trie.erase(IpPrefix("10.1.0.0/16")), 1u);
+        EXPECT_EQ(trie.erase(IpPrefix("10.1.0.0/16")), 0u);
+        EXPECT_EQ(trie.longest_match(IpAddress("10.1.9.9"))->second, "10/8");
+        EXPECT_EQ(trie.longest_match(IpAddress("10.1.2.3"))->second, "host");
+
+        /* IPv4 routes come first */
+        vector<string> order;
+        for (auto route : trie)
+        {
+            order.push_back(route.second);
+        }
+        EXPECT_EQ(order, vector<string>({ "default", "10/8", "host", "v6 default", "doc" }));
+    }
+
+    TEST(RouteTrie, IteratorArrow)
+    {
+        RouteTrie<string> trie;
+        trie[IpPrefix("10.0.0.0/8")] = "old";
+
+        /* The proxy returned by operator-> outlives the statement it is taken in */
+        auto it = trie.find(IpPrefix("10.0.0.0/8"));
+        auto entry = it.operator->();
+        EXPECT_EQ(entry->first, IpPrefix("10.0.0.0/8"));
+        entry->second = "new";
+        EXPECT_EQ(trie.at(IpPrefix("10.0.0.0/8")), "new");
+
+        it->second += "er";
+        EXPECT_EQ(trie.at(IpPrefix("10.0.0.0/8")), "newer");
+
+        const auto &ctrie = trie;
+        EXPECT_EQ(ctrie.find(IpPrefix("10.0.0.0/8"))->second, "newer");
+    }
+
+    TEST(RouteTrie, SmallerThanMap)
+    {
+        /* Red-black tree node header of std::map */
+        const size_t mapNodeOverhead = 4 * sizeof(void *);
+
+        mt19937 rng(2);
+        RouteTrie<NextHopGroupKey> trie;
+        map<IpPrefix, NextHopGroupKey> reference;
+        for (size_t i = 0; i < 100000; i++)
+        {
+            ip_addr_t ip;
+            memset(&ip, 0, sizeof(ip));
+            ip.family = AF_INET;
+            ip.ip_addr.ipv4_addr = static_cast<uint32_t>(rng());
+            auto prefix = makePrefix(ip, 16 + static_cast<int>(rng() % 9));
+            trie[prefix] = NextHopGroupKey();
+            reference[prefix] = NextHopGroupKey();
+        }
+
+        ASSERT_EQ(trie.size(), reference.size());
+        size_t mapBytes = reference.size() * (sizeof(map<IpPrefix, NextHopGroupKey>::value_type) + mapNodeOverhead);
+        EXPECT_LT(trie.bytes(), mapBytes);
+    }
+}
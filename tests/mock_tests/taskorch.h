@@ -0,0 +1,109 @@
+#pragma once
+
+#include "orch.h"
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mock_orch
+{
+    /* Consumer table popping the tuples queued by the test instead of reading redis */
+    class QueueConsumerTable : public swss::ConsumerTableBase
+    {
+    public:
+        QueueConsumerTable(swss::DBConnector *db, const std::string &tableName, int popBatchSize, int pri) :
+            swss::ConsumerTableBase(db, tableName, popBatchSize, pri)
+        {
+        }
+
+        void pops(std::deque<swss::KeyOpFieldsValuesTuple> &vkco, const std::string &prefix = swss::EMPTY_PREFIX) override
+        {
+            vkco.clear();
+            while (!m_queue.empty() && vkco.size() < static_cast<size_t>(POP_BATCH_SIZE))
+            {
+                vkco.push_back(std::move(m_queue.front()));
+                m_queue.pop_front();
+            }
+        }
+
+        std::deque<swss::KeyOpFieldsValuesTuple> m_queue;
+    };
+
+    /*
+     * Orch draining at most chunk tasks of its consumer on each doTask(), every task
+     * costing cost of busy time, and logging its runs
+     */
+    class TaskOrch : public Orch
+    {
+    public:
+        TaskOrch(swss::DBConnector *db, const std::string &tableName, int pri, size_t chunk,
+                 std::chrono::nanoseconds cost, std::vector<std::string> &runLog) :
+            Orch(std::vector<TableConnector>()),
+            m_tableName(tableName),
+            m_chunk(chunk),
+            m_cost(cost),
+            m_runLog(runLog)
+        {
+            m_table = new QueueConsumerTable(db, tableName, 128, pri);
+            addExecutor(new Consumer(m_table, this, tableName));
+        }
+
+        void doTask(Consumer &consumer) override
+        {
+            m_runLog.push_back(m_tableName);
+
+            size_t n = 0;
+            auto it = consumer.m_toSync.begin();
+            while (it != consumer.m_toSync.end() && n++ < m_chunk)
+            {
+                auto end = sched_clock_t::now() + m_cost;
+                while (sched_clock_t::now() < end);
+
+                m_handled++;
+                it = consumer.m_toSync.erase(it);
+            }
+        }
+
+        /* Tasks added straight to m_toSync */
+        void addTasks(size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                getConsumer()->addToSync(nextTask());
+            }
+        }
+
+        /* Tasks left in the table, to be popped */
+        void queueTasks(size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                m_table->m_queue.push_back(nextTask());
+            }
+        }
+
+        Consumer *getConsumer()
+        {
+            return dynamic_cast<Consumer *>(getExecutor(m_tableName));
+        }
+
+        size_t getPending() const { return m_added - m_handled; }
+
+    private:
+        std::string m_tableName;
+        size_t m_chunk;
+        std::chrono::nanoseconds m_cost;
+        std::vector<std::string> &m_runLog;
+        QueueConsumerTable *m_table;
+        size_t m_added = 0;
+        size_t m_handled = 0;
+
+        swss::KeyOpFieldsValuesTuple nextTask()
+        {
+            return swss::KeyOpFieldsValuesTuple(
+                { m_tableName + ":" + std::to_string(m_added++), SET_COMMAND, { { "field", "value" } } });
+        }
+    };
+}
@@ -0,0 +1,47 @@
+#include "ut_helper.h"
+#include "timingwheel.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace timingwheel_bench
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    typedef TimingWheel<uint32_t> Wheel;
+
+    TEST(TimingWheelBench, Aging)
+    {
+        /* 100k flows queried every 2160 ticks, as TCP NAPT entries on 5 secs ticks, over a day */
+        const uint32_t flowCount = 100000;
+        const uint64_t period = 2160;
+        const uint64_t tickCount = 17280;
+
+        Wheel wheel;
+        for (uint32_t i = 0; i < flowCount; i++)
+        {
+            wheel.schedule(i, 1 + i % period);
+        }
+
+        auto begin = steady_clock::now();
+        size_t queried = 0;
+        Wheel::Timer timer;
+        for (uint64_t tick = 1; tick <= tickCount; tick++)
+        {
+            wheel.advance(tick);
+            while (wheel.pop(timer))
+            {
+                wheel.schedule(timer.second, tick + period);
+                queried++;
+            }
+        }
+        duration<double> elapsed = steady_clock::now() - begin;
+
+        ASSERT_EQ(queried, static_cast<size_t>(flowCount) * tickCount / period);
+        ASSERT_EQ(wheel.size(), flowCount);
+        cout << "Aging of " << flowCount << " flows over " << tickCount << " ticks: "
+             << queried / tickCount << " flows due/tick, "
+             << elapsed.count() * 1e6 / static_cast<double>(tickCount) << " usecs/tick" << endl;
+    }
+}
@@ -0,0 +1,117 @@
+#include "ut_helper.h"
+#include "timingwheel.h"
+
+#include <map>
+#include <random>
+
+namespace timingwheel_test
+{
+    using namespace std;
+
+    typedef TimingWheel<uint32_t> Wheel;
+
+    /* Moves the wheel to 'tick' and pops all the keys due */
+    vector<Wheel::Timer> popAll(Wheel &wheel, uint64_t tick)
+    {
+        vector<Wheel::Timer> timers;
+        Wheel::Timer timer;
+
+        wheel.advance(tick);
+        while (wheel.pop(timer))
+        {
+            timers.push_back(timer);
+        }
+        return timers;
+    }
+
+    TEST(TimingWheelTest, DueOnTheirTick)
+    {
+        Wheel wheel(1000);
+
+        /* On every level, on the edges of the slots, and beyond the span of the top level */
+        vector<uint64_t> ticks = { 1001, 1063, 1064, 1065, 1000 + 4095, 1000 + 4096, 1000 + 262143,
+                                   1000 + 262144, 1000 + 16777215, 1000 + 16777216, 1000 + 40000000 };
+        for (uint32_t i = 0; i < ticks.size(); i++)
+        {
+            wheel.schedule(i, ticks[i]);
+        }
+        ASSERT_EQ(wheel.size(), ticks.size());
+        ASSERT_EQ(wheel.backlog(), 0u);
+
+        for (uint32_t i = 0; i < ticks.size(); i++)
+        {
+            ASSERT_TRUE(popAll(wheel, ticks[i] - 1).empty());
+
+            auto timers = popAll(wheel, ticks[i]);
+            ASSERT_EQ(timers.size(), 1u);
+            ASSERT_EQ(timers[0].first, ticks[i]);
+            ASSERT_EQ(timers[0].second, i);
+        }
+        ASSERT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(TimingWheelTest, DueRightAway)
+    {
+        Wheel wheel(100);
+        wheel.schedule(1, 100);
+        wheel.schedule(2, 50);
+        ASSERT_EQ(wheel.backlog(), 2u);
+
+        /* Keys due are popped one at a time, the others wait for the next pop */
+        Wheel::Timer timer;
+        ASSERT_TRUE(wheel.pop(timer));
+        ASSERT_EQ(timer, Wheel::Timer(100, 1));
+        ASSERT_EQ(wheel.backlog(), 1u);
+
+        wheel.schedule(3, 101);
+        wheel.advance(101);
+        ASSERT_EQ(wheel.backlog(), 2u);
+        ASSERT_TRUE(wheel.pop(timer));
+        ASSERT_EQ(timer, Wheel::Timer(50, 2));
+        ASSERT_TRUE(wheel.pop(timer));
+        ASSERT_EQ(timer, Wheel::Timer(101, 3));
+        ASSERT_FALSE(wheel.pop(timer));
+
+        /* An empty wheel jumps to the tick */
+        wheel.advance(1ULL << 40);
+        ASSERT_EQ(wheel.getTick(), 1ULL << 40);
+
+        wheel.schedule(4, (1ULL << 40) + 10);
+        wheel.schedule(5, (1ULL << 40) + 100000);
+        wheel.clear();
+        ASSERT_EQ(wheel.size(), 0u);
+        ASSERT_TRUE(popAll(wheel, (1ULL << 40) + 200000).empty());
+    }
+
+    TEST(TimingWheelTest, RandomTicks)
+    {
+        mt19937_64 random(42);
+        Wheel wheel(random() % 1000000);
+        map<uint32_t, uint64_t> due;
+
+        for (uint32_t i = 0; i < 20000; i++)
+        {
+            uint64_t tick = wheel.getTick() + random() % (1ULL << (random() % 26));
+            wheel.schedule(i, tick);
+            due[i] = tick;
+        }
+
+        /* Every key is popped on the first advance to its tick or after, the first due first */
+        while (wheel.size())
+        {
+            uint64_t tick = wheel.getTick() + 1 + random() % 5000;
+            uint64_t last = 0;
+
+            for (auto &timer : popAll(wheel, tick))
+            {
+                ASSERT_EQ(due[timer.second], timer.first);
+                ASSERT_LE(timer.first, tick);
+                ASSERT_GT(timer.first + 5000, tick);
+                ASSERT_LE(last, timer.first);
+                last = timer.first;
+                due.erase(timer.second);
+            }
+        }
+        ASSERT_TRUE(due.empty());
+    }
+}
@@ -0,0 +1,196 @@
+#include "ut_helper.h"
+#include "mock_orchagent_main.h"
+#include "mock_table.h"
+#include "warmsnapshot.h"
+
+#include <unistd.h>
+#include <fstream>
+
+namespace warmsnapshot_test
+{
+    using namespace std;
+
+    class SnapshotOrch : public Orch
+    {
+    public:
+        SnapshotOrch(swss::DBConnector *db, const vector<string> &tableNames) :
+            Orch(db, tableNames)
+        {
+        }
+
+        void doTask(Consumer &consumer) override
+        {
+        }
+
+        Consumer *getConsumer(const string &tableName)
+        {
+            return dynamic_cast<Consumer *>(getExecutor(tableName));
+        }
+    };
+
+    struct WarmSnapshotTest : public ::testing::Test
+    {
+        shared_ptr<swss::DBConnector> m_app_db;
+        string m_path;
+
+        void SetUp() override
+        {
+            ::testing_db::reset();
+            m_app_db = make_shared<swss::DBConnector>("APPL_DB", 0);
+            m_path = "/tmp/warmsnapshot_ut." + to_string(getpid());
+        }
+
+        void TearDown() override
+        {
+            Orch::setRefillSource(nullptr);
+            WarmSnapshot(m_path).remove();
+            ::testing_db::reset();
+        }
+
+        deque<KeyOpFieldsValuesTuple> makeEntries(const string &tableName, size_t count)
+        {
+            deque<KeyOpFieldsValuesTuple> entries;
+            for (size_t i = 0; i < count; i++)
+            {
+                entries.emplace_back(tableName + to_string(i), SET_COMMAND, vector<FieldValueTuple>{
+                    { "nexthop", "10.0.0." + to_string(i) }, { "ifname", "Ethernet0" } });
+            }
+            return entries;
+        }
+
+        void fillTable(const string &tableName, size_t count)
+        {
+            Table table(m_app_db.get(), tableName);
+            for (const auto &entry : makeEntries(tableName, count))
+            {
+                table.set(kfvKey(entry), kfvFieldsValues(entry));
+            }
+        }
+
+        void save(SnapshotOrch &orch, uint64_t id)
+        {
+            WarmSnapshot snapshot(m_path);
+            ASSERT_TRUE(snapshot.begin(id));
+            ASSERT_TRUE(snapshot.add(orch));
+            ASSERT_TRUE(snapshot.commit());
+        }
+
+        void bake(SnapshotOrch &orch, WarmSnapshot &snapshot)
+        {
+            Orch::setRefillSource([&snapshot](const string &table, deque<KeyOpFieldsValuesTuple> &entries) {
+                return snapshot.take(table, entries);
+            });
+            orch.bake();
+            Orch::setRefillSource(nullptr);
+        }
+
+        /* Overwrite the file at offset */
+        void patch(size_t offset, const void *data, size_t len)
+        {
+            fstream file(m_path, ios::in | ios::out | ios::binary);
+            file.seekp(static_cast<streamoff>(offset));
+            file.write(static_cast<const char *>(data), static_cast<streamsize>(len));
+        }
+    };
+
+    TEST_F(WarmSnapshotTest, RefillFromSnapshot)
+    {
+        SnapshotOrch orch(m_app_db.get(), { "SNAP_A_TABLE", "SNAP_B_TABLE" });
+        fillTable("SNAP_A_TABLE", 3);
+        fillTable("SNAP_B_TABLE", 1000);
+        save(orch, 42);
+
+        /* The tables are refilled from the snapshot, not from redis */
+        ::testing_db::reset();
+
+        SnapshotOrch restarted(m_app_db.get(), { "SNAP_A_TABLE", "SNAP_B_TABLE" });
+        WarmSnapshot snapshot(m_path);
+        ASSERT_TRUE(snapshot.load(42));
+        ASSERT_EQ(snapshot.getTableCount(), 2u);
+
+        bake(restarted, snapshot);
+
+        ASSERT_EQ(restarted.getConsumer("SNAP_A_TABLE")->m_toSync.size(), 3u);
+        ASSERT_EQ(restarted.getConsumer("SNAP_B_TABLE")->m_toSync.size(), 1000u);
+        ASSERT_EQ(snapshot.getTableCount(), 0u);
+
+        auto &entry = restarted.getConsumer("SNAP_B_TABLE")->m_toSync.find("SNAP_B_TABLE7")->second;
+        ASSERT_EQ(kfvOp(entry), SET_COMMAND);
+        vector<FieldValueTuple> expected = { { "nexthop", "10.0.0.7" }, { "ifname", "Ethernet0" } };
+        ASSERT_EQ(kfvFieldsValues(entry), expected);
+    }
+
+    TEST_F(WarmSnapshotTest, SavedOneKeyAtATime)
+    {
+        Consumer::setRefillChunkSize(0);
+
+        SnapshotOrch orch(m_app_db.get(), { "SNAP_A_TABLE" });
+        fillTable("SNAP_A_TABLE", 5);
+
+        /* Pending in m_toSync but not in the table, left out of the snapshot */
+        orch.getConsumer("SNAP_A_TABLE")->addToSync(KeyOpFieldsValuesTuple("SNAP_A_TABLE9", SET_COMMAND, { { "ifname", "Ethernet4" } }));
+
+        save(orch, 3);
+        Consumer::setRefillChunkSize(1024);
+        ::testing_db::reset();
+
+        SnapshotOrch restarted(m_app_db.get(), { "SNAP_A_TABLE" });
+        WarmSnapshot snapshot(m_path);
+        ASSERT_TRUE(snapshot.load(3));
+        bake(restarted, snapshot);
+
+        auto &toSync = restarted.getConsumer("SNAP_A_TABLE")->m_toSync;
+        ASSERT_EQ(toSync.size(), 5u);
+        vector<FieldValueTuple> expected = { { "nexthop", "10.0.0.1" }, { "ifname", "Ethernet0" } };
+        ASSERT_EQ(kfvFieldsValues(toSync.find("SNAP_A_TABLE1")->second), expected);
+        ASSERT_TRUE(toSync.find("SNAP_A_TABLE9") == toSync.end());
+    }
+
+    TEST_F(WarmSnapshotTest, MissingTableReadFromRedis)
+    {
+        SnapshotOrch before(m_app_db.get(), { "SNAP_A_TABLE" });
+        fillTable("SNAP_A_TABLE", 3);
+        save(before, 1);
+        ::testing_db::reset();
+
+        SnapshotOrch after(m_app_db.get(), { "SNAP_A_TABLE", "SNAP_B_TABLE" });
+        fillTable("SNAP_B_TABLE", 5);
+
+        WarmSnapshot snapshot(m_path);
+        ASSERT_TRUE(snapshot.load(1));
+
+        bake(after, snapshot);
+
+        ASSERT_EQ(after.getConsumer("SNAP_A_TABLE")->m_toSync.size(), 3u);
+        ASSERT_EQ(after.getConsumer("SNAP_B_TABLE")->m_toSync.size(), 5u);
+    }
+
+    TEST_F(WarmSnapshotTest, Incompatible)
+    {
+        SnapshotOrch orch(m_app_db.get(), { "SNAP_A_TABLE" });
+        fillTable("SNAP_A_TABLE", 10);
+        save(orch, 7);
+
+        WarmSnapshot snapshot(m_path);
+
+        /* Snapshot of another freeze */
+        ASSERT_FALSE(snapshot.load(8));
+
+        /* Another format version, after the magic and the byte order */
+        uint32_t version = WarmSnapshot::VERSION + 1;
+        patch(12, &version, sizeof(version));
+        ASSERT_FALSE(snapshot.load(7));
+
+        version = WarmSnapshot::VERSION;
+        patch(12, &version, sizeof(version));
+        ASSERT_TRUE(snapshot.load(7));
+
+        /* Corrupted payload */
+        patch(100, "x", 1);
+        ASSERT_FALSE(snapshot.load(7));
+
+        /* No snapshot */
+        snapshot.remove();
+        ASSERT_FALSE(snapshot.load(7));
+    }
+}
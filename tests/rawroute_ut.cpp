@@ -0,0 +1,423 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <netlink/route/route.h>
+#include <netlink/route/nexthop.h>
+#include "fpmsyncd/rawroute.h"
+
+using namespace std;
+using namespace swss;
+
+namespace rawroute_test
+{
+    /* Next hop interface names, ifindex 0 has none */
+    bool ifName(int ifindex, char *name, size_t len)
+    {
+        if (ifindex <= 0)
+        {
+            return false;
+        }
+        snprintf(name, len, "Ethernet%d", ifindex);
+        return true;
+    }
+
+    /* Route message built attribute by attribute */
+    class RouteMsg
+    {
+    public:
+        RouteMsg(uint16_t type, uint8_t family, uint8_t dstLen, uint8_t rtmType = RTN_UNICAST) :
+            m_family(family)
+        {
+            nlmsghdr *h = hdr();
+            h->nlmsg_len = NLMSG_LENGTH(sizeof(rtmsg));
+            h->nlmsg_type = type;
+
+            rtmsg *rtm = (rtmsg *)NLMSG_DATA(h);
+            rtm->rtm_family = family;
+            rtm->rtm_dst_len = dstLen;
+            rtm->rtm_table = RT_TABLE_MAIN;
+            rtm->rtm_protocol = RTPROT_BGP;
+            rtm->rtm_scope = RT_SCOPE_UNIVERSE;
+            rtm->rtm_type = rtmType;
+        }
+
+        nlmsghdr *hdr()
+        {
+            return (nlmsghdr *)m_buf;
+        }
+
+        void add(uint16_t type, const void *data, size_t len)
+        {
+            append(hdr()->nlmsg_len, type, data, len);
+        }
+
+        void addAddr(uint16_t type, const char *addr)
+        {
+            uint8_t buf[16];
+            ASSERT_EQ(inet_pton(m_family, addr, buf), 1);
+            add(type, buf, m_family == AF_INET ? 4 : 16);
+        }
+
+        void addU32(uint16_t type, uint32_t value)
+        {
+            add(type, &value, sizeof(value));
+        }
+
+        /* Next hops of RTA_MULTIPATH, added by endMultipath() */
+        void addNextHop(const char *gw, int ifindex, uint8_t hops)
+        {
+            rtnexthop rtnh = {};
+            rtnh.rtnh_len = sizeof(rtnh);
+            rtnh.rtnh_hops = hops;
+            rtnh.rtnh_ifindex = ifindex;
+
+            uint32_t start = m_multipathLen;
+            memcpy(m_multipath + start, &rtnh, sizeof(rtnh));
+            m_multipathLen += (uint32_t)sizeof(rtnh);
+
+            if (gw)
+            {
+                uint8_t buf[16];
+                ASSERT_EQ(inet_pton(m_family, gw, buf), 1);
+                append(m_multipathLen, RTA_GATEWAY, buf, m_family == AF_INET ? 4 : 16, m_multipath);
+            }
+            ((rtnexthop *)(m_multipath + start))->rtnh_len = (unsigned short)(m_multipathLen - start);
+        }
+
+        void endMultipath()
+        {
+            add(RTA_MULTIPATH, m_multipath, m_multipathLen);
+        }
+
+    private:
+        alignas(NLMSG_ALIGNTO) char m_buf[4096] = {};
+        alignas(RTA_ALIGNTO) char m_multipath[1024] = {};
+        uint32_t m_multipathLen = 0;
+        uint8_t m_family;
+
+        void append(uint32_t &len, uint16_t type, const void *data, size_t dataLen, char *base = nullptr)
+        {
+            rtattr *rta = (rtattr *)((base ? base : m_buf) + RTA_ALIGN(len));
+            rta->rta_type = type;
+            rta->rta_len = (unsigned short)RTA_LENGTH(dataLen);
+            memcpy(RTA_DATA(rta), data, dataLen);
+            len = RTA_ALIGN(len) + RTA_ALIGN(rta->rta_len);
+        }
+    };
+
+    struct Route
+    {
+        string prefix;
+        uint32_t table;
+        string nexthops;
+        string ifnames;
+        string weights;
+    };
+
+    /* The route as fpmsyncd reads it through libnl, see RouteSync::onRouteMsg() */
+    Route libnlRoute(nlmsghdr *h)
+    {
+        Route r;
+        rtnl_route *route = nullptr;
+        EXPECT_GE(rtnl_route_parse(h, &route), 0);
+        if (!route)
+        {
+            return r;
+        }
+
+        char buf[INET6_ADDRSTRLEN + 8];
+        nl_addr2str(rtnl_route_get_dst(route), buf, sizeof(buf));
+        r.prefix = buf;
+        r.table = rtnl_route_get_table(route);
+
+        bool weighted = true;
+        int count = rtnl_route_get_nnexthops(route);
+        for (int i = 0; i < count; i++)
+        {
+            rtnl_nexthop *nh = rtnl_route_nexthop_n(route, i);
+            string sep = i ? "," : "";
+
+            nl_addr *gw = rtnl_route_nh_get_gateway(nh);
+            if (gw)
+            {
+                nl_addr2str(gw, buf, sizeof(buf));
+                r.nexthops += sep + buf;
+            }
+            else
+            {
+                r.nexthops += sep + (rtnl_route_get_family(route) == AF_INET ? "0.0.0.0" : "::");
+            }
+
+            char name[IFNAMSIZ];
+            if (!ifName(rtnl_route_nh_get_ifindex(nh), name, sizeof(name)))
+            {
+                strcpy(name, "unknown");
+            }
+            r.ifnames += sep + name;
+
+            uint8_t weight = rtnl_route_nh_get_weight(nh);
+            weighted = weighted && weight;
+            if (weighted)
+            {
+                r.weights += sep + to_string(weight + 1);
+            }
+        }
+        if (!weighted)
+        {
+            r.weights.clear();
+        }
+
+        rtnl_route_put(route);
+        return r;
+    }
+
+    void expectSameAsLibnl(RouteMsg &msg)
+    {
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(msg.hdr()));
+        raw.formatNextHops(ifName);
+
+        Route expected = libnlRoute(msg.hdr());
+        EXPECT_EQ(raw.nlmsg_type, msg.hdr()->nlmsg_type);
+        EXPECT_EQ(string(raw.prefix), expected.prefix);
+        EXPECT_EQ(raw.table, expected.table);
+        EXPECT_EQ(raw.nexthops, expected.nexthops);
+        EXPECT_EQ(raw.ifnames, expected.ifnames);
+        EXPECT_EQ(raw.weights, expected.weights);
+    }
+
+    TEST(RawRoute, V4Gateway)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET, 24);
+        msg.addAddr(RTA_DST, "10.1.1.0");
+        msg.addAddr(RTA_GATEWAY, "10.0.0.1");
+        msg.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(msg);
+
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(msg.hdr()));
+        raw.formatNextHops(ifName);
+        EXPECT_STREQ(raw.prefix, "10.1.1.0/24");
+        EXPECT_EQ(raw.nexthops, "10.0.0.1");
+        EXPECT_EQ(raw.ifnames, "Ethernet4");
+        EXPECT_EQ(raw.weights, "");
+    }
+
+    TEST(RawRoute, V6Gateway)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET6, 64);
+        msg.addAddr(RTA_DST, "2001:db8:1::");
+        msg.addAddr(RTA_GATEWAY, "fe80::1");
+        msg.addU32(RTA_OIF, 8);
+        expectSameAsLibnl(msg);
+    }
+
+    TEST(RawRoute, HostRoutes)
+    {
+        RouteMsg v4(RTM_NEWROUTE, AF_INET, 32);
+        v4.addAddr(RTA_DST, "10.1.1.1");
+        v4.addAddr(RTA_GATEWAY, "10.0.0.1");
+        v4.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(v4);
+
+        RouteMsg v6(RTM_NEWROUTE, AF_INET6, 128);
+        v6.addAddr(RTA_DST, "2001:db8::1");
+        v6.addAddr(RTA_GATEWAY, "fe80::1");
+        v6.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(v6);
+
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(v6.hdr()));
+        EXPECT_STREQ(raw.prefix, "2001:db8::1");
+    }
+
+    TEST(RawRoute, DefaultRoute)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET, 0);
+        msg.addAddr(RTA_DST, "0.0.0.0");
+        msg.addAddr(RTA_GATEWAY, "10.0.0.1");
+        msg.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(msg);
+    }
+
+    TEST(RawRoute, VrfTable)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET, 24);
+        msg.addAddr(RTA_DST, "10.1.1.0");
+        msg.addU32(RTA_TABLE, 1001);
+        msg.addAddr(RTA_GATEWAY, "10.0.0.1");
+        msg.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(msg);
+
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(msg.hdr()));
+        EXPECT_EQ(raw.table, 1001u);
+    }
+
+    TEST(RawRoute, Multipath)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET, 24);
+        msg.addAddr(RTA_DST, "10.1.1.0");
+        msg.addNextHop("10.0.0.1", 4, 0);
+        msg.addNextHop("10.0.0.2", 8, 0);
+        msg.addNextHop("10.0.0.3", 12, 0);
+        msg.endMultipath();
+        expectSameAsLibnl(msg);
+
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(msg.hdr()));
+        raw.formatNextHops(ifName);
+        EXPECT_EQ(raw.nexthops, "10.0.0.1,10.0.0.2,10.0.0.3");
+        EXPECT_EQ(raw.ifnames, "Ethernet4,Ethernet8,Ethernet12");
+        EXPECT_EQ(raw.weights, "");
+    }
+
+    TEST(RawRoute, MultipathWeights)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET6, 48);
+        msg.addAddr(RTA_DST, "2001:db8:1::");
+        msg.addNextHop("fe80::1", 4, 1);
+        msg.addNextHop("fe80::2", 8, 3);
+        msg.endMultipath();
+        expectSameAsLibnl(msg);
+
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(msg.hdr()));
+        raw.formatNextHops(ifName);
+        EXPECT_EQ(raw.weights, "2,4");
+
+        /* One next hop without weight drops them all */
+        RouteMsg partial(RTM_NEWROUTE, AF_INET, 24);
+        partial.addAddr(RTA_DST, "10.1.1.0");
+        partial.addNextHop("10.0.0.1", 4, 1);
+        partial.addNextHop("10.0.0.2", 8, 0);
+        partial.endMultipath();
+        expectSameAsLibnl(partial);
+    }
+
+    TEST(RawRoute, OifOnly)
+    {
+        RouteMsg v4(RTM_NEWROUTE, AF_INET, 24);
+        v4.addAddr(RTA_DST, "10.1.1.0");
+        v4.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(v4);
+
+        RouteMsg v6(RTM_NEWROUTE, AF_INET6, 64);
+        v6.addAddr(RTA_DST, "2001:db8:1::");
+        v6.addU32(RTA_OIF, 4);
+        expectSameAsLibnl(v6);
+
+        /* Multipath next hops without gateway */
+        RouteMsg multipath(RTM_NEWROUTE, AF_INET, 24);
+        multipath.addAddr(RTA_DST, "10.1.1.0");
+        multipath.addNextHop(nullptr, 4, 0);
+        multipath.addNextHop(nullptr, 8, 0);
+        multipath.endMultipath();
+        expectSameAsLibnl(multipath);
+    }
+
+    TEST(RawRoute, Delete)
+    {
+        RouteMsg msg(RTM_DELROUTE, AF_INET, 24);
+        msg.addAddr(RTA_DST, "10.1.1.0");
+        expectSameAsLibnl(msg);
+
+        RouteMsg vrf(RTM_DELROUTE, AF_INET6, 64);
+        vrf.addAddr(RTA_DST, "2001:db8:1::");
+        vrf.addU32(RTA_TABLE, 1001);
+        expectSameAsLibnl(vrf);
+    }
+
+    TEST(RawRoute, Blackhole)
+    {
+        RouteMsg msg(RTM_NEWROUTE, AF_INET, 24, RTN_BLACKHOLE);
+        msg.addAddr(RTA_DST, "10.1.1.0");
+        expectSameAsLibnl(msg);
+
+        RawRoute raw;
+        ASSERT_TRUE(raw.parse(msg.hdr()));
+        EXPECT_EQ(raw.rtm_type, RTN_BLACKHOLE);
+    }
+
+    /* The messages libnl may read differently are left to it */
+    TEST(RawRoute, Fallbacks)
+    {
+        RawRoute raw;
+
+        RouteMsg noDst(RTM_NEWROUTE, AF_INET, 0);
+        noDst.addAddr(RTA_GATEWAY, "10.0.0.1");
+        noDst.addU32(RTA_OIF, 4);
+        EXPECT_FALSE(raw.parse(noDst.hdr()));
+
+        RouteMsg via(RTM_NEWROUTE, AF_INET, 24);
+        via.addAddr(RTA_DST, "10.1.1.0");
+        uint8_t viaAddr[18] = { AF_INET6 & 0xff, 0, 0xfe, 0x80 };
+        via.add(RTA_VIA, viaAddr, sizeof(viaAddr));
+        via.addU32(RTA_OIF, 4);
+        EXPECT_FALSE(raw.parse(via.hdr()));
+
+        RouteMsg noNextHop(RTM_NEWROUTE, AF_INET, 24);
+        noNextHop.addAddr(RTA_DST, "10.1.1.0");
+        EXPECT_FALSE(raw.parse(noNextHop.hdr()));
+
+        RouteMsg mixed(RTM_NEWROUTE, AF_INET, 24);
+        mixed.addAddr(RTA_DST, "10.1.1.0");
+        mixed.addAddr(RTA_GATEWAY, "10.0.0.1");
+        mixed.addNextHop("10.0.0.2", 8, 0);
+        mixed.endMultipath();
+        EXPECT_FALSE(raw.parse(mixed.hdr()));
+
+        RouteMsg other(RTM_NEWLINK, AF_INET, 24);
+        other.addAddr(RTA_DST, "10.1.1.0");
+        EXPECT_FALSE(raw.parse(other.hdr()));
+
+        RouteMsg family(RTM_NEWROUTE, AF_MPLS, 20);
+        uint32_t label = 0;
+        family.add(RTA_DST, &label, sizeof(label));
+        EXPECT_FALSE(raw.parse(family.hdr()));
+    }
+
+    TEST(RawRoute, BadLengths)
+    {
+        RawRoute raw;
+
+        RouteMsg dstLen(RTM_NEWROUTE, AF_INET, 33);
+        dstLen.addAddr(RTA_DST, "10.1.1.1");
+        dstLen.addU32(RTA_OIF, 4);
+        EXPECT_FALSE(raw.parse(dstLen.hdr()));
+
+        RouteMsg dst(RTM_NEWROUTE, AF_INET, 24);
+        uint8_t shortDst[3] = { 10, 1, 1 };
+        dst.add(RTA_DST, shortDst, sizeof(shortDst));
+        dst.addU32(RTA_OIF, 4);
+        EXPECT_FALSE(raw.parse(dst.hdr()));
+
+        RouteMsg gateway(RTM_NEWROUTE, AF_INET6, 64);
+        gateway.addAddr(RTA_DST, "2001:db8:1::");
+        uint8_t v4Gateway[4] = { 10, 0, 0, 1 };
+        gateway.add(RTA_GATEWAY, v4Gateway, sizeof(v4Gateway));
+        EXPECT_FALSE(raw.parse(gateway.hdr()));
+
+        RouteMsg table(RTM_NEWROUTE, AF_INET, 24);
+        table.addAddr(RTA_DST, "10.1.1.0");
+        uint16_t shortTable = 1001;
+        table.add(RTA_TABLE, &shortTable, sizeof(shortTable));
+        table.addU32(RTA_OIF, 4);
+        EXPECT_FALSE(raw.parse(table.hdr()));
+
+        /* Next hop longer than the multipath attribute */
+        RouteMsg multipath(RTM_NEWROUTE, AF_INET, 24);
+        multipath.addAddr(RTA_DST, "10.1.1.0");
+        rtnexthop rtnh = {};
+        rtnh.rtnh_len = sizeof(rtnh) + 8;
+        rtnh.rtnh_ifindex = 4;
+        multipath.add(RTA_MULTIPATH, &rtnh, sizeof(rtnh));
+        EXPECT_FALSE(raw.parse(multipath.hdr()));
+
+        /* Truncated message */
+        RouteMsg truncated(RTM_NEWROUTE, AF_INET, 24);
+        truncated.hdr()->nlmsg_len = NLMSG_LENGTH(sizeof(rtmsg) - 1);
+        EXPECT_FALSE(raw.parse(truncated.hdr()));
+    }
+}
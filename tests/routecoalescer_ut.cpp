@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "fpmsyncd/routecoalescer.h"
+
+using namespace std;
+using namespace swss;
+
+namespace routecoalescer_test
+{
+    typedef tuple<string, string, vector<FieldValueTuple>> Write;
+
+    vector<Write> flush(RouteCoalescer &routes)
+    {
+        vector<Write> writes;
+        size_t written = routes.flush([&writes](const string &key, const string &op,
+                                                const vector<FieldValueTuple> &fvVector) {
+            writes.emplace_back(key, op, fvVector);
+        });
+        EXPECT_EQ(written, writes.size());
+        EXPECT_TRUE(routes.empty());
+        return writes;
+    }
+
+    const vector<FieldValueTuple> blackhole = { { "blackhole", "true" } };
+    const vector<FieldValueTuple> nexthop1 = { { "nexthop", "10.0.0.1" }, { "ifname", "Ethernet0" } };
+    const vector<FieldValueTuple> nexthop2 = { { "nexthop", "10.0.0.2" }, { "ifname", "Ethernet4" } };
+
+    TEST(RouteCoalescer, SetReplacesSet)
+    {
+        RouteCoalescer routes(1024, 1000);
+
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1);
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop2);
+        EXPECT_EQ(routes.size(), 1u);
+        EXPECT_EQ(routes.getUpdates(), 2u);
+        EXPECT_EQ(routes.getCoalesced(), 1u);
+
+        EXPECT_EQ(flush(routes), (vector<Write>{ Write("1.1.1.0/24", SET_COMMAND, nexthop2) }));
+    }
+
+    TEST(RouteCoalescer, SetDelSet)
+    {
+        RouteCoalescer routes(1024, 1000);
+
+        /* The fields of the first set must not be merged into the last one */
+        routes.add("1.1.1.0/24", SET_COMMAND, blackhole);
+        routes.add("1.1.1.0/24", DEL_COMMAND, {});
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1);
+        EXPECT_EQ(routes.getCoalesced(), 2u);
+
+        EXPECT_EQ(flush(routes), (vector<Write>{
+            Write("1.1.1.0/24", DEL_COMMAND, {}),
+            Write("1.1.1.0/24", SET_COMMAND, nexthop1) }));
+    }
+
+    TEST(RouteCoalescer, DelSet)
+    {
+        RouteCoalescer routes(1024, 1000);
+
+        routes.add("1.1.1.0/24", DEL_COMMAND, {});
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1);
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop2);
+
+        /* The delete is kept ahead of the last set */
+        EXPECT_EQ(flush(routes), (vector<Write>{
+            Write("1.1.1.0/24", DEL_COMMAND, {}),
+            Write("1.1.1.0/24", SET_COMMAND, nexthop2) }));
+    }
+
+    TEST(RouteCoalescer, DelSetDel)
+    {
+        RouteCoalescer routes(1024, 1000);
+
+        routes.add("1.1.1.0/24", DEL_COMMAND, {});
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1);
+        routes.add("1.1.1.0/24", DEL_COMMAND, {});
+
+        EXPECT_EQ(flush(routes), (vector<Write>{ Write("1.1.1.0/24", DEL_COMMAND, {}) }));
+    }
+
+    TEST(RouteCoalescer, FlushedDeleteNotKept)
+    {
+        RouteCoalescer routes(1024, 1000);
+
+        routes.add("1.1.1.0/24", DEL_COMMAND, {});
+        EXPECT_EQ(flush(routes), (vector<Write>{ Write("1.1.1.0/24", DEL_COMMAND, {}) }));
+
+        /* Written already, the delete is not written again with the next set */
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1);
+        EXPECT_EQ(flush(routes), (vector<Write>{ Write("1.1.1.0/24", SET_COMMAND, nexthop1) }));
+    }
+
+    TEST(RouteCoalescer, ArrivalOrder)
+    {
+        RouteCoalescer routes(1024, 1000);
+
+        routes.add("2.2.2.0/24", SET_COMMAND, nexthop1);
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1);
+        routes.add("2.2.2.0/24", DEL_COMMAND, {});
+        routes.add("3.3.3.0/24", DEL_COMMAND, {});
+
+        EXPECT_EQ(flush(routes), (vector<Write>{
+            Write("2.2.2.0/24", DEL_COMMAND, {}),
+            Write("1.1.1.0/24", SET_COMMAND, nexthop1),
+            Write("3.3.3.0/24", DEL_COMMAND, {}) }));
+    }
+
+    TEST(RouteCoalescer, FlushKeys)
+    {
+        RouteCoalescer routes(3, 1000000);
+        auto now = RouteCoalescer::clock::now();
+
+        EXPECT_FALSE(routes.isFlushDue(now));
+
+        /* Prefixes count, not updates */
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1, now);
+        routes.add("1.1.1.0/24", DEL_COMMAND, {}, now);
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop2, now);
+        routes.add("2.2.2.0/24", SET_COMMAND, nexthop1, now);
+        EXPECT_FALSE(routes.isFlushDue(now));
+
+        routes.add("3.3.3.0/24", SET_COMMAND, nexthop1, now);
+        EXPECT_TRUE(routes.isFlushDue(now));
+
+        flush(routes);
+        EXPECT_FALSE(routes.isFlushDue(now));
+    }
+
+    TEST(RouteCoalescer, FlushUsec)
+    {
+        RouteCoalescer routes(1024, 1000);
+        auto start = RouteCoalescer::clock::now();
+
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop1, start);
+        routes.add("2.2.2.0/24", SET_COMMAND, nexthop1, start + chrono::microseconds(900));
+
+        /* Timed from the first update pending */
+        EXPECT_FALSE(routes.isFlushDue(start + chrono::microseconds(999)));
+        EXPECT_TRUE(routes.isFlushDue(start + chrono::microseconds(1000)));
+
+        flush(routes);
+        EXPECT_FALSE(routes.isFlushDue(start + chrono::microseconds(2000)));
+
+        /* The next window starts with the next update */
+        routes.add("1.1.1.0/24", SET_COMMAND, nexthop2, start + chrono::microseconds(2000));
+        EXPECT_FALSE(routes.isFlushDue(start + chrono::microseconds(2500)));
+        EXPECT_TRUE(routes.isFlushDue(start + chrono::microseconds(3000)));
+    }
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "warmrestart/warmRestartHelper.h"
+
+using namespace std;
+using namespace swss;
+
+namespace warmrestarthelper_test
+{
+    typedef WarmStartReconciler::kfvVector kfvVector;
+
+    /* Keys deleted and entries set by a reconciliation */
+    struct Reconciled
+    {
+        set<string> dels;
+        map<string, vector<FieldValueTuple>> sets;
+    };
+
+    Reconciled reconcile(WarmStartReconciler::ReconcileMode mode, const kfvVector &restored,
+                         const kfvVector &refreshed)
+    {
+        WarmStartReconciler reconciler(mode);
+        Reconciled result;
+
+        reconciler.restore(kfvVector(restored));
+        for (const auto &kfv : refreshed)
+        {
+            reconciler.insertRefreshMap(kfv);
+        }
+
+        reconciler.reconcile(
+            [&result](const string &key)
+            {
+                EXPECT_TRUE(result.dels.insert(key).second) << key << " deleted twice";
+            },
+            [&result](const string &key, const vector<FieldValueTuple> &fv)
+            {
+                EXPECT_TRUE(result.sets.emplace(key, fv).second) << key << " set twice";
+            });
+
+        EXPECT_EQ(reconciler.restoredSize(), 0u);
+        return result;
+    }
+
+    /* Both modes hand the exact same keys to del and set */
+    void expectReconciled(const kfvVector &restored, const kfvVector &refreshed,
+                          const set<string> &dels, const map<string, vector<FieldValueTuple>> &sets)
+    {
+        for (auto mode : { WarmStartReconciler::RECONCILE_FULL, WarmStartReconciler::RECONCILE_HASH })
+        {
+            SCOPED_TRACE(mode == WarmStartReconciler::RECONCILE_FULL ? "RECONCILE_FULL" : "RECONCILE_HASH");
+
+            Reconciled result = reconcile(mode, restored, refreshed);
+            EXPECT_EQ(result.dels, dels);
+            EXPECT_EQ(result.sets, sets);
+        }
+    }
+
+    KeyOpFieldsValuesTuple route(const string &prefix, const string &nexthops, const string &ifnames)
+    {
+        return KeyOpFieldsValuesTuple(prefix, SET_COMMAND, { { "nexthop", nexthops }, { "ifname", ifnames } });
+    }
+
+    KeyOpFieldsValuesTuple routeDel(const string &prefix)
+    {
+        return KeyOpFieldsValuesTuple(prefix, DEL_COMMAND, {});
+    }
+
+    const kfvVector restored = {
+        route("1.1.1.0/24", "10.0.0.1,10.0.0.2", "Ethernet0,Ethernet4"),
+        route("2.2.2.0/24", "10.0.0.1", "Ethernet0"),
+        route("3.3.3.0/24", "10.0.0.2", "Ethernet4"),
+    };
+
+    TEST(WarmStartReconciler, Unchanged)
+    {
+        expectReconciled(restored, restored, {}, {});
+    }
+
+    TEST(WarmStartReconciler, ReorderedNextHops)
+    {
+        kfvVector refreshed = restored;
+        refreshed[0] = route("1.1.1.0/24", "10.0.0.2,10.0.0.1", "Ethernet4,Ethernet0");
+
+        /* Fields in another order too */
+        refreshed[1] = KeyOpFieldsValuesTuple("2.2.2.0/24", SET_COMMAND,
+                                              { { "ifname", "Ethernet0" }, { "nexthop", "10.0.0.1" } });
+
+        expectReconciled(restored, refreshed, {}, {});
+    }
+
+    TEST(WarmStartReconciler, Changed)
+    {
+        kfvVector refreshed = restored;
+        refreshed[0] = route("1.1.1.0/24", "10.0.0.1,10.0.0.3", "Ethernet0,Ethernet8");
+
+        expectReconciled(restored, refreshed, {},
+                         { { "1.1.1.0/24", kfvFieldsValues(refreshed[0]) } });
+    }
+
+    TEST(WarmStartReconciler, Stale)
+    {
+        kfvVector refreshed = { restored[0] };
+
+        expectReconciled(restored, refreshed, { "2.2.2.0/24", "3.3.3.0/24" }, {});
+    }
+
+    TEST(WarmStartReconciler, BrandNew)
+    {
+        kfvVector refreshed = restored;
+        refreshed.push_back(route("4.4.4.0/24", "10.0.0.1", "Ethernet0"));
+
+        expectReconciled(restored, refreshed, {},
+                         { { "4.4.4.0/24", kfvFieldsValues(refreshed.back()) } });
+    }
+
+    TEST(WarmStartReconciler, RefreshedThenReverted)
+    {
+        kfvVector refreshed = restored;
+        refreshed.push_back(route("1.1.1.0/24", "10.0.0.3", "Ethernet8"));
+        refreshed.push_back(restored[0]);
+
+        expectReconciled(restored, refreshed, {}, {});
+    }
+
+    TEST(WarmStartReconciler, DelRefreshed)
+    {
+        kfvVector refreshed = restored;
+        refreshed.push_back(routeDel("1.1.1.0/24"));
+
+        /* Deleted then set back as restored */
+        refreshed.push_back(routeDel("2.2.2.0/24"));
+        refreshed.push_back(restored[1]);
+
+        /* Deleted then set to another state */
+        refreshed.push_back(routeDel("3.3.3.0/24"));
+        refreshed.push_back(route("3.3.3.0/24", "10.0.0.3", "Ethernet8"));
+
+        /* Never restored, the delete is not pushed */
+        refreshed.push_back(route("4.4.4.0/24", "10.0.0.1", "Ethernet0"));
+        refreshed.push_back(routeDel("4.4.4.0/24"));
+
+        expectReconciled(restored, refreshed, { "1.1.1.0/24" },
+                         { { "3.3.3.0/24", kfvFieldsValues(refreshed[7]) } });
+    }
+
+    TEST(WarmStartReconciler, Mixed)
+    {
+        kfvVector refreshed = {
+            route("1.1.1.0/24", "10.0.0.2,10.0.0.1", "Ethernet4,Ethernet0"),
+            route("3.3.3.0/24", "10.0.0.1", "Ethernet0"),
+            route("5.5.5.0/24", "10.0.0.2", "Ethernet4"),
+        };
+
+        expectReconciled(restored, refreshed, { "2.2.2.0/24" },
+                         { { "3.3.3.0/24", kfvFieldsValues(refreshed[1]) },
+                           { "5.5.5.0/24", kfvFieldsValues(refreshed[2]) } });
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef __WARMRESTART_HASHES__
+#define __WARMRESTART_HASHES__
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "table.h"
+
+namespace swss {
+
+/*
+ * Restored state of a warm-restart reconciliation, kept as a 64-bit content
+ * hash per key instead of the field-value tuples themselves.
+ *
+ * The hash of an entry does not depend on the order of its fields, nor on the
+ * order of the comma-separated items of a value, so that two entries with the
+ * same hash are the ones WarmStartReconciler::compareAllFV() finds equal. Unlike
+ * compareAllFV(), a field missing on either side is a difference.
+ */
+class WarmStartHashes
+{
+public:
+    static uint64_t hashFV(const std::vector<FieldValueTuple> &fv)
+    {
+        uint64_t hash = 0;
+
+        for (const auto &it : fv)
+        {
+            const std::string &value = fvValue(it);
+            uint64_t items = value.size();
+            size_t start = 0;
+
+            while (start <= value.size())
+            {
+                size_t end = value.find(',', start);
+                if (end == std::string::npos)
+                {
+                    end = value.size();
+                }
+                items += mix(fnv(value.data() + start, end - start));
+                start = end + 1;
+            }
+
+            hash += mix(fnv(fvField(it).data(), fvField(it).size()) ^ mix(items));
+        }
+
+        return hash;
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+    }
+
+    void restore(const std::string &key, const std::vector<FieldValueTuple> &fv)
+    {
+        m_entries[key] = Entry{ hashFV(fv), false };
+    }
+
+    /*
+     * Record a refreshed entry. Returns true when it is a set matching the
+     * restored entry: the entry is up to date and needs no update. Otherwise
+     * the entry is to be updated with the refreshed state.
+     */
+    bool refresh(const KeyOpFieldsValuesTuple &kfv)
+    {
+        auto it = m_entries.find(kfvKey(kfv));
+        if (it == m_entries.end())
+        {
+            return false;
+        }
+
+        it->second.upToDate = kfvOp(kfv) == SET_COMMAND &&
+                              it->second.hash == hashFV(kfvFieldsValues(kfv));
+        return it->second.upToDate;
+    }
+
+    bool contains(const std::string &key) const
+    {
+        return m_entries.find(key) != m_entries.end();
+    }
+
+    /*
+     * Empties the restored entries, calling outdated(key) on the ones which
+     * were not refreshed with their restored state.
+     */
+    template <typename Outdated>
+    void sweep(Outdated outdated)
+    {
+        for (auto it = m_entries.begin(); it != m_entries.end(); )
+        {
+            if (!it->second.upToDate)
+            {
+                outdated(it->first);
+            }
+            it = m_entries.erase(it);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t    hash;
+        bool        upToDate;
+    };
+
+    std::unordered_map<std::string, Entry> m_entries;
+
+    /* FNV-1a */
+    static uint64_t fnv(const char *data, size_t len)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < len; i++)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    /* splitmix64 finalizer, so that sums of hashes do not cancel out */
+    static uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+};
+
+}
+
+#endif
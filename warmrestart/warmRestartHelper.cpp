@@ -1,4 +1,5 @@
 #include <cassert>
+#include <iterator>
 #include <sstream>
 
 #include "warmRestartHelper.h"
@@ -11,9 +12,13 @@ WarmStartHelper::WarmStartHelper(RedisPipeline      *pipeline,
                                  ProducerStateTable *syncTable,
                                  const std::string  &syncTableName,
                                  const std::string  &dockerName,
-                                 const std::string  &appName) :
-    m_restorationTable(pipeline, syncTableName, false),
+                                 const std::string  &appName,
+                                 ReconcileMode       mode) :
+    m_pipeline(pipeline),
     m_syncTable(syncTable),
+    m_restorationTable(pipeline, syncTableName, false),
+    m_reconciler(mode),
+    m_reconciledCount(0),
     m_syncTableName(syncTableName),
     m_dockName(dockerName),
     m_appName(appName)
@@ -65,8 +70,7 @@ bool WarmStartHelper::checkAndStart(void)
     }
 
     /* Cleaning state from previous (unsuccessful) warm-restart attempts */
-    m_restorationVector.clear();
-    m_refreshMap.clear();
+    m_reconciler.clear();
 
     /* Keeping track of warm-reboot active/inactive state */
     m_enabled = enabled;
@@ -104,13 +108,39 @@ bool WarmStartHelper::runRestoration()
     SWSS_LOG_NOTICE("Warm-Restart: Initiating AppDB restoration process for %s "
                     "application.", m_appName.c_str());
 
-    m_restorationTable.getContent(m_restorationVector);
+    if (m_reconciler.getMode() == WarmStartReconciler::RECONCILE_HASH)
+    {
+        /*
+         * Restoring one entry at a time and keeping its hash only, so that the
+         * whole table is never held in memory.
+         */
+        std::vector<std::string> keys;
+        m_restorationTable.getKeys(keys);
+
+        for (const auto &key : keys)
+        {
+            std::vector<FieldValueTuple> fv;
+
+            if (m_restorationTable.get(key, fv))
+            {
+                m_reconciler.restore(key, fv);
+            }
+        }
+    }
+    else
+    {
+        WarmStartReconciler::kfvVector restorationVector;
+        m_restorationTable.getContent(restorationVector);
+        m_reconciler.restore(std::move(restorationVector));
+    }
+
+    size_t restored = m_reconciler.restoredSize();
 
     /*
      * If there's no AppDB state to restore, then alert callee right away to avoid
      * iterating through the 'reconciliation' process.
      */
-    if (!m_restorationVector.size())
+    if (!restored)
     {
         SWSS_LOG_NOTICE("Warm-Restart: No records received from AppDB for %s "
                         "application.", m_appName.c_str());
@@ -122,7 +152,7 @@ bool WarmStartHelper::runRestoration()
 
     SWSS_LOG_NOTICE("Warm-Restart: Received %zu records from AppDB for %s "
                     "application.",
-                    m_restorationVector.size(),
+                    restored,
                     m_appName.c_str());
 
     setState(WarmStart::RESTORED);
@@ -135,9 +165,126 @@ bool WarmStartHelper::runRestoration()
 
 
 void WarmStartHelper::insertRefreshMap(const KeyOpFieldsValuesTuple &kfv)
+{
+    m_reconciler.insertRefreshMap(kfv);
+}
+
+
+/*
+ * Pushes down to AppDB the differences the reconciler finds between the
+ * restored state and the refreshed one.
+ */
+void WarmStartHelper::reconcile(void)
+{
+    SWSS_LOG_NOTICE("Warm-Restart: Initiating reconciliation process for %s "
+                    "application.", m_appName.c_str());
+
+    assert(getState() == WarmStart::RESTORED);
+
+    m_reconciledCount = 0;
+
+    m_reconciler.reconcile(
+        [this](const std::string &key)
+        {
+            m_syncTable->del(key);
+            pushReconciled();
+        },
+        [this](const std::string &key, const std::vector<FieldValueTuple> &fv)
+        {
+            m_syncTable->set(key, fv);
+            pushReconciled();
+        });
+
+    m_pipeline->flush();
+
+    setState(WarmStart::RECONCILED);
+
+    SWSS_LOG_NOTICE("Warm-Restart: Concluded reconciliation process for %s "
+                    "application.", m_appName.c_str());
+}
+
+
+/*
+ * Flushes the pipeline every RECONCILE_BATCH_SIZE entries pushed down to
+ * AppDB, so that the reconciliation of large tables is streamed to redis
+ * rather than buffered.
+ */
+void WarmStartHelper::pushReconciled(void)
+{
+    if (++m_reconciledCount % RECONCILE_BATCH_SIZE == 0)
+    {
+        m_pipeline->flush();
+    }
+}
+
+
+WarmStartReconciler::WarmStartReconciler(ReconcileMode mode) :
+    m_mode(mode)
+{
+}
+
+
+void WarmStartReconciler::clear(void)
+{
+    m_restorationVector.clear();
+    m_restoredHashes.clear();
+    m_refreshMap.clear();
+}
+
+
+void WarmStartReconciler::restore(const std::string &key, const std::vector<FieldValueTuple> &fv)
+{
+    if (m_mode == RECONCILE_HASH)
+    {
+        m_restoredHashes.restore(key, fv);
+    }
+    else
+    {
+        m_restorationVector.emplace_back(key, SET_COMMAND, fv);
+    }
+}
+
+
+void WarmStartReconciler::restore(kfvVector &&kfvs)
+{
+    if (m_mode == RECONCILE_HASH)
+    {
+        for (const auto &kfv : kfvs)
+        {
+            m_restoredHashes.restore(kfvKey(kfv), kfvFieldsValues(kfv));
+        }
+    }
+    else
+    {
+        m_restorationVector.insert(m_restorationVector.end(),
+                                   std::make_move_iterator(kfvs.begin()),
+                                   std::make_move_iterator(kfvs.end()));
+    }
+}
+
+
+size_t WarmStartReconciler::restoredSize(void) const
+{
+    return (m_mode == RECONCILE_HASH) ? m_restoredHashes.size() :
+                                        m_restorationVector.size();
+}
+
+
+void WarmStartReconciler::insertRefreshMap(const KeyOpFieldsValuesTuple &kfv)
 {
     const std::string key = kfvKey(kfv);
 
+    /*
+     * In hash mode, only the entries differing from their restored state are
+     * kept. An entry brought back to its restored state supersedes any earlier
+     * refresh of it.
+     */
+    if (m_mode == RECONCILE_HASH && m_restoredHashes.refresh(kfv))
+    {
+        m_refreshMap.erase(key);
+        return;
+    }
+
     m_refreshMap[key] = kfv;
 }
 
@@ -147,14 +294,15 @@ void WarmStartHelper::insertRefreshMap(const KeyOpFieldsValuesTuple &kfv)
  * is comparing the restored elements (old state) with the refreshed/new ones
  * generated by the application once it completes its restart cycle. If a
  * state-diff is found between these two, we will be honoring the refreshed
- * one received from the application, and will proceed to push it down to AppDB.
+ * one received from the application, and will proceed to hand it to 'set', or
+ * to 'del' for the restored elements to delete.
  */
-void WarmStartHelper::reconcile(void)
+void WarmStartReconciler::reconcile(const DelCallback &del, const SetCallback &set)
 {
-    SWSS_LOG_NOTICE("Warm-Restart: Initiating reconciliation process for %s "
-                    "application.", m_appName.c_str());
-
-    assert(getState() == WarmStart::RESTORED);
+    if (m_mode == RECONCILE_HASH)
+    {
+        reconcileHashes(del, set);
+    }
 
     for (auto &restoredElem : m_restorationVector)
     {
@@ -172,7 +320,7 @@ void WarmStartHelper::reconcile(void)
             SWSS_LOG_NOTICE("Warm-Restart reconciliation: deleting stale entry %s",
                             printKFV(restoredKey, restoredFV).c_str());
 
-            m_syncTable->del(restoredKey);
+            del(restoredKey);
             continue;
         }
 
@@ -185,7 +333,7 @@ void WarmStartHelper::reconcile(void)
             SWSS_LOG_NOTICE("Warm-Restart reconciliation: deleting entry %s",
                             printKFV(restoredKey, restoredFV).c_str());
 
-            m_syncTable->del(restoredKey);
+            del(restoredKey);
         }
 
         /*
@@ -202,7 +350,7 @@ void WarmStartHelper::reconcile(void)
                 SWSS_LOG_NOTICE("Warm-Restart reconciliation: updating entry %s",
                                 printKFV(refreshedKey, refreshedFV).c_str());
 
-                m_syncTable->set(refreshedKey, refreshedFV);
+                set(refreshedKey, refreshedFV);
             }
             else
             {
@@ -243,7 +391,7 @@ void WarmStartHelper::reconcile(void)
             SWSS_LOG_NOTICE("Warm-Restart reconciliation: introducing new entry %s",
                             printKFV(refreshedKey, refreshedFV).c_str());
 
-            m_syncTable->set(refreshedKey, refreshedFV);
+            set(refreshedKey, refreshedFV);
         }
     }
 
@@ -252,11 +400,47 @@ void WarmStartHelper::reconcile(void)
 
     /* Clearing restoration vector */
     m_restorationVector.clear();
+}
 
-    setState(WarmStart::RECONCILED);
 
-    SWSS_LOG_NOTICE("Warm-Restart: Concluded reconciliation process for %s "
-                    "application.", m_appName.c_str());
+/*
+ * Reconciliation of the restored entries held as hashes. The refreshMap only
+ * holds the entries which differ from their restored state, so every restored
+ * entry left out of date is either deleted or updated. The refreshMap is left
+ * with the brand-new entries.
+ */
+void WarmStartReconciler::reconcileHashes(const DelCallback &del, const SetCallback &set)
+{
+    m_restoredHashes.sweep([&](const std::string &restoredKey)
+    {
+        auto iter = m_refreshMap.find(restoredKey);
+
+        if (iter == m_refreshMap.end())
+        {
+            SWSS_LOG_NOTICE("Warm-Restart reconciliation: deleting stale entry %s",
+                            restoredKey.c_str());
+
+            del(restoredKey);
+        }
+        else if (kfvOp(iter->second) == DEL_COMMAND)
+        {
+            SWSS_LOG_NOTICE("Warm-Restart reconciliation: deleting entry %s",
+                            restoredKey.c_str());
+
+            del(restoredKey);
+            m_refreshMap.erase(iter);
+        }
+        else
+        {
+            auto refreshedFV = kfvFieldsValues(iter->second);
+
+            SWSS_LOG_NOTICE("Warm-Restart reconciliation: updating entry %s",
+                            printKFV(restoredKey, refreshedFV).c_str());
+
+            set(restoredKey, refreshedFV);
+            m_refreshMap.erase(iter);
+        }
+    });
 }
 
 
@@ -271,8 +455,8 @@ void WarmStartHelper::reconcile(void)
  *    'false' : If the content of both 'fields' and 'values' fully match
  *    'true'  : No full-match is found
  */
-bool WarmStartHelper::compareAllFV(const std::vector<FieldValueTuple> &v1,
-                                   const std::vector<FieldValueTuple> &v2)
+bool WarmStartReconciler::compareAllFV(const std::vector<FieldValueTuple> &v1,
+                                       const std::vector<FieldValueTuple> &v2)
 {
     std::unordered_map<std::string, std::string> v1Map((v1.begin()), v1.end());
 
@@ -318,7 +502,7 @@ bool WarmStartHelper::compareAllFV(const std::vector<FieldValueTuple> &v1,
  *    'false' : If the content of both strings fully matches
  *    'true'  : No full-match is found
  */
-bool WarmStartHelper::compareOneFV(const std::string &s1, const std::string &s2)
+bool WarmStartReconciler::compareOneFV(const std::string &s1, const std::string &s2)
 {
     if (s1.size() != s2.size())
     {
@@ -355,8 +539,8 @@ bool WarmStartHelper::compareOneFV(const std::string &s1, const std::string &s2)
  *
  * 192.168.1.0/30 { nexthop: 10.2.2.1,10.1.2.1 | ifname: Ethernet116,Ethernet112 }
  */
-const std::string WarmStartHelper::printKFV(const std::string                  &key,
-                                            const std::vector<FieldValueTuple> &fv)
+const std::string WarmStartReconciler::printKFV(const std::string                  &key,
+                                                const std::vector<FieldValueTuple> &fv)
 {
     std::string res;
 
@@ -6,6 +6,7 @@
 #include <map>
 #include <unordered_map>
 #include <algorithm>
+#include <functional>
 
 #include "dbconnector.h"
 #include "producerstatetable.h"
@@ -13,21 +14,33 @@
 #include "table.h"
 #include "tokenize.h"
 #include "warm_restart.h"
+#include "warmRestartHashes.h"
 
 
 namespace swss {
 
 
-class WarmStartHelper {
+/*
+ * Old (restored) and new (refreshed) state of a warm-restart reconciliation,
+ * and the comparison of both. It holds no redis state: the entries to delete
+ * or to set are handed to the callbacks given to reconcile().
+ */
+class WarmStartReconciler {
   public:
 
-    WarmStartHelper(RedisPipeline      *pipeline,
-                    ProducerStateTable *syncTable,
-                    const std::string  &syncTableName,
-                    const std::string  &dockerName,
-                    const std::string  &appName);
-
-    ~WarmStartHelper();
+    /*
+     * How the restored state is held until reconciliation:
+     *
+     *   RECONCILE_FULL : all the field-value tuples of every restored entry.
+     *   RECONCILE_HASH : a content hash per restored entry, and the refreshed
+     *                    entries differing from the restored ones. Meant for
+     *                    large tables, such as the routes of fpmsyncd.
+     */
+    enum ReconcileMode
+    {
+        RECONCILE_FULL,
+        RECONCILE_HASH,
+    };
 
     /* fvVector type to be used to host AppDB restored elements */
     using kfvVector = std::vector<KeyOpFieldsValuesTuple>;
@@ -38,6 +51,65 @@ class WarmStartHelper {
      */
     using kfvMap = std::unordered_map<std::string, KeyOpFieldsValuesTuple>;
 
+    using DelCallback = std::function<void(const std::string &key)>;
+    using SetCallback = std::function<void(const std::string &key,
+                                           const std::vector<FieldValueTuple> &fv)>;
+
+    WarmStartReconciler(ReconcileMode mode = RECONCILE_FULL);
+
+    ReconcileMode getMode(void) const
+    {
+        return m_mode;
+    }
+
+    void clear(void);
+
+    void restore(const std::string &key, const std::vector<FieldValueTuple> &fv);
+
+    void restore(kfvVector &&kfvs);
+
+    size_t restoredSize(void) const;
+
+    void insertRefreshMap(const KeyOpFieldsValuesTuple &kfv);
+
+    void reconcile(const DelCallback &del, const SetCallback &set);
+
+    static bool compareAllFV(const std::vector<FieldValueTuple> &left,
+                             const std::vector<FieldValueTuple> &right);
+
+    static bool compareOneFV(const std::string &v1, const std::string &v2);
+
+    static const std::string printKFV(const std::string                  &key,
+                                      const std::vector<FieldValueTuple> &fv);
+
+  private:
+
+    void reconcileHashes(const DelCallback &del, const SetCallback &set);
+
+    kfvVector                 m_restorationVector; // buffer struct to hold old state
+    WarmStartHashes           m_restoredHashes;    // old state, as content hashes
+    kfvMap                    m_refreshMap;        // buffer struct to hold new state
+    ReconcileMode             m_mode;              // how old state is held
+};
+
+
+class WarmStartHelper {
+  public:
+
+    using ReconcileMode = WarmStartReconciler::ReconcileMode;
+
+    /* Pipeline flushes while pushing the reconciled entries, every so many */
+    static const size_t RECONCILE_BATCH_SIZE = 1024;
+
+    WarmStartHelper(RedisPipeline      *pipeline,
+                    ProducerStateTable *syncTable,
+                    const std::string  &syncTableName,
+                    const std::string  &dockerName,
+                    const std::string  &appName,
+                    ReconcileMode       mode = WarmStartReconciler::RECONCILE_FULL);
+
+    ~WarmStartHelper();
+
     void setState(WarmStart::WarmStartState state);
 
     WarmStart::WarmStartState getState(void) const;
@@ -57,19 +129,20 @@ class WarmStartHelper {
     void reconcile(void);
 
     const std::string printKFV(const std::string                  &key,
-                               const std::vector<FieldValueTuple> &fv);
+                               const std::vector<FieldValueTuple> &fv)
+    {
+        return WarmStartReconciler::printKFV(key, fv);
+    }
 
   private:
 
-    bool compareAllFV(const std::vector<FieldValueTuple> &left,
-                      const std::vector<FieldValueTuple> &right);
-
-    bool compareOneFV(const std::string &v1, const std::string &v2);
+    void pushReconciled(void);
 
+    RedisPipeline            *m_pipeline;          // pipeline shared with the producer-table
     ProducerStateTable       *m_syncTable;         // producer-table to sync/push state to
     Table                     m_restorationTable;  // redis table to import current-state from
-    kfvVector                 m_restorationVector; // buffer struct to hold old state
-    kfvMap                    m_refreshMap;        // buffer struct to hold new state
+    WarmStartReconciler       m_reconciler;        // old and new state
+    size_t                    m_reconciledCount;   // entries pushed down by reconcile()
     WarmStart::WarmStartState m_state;             // cached value of warmStart's FSM state
     bool                      m_enabled;           // warm-reboot enabled/disabled status
     std::string               m_syncTableName;     // producer-table-name to sync/push state to